@@ -248,6 +248,55 @@ PHI_DEFINE_EXPORTED_int64(
     "operator. The deterministic algorithm may be slower. If "
     "it is larger than 0, the algorithm is deterministic.");
 
+/**
+ * CPU related FLAG
+ * Name: FLAGS_cpu_reduce_use_kahan_sum
+ * Since Version: 3.1.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_cpu_reduce_use_kahan_sum=true
+ * Note: Whether the floating point sums of the CPU reduce kernels (sum, mean
+ *       and p_norm) use compensated (Kahan) summation instead of pairwise
+ *       summation. Kahan summation is more accurate and slower.
+ */
+PHI_DEFINE_EXPORTED_bool(cpu_reduce_use_kahan_sum,
+                         false,
+                         "Whether the CPU reduce kernels use Kahan summation "
+                         "instead of pairwise summation.");
+
+/**
+ * CPU related FLAG
+ * Name: FLAGS_cpu_random_use_philox
+ * Since Version: 3.1.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_cpu_random_use_philox=true
+ * Note: Whether the CPU dropout, uniform and gaussian kernels draw from a
+ *       Philox counter based generator keyed by the (seed, offset) of the
+ *       generator, like the GPU kernels, instead of its mt19937_64 engine.
+ *       The Philox kernels run in parallel and their results do not depend
+ *       on the number of threads.
+ */
+PHI_DEFINE_EXPORTED_bool(cpu_random_use_philox,
+                         false,
+                         "Whether the CPU random kernels use a Philox counter "
+                         "based generator.");
+
+/**
+ * CPU related FLAG
+ * Name: FLAGS_cpu_conv2d_algo
+ * Since Version: 3.1.0
+ * Value Range: string, default=auto
+ * Example: FLAGS_cpu_conv2d_algo=winograd_f43
+ * Note: The algorithm of the CPU conv2d and depthwise_conv2d kernels. auto
+ *       picks one from the shape of the conv, legacy runs im2col + GEMM one
+ *       sample after the other, and im2col, direct, depthwise, winograd_f23
+ *       and winograd_f43 force that algorithm on the convs it supports.
+ */
+PHI_DEFINE_EXPORTED_string(cpu_conv2d_algo,
+                           "auto",
+                           "The algorithm of the CPU conv2d kernels: auto, "
+                           "legacy, im2col, direct, depthwise, winograd_f23 "
+                           "or winograd_f43.");
+
 /**
  * CUDNN related FLAG
  * Name: FLAGS_cudnn_exhaustive_search
@@ -1505,6 +1554,54 @@ PHI_DEFINE_EXPORTED_bool(dataloader_use_file_descriptor,
                          false,
                          "Use file descriptor in mmap_allocator.");
 
+/**
+ * Dataset related FLAG
+ * Name: localfs_native_read
+ * Since Version: 3.1.0
+ * Value Range: bool, default=true
+ * Example: FLAGS_localfs_native_read=false
+ * Note: Whether fs_open_read reads local files whose converter is empty or
+ *       `cat` inside the process, inflating .gz files with zlib, instead of
+ *       forking a `cat` or `zcat` pipeline for every file.
+ */
+PHI_DEFINE_EXPORTED_bool(localfs_native_read,
+                         true,
+                         "Whether local dataset files are read and inflated "
+                         "in process instead of through a shell pipeline.");
+
+/**
+ * Dataset related FLAG
+ * Name: dataset_columnar_global_shuffle
+ * Since Version: 3.1.0
+ * Value Range: bool, default=true
+ * Example: FLAGS_dataset_columnar_global_shuffle=false
+ * Note: Whether MultiSlotDataset::GlobalShuffle packs the records of each
+ *       trainer into columnar batches, instead of serializing them one by
+ *       one into BinaryArchives. The columnar path bounds the batches in
+ *       flight with FLAGS_dataset_global_shuffle_max_inflight_msgs and does
+ *       not sleep for fleet_send_sleep_seconds between sends. All trainers
+ *       can receive both formats.
+ */
+PHI_DEFINE_EXPORTED_bool(dataset_columnar_global_shuffle,
+                         true,
+                         "Whether GlobalShuffle sends columnar record "
+                         "batches.");
+
+/**
+ * Dataset related FLAG
+ * Name: dataset_global_shuffle_max_inflight_msgs
+ * Since Version: 3.1.0
+ * Value Range: int32, default=64
+ * Example: FLAGS_dataset_global_shuffle_max_inflight_msgs=16
+ * Note: The maximum number of columnar record batches a GlobalShuffle thread
+ *       has sent and not seen answered yet. Lower it when the receivers
+ *       cannot keep up with the senders.
+ */
+PHI_DEFINE_EXPORTED_int32(dataset_global_shuffle_max_inflight_msgs,
+                          64,
+                          "The maximum columnar record batches in flight of "
+                          "a GlobalShuffle thread.");
+
 /**
  * Tensor operants related FLAG
  * Name: tensor_operants_mode
@@ -1570,6 +1667,38 @@ PHI_DEFINE_EXPORTED_bool(
     false,
     "whether PirInterpreter::RecordStreamForGC use cache strategy.");
 
+/**
+ * Executor related FLAG
+ * Name: FLAGS_pir_interpreter_shape_plan_capacity
+ * Since Version: 3.1.0
+ * Value Range: int32, default=4
+ * Example: FLAGS_pir_interpreter_shape_plan_capacity=0 makes PirInterpreter
+ * run InferMeta of every instruction on every run.
+ * Note: The number of feed shapes whose InferMeta results PirInterpreter keeps
+ * and replays when a run is fed with the same shapes again.
+ */
+PHI_DEFINE_EXPORTED_int32(pir_interpreter_shape_plan_capacity,
+                          4,
+                          "The number of feed shapes whose InferMeta results "
+                          "PirInterpreter keeps, 0 means no reuse.");
+
+/**
+ * Executor related FLAG
+ * Name: FLAGS_pir_interpreter_macro_instruction_max_numel
+ * Since Version: 3.1.0
+ * Value Range: int64, default=0
+ * Example: FLAGS_pir_interpreter_macro_instruction_max_numel=64 makes the
+ * trace mode of PirInterpreter run consecutive CPU kernels whose outputs have
+ * at most 64 elements as one macro instruction.
+ * Note: A macro instruction runs its kernels inline without the per op
+ * profiler events, memory attribution and GC bookkeeping, 0 turns it off.
+ */
+PHI_DEFINE_EXPORTED_int64(pir_interpreter_macro_instruction_max_numel,
+                          0,
+                          "The max number of output elements of the CPU "
+                          "kernels PirInterpreter runs as macro instructions "
+                          "in trace mode, 0 means no macro instructions.");
+
 /**
  * Using PIR API in Python
  * Name: enable_pir_api
@@ -1626,6 +1755,21 @@ PHI_DEFINE_EXPORTED_int64(host_trace_level,
                           "RecordEvent will works "
                           "if host_trace_level >= level.");
 
+/**
+ * Profiler related FLAG
+ * Name: FLAGS_enable_profiler_hw_counters
+ * Since Version: 3.1.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_enable_profiler_hw_counters=true
+ * Note: Read hardware performance counters (cycles, instructions, LLC misses
+ * and branch misses) for each operator recorded by the host tracer. Only
+ * supported on Linux.
+ */
+PHI_DEFINE_EXPORTED_bool(enable_profiler_hw_counters,
+                         false,
+                         "Read hardware performance counters for each "
+                         "operator recorded by the host tracer.");
+
 PHI_DEFINE_EXPORTED_int32(
     multiple_of_cupti_buffer_size,
     1,
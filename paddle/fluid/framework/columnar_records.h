@@ -0,0 +1,201 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "paddle/fluid/framework/data_feed.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace framework {
+
+// The client to client message type of columnar record batches. Messages of
+// type 0 carry records serialized one by one into a BinaryArchive.
+constexpr int kColumnarRecordsMsgType = 1;
+
+static_assert(std::is_trivially_copyable<FeatureItem>::value,
+              "Columnar record batches copy FeatureItems as raw bytes.");
+
+// A columnar record batch holds the fields GlobalShuffle sends of a list of
+// records (the uint64 and float feasigns and the ins id) column by column:
+//   uint64_t num_records, num_uint64_feasigns, num_float_feasigns,
+//            ins_id_bytes
+//   uint32_t uint64 feasign count, float feasign count and ins id length of
+//            each record
+//   FeatureItem uint64 feasigns, FeatureItem float feasigns, char ins ids
+// so packing and unpacking a record copies each of its fields at once,
+// instead of going through the Archive of every FeatureItem.
+struct ColumnarRecordsHeader {
+  uint64_t num_records{0};
+  uint64_t num_uint64_feasigns{0};
+  uint64_t num_float_feasigns{0};
+  uint64_t ins_id_bytes{0};
+
+  size_t BatchBytes() const {
+    return sizeof(ColumnarRecordsHeader) +
+           3 * sizeof(uint32_t) * num_records +
+           sizeof(FeatureItem) * (num_uint64_feasigns + num_float_feasigns) +
+           ins_id_bytes;
+  }
+
+  void Add(const Record& record) {
+    ++num_records;
+    num_uint64_feasigns += record.uint64_feasigns_.size();
+    num_float_feasigns += record.float_feasigns_.size();
+    ins_id_bytes += record.ins_id_.size();
+  }
+};
+
+// Partitions records among num_parts destinations with a counting sort on
+// part_of(record) and packs the records of destination i, in their order,
+// into the columnar batch (*batches)[i]. A destination without records
+// gets an empty batch.
+template <typename PartOf>
+void PackColumnarRecords(const std::vector<Record>& records,
+                         int num_parts,
+                         const PartOf& part_of,
+                         std::vector<std::string>* batches) {
+  // Counts the size of every column of every destination.
+  std::vector<int> parts(records.size());
+  std::vector<ColumnarRecordsHeader> headers(num_parts);
+  for (size_t i = 0; i < records.size(); ++i) {
+    parts[i] = static_cast<int>(part_of(records[i]));
+    headers[parts[i]].Add(records[i]);
+  }
+
+  // Lays out the columns of each batch, then scatters the records to them.
+  struct Columns {
+    uint32_t* uint64_counts;
+    uint32_t* float_counts;
+    uint32_t* ins_id_lengths;
+    char* uint64_feasigns;
+    char* float_feasigns;
+    char* ins_ids;
+  };
+  std::vector<Columns> columns(num_parts);
+  batches->resize(num_parts);
+  for (int p = 0; p < num_parts; ++p) {
+    const ColumnarRecordsHeader& header = headers[p];
+    std::string& batch = (*batches)[p];
+    if (header.num_records == 0) {
+      batch.clear();
+      continue;
+    }
+    batch.resize(header.BatchBytes());
+    char* cursor = &batch[0];
+    memcpy(cursor, &header, sizeof(header));
+    cursor += sizeof(header);
+    Columns& c = columns[p];
+    c.uint64_counts = reinterpret_cast<uint32_t*>(cursor);
+    c.float_counts = c.uint64_counts + header.num_records;
+    c.ins_id_lengths = c.float_counts + header.num_records;
+    c.uint64_feasigns =
+        reinterpret_cast<char*>(c.ins_id_lengths + header.num_records);
+    c.float_feasigns =
+        c.uint64_feasigns + sizeof(FeatureItem) * header.num_uint64_feasigns;
+    c.ins_ids =
+        c.float_feasigns + sizeof(FeatureItem) * header.num_float_feasigns;
+  }
+  for (size_t i = 0; i < records.size(); ++i) {
+    const Record& record = records[i];
+    Columns& c = columns[parts[i]];
+    const size_t num_uint64 = record.uint64_feasigns_.size();
+    const size_t num_float = record.float_feasigns_.size();
+    *c.uint64_counts++ = static_cast<uint32_t>(num_uint64);
+    *c.float_counts++ = static_cast<uint32_t>(num_float);
+    *c.ins_id_lengths++ = static_cast<uint32_t>(record.ins_id_.size());
+    memcpy(c.uint64_feasigns,
+           record.uint64_feasigns_.data(),
+           sizeof(FeatureItem) * num_uint64);
+    c.uint64_feasigns += sizeof(FeatureItem) * num_uint64;
+    memcpy(c.float_feasigns,
+           record.float_feasigns_.data(),
+           sizeof(FeatureItem) * num_float);
+    c.float_feasigns += sizeof(FeatureItem) * num_float;
+    memcpy(c.ins_ids, record.ins_id_.data(), record.ins_id_.size());
+    c.ins_ids += record.ins_id_.size();
+  }
+}
+
+// Appends the records of a batch written by PackColumnarRecords to records.
+inline void UnpackColumnarRecords(const char* batch,
+                                  size_t length,
+                                  std::vector<Record>* records) {
+  ColumnarRecordsHeader header;
+  PADDLE_ENFORCE_GE(
+      length,
+      sizeof(header),
+      common::errors::InvalidArgument(
+          "The columnar record batch of %d bytes misses its header.", length));
+  memcpy(&header, batch, sizeof(header));
+  PADDLE_ENFORCE_EQ(length,
+                    header.BatchBytes(),
+                    common::errors::InvalidArgument(
+                        "The columnar record batch of %d records should have "
+                        "%d bytes, but received %d bytes.",
+                        header.num_records,
+                        header.BatchBytes(),
+                        length));
+  const char* cursor = batch + sizeof(header);
+  std::vector<uint32_t> counts(3 * header.num_records);
+  memcpy(counts.data(), cursor, sizeof(uint32_t) * counts.size());
+  const uint32_t* uint64_counts = counts.data();
+  const uint32_t* float_counts = uint64_counts + header.num_records;
+  const uint32_t* ins_id_lengths = float_counts + header.num_records;
+  const char* uint64_feasigns = cursor + sizeof(uint32_t) * counts.size();
+  const char* float_feasigns =
+      uint64_feasigns + sizeof(FeatureItem) * header.num_uint64_feasigns;
+  const char* ins_ids =
+      float_feasigns + sizeof(FeatureItem) * header.num_float_feasigns;
+  uint64_t total[3] = {0, 0, 0};
+  for (size_t i = 0; i < header.num_records; ++i) {
+    total[0] += uint64_counts[i];
+    total[1] += float_counts[i];
+    total[2] += ins_id_lengths[i];
+  }
+  PADDLE_ENFORCE_EQ(total[0] == header.num_uint64_feasigns &&
+                        total[1] == header.num_float_feasigns &&
+                        total[2] == header.ins_id_bytes,
+                    true,
+                    common::errors::InvalidArgument(
+                        "The field sizes of the records in the columnar "
+                        "record batch do not add up to its header."));
+
+  size_t begin = records->size();
+  records->resize(begin + header.num_records);
+  for (size_t i = 0; i < header.num_records; ++i) {
+    Record& record = (*records)[begin + i];
+    record.uint64_feasigns_.resize(uint64_counts[i]);
+    memcpy(record.uint64_feasigns_.data(),
+           uint64_feasigns,
+           sizeof(FeatureItem) * uint64_counts[i]);
+    uint64_feasigns += sizeof(FeatureItem) * uint64_counts[i];
+    record.float_feasigns_.resize(float_counts[i]);
+    memcpy(record.float_feasigns_.data(),
+           float_feasigns,
+           sizeof(FeatureItem) * float_counts[i]);
+    float_feasigns += sizeof(FeatureItem) * float_counts[i];
+    record.ins_id_.assign(ins_ids, ins_id_lengths[i]);
+    ins_ids += ins_id_lengths[i];
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -19,6 +19,7 @@
 #include "paddle/fluid/distributed/index_dataset/index_sampler.h"
 #endif
 #include "paddle/common/flags.h"
+#include "paddle/fluid/framework/columnar_records.h"
 #include "paddle/fluid/framework/data_feed_factory.h"
 #include "paddle/fluid/framework/fleet/fleet_wrapper.h"
 #include "paddle/fluid/framework/io/fs.h"
@@ -42,6 +43,8 @@ COMMON_DECLARE_bool(graph_get_neighbor_id);
 COMMON_DECLARE_int32(gpugraph_storage_mode);
 COMMON_DECLARE_string(graph_edges_split_mode);
 COMMON_DECLARE_bool(query_dest_rank_by_multi_node);
+COMMON_DECLARE_bool(dataset_columnar_global_shuffle);
+COMMON_DECLARE_int32(dataset_global_shuffle_max_inflight_msgs);
 
 namespace paddle::framework {
 
@@ -288,10 +291,13 @@ void DatasetImpl<T>::RegisterClientToClientMsgHandler() {
   auto fleet_ptr = framework::FleetWrapper::GetInstance();
 #endif
   VLOG(1) << "RegisterClientToClientMsgHandler";
-  fleet_ptr->RegisterClientToClientMsgHandler(
-      0, [this](int msg_type, int client_id, const std::string& msg) -> int {
-        return this->ReceiveFromClient(msg_type, client_id, msg);
-      });
+  for (int msg_type : {0, kColumnarRecordsMsgType}) {
+    fleet_ptr->RegisterClientToClientMsgHandler(
+        msg_type,
+        [this](int msg_type, int client_id, const std::string& msg) -> int {
+          return this->ReceiveFromClient(msg_type, client_id, msg);
+        });
+  }
   VLOG(1) << "RegisterClientToClientMsgHandler done";
 }
 static void compute_left_batch_num(const int ins_num,
@@ -882,7 +888,11 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
   data.shrink_to_fit();
 
   input_channel_->Close();
-  input_channel_->SetBlockSize(fleet_send_batch_size_);
+  // A columnar batch goes to every trainer, so each thread reads the records
+  // of fleet_send_batch_size_ records per trainer at once.
+  input_channel_->SetBlockSize(FLAGS_dataset_columnar_global_shuffle
+                                   ? fleet_send_batch_size_ * trainer_num_
+                                   : fleet_send_batch_size_);
   VLOG(3) << "MultiSlotDataset::GlobalShuffle() input_channel_ size "
           << input_channel_->Size();
 
@@ -944,13 +954,57 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
     }
   };
 
+  // Packs the records of each trainer into one columnar batch with a
+  // counting sort, and bounds the batches in flight instead of sleeping
+  // between sends.
+  auto columnar_global_shuffle_func = [this, get_client_id]() {
+#ifdef PADDLE_WITH_PSCORE
+    auto fleet_ptr = distributed::FleetWrapper::GetInstance();
+#else
+    auto fleet_ptr = framework::FleetWrapper::GetInstance();
+#endif
+    const size_t max_inflight = static_cast<size_t>(
+        std::max(FLAGS_dataset_global_shuffle_max_inflight_msgs, 1));
+    std::deque<std::future<int32_t>> inflight;
+    std::vector<Record> data;
+    std::vector<std::string> batches;
+    std::vector<int> send_index(this->trainer_num_);
+    for (int i = 0; i < this->trainer_num_; ++i) {
+      send_index[i] = i;
+    }
+    while (this->input_channel_->Read(data)) {
+      PackColumnarRecords(data, this->trainer_num_, get_client_id, &batches);
+      data.clear();
+      std::shuffle(
+          send_index.begin(), send_index.end(), fleet_ptr->LocalRandomEngine());
+      for (int i : send_index) {
+        if (batches[i].empty()) {
+          continue;
+        }
+        while (inflight.size() >= max_inflight) {
+          inflight.front().wait();
+          inflight.pop_front();
+        }
+        inflight.push_back(fleet_ptr->SendClientToClientMsg(
+            kColumnarRecordsMsgType, i, batches[i]));
+      }
+    }
+    for (auto& t : inflight) {
+      t.wait();
+    }
+  };
+
   std::vector<std::thread> global_shuffle_threads;
   if (thread_num == -1) {
     thread_num = thread_num_;
   }
   VLOG(3) << "start global shuffle threads, num = " << thread_num;
   for (int i = 0; i < thread_num; ++i) {
-    global_shuffle_threads.emplace_back(global_shuffle_func);
+    if (FLAGS_dataset_columnar_global_shuffle) {
+      global_shuffle_threads.emplace_back(columnar_global_shuffle_func);
+    } else {
+      global_shuffle_threads.emplace_back(global_shuffle_func);
+    }
   }
   for (std::thread& t : global_shuffle_threads) {
     t.join();
@@ -1357,23 +1411,28 @@ int MultiSlotDataset::ReceiveFromClient(int msg_type,
   if (msg.length() == 0) {
     return 0;
   }
-  paddle::framework::BinaryArchive ar;
-  ar.SetReadBuffer(const_cast<char*>(msg.c_str()), msg.length(), nullptr);
-  if (ar.Cursor() == ar.Finish()) {
-    return 0;
-  }
   std::vector<Record> data;
-  while (ar.Cursor() < ar.Finish()) {
-    data.push_back(ar.Get<Record>());
+  if (msg_type == kColumnarRecordsMsgType) {
+    UnpackColumnarRecords(msg.data(), msg.length(), &data);
+  } else {
+    paddle::framework::BinaryArchive ar;
+    ar.SetReadBuffer(const_cast<char*>(msg.c_str()), msg.length(), nullptr);
+    if (ar.Cursor() == ar.Finish()) {
+      return 0;
+    }
+    while (ar.Cursor() < ar.Finish()) {
+      data.push_back(ar.Get<Record>());
+    }
+    PADDLE_ENFORCE_EQ(ar.Cursor(),
+                      ar.Finish(),
+                      common::errors::InvalidArgument(
+                          "Cursor position does not match finish position. "
+                          "The cursor should be at the finish position. "
+                          "Received cursor position: %d, expected finish "
+                          "position: %d.",
+                          ar.Cursor(),
+                          ar.Finish()));
   }
-  PADDLE_ENFORCE_EQ(ar.Cursor(),
-                    ar.Finish(),
-                    common::errors::InvalidArgument(
-                        "Cursor position does not match finish position. The "
-                        "cursor should be at the finish position. Received "
-                        "cursor position: %d, expected finish position: %d.",
-                        ar.Cursor(),
-                        ar.Finish()));
 
   auto fleet_ptr = framework::FleetWrapper::GetInstance();
   // not use random because it doesn't perform well here.
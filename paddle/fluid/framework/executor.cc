@@ -91,6 +91,10 @@ void Executor::CreateVariables(const ProgramDesc& pdesc,
                                int block_id) {
   VLOG(3) << "Creating Variables for block " << block_id;
   auto& global_block = pdesc.Block(block_id);
+  // A new scope creates all its variables here, from one arena.
+  if (scope->Size() == 0) {
+    scope->ReserveVars(global_block.AllVars().size());
+  }
   const Scope* ancestor_scope = scope;
   while (ancestor_scope->parent()) {
     ancestor_scope = ancestor_scope->parent();
@@ -477,11 +481,15 @@ void Executor::RunPartialPreparedContext(ExecutorPrepareContext* ctx,
   PADDLE_ENFORCE_NOT_NULL(
       scope, common::errors::InvalidArgument("Scope shouldn't be null"));
   Scope* local_scope = scope;
+  // The variables a new local scope creates have the same index in every
+  // run, so the unused ones are found by index instead of their names.
+  bool use_var_indices = false;
   if (create_vars) {
     if (create_local_scope) {
       local_scope = &scope->NewScope();
     }
     CreateVariables(ctx->prog_, local_scope, static_cast<int>(ctx->block_id_));
+    use_var_indices = create_local_scope;
   }
 
   int64_t max_memory_size = GetEagerDeletionThreshold();
@@ -489,13 +497,28 @@ void Executor::RunPartialPreparedContext(ExecutorPrepareContext* ctx,
   if (!ctx->force_disable_gc_ && max_memory_size >= 0) {
     gc = CreateGarbageCollector(place_, max_memory_size);
   }
+  if (gc && use_var_indices) {
+    std::call_once(ctx->unused_var_indices_once_, [ctx, local_scope] {
+      for (auto& pair : ctx->unused_vars_) {
+        auto& indices = ctx->unused_var_indices_[pair.first];
+        indices.reserve(pair.second.size());
+        for (auto& name : pair.second) {
+          indices.push_back(local_scope->LocalVarIndex(name));
+        }
+      }
+    });
+  }
 
   for (int64_t i = start_op_index; i < end_op_index; ++i) {
     auto& op = ctx->ops_[i];
     op->Run(*local_scope, place_);
     if (gc) {
       phi::RecordEvent record("CheckGC", phi::TracerEventType::UserDefined, 10);
-      DeleteUnusedTensors(*local_scope, op.get(), ctx->unused_vars_, gc.get());
+      DeleteUnusedTensors(*local_scope,
+                          op.get(),
+                          ctx->unused_vars_,
+                          gc.get(),
+                          use_var_indices ? &ctx->unused_var_indices_ : nullptr);
     }
   }
 
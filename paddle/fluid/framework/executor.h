@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -52,6 +53,11 @@ struct TEST_API ExecutorPrepareContext {
 
   std::unordered_map<const OperatorBase*, std::vector<std::string>>
       unused_vars_;
+  // The index of each variable of `unused_vars_` in the local scope of a
+  // run, or -1 to find it by name, see Executor::RunPartialPreparedContext.
+  std::unordered_map<const OperatorBase*, std::vector<int64_t>>
+      unused_var_indices_;
+  std::once_flag unused_var_indices_once_;
   bool force_disable_gc_{false};
 
   DISABLE_COPY_AND_ASSIGN(ExecutorPrepareContext);
@@ -175,11 +175,15 @@ GetUnusedVars(const BlockDesc &block,
 
 void DeleteUnusedTensors(const Scope &scope,
                          const std::vector<std::string> &delete_vars,
-                         GarbageCollector *gc) {
+                         GarbageCollector *gc,
+                         const std::vector<int64_t> *var_indices) {
   std::deque<std::shared_ptr<memory::Allocation>> garbages;
 
-  for (auto &var_name : delete_vars) {
-    auto *var = scope.FindVar(var_name);
+  for (size_t i = 0; i < delete_vars.size(); ++i) {
+    auto &var_name = delete_vars[i];
+    auto *var = var_indices != nullptr && (*var_indices)[i] >= 0
+                    ? scope.LocalVar((*var_indices)[i])
+                    : scope.FindVar(var_name);
     if (var == nullptr) {
       continue;
     }
@@ -219,14 +223,23 @@ void DeleteUnusedTensors(
     const OperatorBase *op,
     const std::unordered_map<const OperatorBase *, std::vector<std::string>>
         &delete_vars_map,
-    GarbageCollector *gc) {
+    GarbageCollector *gc,
+    const std::unordered_map<const OperatorBase *, std::vector<int64_t>>
+        *var_indices_map) {
   auto iter = delete_vars_map.find(op);
   if (iter == delete_vars_map.end()) {
     return;
   }
 
   auto &delete_vars = iter->second;
-  DeleteUnusedTensors(scope, delete_vars, gc);
+  const std::vector<int64_t> *var_indices = nullptr;
+  if (var_indices_map != nullptr) {
+    auto indices_iter = var_indices_map->find(op);
+    if (indices_iter != var_indices_map->end()) {
+      var_indices = &indices_iter->second;
+    }
+  }
+  DeleteUnusedTensors(scope, delete_vars, gc, var_indices);
 }
 
 static std::vector<std::unique_ptr<OperatorBase>> CreateOpsFromBlock(
@@ -54,10 +54,12 @@ GetUnusedVars(const BlockDesc &block,
               const std::multiset<std::string> *unpersist_vars = nullptr,
               bool is_shard_for_thread_mode = false);
 
-// Collect unused tensors
+// Collect unused tensors. The ones with an index >= 0 in `var_indices` are
+// found by Scope::LocalVar instead of their names.
 void DeleteUnusedTensors(const Scope &scope,
                          const std::vector<std::string> &delete_vars,
-                         GarbageCollector *gc);
+                         GarbageCollector *gc,
+                         const std::vector<int64_t> *var_indices = nullptr);
 
 // Collect unused tensors after op runs
 void DeleteUnusedTensors(
@@ -65,7 +67,9 @@ void DeleteUnusedTensors(
     const OperatorBase *op,
     const std::unordered_map<const OperatorBase *, std::vector<std::string>>
         &delete_vars_map,
-    GarbageCollector *gc);
+    GarbageCollector *gc,
+    const std::unordered_map<const OperatorBase *, std::vector<int64_t>>
+        *var_indices_map = nullptr);
 
 // Get the clean vars of GC after each op runs. This function is used for
 // analysis statically.
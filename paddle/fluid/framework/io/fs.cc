@@ -19,6 +19,7 @@ limitations under the License. */
 #include <memory>
 
 #include "glog/logging.h"
+#include "paddle/fluid/framework/io/native_reader.h"
 #include "paddle/fluid/platform/enforce.h"
 
 namespace paddle::framework {
@@ -55,19 +56,8 @@ static void fs_add_write_converter_internal(std::string& path,  // NOLINT
   }
 }
 
-static std::shared_ptr<FILE> fs_open_internal(const std::string& path,
-                                              bool is_pipe,
-                                              const std::string& mode,
-                                              size_t buffer_size,
-                                              int* err_no = nullptr) {
-  std::shared_ptr<FILE> fp = nullptr;
-
-  if (!is_pipe) {
-    fp = shell_fopen(path, mode);
-  } else {
-    fp = shell_popen(path, mode, err_no);
-  }
-
+static std::shared_ptr<FILE> fs_set_buffer_internal(std::shared_ptr<FILE> fp,
+                                                    size_t buffer_size) {
   if (buffer_size > 0) {
     char* buffer = new char[buffer_size];
     PADDLE_ENFORCE_EQ(
@@ -87,6 +77,22 @@ static std::shared_ptr<FILE> fs_open_internal(const std::string& path,
   return fp;
 }
 
+static std::shared_ptr<FILE> fs_open_internal(const std::string& path,
+                                              bool is_pipe,
+                                              const std::string& mode,
+                                              size_t buffer_size,
+                                              int* err_no = nullptr) {
+  std::shared_ptr<FILE> fp = nullptr;
+
+  if (!is_pipe) {
+    fp = shell_fopen(path, mode);
+  } else {
+    fp = shell_popen(path, mode, err_no);
+  }
+
+  return fs_set_buffer_internal(fp, buffer_size);
+}
+
 static bool fs_begin_with_internal(const std::string& path,
                                    const std::string& str) {
   return strncmp(path.c_str(), str.c_str(), str.length()) == 0;
@@ -111,6 +117,12 @@ void localfs_set_buffer_size(size_t x) { localfs_buffer_size_internal() = x; }
 
 std::shared_ptr<FILE> localfs_open_read(std::string path,
                                         const std::string& converter) {
+  // Reads plain and gzip files in process, without forking cat or zcat.
+  if (native_read_supported(converter)) {
+    return fs_set_buffer_internal(native_open_read(path),
+                                  localfs_buffer_size());
+  }
+
   bool is_pipe = false;
 
   if (fs_end_with_internal(path, ".gz")) {
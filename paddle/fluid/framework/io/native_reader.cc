@@ -0,0 +1,250 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/native_reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+#include <zlib.h>
+
+#include <algorithm>
+
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/io/shell.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/utils/string/string_helper.h"
+
+COMMON_DECLARE_bool(localfs_native_read);
+
+namespace paddle::framework {
+
+#ifdef __linux__
+
+NativeFileReader::NativeFileReader(const std::string& path, bool gzip)
+    : path_(path),
+      gzip_(gzip),
+      free_chunks_(MakeChannel<Chunk>()),
+      full_chunks_(MakeChannel<Chunk>(kNumChunks)) {
+  if (gzip_) {
+    input_.resize(kChunkSize);
+    inflater_ = std::make_unique<z_stream_s>();
+    // 32 lets zlib detect the gzip header.
+    PADDLE_ENFORCE_EQ(inflateInit2(inflater_.get(), MAX_WBITS + 32),
+                      Z_OK,
+                      common::errors::External(
+                          "Failed to initialize zlib to inflate file[%s].",
+                          path));
+  }
+  fd_ = open(path.c_str(), O_RDONLY);
+  if (fd_ < 0) {
+    if (inflater_ != nullptr) {
+      inflateEnd(inflater_.get());
+    }
+    PADDLE_THROW(common::errors::Unavailable(
+        "Failed to open file, path[%s], mode[r].", path));
+  }
+  // Doubles the read-ahead window of the kernel for this file.
+  posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+  for (size_t i = 0; i < kNumChunks + 1; ++i) {
+    Chunk chunk;
+    chunk.data.resize(kChunkSize);
+    free_chunks_->Put(std::move(chunk));
+  }
+  thread_ = std::thread(&NativeFileReader::ReadLoop, this);
+}
+
+NativeFileReader::~NativeFileReader() {
+  // Stops the reader thread when the caller closes the file before its end.
+  free_chunks_->Close();
+  full_chunks_->Close();
+  thread_.join();
+  if (inflater_ != nullptr) {
+    inflateEnd(inflater_.get());
+  }
+  close(fd_);
+}
+
+int64_t NativeFileReader::Read(char* buf, size_t size) {
+  size_t copied = 0;
+  while (copied < size) {
+    if (current_pos_ == current_.size) {
+      if (!current_.data.empty()) {
+        free_chunks_->Put(std::move(current_));
+      }
+      current_ = Chunk();
+      current_pos_ = 0;
+      if (!full_chunks_->Get(current_)) {
+        break;
+      }
+    }
+    size_t n = std::min(size - copied, current_.size - current_pos_);
+    memcpy(buf + copied, current_.data.data() + current_pos_, n);
+    copied += n;
+    current_pos_ += n;
+  }
+  if (copied == 0 && !error_.empty()) {
+    return -1;
+  }
+  return static_cast<int64_t>(copied);
+}
+
+void NativeFileReader::ReadLoop() {
+  Chunk chunk;
+  try {
+    while (free_chunks_->Get(chunk)) {
+      gzip_ ? FillGzip(&chunk) : FillPlain(&chunk);
+      if (chunk.size == 0 || !full_chunks_->Put(std::move(chunk))) {
+        break;
+      }
+    }
+  } catch (const std::exception& e) {
+    error_ = e.what();
+  }
+  full_chunks_->Close();
+}
+
+size_t NativeFileReader::ReadFile(char* buf, size_t size) {
+  size_t total = 0;
+  while (total < size) {
+    ssize_t n = read(fd_, buf + total, size - total);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      PADDLE_THROW(common::errors::Unavailable(
+          "Failed to read file, path[%s]: %s.", path_, strerror(errno)));
+    }
+    if (n == 0) {
+      break;
+    }
+    total += n;
+  }
+  return total;
+}
+
+void NativeFileReader::FillPlain(Chunk* chunk) {
+  chunk->size = ReadFile(chunk->data.data(), kChunkSize);
+}
+
+void NativeFileReader::FillGzip(Chunk* chunk) {
+  z_stream_s* z = inflater_.get();
+  size_t filled = 0;
+  while (filled < kChunkSize) {
+    if (input_begin_ == input_end_) {
+      input_begin_ = 0;
+      input_end_ = ReadFile(input_.data(), input_.size());
+      if (input_end_ == 0) {
+        PADDLE_ENFORCE_EQ(in_member_,
+                          false,
+                          common::errors::InvalidArgument(
+                              "Unexpected end of gzip file[%s].", path_));
+        break;
+      }
+    }
+    z->next_in = reinterpret_cast<Bytef*>(input_.data() + input_begin_);
+    z->avail_in = static_cast<uInt>(input_end_ - input_begin_);
+    z->next_out = reinterpret_cast<Bytef*>(chunk->data.data() + filled);
+    z->avail_out = static_cast<uInt>(kChunkSize - filled);
+    int ret = inflate(z, Z_NO_FLUSH);
+    input_begin_ = input_end_ - z->avail_in;
+    filled = kChunkSize - z->avail_out;
+    if (ret == Z_STREAM_END) {
+      // Like zcat, goes on with the next member of a concatenated file.
+      in_member_ = false;
+      inflateReset(z);
+    } else if (ret == Z_OK || ret == Z_BUF_ERROR) {
+      in_member_ = true;
+    } else {
+      PADDLE_THROW(common::errors::InvalidArgument(
+          "Failed to inflate gzip file[%s]: %s.",
+          path_,
+          z->msg == nullptr ? "corrupted data" : z->msg));
+    }
+  }
+  chunk->size = filled;
+}
+
+bool native_read_supported(const std::string& converter) {
+  if (!FLAGS_localfs_native_read) {
+    return false;
+  }
+  std::string command = string::trim_spaces(converter);
+  return command.empty() || command == "cat";
+}
+
+std::shared_ptr<FILE> native_open_read(const std::string& path) {
+  if (shell_verbose()) {
+    LOG(INFO) << "Opening file[" << path << "] with native reader";
+  }
+  bool gzip = path.length() >= 3 &&
+              path.compare(path.length() - 3, 3, ".gz") == 0;
+  auto* reader = new NativeFileReader(path, gzip);
+  cookie_io_functions_t functions = {};
+  functions.read = [](void* cookie, char* buf, size_t size) -> ssize_t {
+    return static_cast<NativeFileReader*>(cookie)->Read(buf, size);
+  };
+  functions.close = [](void* cookie) -> int {
+    auto* reader = static_cast<NativeFileReader*>(cookie);
+    int ret = 0;
+    if (!reader->error().empty()) {
+      LOG(ERROR) << reader->error();
+      ret = -1;
+    }
+    delete reader;
+    return ret;
+  };
+  FILE* fp = fopencookie(reader, "r", functions);
+  if (!fp) {
+    delete reader;
+    PADDLE_THROW(common::errors::Unavailable(
+        "Failed to open file, path[%s], mode[r].", path));
+  }
+  return {fp, [path](FILE* fp) {
+            if (shell_verbose()) {
+              LOG(INFO) << "Closing file[" << path << "]";
+            }
+            if (0 != fclose(fp)) {
+              PADDLE_THROW(common::errors::Unavailable(
+                  "Failed to read file, path[%s].", path));
+            }
+          }};
+}
+
+#else
+
+NativeFileReader::NativeFileReader(const std::string& path, bool gzip)
+    : path_(path), gzip_(gzip) {
+  PADDLE_THROW(common::errors::Unimplemented(
+      "NativeFileReader is only supported on Linux."));
+}
+
+NativeFileReader::~NativeFileReader() = default;
+
+int64_t NativeFileReader::Read(char* buf, size_t size) { return -1; }
+
+bool native_read_supported(const std::string& converter) { return false; }
+
+std::shared_ptr<FILE> native_open_read(const std::string& path) {
+  PADDLE_THROW(common::errors::Unimplemented(
+      "NativeFileReader is only supported on Linux."));
+  return nullptr;
+}
+
+#endif
+
+}  // namespace paddle::framework
@@ -0,0 +1,97 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "paddle/fluid/framework/channel.h"
+
+struct z_stream_s;
+
+namespace paddle {
+namespace framework {
+
+// Reads a local file inside the process, instead of through the `cat` and
+// `zcat` pipelines localfs_open_read forks otherwise. A reader thread reads
+// the file in large chunks with sequential read-ahead and inflates gzip
+// files, while the caller parses the chunk read before.
+class NativeFileReader {
+ public:
+  static constexpr size_t kChunkSize = 1 << 20;
+  static constexpr size_t kNumChunks = 4;
+
+  NativeFileReader(const std::string& path, bool gzip);
+  ~NativeFileReader();
+
+  // Copies up to size bytes of the file to buf. Returns 0 at the end of the
+  // file and -1 after an error, which error() describes.
+  int64_t Read(char* buf, size_t size);
+
+  const std::string& error() const { return error_; }
+
+ private:
+  struct Chunk {
+    std::vector<char> data;
+    size_t size{0};
+  };
+
+  void ReadLoop();
+  // Fill chunk with the next bytes of the file, inflated for gzip files. A
+  // chunk left empty marks the end of the file.
+  void FillPlain(Chunk* chunk);
+  void FillGzip(Chunk* chunk);
+  // Reads up to size bytes of the file, retrying interrupted and short
+  // reads. Returns the bytes read, less than size only at the end.
+  size_t ReadFile(char* buf, size_t size);
+
+  std::string path_;
+  bool gzip_;
+  int fd_{-1};
+  // The compressed input of gzip files and whether a gzip member started
+  // but has not ended yet.
+  std::vector<char> input_;
+  size_t input_begin_{0};
+  size_t input_end_{0};
+  bool in_member_{false};
+  std::unique_ptr<z_stream_s> inflater_;
+
+  // Chunks travel from free_chunks_ to the reader thread, which fills them,
+  // to full_chunks_ and back to free_chunks_ once the caller consumed them.
+  Channel<Chunk> free_chunks_;
+  Channel<Chunk> full_chunks_;
+  Chunk current_;
+  size_t current_pos_{0};
+  std::thread thread_;
+  // Set by the reader thread before it closes full_chunks_.
+  std::string error_;
+};
+
+// Whether localfs_open_read reads a file with the given converter through a
+// NativeFileReader: the platform supports it, FLAGS_localfs_native_read is
+// on and the converter is empty or `cat`.
+extern bool native_read_supported(const std::string& converter);
+
+// Opens a local file for reading with a NativeFileReader behind the FILE,
+// inflating it when the path ends with .gz.
+extern std::shared_ptr<FILE> native_open_read(const std::string& path);
+
+}  // namespace framework
+}  // namespace paddle
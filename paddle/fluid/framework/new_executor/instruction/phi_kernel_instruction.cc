@@ -183,6 +183,21 @@ PhiKernelInstruction::PhiKernelInstruction(
 
 PhiKernelInstruction::~PhiKernelInstruction() { delete phi_kernel_; }
 
+void PhiKernelInstruction::SetShapePlanCache(
+    interpreter::ShapePlanCache* shape_plan_cache) {
+  if (infer_meta_interface_ == nullptr) {
+    return;
+  }
+  auto replayer =
+      std::make_unique<interpreter::InferMetaReplayer>(&infer_meta_context_);
+  if (replayer->Replayable()) {
+    shape_plan_cache_ = shape_plan_cache;
+    infer_meta_replayer_ = std::move(replayer);
+  } else {
+    VLOG(6) << phi_op_name_ << " can not replay its infer meta results.";
+  }
+}
+
 void PhiKernelInstruction::Run() {
   if (FLAGS_print_kernel_run_info) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -215,7 +230,18 @@ void PhiKernelInstruction::Run() {
     phi::RecordEvent record_event("PhiKernelInstruction::infermeta",
                                   phi::TracerEventType::UserDefined,
                                   1);
-    infer_meta_interface_->infer_meta_(&(infer_meta_context_));
+    if (infer_meta_replayer_ == nullptr) {
+      infer_meta_interface_->infer_meta_(&(infer_meta_context_));
+    } else {
+      size_t plan = shape_plan_cache_->CurrentPlan();
+      bool hit = infer_meta_replayer_->Replay(plan, &infer_meta_context_);
+      if (!hit) {
+        infer_meta_interface_->infer_meta_(&(infer_meta_context_));
+        infer_meta_replayer_->Record(
+            plan, shape_plan_cache_->Capacity(), &infer_meta_context_);
+      }
+      shape_plan_cache_->AddInferMetaResult(hit);
+    }
   }
   VLOG(6) << "End run op " << phi_op_name_ << " infer meta.";
   for (auto& pair : this->InplaceInfo()) {
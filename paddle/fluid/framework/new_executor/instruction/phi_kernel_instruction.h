@@ -15,6 +15,7 @@
 #pragma once
 
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/framework/new_executor/interpreter/shape_plan_cache.h"
 
 namespace pir {
 class Operation;
@@ -48,6 +49,10 @@ class PhiKernelInstruction : public InstructionBase {
 
   ::pir::Operation* Operation() const override { return op_; }
 
+  // Replays the InferMeta results recorded under the plan cache selects for
+  // each run, instead of running InferMeta, when the input metas match.
+  void SetShapePlanCache(interpreter::ShapePlanCache* shape_plan_cache);
+
   void Run() override;
 
   const std::string& Name() const override { return phi_op_name_; }
@@ -58,6 +63,10 @@ class PhiKernelInstruction : public InstructionBase {
 
   phi::InferMetaContext infer_meta_context_;
 
+  interpreter::ShapePlanCache* shape_plan_cache_{nullptr};  // not owned
+
+  std::unique_ptr<interpreter::InferMetaReplayer> infer_meta_replayer_;
+
   phi::KernelContext kernel_context_;
 
   phi::Kernel* phi_kernel_{nullptr};  // not owned
@@ -0,0 +1,187 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/shape_plan_cache.h"
+
+#include "paddle/fluid/framework/variable.h"
+#include "paddle/phi/core/tensor_utils.h"
+
+namespace paddle::framework::interpreter {
+
+namespace {
+
+inline void HashCombine(uint64_t value, uint64_t* seed) {
+  *seed ^= value + 0x9e3779b97f4a7c15ULL + (*seed << 6) + (*seed >> 2);
+}
+
+}  // namespace
+
+void ShapePlanCache::SelectPlan(const std::vector<const Variable*>& feed_vars) {
+  uint64_t feed_hash = feed_vars.size();
+  for (const Variable* var : feed_vars) {
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      HashCombine(0, &feed_hash);
+      continue;
+    }
+    const auto& tensor = var->Get<phi::DenseTensor>();
+    HashCombine(static_cast<uint64_t>(tensor.dtype()), &feed_hash);
+    HashCombine(tensor.dims().size(), &feed_hash);
+    for (int i = 0; i < tensor.dims().size(); ++i) {
+      HashCombine(tensor.dims()[i], &feed_hash);
+    }
+    for (const auto& level : tensor.lod()) {
+      HashCombine(level.size(), &feed_hash);
+      for (size_t offset : level) {
+        HashCombine(offset, &feed_hash);
+      }
+    }
+  }
+
+  ++run_count_;
+  size_t victim = 0;
+  for (size_t i = 0; i < plans_.size(); ++i) {
+    if (plans_[i].valid && plans_[i].feed_hash == feed_hash) {
+      plans_[i].last_used = run_count_;
+      current_plan_ = i;
+      ++plan_hits_;
+      return;
+    }
+    if (!plans_[victim].valid) {
+      continue;
+    }
+    if (!plans_[i].valid || plans_[i].last_used < plans_[victim].last_used) {
+      victim = i;
+    }
+  }
+  // The instructions still hold the metas of the replaced plan, they miss
+  // on their input check and record the new ones.
+  plans_[victim] = {true, feed_hash, run_count_};
+  current_plan_ = victim;
+  ++plan_misses_;
+}
+
+ShapePlanStats ShapePlanCache::Stats() const {
+  ShapePlanStats stats;
+  stats.plan_hits = plan_hits_;
+  stats.plan_misses = plan_misses_;
+  stats.infer_meta_hits = infer_meta_hits_.load(std::memory_order_relaxed);
+  stats.infer_meta_misses = infer_meta_misses_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+// The replayer only wraps DenseTensors and reads and writes their metas
+// directly.
+phi::DenseTensor* InferMetaReplayer::GetDenseTensor(
+    const phi::MetaTensor& meta_tensor) {
+  return static_cast<phi::DenseTensor*>(meta_tensor.tensor());
+}
+
+InferMetaReplayer::TensorMeta InferMetaReplayer::GetTensorMeta(
+    const phi::MetaTensor& meta_tensor) {
+  TensorMeta meta;
+  if (meta_tensor) {
+    const auto& dense_meta = GetDenseTensor(meta_tensor)->meta();
+    meta.is_null = false;
+    meta.dims = dense_meta.dims;
+    meta.strides = dense_meta.strides;
+    meta.dtype = dense_meta.dtype;
+    meta.layout = dense_meta.layout;
+    meta.legacy_lod = dense_meta.legacy_lod;
+  }
+  return meta;
+}
+
+bool InferMetaReplayer::SameMeta(const TensorMeta& recorded,
+                                 const phi::MetaTensor& meta_tensor) {
+  if (!meta_tensor) {
+    return recorded.is_null;
+  }
+  const auto& dense_meta = GetDenseTensor(meta_tensor)->meta();
+  return !recorded.is_null && recorded.dims == dense_meta.dims &&
+         recorded.strides == dense_meta.strides &&
+         recorded.dtype == dense_meta.dtype &&
+         recorded.layout == dense_meta.layout &&
+         recorded.legacy_lod == dense_meta.legacy_lod;
+}
+
+InferMetaReplayer::InferMetaReplayer(phi::InferMetaContext* ctx) {
+  for (size_t i = 0; i < ctx->InputsSize(); ++i) {
+    const auto& input = ctx->InputAt(i);
+    replayable_ = replayable_ && (!input || input.is_dense());
+  }
+  for (size_t i = 0; i < ctx->OutputsSize(); ++i) {
+    const auto* output = ctx->MutableOutputAt(i);
+    replayable_ = replayable_ && (output == nullptr || output->is_dense());
+  }
+  // Attributes taken from tensors (e.g. the shape of reshape) change with
+  // the data, not with the input metas.
+  for (size_t i = 0; i < ctx->AttrsSize(); ++i) {
+    const auto& attr = ctx->AttrAt(i);
+    replayable_ = replayable_ &&
+                  !paddle::holds_alternative<phi::TensorRef>(attr) &&
+                  !paddle::holds_alternative<std::vector<phi::TensorRef>>(attr);
+  }
+}
+
+bool InferMetaReplayer::Replay(size_t plan, phi::InferMetaContext* ctx) {
+  bool hit = plan < entries_.size() && entries_[plan].valid &&
+             entries_[plan].inputs.size() == ctx->InputsSize();
+  for (size_t i = 0; hit && i < ctx->InputsSize(); ++i) {
+    hit = SameMeta(entries_[plan].inputs[i], ctx->InputAt(i));
+  }
+  if (!hit) {
+    // Keep the input metas from before InferMeta runs for Record, an inplace
+    // InferMeta changes them.
+    pending_inputs_.resize(ctx->InputsSize());
+    for (size_t i = 0; i < ctx->InputsSize(); ++i) {
+      pending_inputs_[i] = GetTensorMeta(ctx->InputAt(i));
+    }
+    return false;
+  }
+  const Entry& entry = entries_[plan];
+  for (size_t i = 0; i < entry.outputs.size(); ++i) {
+    auto* output = ctx->MutableOutputAt(i);
+    if (output == nullptr) {
+      continue;
+    }
+    const TensorMeta& recorded = entry.outputs[i];
+    auto* meta =
+        phi::DenseTensorUtils::GetMutableMeta(GetDenseTensor(*output));
+    meta->dims = recorded.dims;
+    meta->strides = recorded.strides;
+    meta->dtype = recorded.dtype;
+    meta->layout = recorded.layout;
+    meta->legacy_lod = recorded.legacy_lod;
+  }
+  return true;
+}
+
+void InferMetaReplayer::Record(size_t plan,
+                               size_t capacity,
+                               phi::InferMetaContext* ctx) {
+  if (entries_.size() < capacity) {
+    entries_.resize(capacity);
+  }
+  Entry& entry = entries_[plan];
+  entry.valid = true;
+  entry.inputs.swap(pending_inputs_);
+  entry.outputs.resize(ctx->OutputsSize());
+  for (size_t i = 0; i < ctx->OutputsSize(); ++i) {
+    const auto* output = ctx->MutableOutputAt(i);
+    entry.outputs[i] =
+        output == nullptr ? TensorMeta() : GetTensorMeta(*output);
+  }
+}
+
+}  // namespace paddle::framework::interpreter
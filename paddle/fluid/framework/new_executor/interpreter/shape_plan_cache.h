@@ -0,0 +1,132 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/infermeta_utils.h"
+
+namespace paddle {
+namespace framework {
+class Variable;
+
+namespace interpreter {
+
+struct ShapePlanStats {
+  // Runs whose feed metas matched a plan kept from an earlier run.
+  int64_t plan_hits{0};
+  int64_t plan_misses{0};
+  // Instructions that replayed the output metas of their plan instead of
+  // running InferMeta, and the ones that had to run it.
+  int64_t infer_meta_hits{0};
+  int64_t infer_meta_misses{0};
+};
+
+// Keeps up to `capacity` shape plans of a program, keyed by the metas of its
+// feed variables. Every run selects a plan before its instructions execute,
+// and each instruction keeps the result of its InferMeta per plan, so a
+// program fed with a few recurring shapes (e.g. batch buckets) stops running
+// InferMeta after the first run of each shape.
+class ShapePlanCache {
+ public:
+  explicit ShapePlanCache(size_t capacity) : plans_(capacity) {}
+
+  size_t Capacity() const { return plans_.size(); }
+
+  // Selects the plan of the current run from the metas of the feed variables,
+  // replacing the least recently used plan when none of them matches.
+  void SelectPlan(const std::vector<const Variable*>& feed_vars);
+
+  size_t CurrentPlan() const { return current_plan_; }
+
+  void AddInferMetaResult(bool hit) {
+    (hit ? infer_meta_hits_ : infer_meta_misses_)
+        .fetch_add(1, std::memory_order_relaxed);
+  }
+
+  ShapePlanStats Stats() const;
+
+ private:
+  struct Plan {
+    bool valid{false};
+    uint64_t feed_hash{0};
+    uint64_t last_used{0};
+  };
+
+  std::vector<Plan> plans_;
+  size_t current_plan_{0};
+  uint64_t run_count_{0};
+  int64_t plan_hits_{0};
+  int64_t plan_misses_{0};
+  std::atomic<int64_t> infer_meta_hits_{0};
+  std::atomic<int64_t> infer_meta_misses_{0};
+};
+
+// The output metas InferMeta computed for one instruction under each plan of
+// a ShapePlanCache, together with the input metas they were computed from.
+// Replaying checks the input metas again, so a plan never hides a shape that
+// changed inside the program, e.g. after a kernel with data dependent output
+// shape. Only instructions whose inputs and outputs are all DenseTensors and
+// whose attributes do not come from tensors can be replayed.
+class InferMetaReplayer {
+ public:
+  explicit InferMetaReplayer(phi::InferMetaContext* ctx);
+
+  bool Replayable() const { return replayable_; }
+
+  // Sets the outputs of ctx to the metas recorded under plan and returns
+  // true, if the inputs of ctx have the metas they had when recording.
+  bool Replay(size_t plan, phi::InferMetaContext* ctx);
+
+  // Records the output metas of ctx under plan, after a Replay that missed
+  // and the InferMeta run that followed it.
+  void Record(size_t plan, size_t capacity, phi::InferMetaContext* ctx);
+
+ private:
+  struct TensorMeta {
+    bool is_null{true};
+    phi::DDim dims;
+    phi::DDim strides;
+    phi::DataType dtype{phi::DataType::UNDEFINED};
+    phi::DataLayout layout{phi::DataLayout::UNDEFINED};
+    phi::LegacyLoD legacy_lod;
+  };
+
+  struct Entry {
+    bool valid{false};
+    std::vector<TensorMeta> inputs;
+    std::vector<TensorMeta> outputs;
+  };
+
+  static phi::DenseTensor* GetDenseTensor(const phi::MetaTensor& meta_tensor);
+
+  static TensorMeta GetTensorMeta(const phi::MetaTensor& meta_tensor);
+
+  // Compares without copying the metas of meta_tensor, replaying runs it on
+  // every input of the instruction.
+  static bool SameMeta(const TensorMeta& recorded,
+                       const phi::MetaTensor& meta_tensor);
+
+  bool replayable_{true};
+  std::vector<Entry> entries_;
+  std::vector<TensorMeta> pending_inputs_;
+};
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -24,8 +24,10 @@
 #include "paddle/fluid/framework/new_executor/interpreter/static_build.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/platform/profiler/supplement_tracing.h"
+#include "paddle/phi/api/profiler/op_sampling_profiler.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/memory/memory_attribution.h"
 #include "paddle/phi/core/os_info.h"
 #include "paddle/phi/core/platform/device/gpu/gpu_info.h"
 #include "paddle/phi/core/platform/profiler/event_tracing.h"
@@ -90,6 +92,8 @@ COMMON_DECLARE_bool(enable_pir_in_executor_trace_run);
 COMMON_DECLARE_bool(enable_collect_shape);
 COMMON_DECLARE_int32(low_precision_op_list);
 COMMON_DECLARE_bool(pir_interpreter_record_stream_for_gc_cache);
+COMMON_DECLARE_int32(pir_interpreter_shape_plan_capacity);
+COMMON_DECLARE_int64(pir_interpreter_macro_instruction_max_numel);
 
 #define CREATE_INSTR(instr_name)                                   \
   vec_instruction_base_.emplace_back(std::make_unique<instr_name>( \
@@ -810,6 +814,11 @@ void PirInterpreter::AnalyzeForceSyncOps() {
 void PirInterpreter::BuildInstruction() {
   VLOG(6) << "Build Instructions for pir ... ";
   vec_instruction_base_.clear();
+  shape_plan_feed_names_.clear();
+  if (FLAGS_pir_interpreter_shape_plan_capacity > 0 && !shape_plan_cache_) {
+    shape_plan_cache_ = std::make_unique<interpreter::ShapePlanCache>(
+        FLAGS_pir_interpreter_shape_plan_capacity);
+  }
   size_t op_idx = 0;
   for (auto& op : *ir_block_) {
     VLOG(6) << "Build Instruction for op: " << op_idx;
@@ -925,6 +934,10 @@ void PirInterpreter::BuildInstruction() {
                          .at("op_name")
                          .dyn_cast<::pir::StrAttribute>()
                          .AsString();
+      if (op_name == "pd_op.data" || op_name == "pd_op.feed") {
+        shape_plan_feed_names_.push_back(
+            value_exe_info_->GetVarName(op.result(0)));
+      }
       if (interpreter::GetSpecialOpNames().count(op_name)) {
         VLOG(6) << "skip process " << op_name;
         continue;
@@ -935,6 +948,10 @@ void PirInterpreter::BuildInstruction() {
         CREATE_INSTR(LegacyKernelInstruction);
       } else {
         CREATE_INSTR(PhiKernelInstruction);
+        if (shape_plan_cache_) {
+          static_cast<PhiKernelInstruction*>(vec_instruction_base_.back().get())
+              ->SetShapePlanCache(shape_plan_cache_.get());
+        }
       }
 #ifdef PADDLE_WITH_DNNL
     } else if (op.dialect()->name() == "onednn_kernel") {
@@ -1650,6 +1667,24 @@ FetchList PirInterpreter::Run(const std::vector<std::string>& feed_names,
   return fetch_res;
 }
 
+void PirInterpreter::SelectShapePlan() {
+  if (!shape_plan_cache_) {
+    return;
+  }
+  std::vector<const Variable*> feed_vars;
+  feed_vars.reserve(shape_plan_feed_names_.size());
+  for (auto& var_name : shape_plan_feed_names_) {
+    feed_vars.push_back(InnerScope()->FindVar(var_name));
+  }
+  shape_plan_cache_->SelectPlan(feed_vars);
+  VLOG(4) << "Run with shape plan " << shape_plan_cache_->CurrentPlan();
+}
+
+interpreter::ShapePlanStats PirInterpreter::GetShapePlanStats() const {
+  return shape_plan_cache_ ? shape_plan_cache_->Stats()
+                           : interpreter::ShapePlanStats();
+}
+
 void PirInterpreter::TraceRunImpl() {
   // lazy initialization of gc, do not create gc is the program only run once
   if (!gc_) {
@@ -1657,6 +1692,7 @@ void PirInterpreter::TraceRunImpl() {
   }
 
   interpreter::ResetAtomicGuard guard(&deps_, &refs_);
+  SelectShapePlan();
   VLOG(4) << "Tracing Instruction List";
 
   TraceRunInstructionList(vec_instruction_base_);
@@ -1675,6 +1711,7 @@ void PirInterpreter::MultiThreadRunImpl() {
   }
 
   interpreter::ResetAtomicGuard guard(&deps_, &refs_);
+  SelectShapePlan();
   VLOG(4) << "Multi Thread Run Instruction List";
 
   async_work_queue_ = GetWorkQueue();
@@ -1718,13 +1755,27 @@ void PirInterpreter::TraceRunInstructionList(
     }
   }
 
+  bool use_macro_instructions = UseMacroInstructions();
+  if (use_macro_instructions &&
+      (macro_instruction_at_.size() != trace_execute_order_.size() ||
+       macro_instruction_max_numel_ !=
+           FLAGS_pir_interpreter_macro_instruction_max_numel)) {
+    BuildMacroInstructions();
+  }
+
   for (size_t idx = 0; idx < trace_execute_order_.size(); idx++) {
-    auto instr_id = trace_execute_order_[idx];
-    InstructionBase* instr_node = vec_instruction_base_.at(instr_id).get();
+    if (use_macro_instructions && macro_instruction_at_[idx] >= 0) {
+      const auto& macro = macro_instructions_[macro_instruction_at_[idx]];
+      RunMacroInstruction(macro);
+      idx += macro.instrs.size() - 1;
+    } else {
+      auto instr_id = trace_execute_order_[idx];
+      InstructionBase* instr_node = vec_instruction_base_.at(instr_id).get();
 
-    VLOG(6) << "Run InstructionBase " << instr_node->Name() << "[" << instr_id
-            << "], op id: " << instr_node->Operation()->id();
-    RunInstructionBase(instr_node);
+      VLOG(6) << "Run InstructionBase " << instr_node->Name() << "["
+              << instr_id << "], op id: " << instr_node->Operation()->id();
+      RunInstructionBase(instr_node);
+    }
 
     if (UNLIKELY(exception_holder_.IsCaught())) {
       VLOG(4) << "Exception caught";
@@ -1905,6 +1956,8 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
 
   auto cur_place = instr_node->DeviceContext().GetPlace();
   SetDeviceId(cur_place);
+  memory::MemoryAttributionGuard memory_attribution_guard(
+      instr_node->Name(), instr_node->Id(), cur_place);
 
   try {
     instr_node->WaitEvent(cur_place);
@@ -1948,6 +2001,7 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
       {
         phi::RecordEvent record(
             "InstrRun", phi::TracerEventType::UserDefined, 10);
+        phi::OpSamplingGuard sampling_guard(instr_node->Name());
         instr_node->Run();
       }
 
@@ -1995,6 +2049,14 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
       }
     }
 #endif
+  } catch (...) {
+    CatchInstructionException(instr_node);
+  }
+}
+
+void PirInterpreter::CatchInstructionException(InstructionBase* instr_node) {
+  try {
+    throw;
   } catch (platform::EnforceNotMet& ex) {
     auto* op = instr_node->Operation();
     const std::vector<std::string> op_callstack_attr =
@@ -2027,6 +2089,122 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
   }
 }
 
+bool PirInterpreter::UseMacroInstructions() const {
+  // Macro instructions skip the per instruction hooks and checks.
+  return FLAGS_pir_interpreter_macro_instruction_max_numel > 0 &&
+         !FLAGS_enable_collect_shape && !FLAGS_check_nan_inf &&
+         !FLAGS_low_precision_op_list && !enable_job_schedule_profiler_ &&
+         pir_input_hookfuncs_.empty() && pir_output_hookfuncs_.empty();
+}
+
+void PirInterpreter::BuildMacroInstructions() {
+  macro_instruction_max_numel_ =
+      FLAGS_pir_interpreter_macro_instruction_max_numel;
+  macro_instructions_.clear();
+  macro_instruction_at_.assign(trace_execute_order_.size(), -1);
+
+  // Phi kernels on CPU whose outputs are dense tensors with static shapes of
+  // at most macro_instruction_max_numel_ elements.
+  auto IsTiny = [this](InstructionBase* instr) {
+    if (instr->IsArtificial() ||
+        instr->KernelType() != OpFuncType::kCpuSync ||
+        !phi::is_cpu_place(instr->DeviceContext().GetPlace()) ||
+        instr->IsSyncAfterLaunch() || !instr->EventsToWait().empty() ||
+        instr->EventToRecord() != nullptr ||
+        dynamic_cast<PhiKernelInstruction*>(instr) == nullptr) {
+      return false;
+    }
+    ::pir::Operation* op = instr->Operation();
+    if (op->num_results() == 0 || op->HasAttribute("ring_id")) {
+      return false;
+    }
+    for (auto result : op->results()) {
+      auto type =
+          result.type().dyn_cast<paddle::dialect::AllocatedDenseTensorType>();
+      if (!type || common::contain_unknown_dim(type.dims()) ||
+          common::product(type.dims()) > macro_instruction_max_numel_) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  size_t begin = 0;
+  while (begin < trace_execute_order_.size()) {
+    size_t end = begin;
+    while (end < trace_execute_order_.size() &&
+           IsTiny(vec_instruction_base_[trace_execute_order_[end]].get())) {
+      ++end;
+    }
+    if (end - begin > 1) {
+      MacroInstruction macro;
+      std::map<size_t, int> gc_check_count;
+      for (size_t idx = begin; idx < end; ++idx) {
+        auto* instr = vec_instruction_base_[trace_execute_order_[idx]].get();
+        macro.instrs.push_back(instr);
+        for (auto var_id : instr->GCCheckVars()) {
+          ++gc_check_count[var_id];
+        }
+      }
+      for (auto& [var_id, count] : gc_check_count) {
+        if (parameter_var_names_.count(
+                value_exe_info_->GetNameById(static_cast<int>(var_id)))) {
+          continue;
+        }
+        if (count == var_ref_count_[var_id]) {
+          macro.gc_vars.push_back(var_id);
+        } else {
+          macro.gc_ref_vars.insert(macro.gc_ref_vars.end(), count, var_id);
+        }
+      }
+      macro_instruction_at_[begin] =
+          static_cast<int>(macro_instructions_.size());
+      macro_instructions_.push_back(std::move(macro));
+    }
+    begin = std::max(end, begin + 1);
+  }
+  VLOG(4) << "Build " << macro_instructions_.size()
+          << " macro instructions for trace mode.";
+}
+
+void PirInterpreter::RunMacroInstruction(const MacroInstruction& macro) {
+  phi::RecordEvent macro_event(
+      "MacroInstruction", phi::TracerEventType::Operator, 1);
+  InstructionBase* instr_node = nullptr;
+  try {
+    for (auto* instr : macro.instrs) {
+      instr_node = instr;
+      VLOG(6) << "Run InstructionBase " << instr->Name() << "[" << instr->Id()
+              << "] in a macro instruction";
+      // The sampling profiler and the memory attribution still see every
+      // instruction, the frees of the GC after the macro are untagged.
+      memory::MemoryAttributionGuard memory_attribution_guard(
+          instr->Name(), instr->Id(), instr->DeviceContext().GetPlace());
+      phi::OpSamplingGuard sampling_guard(instr->Name());
+      instr->Run();
+    }
+  } catch (...) {
+    CatchInstructionException(instr_node);
+    return;
+  }
+
+  auto* last_instr = macro.instrs.back();
+  for (auto var_id : macro.gc_vars) {
+    gc_->Add(refs_[var_id]->Var(), last_instr);
+  }
+  for (auto var_id : macro.gc_ref_vars) {
+    if (refs_[var_id]->CheckAndDecrease()) {
+      gc_->Add(refs_[var_id]->Var(), last_instr);
+    }
+  }
+  for (auto* instr : macro.instrs) {
+    for (auto var : instr->EagerGCVars()) {
+      gc_->Add(var, instr);
+    }
+    instr->ClearEagerGCVars();
+  }
+}
+
 void PirInterpreter::PreAnalysis() {
   BuildInstructionDependences();
   VLOG(4) << "Done BuildInstructionDependences";
@@ -15,6 +15,7 @@
 #pragma once
 #include <memory>
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/framework/new_executor/interpreter/shape_plan_cache.h"
 #include "paddle/fluid/framework/new_executor/interpreter_base_impl.h"
 #include "paddle/pir/include/core/value.h"
 
@@ -110,6 +111,12 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   std::string GetNameByValue(::pir::Value value) const;
 
+  // Counters of the shape plans and of the InferMeta runs they saved.
+  interpreter::ShapePlanStats GetShapePlanStats() const;
+
+  // Number of the macro instructions built for the trace run.
+  size_t NumMacroInstructions() const { return macro_instructions_.size(); }
+
   // Only for debug
   Variable* DebugVar(const std::string& name) const override;
 
@@ -153,6 +160,25 @@ class PirInterpreter : public InterpreterBaseImpl {
   // workqueue
   std::shared_ptr<interpreter::AsyncWorkQueue> GetWorkQueue();
 
+  // shape plan
+  void SelectShapePlan();
+
+  // macro instruction, a run of tiny CPU instructions of the trace order
+  // that runs inline as one instruction without the per instruction
+  // bookkeeping
+  struct MacroInstruction {
+    std::vector<InstructionBase*> instrs;
+    // The vars only the instructions of the macro check for GC, freed after
+    // it without counting.
+    std::vector<size_t> gc_vars;
+    // The other vars the instructions check, once per instruction.
+    std::vector<size_t> gc_ref_vars;
+  };
+
+  bool UseMacroInstructions() const;
+  void BuildMacroInstructions();
+  void RunMacroInstruction(const MacroInstruction& macro);
+
   // scope
   bool HasLocalScope() const;
 
@@ -209,6 +235,16 @@ class PirInterpreter : public InterpreterBaseImpl {
   std::vector<PirHookFunc> pir_output_hookfuncs_;
   std::vector<PirHookFunc> pir_input_hookfuncs_;
 
+  // used for replaying InferMeta, keyed by the metas of the feed variables
+  std::unique_ptr<interpreter::ShapePlanCache> shape_plan_cache_;
+  std::vector<std::string> shape_plan_feed_names_;
+
+  // used for running tiny CPU instructions as one in trace mode, the macro
+  // instruction starting at each position of trace_execute_order_ or -1
+  std::vector<MacroInstruction> macro_instructions_;
+  std::vector<int> macro_instruction_at_;
+  int64_t macro_instruction_max_numel_{0};
+
   /// ======================== ///
   ///        For new ir        ///
   /// ======================== ///
@@ -243,6 +279,9 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   void RunInstructionBase(InstructionBase* instr_node);
 
+  // Called in a catch block, keeps the exception to rethrow after the run.
+  void CatchInstructionException(InstructionBase* instr_node);
+
   void RecordMemcpyD2H(InstructionBase* instr_node);
 
   ::pir::Value GetValueByName(const std::string& var_name);
@@ -86,6 +86,42 @@ Variable* Scope::FindLocalVar(const std::string& name) const {
   return FindVarLocally(name);
 }
 
+int64_t Scope::LocalVarIndex(const std::string& name) const {
+  SCOPE_VARS_READER_LOCK
+  auto it = vars_.find(name);
+  if (it == vars_.end()) {
+    return -1;
+  }
+  // The generation of the slot in the high bits, and the slot in the low.
+  return static_cast<int64_t>(var_list_[it->second].generation) << 32 |
+         static_cast<int64_t>(it->second);
+}
+
+Variable* Scope::LocalVar(int64_t index) const {
+  SCOPE_VARS_READER_LOCK
+  if (index < 0) {
+    return nullptr;
+  }
+  size_t slot = index & 0xffffffff;
+  if (slot >= var_list_.size() ||
+      var_list_[slot].generation != static_cast<uint32_t>(index >> 32)) {
+    return nullptr;
+  }
+  return var_list_[slot].var.get();
+}
+
+void Scope::ReserveVars(size_t num_vars) {
+  SCOPE_VARS_WRITER_LOCK
+  size_t num_arena_vars = var_arena_end_ - var_arena_next_;
+  if (num_vars > num_arena_vars) {
+    var_arena_.emplace_back(new Variable[num_vars - num_arena_vars]);
+    var_arena_next_ = var_arena_.back().get();
+    var_arena_end_ = var_arena_next_ + num_vars - num_arena_vars;
+  }
+  vars_.reserve(vars_.size() + num_vars);
+  var_list_.reserve(var_list_.size() + num_vars);
+}
+
 const Scope* Scope::FindScope(const Variable* var) const {
   SCOPE_VARS_READER_LOCK
   return FindScopeInternal(var);
@@ -139,7 +175,7 @@ std::vector<Variable*> Scope::LocalVars() {
     SCOPE_VARS_READER_LOCK
     known_vars.reserve(this->vars_.size());
     for (auto& p : vars_) {
-      known_vars.emplace_back(p.second.get());
+      known_vars.emplace_back(var_list_[p.second].var.get());
     }
   }
   return known_vars;
@@ -169,6 +205,7 @@ void Scope::EraseVars(const std::vector<std::string>& var_names) {
     SCOPE_VARS_WRITER_LOCK
     for (auto it = vars_.begin(); it != vars_.end();) {
       if (var_set.find(it->first) != var_set.end()) {
+        EraseVarAt(it->second);
         it = vars_.erase(it);
       } else {
         ++it;
@@ -197,15 +234,25 @@ std::string Scope::Rename(const std::string& origin_name) const {
 Variable* Scope::VarInternal(const std::string& name) {
   auto* v = FindVarLocally(name);
   if (v != nullptr) return v;
-  v = new Variable();
-  vars_.emplace(name, std::unique_ptr<Variable>(v));
+  bool in_arena = var_arena_next_ != var_arena_end_;
+  v = in_arena ? var_arena_next_++ : new Variable();
+  size_t slot = var_list_.size();
+  if (free_var_slots_.empty()) {
+    var_list_.emplace_back();
+  } else {
+    slot = free_var_slots_.back();
+    free_var_slots_.pop_back();
+  }
+  var_list_[slot].var =
+      std::unique_ptr<Variable, VarDeleter>(v, VarDeleter(in_arena));
+  vars_.emplace(name, slot);
   VLOG(3) << "Create variable " << name;
   return v;
 }
 
 const Scope* Scope::FindScopeInternal(const Variable* var) const {
-  for (auto& kv : vars_) {
-    if (kv.second.get() == var) {
+  for (auto& local_var : var_list_) {
+    if (local_var.var != nullptr && local_var.var.get() == var) {
       return this;
     }
   }
@@ -234,8 +281,10 @@ void Scope::RenameInternal(const std::string& origin_name,
       vars_.end(),
       common::errors::AlreadyExists(
           "The variable with name %s already exists in the scope.", new_name));
-  vars_[new_name].reset(origin_it->second.release());
+  size_t slot = origin_it->second;
   vars_.erase(origin_it);
+  vars_.emplace(new_name, slot);
+  ++var_list_[slot].generation;
 }
 
 Variable* Scope::FindVarInternal(const std::string& name) const {
@@ -249,17 +298,24 @@ Variable* Scope::FindVarInternal(const std::string& name) const {
 Variable* Scope::FindVarLocally(const std::string& name) const {
   auto it = vars_.find(name);
   if (it != vars_.end()) {
-    return it->second.get();
+    return var_list_[it->second].var.get();
   }
   return nullptr;
 }
 
+void Scope::EraseVarAt(size_t slot) {
+  var_list_[slot].var.reset();
+  ++var_list_[slot].generation;
+  free_var_slots_.push_back(slot);
+}
+
 void Scope::EraseVarsExcept(const std::unordered_set<Variable*>& vars) {
   SCOPE_VARS_WRITER_LOCK
   for (auto iter = vars_.begin(); iter != vars_.end();) {
-    if (vars.count(iter->second.get()) != 0) {
+    if (vars.count(var_list_[iter->second].var.get()) != 0) {
       ++iter;
     } else {
+      EraseVarAt(iter->second);
       vars_.erase(iter++);
     }
   }
@@ -88,6 +88,20 @@ class TEST_API Scope {
   /// Caller doesn't own the returned Variable.
   Variable* FindLocalVar(const std::string& name) const;
 
+  /// Return the index of a variable in the current scope, or -1 if cannot
+  /// find. The index stays valid until the variable is erased or renamed.
+  int64_t LocalVarIndex(const std::string& name) const;
+
+  /// Find a variable in the current scope by the index of LocalVarIndex,
+  /// without hashing its name. Return nullptr if the index is no longer
+  /// valid. Caller doesn't own the returned Variable.
+  Variable* LocalVar(int64_t index) const;
+
+  /// Allocate the next `num_vars` variables of the scope from one arena and
+  /// reserve their entries, so that creating them does not allocate for each
+  /// variable. The arena is freed together with the scope.
+  void ReserveVars(size_t num_vars);
+
   const Scope* parent() const { return parent_; }
 
   const Scope* root() const;
@@ -136,8 +150,41 @@ class TEST_API Scope {
     }
   };
 
-  mutable std::unordered_map<std::string, std::unique_ptr<Variable>, KeyHasher>
-      vars_;
+  // Deletes the variables allocated alone, and only clears the ones in
+  // `var_arena_`.
+  struct VarDeleter {
+    VarDeleter() {}  // NOLINT
+    explicit VarDeleter(bool in_arena) : in_arena(in_arena) {}
+
+    void operator()(Variable* var) const {
+      if (in_arena) {
+        var->Clear();
+      } else {
+        delete var;
+      }
+    }
+
+    bool in_arena{false};
+  };
+
+  // Declared before `var_list_` to outlive the variables in it.
+  std::vector<std::unique_ptr<Variable[]>> var_arena_;
+  Variable* var_arena_next_{nullptr};
+  Variable* var_arena_end_{nullptr};
+
+  // A slot is reused after its variable is erased, and its generation tells
+  // the indices of the old variable from the ones of the new.
+  struct VarSlot {
+    std::unique_ptr<Variable, VarDeleter> var;
+    uint32_t generation{0};
+  };
+
+  // The local variables by slot, and the slots of the erased ones.
+  mutable std::vector<VarSlot> var_list_;
+  std::vector<size_t> free_var_slots_;
+
+  // The slot in `var_list_` of each local variable.
+  mutable std::unordered_map<std::string, size_t, KeyHasher> vars_;
 
  private:
   // Call Scope::NewScope for a sub-scope.
@@ -162,6 +209,9 @@ class TEST_API Scope {
   // Called by FindVarInternal and Var.
   Variable* FindVarLocally(const std::string& name) const;
 
+  // Called by EraseVars and EraseVarsExcept.
+  void EraseVarAt(size_t slot);
+
   // Scope in `kids_` are owned by this class.
   mutable std::list<Scope*> kids_;
   const Scope* parent_{nullptr};
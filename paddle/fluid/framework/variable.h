@@ -47,7 +47,8 @@ class Variable {
   template <typename T>
   T* GetMutable() {
     if (!holder_) {
-      holder_.reset(new PlaceholderImpl<T>());
+      // One allocation for the object and the reference count.
+      holder_ = std::make_shared<PlaceholderImpl<T>>();
     } else {
       // If holder_ is RawTensor, call holder_->Ptr() GetMutable again. Used for
       // load_combine.
@@ -575,6 +575,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(specify_input_name_);
 
   CP_MEMBER(use_optimized_model_);
+  CP_MEMBER(use_optimized_program_cache_);
 
   CP_MEMBER(cpu_math_library_num_threads_);
 
@@ -1161,6 +1162,7 @@ std::string AnalysisConfig::SerializeInfoCache() {
   ss << ir_debug_;
 
   ss << use_optimized_model_;
+  ss << use_optimized_program_cache_;
 
   ss << specify_input_name_;
   ss << cpu_math_library_num_threads_;
@@ -1461,6 +1463,8 @@ std::string AnalysisConfig::Summary() {
   os.InsertRow({"ir_debug", ir_debug_ ? "true" : "false"});
   os.InsertRow(
       {"use_optimized_model", use_optimized_model_ ? "true" : "false"});
+  os.InsertRow({"optimized_program_cache",
+                use_optimized_program_cache_ ? "true" : "false"});
   os.InsertRow({"memory_optim", enable_memory_optim_ ? "true" : "false"});
   os.InsertRow({"enable_profile", with_profile_ ? "true" : "false"});
   os.InsertRow({"enable_log", with_glog_info_ ? "true" : "false"});
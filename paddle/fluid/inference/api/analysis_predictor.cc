@@ -15,6 +15,7 @@
 #include "paddle/fluid/inference/api/analysis_predictor.h"
 
 #include <glog/logging.h>
+#include <xxhash.h>
 
 #include <algorithm>
 #include <cstdlib>
@@ -22,6 +23,7 @@
 #include <fstream>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -70,6 +72,7 @@
 #include "paddle/phi/core/platform/profiler.h"
 
 #include "paddle/phi/core/generator.h"
+#include "paddle/phi/kernels/funcs/blas/packed_weight_cache.h"
 #include "paddle/phi/kernels/funcs/data_type_transform.h"
 #include "paddle/utils/string/split.h"
 
@@ -364,6 +367,19 @@ bool PaddleTensorToDenseTensor(const PaddleTensor &pt,
   t->set_lod(lod);
   return true;
 }
+
+// Feed the contents of the file into the hash state, returns false if the file
+// can not be read.
+bool UpdateHashWithFile(XXH64_state_t *state, const std::string &path) {
+  std::ifstream fin(path, std::ios::in | std::ios::binary);
+  if (!fin.is_open()) return false;
+  std::vector<char> buffer(1 << 20);
+  while (fin) {
+    fin.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    XXH64_update(state, buffer.data(), static_cast<size_t>(fin.gcount()));
+  }
+  return true;
+}
 }  // namespace
 
 AnalysisPredictor::AnalysisPredictor(const AnalysisConfig &config)
@@ -461,6 +477,23 @@ bool AnalysisPredictor::Init(
     config_.use_new_executor_ = true;
   }
 
+  // Reuse the optimized program cached by a previous start with the same
+  // model, config and passes, or save it for the next start.
+  if (config_.optimized_program_cache_enabled() && config_.new_ir_enabled() &&
+      !config_.use_optimized_model_) {
+    if (config_.model_from_memory() || !config_.model_dir().empty()) {
+      LOG(WARNING) << "The optimized program cache only supports combined "
+                      "models loaded from files, it will be disabled.";
+    } else {
+      optimized_program_cache_key_ = GetOptimizedProgramCacheKey();
+      if (IsOptimizedProgramCacheValid()) {
+        config_.UseOptimizedModel(true);
+      } else {
+        config_.EnableSaveOptimModel(true);
+      }
+    }
+  }
+
   // Use Optimized model to inference
   if (config_.use_optimized_model_) {
     std::string optimized_model_path = GetOptimizedModelPath();
@@ -608,23 +641,113 @@ void AnalysisPredictor::InitPlace() {
 
 std::string AnalysisPredictor::GetOptimizedModelPath() {
   std::string model_opt_cache_dir = config_.opt_cache_dir_;
-  if (!model_opt_cache_dir.empty()) {
-    if (!PathExists(model_opt_cache_dir)) {
+  if (model_opt_cache_dir.empty()) {
+    model_opt_cache_dir =
+        !config_.model_dir().empty()
+            ? config_.model_dir()
+            : inference::analysis::GetDirRoot(config_.prog_file());
+  }
+  if (!optimized_program_cache_key_.empty()) {
+    model_opt_cache_dir +=
+        "/_optimized_program_cache_" + optimized_program_cache_key_;
+  }
+  return model_opt_cache_dir;
+}
+
+void AnalysisPredictor::CreateOptimizedModelDir() {
+  std::vector<std::string> dirs;
+  if (!config_.opt_cache_dir_.empty()) {
+    dirs.push_back(config_.opt_cache_dir_);
+  }
+  if (!optimized_program_cache_key_.empty()) {
+    dirs.push_back(GetOptimizedModelPath());
+  }
+  for (const auto &dir : dirs) {
+    if (!PathExists(dir)) {
       PADDLE_ENFORCE_NE(
-          MKDIR(model_opt_cache_dir.c_str()),
+          MKDIR(dir.c_str()),
           -1,
           common::errors::PreconditionNotMet(
               "Can not create optimize cache directory: %s, Make sure you "
               "have permission to write",
-              model_opt_cache_dir));
+              dir));
     }
-  } else {
-    model_opt_cache_dir =
-        !config_.model_dir().empty()
-            ? config_.model_dir()
-            : inference::analysis::GetDirRoot(config_.prog_file());
   }
-  return model_opt_cache_dir;
+}
+
+std::string AnalysisPredictor::GetOptimizedProgramCacheKey() {
+  // Freed even if reading a file below throws.
+  std::unique_ptr<XXH64_state_t, decltype(&XXH64_freeState)> state(
+      XXH64_createState(), &XXH64_freeState);
+  XXH64_reset(state.get(), 0);
+
+  // The pass list used by OptimizeInferencePirProgram.
+  std::stringstream ss;
+  ss << paddle::get_version() << ";";
+  ss << config_.SerializeInfoCache() << ";";
+  ss << static_cast<int>(config_.pm_opt_level_) << ";";
+  for (const auto *passes : {&kPirGpuPasses,
+                             &kPirCpuPasses,
+                             &kPirXpuPasses,
+                             &kPirMkldnnPasses,
+                             &kPirMkldnnBf16Passes,
+                             &config_.custom_passes_}) {
+    for (const auto &pass : *passes) {
+      ss << pass << ",";
+    }
+    ss << ";";
+  }
+  std::vector<std::string> deleted_passes(config_.deleted_passes_.begin(),
+                                          config_.deleted_passes_.end());
+  std::sort(deleted_passes.begin(), deleted_passes.end());
+  for (const auto &pass : deleted_passes) {
+    ss << pass << ",";
+  }
+  std::string info = ss.str();
+  XXH64_update(state.get(), info.data(), info.size());
+
+  // The contents of the model and params.
+  for (const auto &path : {config_.prog_file(), config_.params_file()}) {
+    PADDLE_ENFORCE_EQ(UpdateHashWithFile(state.get(), path),
+                      true,
+                      common::errors::NotFound(
+                          "Cannot open file %s, please confirm whether the "
+                          "file is normal.",
+                          path));
+  }
+
+  uint64_t hash = XXH64_digest(state.get());
+
+  std::stringstream key;
+  key << std::hex << hash;
+  return key.str();
+}
+
+bool AnalysisPredictor::IsOptimizedProgramCacheValid() {
+  std::string cache_dir = GetOptimizedModelPath();
+  std::ifstream fin(cache_dir + "/_optimized_program_cache_info");
+  if (!fin.is_open()) return false;
+  std::string key;
+  fin >> key;
+  return key == optimized_program_cache_key_ &&
+         FileExists(cache_dir + "/_optimized.json") &&
+         FileExists(cache_dir + "/_optimized.pdiparams");
+}
+
+void AnalysisPredictor::SaveOptimizedProgramCacheInfo() {
+  // Written after the program and params, so that an interrupted save will
+  // not be taken as a valid cache.
+  std::string cache_info =
+      GetOptimizedModelPath() + "/_optimized_program_cache_info";
+  std::ofstream fout(cache_info);
+  PADDLE_ENFORCE_EQ(fout.is_open(),
+                    true,
+                    common::errors::PreconditionNotMet(
+                        "Cannot open file %s to write the optimized program "
+                        "cache info.",
+                        cache_info));
+  fout << optimized_program_cache_key_;
+  LOG(INFO) << "Optimized program cache saved to " << GetOptimizedModelPath();
 }
 
 void AnalysisPredictor::ClearExtraParams() {
@@ -1042,11 +1165,15 @@ void AnalysisPredictor::OptimizeInferencePirProgram() {
     pass_pm.Run(pir_program_.get());
 
     if (config_.save_optimized_model_) {
+      CreateOptimizedModelDir();
       std::string optimized_model =
           GetOptimizedModelPath() + "/" + "_optimized.json";
       pir::WriteModule(*pir_program_, optimized_model, 1, true, false, true);
       LOG(INFO) << "Optimized model saved to " << optimized_model;
       SaveOrLoadPirParameters(true);
+      if (!optimized_program_cache_key_.empty()) {
+        SaveOptimizedProgramCacheInfo();
+      }
     }
   }
 
@@ -1496,6 +1623,19 @@ bool AnalysisPredictor::PrepareExecutor() {
             root_predictor_id_, "memory_optimize_pass");
     executor_->MakeReusePlan(reuse_table);
   }
+
+  // The parameters are constant during inference, so the CPU fc and matmul
+  // kernels can pack them once and reuse the packed weights.
+  if (phi::funcs::PackedWeightCache::IsEnabled() &&
+      phi::is_cpu_place(place_)) {
+    for (auto &var_name : scope_->LocalVarNames()) {
+      auto *var = scope_->FindVar(var_name);
+      if (var->IsType<phi::DenseTensor>()) {
+        phi::funcs::PackedWeightCache::Instance().RegisterConstant(
+            var->Get<phi::DenseTensor>());
+      }
+    }
+  }
   return true;
 }
 
@@ -1949,6 +2089,9 @@ void AnalysisPredictor::PrepareArgument() {
     argument_->SetModelProgramPath(config_.prog_file());
     argument_->SetModelParamsPath(config_.params_file());
   }
+  if (config_.save_optimized_model_) {
+    CreateOptimizedModelDir();
+  }
   argument_->SetOptimizedModelSavePath(GetOptimizedModelPath());
   // For JITLayer
   argument_->SetSkipLoadParams(config_.skip_load_params_);
@@ -3142,6 +3285,7 @@ AnalysisPredictor::~AnalysisPredictor() {  // NOLINT
     }
 
     scope_->DeleteScope(sub_scope_);
+    phi::funcs::PackedWeightCache::Instance().ReleaseExpired();
   }
 
   if (config_.shape_range_info_collected()) {
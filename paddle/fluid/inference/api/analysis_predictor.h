@@ -507,6 +507,20 @@ class AnalysisPredictor : public PaddlePredictor {
   void InitDeviceContexts();
   void InitResourceManager(void *stream);
   std::string GetOptimizedModelPath();
+  ///
+  /// \brief Create the directory returned by GetOptimizedModelPath, before the
+  /// optimized model is saved into it.
+  ///
+  void CreateOptimizedModelDir();
+  ///
+  /// \brief Compute the key of the optimized program cache from the model and
+  /// params contents, the config and the pass list.
+  ///
+  /// \return The hex string of the key.
+  ///
+  std::string GetOptimizedProgramCacheKey();
+  bool IsOptimizedProgramCacheValid();
+  void SaveOptimizedProgramCacheInfo();
   void ClearExtraParams();
 
  private:
@@ -520,6 +534,8 @@ class AnalysisPredictor : public PaddlePredictor {
   std::shared_ptr<framework::ProgramDesc> inference_program_;
   std::shared_ptr<pir::Program> pir_program_;
   bool load_pir_model_{false};
+  // Key of the optimized program cache, empty if the cache is disabled.
+  std::string optimized_program_cache_key_;
   std::vector<framework::OpDesc *> feeds_;
   std::vector<pir::Operation *> pir_feeds_;
   std::map<std::string, size_t> feed_names_;
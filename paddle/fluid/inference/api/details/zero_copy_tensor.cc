@@ -14,8 +14,10 @@
 
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_layout_transform.h"
+#include "paddle/fluid/framework/dlpack_tensor.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/api/paddle_tensor.h"
 #include "paddle/fluid/platform/enforce.h"
@@ -89,6 +91,49 @@ void Tensor::ReshapeStrings(const size_t &shape) {
   }                                      \
   auto *tensor = static_cast<tensor_type *>(tensor_);
 
+namespace {
+
+// The data the caller shares with a tensor, release(release_params) is
+// called once the last tensor referencing it is gone.
+class ExternalAllocation : public phi::Allocation {
+ public:
+  ExternalAllocation(void *data,
+                     size_t size,
+                     const phi::Place &place,
+                     CallbackFunc release,
+                     void *release_params)
+      : phi::Allocation(data, size, place),
+        release_(release),
+        release_params_(release_params) {}
+
+  ~ExternalAllocation() override {
+    if (release_ != nullptr) {
+      release_(release_params_);
+    }
+  }
+
+ private:
+  CallbackFunc release_;
+  void *release_params_;
+};
+
+// Never writes into the data shared by the caller, it is released here and
+// the tensor allocates its own memory.
+void DropExternalData(phi::DenseTensor *tensor) {
+  if (dynamic_cast<ExternalAllocation *>(tensor->Holder().get()) != nullptr) {
+    tensor->clear();
+  }
+}
+
+void ReleaseDLPack(void *dl_tensor) {
+  auto *src = static_cast<DLManagedTensor *>(dl_tensor);
+  if (src->deleter != nullptr) {
+    src->deleter(src);
+  }
+}
+
+}  // namespace
+
 template <typename T>
 T *Tensor::mutable_data(PlaceType place) {
 #ifdef PADDLE_WITH_ONNXRUNTIME
@@ -104,6 +149,7 @@ T *Tensor::mutable_data(PlaceType place) {
           "You should call Tensor::Reshape(const std::vector<int> "
           "&shape)"
           "function before retrieving mutable_data from input tensor."));
+  DropExternalData(tensor);
   switch (static_cast<int>(place)) {
     case static_cast<int>(PlaceType::kCPU): {
       return tensor->mutable_data<T>(phi::CPUPlace());
@@ -201,6 +247,7 @@ void Tensor::CopyFromCpu(const T *data) {
                         "std::vector<int> &shape)"
                         "function before copying data from cpu."));
   size_t ele_size = tensor->numel() * sizeof(T);
+  DropExternalData(tensor);
 
   if (place_ == PlaceType::kCPU) {
     auto *t_data = tensor->mutable_data<T>(phi::CPUPlace());
@@ -329,41 +376,65 @@ void Tensor::ShareExternalData(const T *data,
                                const std::vector<int> &shape,
                                PlaceType place,
                                DataLayout layout) {
+  ShareExternalData(data, shape, place, nullptr, nullptr, layout);
+}
+
+template <typename T>
+void Tensor::ShareExternalData(const T *data,
+                               const std::vector<int> &shape,
+                               PlaceType place,
+                               CallbackFunc release,
+                               void *release_params,
+                               DataLayout layout) {
   EAGER_GET_TENSOR(phi::DenseTensor)
   size_t size =
       std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>()) *
       sizeof(T);
   phi::DenseTensorMeta meta(
       DataTypeInfo<T>().TYPE, common::make_ddim(shape), LayoutConvert(layout));
+  phi::Place data_place;
   if (place == PlaceType::kCPU) {
-    phi::DenseTensor dtensor(std::make_shared<phi::Allocation>(
-                                 const_cast<T *>(data), size, phi::CPUPlace()),
-                             meta);
-    *tensor = std::move(dtensor);
+    data_place = phi::CPUPlace();
   } else if (place == PlaceType::kGPU) {
-    phi::DenseTensor dtensor(
-        std::make_shared<phi::Allocation>(
-            const_cast<T *>(data), size, phi::GPUPlace(device_)),
-        meta);
-    *tensor = std::move(dtensor);
+    data_place = phi::GPUPlace(device_);
   } else if (place == PlaceType::kXPU) {
-    phi::DenseTensor dtensor(
-        std::make_shared<phi::Allocation>(
-            const_cast<T *>(data), size, phi::XPUPlace(device_)),
-        meta);
-    *tensor = std::move(dtensor);
+    data_place = phi::XPUPlace(device_);
   } else if (place == PlaceType::kCUSTOM) {
-    phi::DenseTensor dtensor(std::make_shared<phi::Allocation>(
-                                 const_cast<T *>(data),
-                                 size,
-                                 phi::CustomPlace(device_type_, device_)),
-                             meta);
-    *tensor = std::move(dtensor);
+    data_place = phi::CustomPlace(device_type_, device_);
   } else {
     PADDLE_THROW(common::errors::InvalidArgument(
         "PlaceType must be one of [PlaceType::kCPU, PlaceType::kGPU, "
         "PlaceType::kXPU]."));
   }
+  phi::DenseTensor dtensor(
+      std::make_shared<ExternalAllocation>(
+          const_cast<T *>(data), size, data_place, release, release_params),
+      meta);
+  *tensor = std::move(dtensor);
+}
+
+void Tensor::FromDLPack(DLManagedTensor *dl_tensor) {
+  EAGER_GET_TENSOR(phi::DenseTensor)
+  PADDLE_ENFORCE_NOT_NULL(
+      dl_tensor,
+      common::errors::InvalidArgument("The DLPack tensor should not be null."));
+  // Only takes the meta and the data, the deleter is called by the holder.
+  phi::DenseTensor shared =
+      paddle::framework::TensorFromDLPack(dl_tensor, nullptr);
+  const auto &holder = shared.Holder();
+  phi::DenseTensor dtensor(
+      std::make_shared<ExternalAllocation>(holder->ptr(),
+                                           holder->size(),
+                                           holder->place(),
+                                           ReleaseDLPack,
+                                           dl_tensor),
+      shared.meta());
+  *tensor = std::move(dtensor);
+}
+
+DLManagedTensor *Tensor::ToDLPack() const {
+  EAGER_GET_TENSOR(phi::DenseTensor)
+  return paddle::framework::toDLPack(*tensor);
 }
 
 void Tensor::CopyStringsFromCpu(const paddle_infer::Strings *data) {
@@ -387,6 +458,15 @@ void Tensor::CopyToCpuImpl(T *data,
   auto *t_data = tensor->data<T>();
   auto t_place = tensor->place();
 
+  // The output was written into the data shared by ShareExternalData.
+  if (phi::is_cpu_place(t_place) && static_cast<void *>(data) == t_data &&
+      tensor->layout() != phi::DataLayout::ONEDNN) {
+    if (cb) {
+      cb(cb_params);
+    }
+    return;
+  }
+
   if (phi::is_cpu_place(t_place)) {
 #ifdef PADDLE_WITH_DNNL
     if (tensor->layout() == phi::DataLayout::ONEDNN) {
@@ -560,6 +640,69 @@ template PD_INFER_DECL void Tensor::ShareExternalData<bool>(
     const std::vector<int> &shape,
     PlaceType place,
     DataLayout layout);
+template PD_INFER_DECL void Tensor::ShareExternalData<double>(
+    const double *data,
+    const std::vector<int> &shape,
+    PlaceType place,
+    CallbackFunc release,
+    void *release_params,
+    DataLayout layout);
+template PD_INFER_DECL void Tensor::ShareExternalData<float>(
+    const float *data,
+    const std::vector<int> &shape,
+    PlaceType place,
+    CallbackFunc release,
+    void *release_params,
+    DataLayout layout);
+template PD_INFER_DECL void Tensor::ShareExternalData<int64_t>(
+    const int64_t *data,
+    const std::vector<int> &shape,
+    PlaceType place,
+    CallbackFunc release,
+    void *release_params,
+    DataLayout layout);
+template PD_INFER_DECL void Tensor::ShareExternalData<int32_t>(
+    const int32_t *data,
+    const std::vector<int> &shape,
+    PlaceType place,
+    CallbackFunc release,
+    void *release_params,
+    DataLayout layout);
+template PD_INFER_DECL void Tensor::ShareExternalData<uint8_t>(
+    const uint8_t *data,
+    const std::vector<int> &shape,
+    PlaceType place,
+    CallbackFunc release,
+    void *release_params,
+    DataLayout layout);
+template PD_INFER_DECL void Tensor::ShareExternalData<int8_t>(
+    const int8_t *data,
+    const std::vector<int> &shape,
+    PlaceType place,
+    CallbackFunc release,
+    void *release_params,
+    DataLayout layout);
+template PD_INFER_DECL void Tensor::ShareExternalData<float16>(
+    const float16 *data,
+    const std::vector<int> &shape,
+    PlaceType place,
+    CallbackFunc release,
+    void *release_params,
+    DataLayout layout);
+template PD_INFER_DECL void Tensor::ShareExternalData<bfloat16>(
+    const bfloat16 *data,
+    const std::vector<int> &shape,
+    PlaceType place,
+    CallbackFunc release,
+    void *release_params,
+    DataLayout layout);
+template PD_INFER_DECL void Tensor::ShareExternalData<bool>(
+    const bool *data,
+    const std::vector<int> &shape,
+    PlaceType place,
+    CallbackFunc release,
+    void *release_params,
+    DataLayout layout);
 
 template PD_INFER_DECL void Tensor::CopyToCpu<double>(double *data) const;
 template PD_INFER_DECL void Tensor::CopyToCpu<float>(float *data) const;
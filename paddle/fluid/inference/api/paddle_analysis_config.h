@@ -856,6 +856,28 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   void UseOptimizedModel(bool x = true) { use_optimized_model_ = x; }
 
+  ///
+  /// \brief Control whether to cache the optimized program automatically.
+  /// The cache is keyed by the model and params contents, the config and the
+  /// pass list. On a hit the optimization passes are skipped and the cached
+  /// program is loaded, otherwise the optimized program is saved for the next
+  /// start. Only works with PIR.
+  ///
+  /// \param x whether to enable the optimized program cache.
+  ///
+  void EnableOptimizedProgramCache(bool x = true) {
+    use_optimized_program_cache_ = x;
+  }
+  ///
+  /// \brief A boolean state telling whether the optimized program cache is
+  /// enabled.
+  ///
+  /// \return bool Whether the optimized program cache is enabled.
+  ///
+  bool optimized_program_cache_enabled() const {
+    return use_optimized_program_cache_;
+  }
+
   ///
   /// \brief Control whether to debug IR graph analysis phase.
   /// This will generate DOT files for visualizing the computation graph after
@@ -1257,6 +1279,7 @@ struct PD_INFER_DECL AnalysisConfig {
   bool ir_debug_{false};
 
   bool use_optimized_model_{false};
+  bool use_optimized_program_cache_{false};
 
   bool use_new_executor_{false};
 
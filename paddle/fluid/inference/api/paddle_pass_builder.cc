@@ -678,9 +678,21 @@ const std::vector<std::string> kPirMkldnnBf16Passes{
     "cpu_bf16_quantize_squash_pass",
 };
 
+// The CPU passes only fuse into ops with plain CPU kernels, so they also run
+// in the builds without oneDNN.
 const std::vector<std::string> kPirCpuPasses{
+    // Functional pass
     "add_shadow_output_after_dead_parameter_pass",
     "delete_quant_dequant_linear_op_pass",
-    "delete_weight_dequant_linear_op_pass"};
+    "delete_weight_dequant_linear_op_pass",
+    "identity_op_clean_pass",
+    "remove_redundant_reshape_pass",
+    // Operator fusion pass
+    "embedding_eltwise_layernorm_fuse_pass",
+    "matmul_scale_fuse_pass",
+    "matmul_transpose_fuse_pass",
+    "matmul_add_act_fuse_pass",
+    "add_norm_fuse_pass",
+    "remove_redundant_transpose_pass"};
 
 }  // namespace paddle
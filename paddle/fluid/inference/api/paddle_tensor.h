@@ -26,6 +26,8 @@
 #include "onnxruntime_cxx_api.h"  // NOLINT
 #endif
 
+struct DLManagedTensor;
+
 namespace paddle {
 class Tensor;
 }
@@ -129,6 +131,40 @@ class PD_INFER_DECL Tensor {
                          PlaceType place,
                          DataLayout layout = DataLayout::kNCHW);
 
+  /// \brief Share the data with tensor data, and release it by callback.
+  /// The tensor borrows the data without copying it, and release(
+  /// release_params) is called once the predictor no longer references the
+  /// data, i.e. when the tensor is fed again or the predictor is destroyed.
+  /// Shared with an output tensor, the data is the buffer the last kernel
+  /// writes the output into when it is large enough, and CopyToCpu into the
+  /// same buffer does not copy.
+  /// \param data The pointer of the data, from which the tensor will share.
+  /// \param shape The shape of data.
+  /// \param place The place of data.
+  /// \param release The callback to release the data, can be nullptr.
+  /// \param release_params The parameter passed to release.
+  /// \param layout The layout of data. Only NCHW is supported now.
+  template <typename T>
+  void ShareExternalData(const T* data,
+                         const std::vector<int>& shape,
+                         PlaceType place,
+                         CallbackFunc release,
+                         void* release_params,
+                         DataLayout layout = DataLayout::kNCHW);
+
+  /// \brief Share the data of a DLPack tensor with tensor data.
+  /// The tensor takes the ownership of dl_tensor and calls its deleter once
+  /// the predictor no longer references the data.
+  /// \param dl_tensor The DLPack tensor, from which the tensor will share.
+  void FromDLPack(DLManagedTensor* dl_tensor);
+
+  /// \brief Return the tensor data as a DLPack tensor without copying it.
+  /// It's usually used to get the output tensor data. The caller owns the
+  /// returned tensor and must call its deleter, and the data may be
+  /// overwritten by the next run of the predictor.
+  /// \return The DLPack tensor that shares the tensor data.
+  DLManagedTensor* ToDLPack() const;
+
   /// \brief Experimental interface.
   /// It's usually used to set the input tensor data with Strings data type.
   /// \param data The pointer of the data, from which the tensor will copy.
@@ -285,6 +285,10 @@ class IdentityOpCleanPass : public pir::PatternRewritePass {
     ps.Add(paddle::drr::Create<ReplaceDropoutWithScalePattern>(context));
     return ps;
   }
+
+  std::unique_ptr<pir::Pass> CloneForThread() const override {
+    return std::make_unique<IdentityOpCleanPass>();
+  }
 };
 
 }  // namespace
@@ -85,6 +85,10 @@ class MatmulScaleFusePass : public pir::PatternRewritePass {
     ps.Add(paddle::drr::Create<MatmulScaleFusePattern>(context));
     return ps;
   }
+
+  std::unique_ptr<pir::Pass> CloneForThread() const override {
+    return std::make_unique<MatmulScaleFusePass>();
+  }
 };
 
 }  // namespace
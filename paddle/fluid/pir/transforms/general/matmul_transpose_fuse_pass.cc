@@ -192,6 +192,10 @@ class MatmulTransposeFusePass : public pir::PatternRewritePass {
     // Add three pattern here
     return ps;
   }
+
+  std::unique_ptr<pir::Pass> CloneForThread() const override {
+    return std::make_unique<MatmulTransposeFusePass>();
+  }
 };
 
 }  // namespace
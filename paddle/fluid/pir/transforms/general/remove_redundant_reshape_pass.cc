@@ -0,0 +1,209 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/general/remove_redundant_reshape_pass.h"
+
+#include <algorithm>
+
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/drr/include/drr_pattern_base.h"
+#include "paddle/fluid/pir/utils/general_functions.h"
+
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+namespace {
+
+bool IsStaticShape(const std::vector<int64_t> &shape) {
+  return std::all_of(
+      shape.begin(), shape.end(), [](int64_t dim) { return dim >= 0; });
+}
+
+std::vector<int64_t> NormalizeAxes(const std::vector<int64_t> &axes,
+                                   int64_t rank) {
+  std::vector<int64_t> normalized;
+  for (int64_t axis : axes) {
+    normalized.push_back(axis < 0 ? axis + rank : axis);
+  }
+  std::sort(normalized.begin(), normalized.end());
+  return normalized;
+}
+
+// reshape/squeeze/unsqueeze + reshape -> reshape
+class RemoveRedundantReshapePattern : public paddle::drr::DrrPatternBase {
+ private:
+  const std::string first_op_name_;
+
+ public:
+  explicit RemoveRedundantReshapePattern(const std::string &first_op_name)
+      : first_op_name_(first_op_name) {}
+
+  std::string name() const override { return "RemoveRedundantReshapePattern"; }
+  uint32_t benefit() const override { return 2; }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern pat = ctx->SourcePattern();
+    const auto &first_op = pat.Op(first_op_name_);
+    first_op({&pat.Tensor("x"), &pat.Tensor("first_shape")},
+             {&pat.Tensor("first_out")});
+    const auto &full_int_array =
+        pat.Op(paddle::dialect::FullIntArrayOp::name(),
+               {{"value", pat.Attr("shape")}});
+    const auto &reshape = pat.Op(paddle::dialect::ReshapeOp::name());
+    reshape({&pat.Tensor("first_out"), &full_int_array()},
+            {&pat.Tensor("out")});
+
+    pat.AddConstraint([](const paddle::drr::MatchContext &match_ctx) {
+      // A 0 in the shape copies a dim of first_out, which x may not have.
+      const auto &shape = match_ctx.Attr<std::vector<int64_t>>("shape");
+      return std::find(shape.begin(), shape.end(), 0) == shape.end();
+    });
+
+    paddle::drr::ResultPattern res = pat.ResultPattern();
+    const auto &res_reshape = res.Op(paddle::dialect::ReshapeOp::name(),
+                                     {{"shape", pat.Attr("shape")}});
+    res_reshape({&res.Tensor("x")}, {&res.Tensor("out")});
+  }
+};
+
+// reshape/squeeze/unsqueeze whose output has the static shape of its input
+class RemoveInvalidReshapePattern : public paddle::drr::DrrPatternBase {
+ private:
+  const std::string op_name_;
+
+ public:
+  explicit RemoveInvalidReshapePattern(const std::string &op_name)
+      : op_name_(op_name) {}
+
+  std::string name() const override { return "RemoveInvalidReshapePattern"; }
+  uint32_t benefit() const override { return 1; }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern pat = ctx->SourcePattern();
+    const auto &op = pat.Op(op_name_);
+    op({&pat.Tensor("x"), &pat.Tensor("shape")}, {&pat.Tensor("out")});
+
+    pat.AddConstraint([](const paddle::drr::MatchContext &match_ctx) {
+      auto x_shape = pir::GetShapeFromValue(match_ctx.Tensor("x"));
+      auto out_shape = pir::GetShapeFromValue(match_ctx.Tensor("out"));
+      return IsStaticShape(x_shape) && x_shape == out_shape;
+    });
+
+    paddle::drr::ResultPattern res = pat.ResultPattern();
+    res.Tensor("out").Assign(res.Tensor("x"));
+  }
+};
+
+// unsqueeze + squeeze over the same axes, or squeeze + unsqueeze over the
+// same axes of size 1 -> x
+class RemoveSqueezeUnsqueezePattern : public paddle::drr::DrrPatternBase {
+ private:
+  const bool squeeze_first_;
+
+ public:
+  explicit RemoveSqueezeUnsqueezePattern(bool squeeze_first)
+      : squeeze_first_(squeeze_first) {}
+
+  std::string name() const override { return "RemoveSqueezeUnsqueezePattern"; }
+  uint32_t benefit() const override { return 3; }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern pat = ctx->SourcePattern();
+    const auto &squeeze = pat.Op(paddle::dialect::SqueezeOp::name());
+    const auto &unsqueeze = pat.Op(paddle::dialect::UnsqueezeOp::name());
+    const auto &squeeze_axis =
+        pat.Op(paddle::dialect::FullIntArrayOp::name(),
+               {{"value", pat.Attr("squeeze_axis")}});
+    const auto &unsqueeze_axis =
+        pat.Op(paddle::dialect::FullIntArrayOp::name(),
+               {{"value", pat.Attr("unsqueeze_axis")}});
+    if (squeeze_first_) {
+      squeeze({&pat.Tensor("x"), &squeeze_axis()}, {&pat.Tensor("mid")});
+      unsqueeze({&pat.Tensor("mid"), &unsqueeze_axis()}, {&pat.Tensor("out")});
+    } else {
+      unsqueeze({&pat.Tensor("x"), &unsqueeze_axis()}, {&pat.Tensor("mid")});
+      squeeze({&pat.Tensor("mid"), &squeeze_axis()}, {&pat.Tensor("out")});
+    }
+
+    pat.AddConstraint([this](const paddle::drr::MatchContext &match_ctx) {
+      auto x_shape = pir::GetShapeFromValue(match_ctx.Tensor("x"));
+      auto mid_shape = pir::GetShapeFromValue(match_ctx.Tensor("mid"));
+      const auto &squeeze_axis =
+          match_ctx.Attr<std::vector<int64_t>>("squeeze_axis");
+      const auto &unsqueeze_axis =
+          match_ctx.Attr<std::vector<int64_t>>("unsqueeze_axis");
+      if (squeeze_axis.empty() || unsqueeze_axis.empty()) {
+        return false;
+      }
+      // unsqueeze resolves negative axes one by one as the rank grows
+      if (unsqueeze_axis.size() > 1 &&
+          std::any_of(unsqueeze_axis.begin(),
+                      unsqueeze_axis.end(),
+                      [](int64_t axis) { return axis < 0; })) {
+        return false;
+      }
+      // The axes of squeeze are relative to its input, and the axes of
+      // unsqueeze to its output, which is the larger tensor in both orders.
+      const auto &large_shape = this->squeeze_first_ ? x_shape : mid_shape;
+      const auto rank = static_cast<int64_t>(large_shape.size());
+      auto axes = NormalizeAxes(squeeze_axis, rank);
+      if (axes != NormalizeAxes(unsqueeze_axis, rank) ||
+          std::adjacent_find(axes.begin(), axes.end()) != axes.end()) {
+        return false;
+      }
+      // squeeze keeps the axes whose size is not 1
+      for (int64_t axis : axes) {
+        if (axis < 0 || axis >= rank || large_shape[axis] != 1) {
+          return false;
+        }
+      }
+      return true;
+    });
+
+    paddle::drr::ResultPattern res = pat.ResultPattern();
+    res.Tensor("out").Assign(res.Tensor("x"));
+  }
+};
+
+class RemoveRedundantReshapePass : public pir::PatternRewritePass {
+ public:
+  RemoveRedundantReshapePass()
+      : pir::PatternRewritePass("remove_redundant_reshape_pass", 2) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    for (const auto &op_name : {paddle::dialect::ReshapeOp::name(),
+                                paddle::dialect::SqueezeOp::name(),
+                                paddle::dialect::UnsqueezeOp::name()}) {
+      ps.Add(paddle::drr::Create<RemoveRedundantReshapePattern>(context,
+                                                                op_name));
+      ps.Add(
+          paddle::drr::Create<RemoveInvalidReshapePattern>(context, op_name));
+    }
+    ps.Add(paddle::drr::Create<RemoveSqueezeUnsqueezePattern>(context, true));
+    ps.Add(paddle::drr::Create<RemoveSqueezeUnsqueezePattern>(context, false));
+    return ps;
+  }
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<Pass> CreateRemoveRedundantReshapePass() {
+  return std::make_unique<RemoveRedundantReshapePass>();
+}
+}  // namespace pir
+
+REGISTER_IR_PASS(remove_redundant_reshape_pass, RemoveRedundantReshapePass);
@@ -92,6 +92,10 @@ class RemoveRedundantTransposePass : public pir::PatternRewritePass {
     ps.Add(paddle::drr::Create<RemoveInvalidTransposePattern>(context));
     return ps;
   }
+
+  std::unique_ptr<pir::Pass> CloneForThread() const override {
+    return std::make_unique<RemoveRedundantTransposePass>();
+  }
 };
 
 }  // namespace
@@ -20,6 +20,8 @@
 #include "paddle/fluid/pir/drr/include/drr_pattern_base.h"
 
 #include "paddle/fluid/pir/utils/general_functions.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/kernel_factory.h"
 #include "paddle/pir/include/core/builtin_op.h"
 #include "paddle/pir/include/core/value.h"
 #include "paddle/pir/include/pass/pass.h"
@@ -212,10 +214,16 @@ class AddLayerNormFusePattern : public paddle::drr::DrrPatternBase {
  private:
   const bool extra_add_;
   const bool trans_extra_add_;
+  // The CPU kernel supports float32 only.
+  const bool is_cpu_;
 
  public:
-  AddLayerNormFusePattern(bool extra_add, bool trans_extra_add)
-      : extra_add_(extra_add), trans_extra_add_{trans_extra_add} {}
+  AddLayerNormFusePattern(bool extra_add,
+                          bool trans_extra_add,
+                          bool is_cpu = false)
+      : extra_add_(extra_add),
+        trans_extra_add_{trans_extra_add},
+        is_cpu_(is_cpu) {}
 
   uint32_t benefit() const override { return extra_add_ ? 4 : 3; }
   std::string name() const override { return "AddLayerNormFusePattern"; }
@@ -241,12 +249,18 @@ class AddLayerNormFusePattern : public paddle::drr::DrrPatternBase {
               ? add1(pat.Tensor("any_tensor"), pat.Tensor("add_out"))
               : add1(pat.Tensor("add_out"), pat.Tensor("any_tensor"));
     }
-    pat.AddConstraint([](const paddle::drr::MatchContext &match_ctx) {
+    pat.AddConstraint([this](const paddle::drr::MatchContext &match_ctx) {
       auto x_shape = pir::GetShapeFromValue(match_ctx.Tensor("x"));
       auto r_shape = pir::GetShapeFromValue(match_ctx.Tensor("residual"));
       if (x_shape[0] != r_shape[0]) {
         return false;
       }
+      if (this->is_cpu_) {
+        auto x_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("x"));
+        auto r_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("residual"));
+        return x_dtype.isa<pir::Float32Type>() &&
+               r_dtype.isa<pir::Float32Type>();
+      }
       return true;
     });
     paddle::drr::ResultPattern res = pat.ResultPattern();
@@ -426,6 +440,25 @@ class AddNormFusePass : public pir::PatternRewritePass {
     // w-----------------------------
     bool is_half_weight = true;
     bool extra_add = true;
+    if (Has(pir::Pass::kPlaceAttr) &&
+        Get<phi::Place>(pir::Pass::kPlaceAttr).GetType() ==
+            phi::AllocationType::CPU) {
+      // On CPU, only add-layer_norm is fused, into the CPU kernel of
+      // fused_bias_residual_layernorm.
+      if (phi::KernelFactory::Instance().HasKernel(
+              "fused_bias_residual_layernorm",
+              phi::KernelKey(phi::Backend::CPU,
+                             phi::DataLayout::ALL_LAYOUT,
+                             phi::DataType::FLOAT32))) {
+        ps.Add(paddle::drr::Create<AddLayerNormFusePattern>(
+            context, !extra_add, false, true));
+        ps.Add(paddle::drr::Create<AddLayerNormFusePattern>(
+            context, extra_add, true, true));
+        ps.Add(paddle::drr::Create<AddLayerNormFusePattern>(
+            context, extra_add, false, true));
+      }
+      return ps;
+    }
     ps.Add(paddle::drr::Create<RmsNormFusePattern>(context, !is_half_weight));
     ps.Add(paddle::drr::Create<RmsNormFusePattern>(context, is_half_weight));
     // x--------
@@ -19,27 +19,58 @@
 #include "paddle/fluid/pir/utils/general_functions.h"
 
 #include "paddle/phi/common/data_type.h"
+#include "paddle/phi/common/place.h"
 #include "paddle/pir/include/core/builtin_type.h"
 #include "paddle/pir/include/pass/pass.h"
 #include "paddle/pir/include/pass/pass_registry.h"
 
 namespace {
 
+// The fused kernels read int64 ids, add the rows of every id including the
+// padding_idx one and normalize over the last dim only.
+bool IsFusableEmbedding(const paddle::drr::MatchContext &match_ctx,
+                        const std::string &ids,
+                        const std::string &padding_idx) {
+  return pir::GetDataTypeFromValue(match_ctx.Tensor(ids))
+             .isa<pir::Int64Type>() &&
+         match_ctx.Attr<int64_t>(padding_idx) == -1;
+}
+
+bool IsLastDimLayerNorm(const paddle::drr::MatchContext &match_ctx,
+                        const std::string &x) {
+  return match_ctx.Attr<int>("begin_norm_axis") ==
+         static_cast<int>(pir::GetShapeFromValue(match_ctx.Tensor(x)).size()) -
+             1;
+}
+
 class Fused2EmbeddingEltwiseLayernormPattern
     : public paddle::drr::DrrPatternBase {
+ private:
+  // The CPU kernel supports float32 only.
+  const bool is_cpu_;
+
  public:
+  explicit Fused2EmbeddingEltwiseLayernormPattern(bool is_cpu)
+      : is_cpu_(is_cpu) {}
+
   std::string name() const override {
     return "Fused2EmbeddingEltwiseLayernormPattern";
   }
 
   void operator()(paddle::drr::DrrPatternContext *ctx) const override {
     paddle::drr::SourcePattern pat = ctx->SourcePattern();
-    const auto &embedding_1 = pat.Op(paddle::dialect::EmbeddingOp::name());
-    const auto &embedding_2 = pat.Op(paddle::dialect::EmbeddingOp::name());
+    const auto &embedding_1 =
+        pat.Op(paddle::dialect::EmbeddingOp::name(),
+               {{"padding_idx", pat.Attr("padding_idx_1")}});
+    const auto &embedding_2 =
+        pat.Op(paddle::dialect::EmbeddingOp::name(),
+               {{"padding_idx", pat.Attr("padding_idx_2")}});
     const auto &add = pat.Op(paddle::dialect::AddOp::name());
 
-    const auto &layernorm = pat.Op(paddle::dialect::LayerNormOp::name(),
-                                   {{"epsilon", pat.Attr("epsilon")}});
+    const auto &layernorm =
+        pat.Op(paddle::dialect::LayerNormOp::name(),
+               {{"epsilon", pat.Attr("epsilon")},
+                {"begin_norm_axis", pat.Attr("begin_norm_axis")}});
 
     embedding_1({&pat.Tensor("x1"), &pat.Tensor("w1")},
                 {&pat.Tensor("embedding_1_out")});
@@ -53,13 +84,16 @@ class Fused2EmbeddingEltwiseLayernormPattern
          &pat.Tensor("layernorm_mean"),
          &pat.Tensor("layernorm_variance")});
 
-    pat.AddConstraint([](const paddle::drr::MatchContext &match_ctx) {
+    pat.AddConstraint([this](const paddle::drr::MatchContext &match_ctx) {
       auto w1_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w1"));
       auto w2_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w2"));
       if (w1_dtype != w2_dtype || (!w1_dtype.isa<pir::Float16Type>() &&
                                    !w1_dtype.isa<pir::Float32Type>())) {
         return false;
       }
+      if (this->is_cpu_ && !w1_dtype.isa<pir::Float32Type>()) {
+        return false;
+      }
 
       auto x1_shape = pir::GetShapeFromValue(match_ctx.Tensor("x1"));
       auto x2_shape = pir::GetShapeFromValue(match_ctx.Tensor("x2"));
@@ -72,7 +106,9 @@ class Fused2EmbeddingEltwiseLayernormPattern
         }
       }
 
-      return true;
+      return IsFusableEmbedding(match_ctx, "x1", "padding_idx_1") &&
+             IsFusableEmbedding(match_ctx, "x2", "padding_idx_2") &&
+             IsLastDimLayerNorm(match_ctx, "add_out");
     });
 
     paddle::drr::ResultPattern res = pat.ResultPattern();
@@ -111,20 +147,35 @@ class Fused2EmbeddingEltwiseLayernormPattern
 
 class Fused3EmbeddingEltwiseLayernormPattern
     : public paddle::drr::DrrPatternBase {
+ private:
+  // The CPU kernel supports float32 only.
+  const bool is_cpu_;
+
  public:
+  explicit Fused3EmbeddingEltwiseLayernormPattern(bool is_cpu)
+      : is_cpu_(is_cpu) {}
+
   std::string name() const override {
     return "Fused3EmbeddingEltwiseLayernormPattern";
   }
 
   void operator()(paddle::drr::DrrPatternContext *ctx) const override {
     paddle::drr::SourcePattern pat = ctx->SourcePattern();
-    const auto &embedding_1 = pat.Op(paddle::dialect::EmbeddingOp::name());
-    const auto &embedding_2 = pat.Op(paddle::dialect::EmbeddingOp::name());
-    const auto &embedding_3 = pat.Op(paddle::dialect::EmbeddingOp::name());
+    const auto &embedding_1 =
+        pat.Op(paddle::dialect::EmbeddingOp::name(),
+               {{"padding_idx", pat.Attr("padding_idx_1")}});
+    const auto &embedding_2 =
+        pat.Op(paddle::dialect::EmbeddingOp::name(),
+               {{"padding_idx", pat.Attr("padding_idx_2")}});
+    const auto &embedding_3 =
+        pat.Op(paddle::dialect::EmbeddingOp::name(),
+               {{"padding_idx", pat.Attr("padding_idx_3")}});
     const auto &add1 = pat.Op(paddle::dialect::AddOp::name());
     const auto &add2 = pat.Op(paddle::dialect::AddOp::name());
-    const auto &layernorm = pat.Op(paddle::dialect::LayerNormOp::name(),
-                                   {{"epsilon", pat.Attr("epsilon")}});
+    const auto &layernorm =
+        pat.Op(paddle::dialect::LayerNormOp::name(),
+               {{"epsilon", pat.Attr("epsilon")},
+                {"begin_norm_axis", pat.Attr("begin_norm_axis")}});
 
     embedding_1({&pat.Tensor("x1"), &pat.Tensor("w1")},
                 {&pat.Tensor("embedding_1_out")});
@@ -142,7 +193,7 @@ class Fused3EmbeddingEltwiseLayernormPattern
          &pat.Tensor("layernorm_mean"),
          &pat.Tensor("layernorm_variance")});
 
-    pat.AddConstraint([](const paddle::drr::MatchContext &match_ctx) {
+    pat.AddConstraint([this](const paddle::drr::MatchContext &match_ctx) {
       auto w1_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w1"));
       auto w2_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w2"));
       auto w3_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w3"));
@@ -151,6 +202,9 @@ class Fused3EmbeddingEltwiseLayernormPattern
            !w1_dtype.isa<pir::Float32Type>())) {
         return false;
       }
+      if (this->is_cpu_ && !w1_dtype.isa<pir::Float32Type>()) {
+        return false;
+      }
 
       auto x1_shape = pir::GetShapeFromValue(match_ctx.Tensor("x1"));
       auto x2_shape = pir::GetShapeFromValue(match_ctx.Tensor("x2"));
@@ -165,7 +219,10 @@ class Fused3EmbeddingEltwiseLayernormPattern
           return false;
         }
       }
-      return true;
+      return IsFusableEmbedding(match_ctx, "x1", "padding_idx_1") &&
+             IsFusableEmbedding(match_ctx, "x2", "padding_idx_2") &&
+             IsFusableEmbedding(match_ctx, "x3", "padding_idx_3") &&
+             IsLastDimLayerNorm(match_ctx, "add2_out");
     });
 
     paddle::drr::ResultPattern res = pat.ResultPattern();
@@ -208,10 +265,15 @@ class EmbeddingEltwiseLayernormFusePass : public pir::PatternRewritePass {
 
   pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
     pir::RewritePatternSet ps(context);
-    ps.Add(
-        paddle::drr::Create<Fused2EmbeddingEltwiseLayernormPattern>(context));
-    ps.Add(
-        paddle::drr::Create<Fused3EmbeddingEltwiseLayernormPattern>(context));
+    bool is_cpu = false;
+    if (Has(pir::Pass::kPlaceAttr)) {
+      is_cpu = Get<phi::Place>(pir::Pass::kPlaceAttr).GetType() ==
+               phi::AllocationType::CPU;
+    }
+    ps.Add(paddle::drr::Create<Fused2EmbeddingEltwiseLayernormPattern>(
+        context, is_cpu));
+    ps.Add(paddle::drr::Create<Fused3EmbeddingEltwiseLayernormPattern>(
+        context, is_cpu));
     return ps;
   }
 };
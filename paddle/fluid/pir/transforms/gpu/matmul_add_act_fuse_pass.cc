@@ -17,6 +17,7 @@
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
 #include "paddle/fluid/pir/drr/include/drr_pattern_base.h"
 #include "paddle/fluid/pir/utils/general_functions.h"
+#include "paddle/phi/common/place.h"
 
 #include "paddle/pir/include/pass/pass.h"
 #include "paddle/pir/include/pass/pass_registry.h"
@@ -36,11 +37,15 @@ class MatmulAddPattern : public paddle::drr::DrrPatternBase {
  private:
   std::string fused_op_name_;
   bool reverse_add_;
+  bool is_cpu_;
 
  public:
-  explicit MatmulAddPattern(const std::string &fused_op_name,
-                            const bool reverse_add)
-      : fused_op_name_(fused_op_name), reverse_add_(reverse_add) {}
+  MatmulAddPattern(const std::string &fused_op_name,
+                   const bool reverse_add,
+                   const bool is_cpu = false)
+      : fused_op_name_(fused_op_name),
+        reverse_add_(reverse_add),
+        is_cpu_(is_cpu) {}
 
   uint32_t benefit() const override {
     return fused_op_name_ == paddle::dialect::GemmEpilogueOp::name() ? 2 : 1;
@@ -71,6 +76,10 @@ class MatmulAddPattern : public paddle::drr::DrrPatternBase {
             !w_dtype.isa<pir::Float64Type>()) {
           return false;
         }
+        // The CPU fc kernel supports float32 and float64 only.
+        if (is_cpu_ && w_dtype.isa<pir::Float16Type>()) {
+          return false;
+        }
       }
       auto w_dims = pir::GetShapeFromValue(match_ctx.Tensor("w"));
       auto x_dims = pir::GetShapeFromValue(match_ctx.Tensor("x"));
@@ -217,9 +226,14 @@ class MatmulAddActFusePass : public pir::PatternRewritePass {
             context, act_op, paddle::dialect::GemmEpilogueOp::name()));
       }
     }
+    bool is_cpu = false;
+    if (Has(pir::Pass::kPlaceAttr)) {
+      is_cpu = Get<phi::Place>(pir::Pass::kPlaceAttr).GetType() ==
+               phi::AllocationType::CPU;
+    }
     /// MatmulAddPatternw
     ps.Add(paddle::drr::Create<MatmulAddPattern>(
-        context, paddle::dialect::FcOp::name(), false));
+        context, paddle::dialect::FcOp::name(), false, is_cpu));
     /// MatmulAddActPattern
     ps.Add(paddle::drr::Create<MatmulAddActPattern>(
         context, "relu", paddle::dialect::FcOp::name()));
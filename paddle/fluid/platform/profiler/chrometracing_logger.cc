@@ -22,6 +22,7 @@ limitations under the License. */
 #include "glog/logging.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/profiler/event_node.h"
+#include "paddle/phi/core/memory/memory_attribution.h"
 #include "paddle/phi/core/platform/device/gpu/gpu_info.h"
 #include "paddle/phi/core/platform/profiler/utils.h"
 
@@ -111,6 +112,11 @@ void ChromeTracingLogger::LogNodeTrees(const NodeTrees& node_trees) {
       }
     }
   }
+  // memory timeline of the executed instructions
+  if (memory::MemoryAttribution::IsEnabled()) {
+    output_file_stream_
+        << memory::MemoryAttribution::Instance().ChromeTraceEvents(start_time_);
+  }
 }
 
 void ChromeTracingLogger::LogMemTraceEventNode(
@@ -174,6 +180,26 @@ void ChromeTracingLogger::LogHostTraceEventNode(
     callstack = std::regex_replace(callstack, std::regex("\""), "\'");
     callstack = std::regex_replace(callstack, std::regex("\n"), "\\n");
   }
+  std::string hw_counters;
+  if (host_node.HasHardwareCounters()) {
+    const auto& counters = host_node.GetHardwareCounters();
+    double ipc = counters.cycles == 0
+                     ? 0.0
+                     : static_cast<double>(counters.instructions) /
+                           static_cast<double>(counters.cycles);
+    hw_counters = string_format(std::string(
+                                    R"JSON(,
+      "cycles": %llu,
+      "instructions": %llu,
+      "ipc": %.3f,
+      "llc_misses": %llu,
+      "branch_misses": %llu)JSON"),
+                                counters.cycles,
+                                counters.instructions,
+                                ipc,
+                                counters.llc_misses,
+                                counters.branch_misses);
+  }
   switch (host_node.Type()) {
     case TracerEventType::ProfileStep:
     case TracerEventType::Forward:
@@ -224,7 +250,7 @@ void ChromeTracingLogger::LogHostTraceEventNode(
       "end_time": "%.3f us",
       "input_shapes": %s,
       "input_dtypes": %s,
-      "callstack": "%s"
+      "callstack": "%s"%s
     }
   },
   )JSON"),
@@ -239,7 +265,8 @@ void ChromeTracingLogger::LogHostTraceEventNode(
           nsToUsFloat(host_node.EndNs(), start_time_),
           json_dict(input_shapes).c_str(),
           json_dict(input_dtypes).c_str(),
-          callstack.c_str());
+          callstack.c_str(),
+          hw_counters.c_str());
       break;
     case TracerEventType::CudaRuntime:
     case TracerEventType::Kernel:
@@ -30,6 +30,8 @@ using CommonEvent = phi::CommonEvent;
 
 using CommonMemEvent = phi::CommonMemEvent;
 
+using CommonHardwareCounterEvent = phi::CommonHardwareCounterEvent;
+
 struct OperatorSupplementOriginEvent {
  public:
   OperatorSupplementOriginEvent(
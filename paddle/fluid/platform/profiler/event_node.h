@@ -197,6 +197,10 @@ class HostTraceEventNode {
   uint64_t Duration() const {
     return host_event_.end_ns - host_event_.start_ns;
   }
+  bool HasHardwareCounters() const { return host_event_.has_hw_counters; }
+  const phi::HardwareCounters& GetHardwareCounters() const {
+    return host_event_.hw_counters;
+  }
 
   // member function
   void AddChild(HostTraceEventNode* node) { children_.push_back(node); }
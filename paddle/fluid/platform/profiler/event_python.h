@@ -125,6 +125,13 @@ struct HostPythonNode {
   framework::AttributeMap attributes;
   // op id
   uint64_t op_id;
+  // whether the hardware counters below are valid
+  bool has_hw_counters = false;
+  // hardware counters
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t llc_misses = 0;
+  uint64_t branch_misses = 0;
   // children node
   std::vector<HostPythonNode*> children_node_ptrs;
   // runtime node
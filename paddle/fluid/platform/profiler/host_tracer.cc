@@ -13,24 +13,46 @@
 // limitations under the License.
 #include "paddle/fluid/platform/profiler/host_tracer.h"
 
+#include <map>
 #include <sstream>
+#include <unordered_map>
 
 #include "glog/logging.h"
 #include "paddle/fluid/framework/op_proto_maker.h"
 #include "paddle/fluid/platform/profiler/common_event.h"
+#include "paddle/phi/api/profiler/hardware_counters.h"
 #include "paddle/phi/core/platform/profiler/host_event_recorder.h"
 
 namespace paddle::platform {
 
 namespace {
 
+// thread id -> (start_ns, end_ns) -> counters
+using HardwareCounterMap = std::unordered_map<
+    uint64_t,
+    std::map<std::pair<uint64_t, uint64_t>, phi::HardwareCounters>>;
+
+HardwareCounterMap ProcessHardwareCounterEvents(
+    const HostEventSection<CommonHardwareCounterEvent>& counter_events) {
+  HardwareCounterMap counter_map;
+  for (const auto& thr_sec : counter_events.thr_sections) {
+    auto& thread_counters = counter_map[thr_sec.thread_id];
+    for (const auto& evt : thr_sec.events) {
+      thread_counters[std::make_pair(evt.start_ns, evt.end_ns)] = evt.counters;
+    }
+  }
+  return counter_map;
+}
+
 void ProcessHostEvents(const HostEventSection<CommonEvent>& host_events,
+                       const HardwareCounterMap& counter_map,
                        TraceEventCollector* collector) {
   for (const auto& thr_sec : host_events.thr_sections) {
     uint64_t tid = thr_sec.thread_id;
     if (thr_sec.thread_name != phi::kDefaultThreadName) {
       collector->AddThreadName(tid, thr_sec.thread_name);
     }
+    auto thread_counters = counter_map.find(tid);
     for (const auto& evt : thr_sec.events) {
       HostTraceEvent event;
       event.name = evt.name;
@@ -39,6 +61,15 @@ void ProcessHostEvents(const HostEventSection<CommonEvent>& host_events,
       event.end_ns = evt.end_ns;
       event.process_id = host_events.process_id;
       event.thread_id = tid;
+      if (evt.type == TracerEventType::Operator &&
+          thread_counters != counter_map.end()) {
+        auto iter = thread_counters->second.find(
+            std::make_pair(evt.start_ns, evt.end_ns));
+        if (iter != thread_counters->second.end()) {
+          event.has_hw_counters = true;
+          event.hw_counters = iter->second;
+        }
+      }
       collector->AddHostEvent(std::move(event));
     }
   }
@@ -144,8 +175,16 @@ void HostTracer::StartTracing() {
       common::errors::PreconditionNotMet("TracerState must be READY"));
   HostEventRecorder<CommonEvent>::GetInstance().GatherEvents();
   HostEventRecorder<CommonMemEvent>::GetInstance().GatherEvents();
+  HostEventRecorder<CommonHardwareCounterEvent>::GetInstance().GatherEvents();
   HostEventRecorder<OperatorSupplementOriginEvent>::GetInstance()
       .GatherEvents();
+  if (options_.enable_hw_counters) {
+    phi::HardwareCounterReader::SetEnabled(true);
+    if (!phi::HardwareCounterReader::IsEnabled()) {
+      LOG(WARNING) << "Hardware counters are not supported on this machine, "
+                      "the profiling result will not contain them.";
+    }
+  }
   HostTraceLevel::GetInstance().SetLevel(options_.trace_level);
   state_ = TracerState::STARTED;
 }
@@ -156,6 +195,7 @@ void HostTracer::StopTracing() {
       TracerState::STARTED,
       common::errors::PreconditionNotMet("TracerState must be STARTED"));
   HostTraceLevel::GetInstance().SetLevel(HostTraceLevel::kDisabled);
+  phi::HardwareCounterReader::SetEnabled(false);
   state_ = TracerState::STOPED;
 }
 
@@ -164,9 +204,13 @@ void HostTracer::CollectTraceData(TraceEventCollector* collector) {
       state_,
       TracerState::STOPED,
       common::errors::PreconditionNotMet("TracerState must be STOPED"));
+  HostEventSection<CommonHardwareCounterEvent> counter_events =
+      HostEventRecorder<CommonHardwareCounterEvent>::GetInstance()
+          .GatherEvents();
   HostEventSection<CommonEvent> host_events =
       HostEventRecorder<CommonEvent>::GetInstance().GatherEvents();
-  ProcessHostEvents(host_events, collector);
+  ProcessHostEvents(
+      host_events, ProcessHardwareCounterEvents(counter_events), collector);
   HostEventSection<CommonMemEvent> host_mem_events =
       HostEventRecorder<CommonMemEvent>::GetInstance().GatherEvents();
   ProcessHostMemEvents(host_mem_events, collector);
@@ -28,6 +28,7 @@
 #include "paddle/phi/core/platform/profiler/cpu_utilization.h"
 
 COMMON_DECLARE_int64(host_trace_level);
+COMMON_DECLARE_bool(enable_profiler_hw_counters);
 
 namespace paddle {
 namespace platform {
@@ -42,6 +43,7 @@ void SynchronizeDevice();
 struct ProfilerOptions {
   uint32_t trace_switch = 0;  // bit 0: cpu, bit 1: gpu, bit 2: xpu
   uint32_t trace_level = FLAGS_host_trace_level;
+  bool enable_hw_counters = FLAGS_enable_profiler_hw_counters;
 };
 
 class Profiler {
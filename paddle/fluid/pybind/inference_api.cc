@@ -865,6 +865,11 @@ void BindAnalysisConfig(py::module *m) {
       .def("use_optimized_model",
            &AnalysisConfig::UseOptimizedModel,
            py::arg("x") = true)
+      .def("enable_optimized_program_cache",
+           &AnalysisConfig::EnableOptimizedProgramCache,
+           py::arg("x") = true)
+      .def("optimized_program_cache_enabled",
+           &AnalysisConfig::optimized_program_cache_enabled)
       .def("enable_memory_optim",
            &AnalysisConfig::EnableMemoryOptim,
            py::arg("x") = true)
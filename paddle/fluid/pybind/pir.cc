@@ -2717,7 +2717,16 @@ void BindPassManager(pybind11::module *m) {
       .def("enable_ir_printing",
            [](PassManager &self) { self.EnableIRPrinting(); })
       .def("enable_print_statistics",
-           [](PassManager &self) { self.EnablePrintStatistics(); });
+           [](PassManager &self) { self.EnablePrintStatistics(); })
+      .def("enable_pass_timing",
+           [](PassManager &self, bool print_module) {
+             self.EnablePassTiming(print_module);
+           },
+           py::arg("print_module") = true)
+      .def("enable_multi_threading",
+           [](PassManager &self, size_t num_threads) {
+             self.EnableMultiThreading(num_threads);
+           });
 }
 
 void BindDrrPatternContext(pybind11::module *m) {
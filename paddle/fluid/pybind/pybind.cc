@@ -123,6 +123,7 @@ limitations under the License. */
 #include "paddle/fluid/pybind/pybind_variant_caster.h"
 #include "paddle/fluid/pybind/python_callable_registry.h"
 #include "paddle/fluid/pybind/xpu_streams_py.h"
+#include "paddle/phi/api/profiler/op_sampling_profiler.h"
 #include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/backends/device_manager.h"
 #include "paddle/phi/backends/dynload/dynamic_loader.h"
@@ -131,6 +132,7 @@ limitations under the License. */
 #include "paddle/phi/core/compat/convert_utils.h"
 #include "paddle/phi/core/lod_utils.h"
 #include "paddle/phi/core/memory/allocation/mmap_allocator.h"
+#include "paddle/phi/core/memory/memory_attribution.h"
 #include "paddle/phi/core/platform/cpu_helper.h"
 #include "paddle/phi/core/platform/device/device_wrapper.h"
 #include "paddle/phi/core/platform/device_context.h"
@@ -1530,6 +1532,8 @@ PYBIND11_MODULE(libpaddle, m) {
   // stored in this static instance to avoid illegal memory access.
   m.def("clear_kernel_factory",
         []() { phi::KernelFactory::Instance().kernels().clear(); });
+  m.def("shutdown_op_sampling_profiler",
+        []() { phi::OpSamplingProfiler::Instance().Shutdown(); });
   m.def("clear_device_manager", []() {
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
     platform::XCCLCommContext::Release();
@@ -2572,6 +2576,17 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("host_memory_stat_peak_value", memory::HostMemoryStatPeakValue);
   m.def("host_memory_stat_reset_peak_value",
         memory::HostMemoryStatResetPeakValue);
+  m.def(
+      "memory_attribution_summary",
+      [](size_t top_k) {
+        return memory::MemoryAttribution::Instance().Summary(top_k);
+      },
+      py::arg("top_k") = 20);
+  m.def("export_memory_attribution_trace", [](const std::string &path) {
+    memory::MemoryAttribution::Instance().ExportChromeTrace(path);
+  });
+  m.def("reset_memory_attribution",
+        [] { memory::MemoryAttribution::Instance().Reset(); });
   m.def(
       "run_cmd",
       [](const std::string &cmd,
@@ -3020,6 +3035,15 @@ All parameter, weight, gradient are variables in Paddle.
       .def_readwrite("attributes",
                      &paddle::platform::HostPythonNode::attributes)
       .def_readwrite("op_id", &paddle::platform::HostPythonNode::op_id)
+      .def_readwrite("has_hw_counters",
+                     &paddle::platform::HostPythonNode::has_hw_counters)
+      .def_readwrite("cycles", &paddle::platform::HostPythonNode::cycles)
+      .def_readwrite("instructions",
+                     &paddle::platform::HostPythonNode::instructions)
+      .def_readwrite("llc_misses",
+                     &paddle::platform::HostPythonNode::llc_misses)
+      .def_readwrite("branch_misses",
+                     &paddle::platform::HostPythonNode::branch_misses)
       .def_readwrite("children_node",
                      &paddle::platform::HostPythonNode::children_node_ptrs)
       .def_readwrite("runtime_node",
@@ -3067,7 +3091,9 @@ All parameter, weight, gradient are variables in Paddle.
   py::class_<paddle::platform::ProfilerOptions>(m, "ProfilerOptions")
       .def(py::init<>())
       .def_readwrite("trace_switch",
-                     &paddle::platform::ProfilerOptions::trace_switch);
+                     &paddle::platform::ProfilerOptions::trace_switch)
+      .def_readwrite("enable_hw_counters",
+                     &paddle::platform::ProfilerOptions::enable_hw_counters);
 
   py::class_<phi::RecordEvent>(m, "_RecordEvent")
       .def(py::init([](std::string name, phi::TracerEventType type) {
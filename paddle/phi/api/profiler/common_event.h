@@ -105,6 +105,18 @@ struct CommonMemEvent {
   uint64_t peak_reserved;
 };
 
+struct CommonHardwareCounterEvent {
+ public:
+  CommonHardwareCounterEvent(uint64_t start_ns,
+                             uint64_t end_ns,
+                             const HardwareCounters &counters)
+      : start_ns(start_ns), end_ns(end_ns), counters(counters) {}
+  // same as the CommonEvent it belongs to
+  uint64_t start_ns;
+  uint64_t end_ns;
+  HardwareCounters counters;
+};
+
 struct OperatorSupplementOriginEvent {
  public:
   OperatorSupplementOriginEvent(
@@ -79,6 +79,10 @@ class TEST_API RecordEvent {
                          const EventRole role,
                          const std::string& attr);
 
+  // Read the hardware counters at the start of an operator, only called when
+  // HardwareCounterReader is enabled.
+  void StartHardwareCounters();
+
   bool is_enabled_{false};
   bool is_pushed_{false};
   // Event name
@@ -91,6 +95,9 @@ class TEST_API RecordEvent {
   EventRole role_{EventRole::kOrdinary};
   TracerEventType type_{TracerEventType::UserDefined};
   std::string* attr_{nullptr};
+  // Hardware counters at the start of the event, valid if has_hw_counters_.
+  HardwareCounters hw_counters_start_;
+  bool has_hw_counters_{false};
   bool finished_{false};
 };
 
@@ -0,0 +1,173 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/api/profiler/hardware_counters.h"
+
+#include <atomic>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#endif
+
+#include "glog/logging.h"
+
+namespace phi {
+
+namespace {
+
+std::atomic<bool> g_hw_counters_enabled{false};
+
+#ifdef __linux__
+
+// The order of the counters in a group read.
+enum CounterIndex {
+  kCycles = 0,
+  kInstructions,
+  kLLCMisses,
+  kBranchMisses,
+  kNumCounters
+};
+
+constexpr uint64_t kCounterConfigs[kNumCounters] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES};
+
+int OpenCounter(uint64_t config, int group_fd) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // pid = 0, cpu = -1: count the calling thread on any cpu
+  return static_cast<int>(
+      syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+class ThreadCounterGroup {
+ public:
+  ThreadCounterGroup() {
+    fds_.fill(-1);
+    slots_.fill(-1);
+    fds_[kCycles] = OpenCounter(kCounterConfigs[kCycles], -1);
+    if (fds_[kCycles] < 0) {
+      static std::once_flag warn_once;
+      int err = errno;
+      std::call_once(warn_once, [err] {
+        LOG(WARNING) << "Hardware counters are not available: "
+                     << strerror(err)
+                     << ". Check /proc/sys/kernel/perf_event_paranoid.";
+      });
+      return;
+    }
+    // Some counters (e.g. LLC misses in VMs) may be missing, keep the others.
+    int num_opened = 0;
+    slots_[kCycles] = num_opened++;
+    for (int i = kCycles + 1; i < kNumCounters; ++i) {
+      fds_[i] = OpenCounter(kCounterConfigs[i], fds_[kCycles]);
+      if (fds_[i] >= 0) {
+        slots_[i] = num_opened++;
+      }
+    }
+    ioctl(fds_[kCycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds_[kCycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  ~ThreadCounterGroup() {
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  bool Read(HardwareCounters* counters) const {
+    if (fds_[kCycles] < 0) {
+      return false;
+    }
+    // layout of PERF_FORMAT_GROUP: { u64 nr; u64 values[nr]; }
+    uint64_t buf[kNumCounters + 1];
+    ssize_t size = read(fds_[kCycles], buf, sizeof(buf));
+    if (size < static_cast<ssize_t>(sizeof(uint64_t) * 2)) {
+      return false;
+    }
+    auto value = [&](int index) -> uint64_t {
+      int slot = slots_[index];
+      return slot >= 0 && static_cast<uint64_t>(slot) < buf[0] ? buf[slot + 1]
+                                                               : 0;
+    };
+    counters->cycles = value(kCycles);
+    counters->instructions = value(kInstructions);
+    counters->llc_misses = value(kLLCMisses);
+    counters->branch_misses = value(kBranchMisses);
+    return true;
+  }
+
+ private:
+  std::array<int, kNumCounters> fds_;
+  // position of each counter in a group read, -1 if not opened
+  std::array<int, kNumCounters> slots_;
+};
+
+ThreadCounterGroup& GetThreadCounterGroup() {
+  static thread_local ThreadCounterGroup group;
+  return group;
+}
+
+#endif
+
+}  // namespace
+
+void HardwareCounterReader::SetEnabled(bool enabled) {
+  if (enabled && !IsSupported()) {
+    enabled = false;
+  }
+  g_hw_counters_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool HardwareCounterReader::IsEnabled() {
+  return g_hw_counters_enabled.load(std::memory_order_relaxed);
+}
+
+bool HardwareCounterReader::IsSupported() {
+#ifdef __linux__
+  HardwareCounters counters;
+  return Read(&counters);
+#else
+  return false;
+#endif
+}
+
+bool HardwareCounterReader::Read(HardwareCounters* counters) {
+#ifdef __linux__
+  return GetThreadCounterGroup().Read(counters);
+#else
+  return false;
+#endif
+}
+
+}  // namespace phi
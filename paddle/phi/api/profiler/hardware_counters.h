@@ -0,0 +1,43 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/phi/api/profiler/trace_event.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+
+// Reads the hardware performance counters (cycles, instructions, LLC misses
+// and branch misses) of the calling thread with perf_event_open. The counters
+// of each thread are opened lazily as one group, so that they are always
+// scheduled together and the values of one read are consistent.
+// Only supported on Linux, and the kernel may refuse to open the counters
+// depending on /proc/sys/kernel/perf_event_paranoid or in some VMs.
+class TEST_API HardwareCounterReader {
+ public:
+  // Counters are only read for the operators recorded when enabled.
+  static void SetEnabled(bool enabled);
+
+  static bool IsEnabled();
+
+  // Returns false if the counters can not be opened in this process.
+  static bool IsSupported();
+
+  // Reads the current values of the calling thread, returns false if the
+  // counters of this thread are not available.
+  static bool Read(HardwareCounters* counters);
+};
+
+}  // namespace phi
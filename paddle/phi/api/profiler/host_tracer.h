@@ -38,6 +38,8 @@ class HostTraceLevel {
 
 struct HostTracerOptions {
   uint32_t trace_level = 0;
+  // read hardware performance counters for each operator
+  bool enable_hw_counters = false;
 };
 
 }  // namespace phi
@@ -0,0 +1,257 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/api/profiler/op_sampling_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include "glog/logging.h"
+
+#include "paddle/common/flags.h"
+
+PHI_DEFINE_int32(op_sampling_profiler_interval,
+                 0,
+                 "Time one in N operator executions of each thread and "
+                 "aggregate them into per-op latency histograms, 0 disables "
+                 "the sampling profiler.");
+
+PHI_DEFINE_int32(op_sampling_profiler_flush_seconds,
+                 60,
+                 "The interval in seconds to flush the histograms of the "
+                 "sampling profiler.");
+
+PHI_DEFINE_string(op_sampling_profiler_path,
+                  "paddle_op_latency.prom",
+                  "The file the sampling profiler flushes the histograms to, "
+                  "in the Prometheus text exposition format.");
+
+namespace phi {
+
+void OpLatencyHistogram::Add(uint64_t latency_ns) {
+  uint64_t latency_us = latency_ns / 1000;
+  size_t idx = 0;
+  while (idx + 1 < kNumBuckets && (latency_us >> idx) != 0) {
+    ++idx;
+  }
+  buckets[idx].fetch_add(1, std::memory_order_relaxed);
+  sum_ns.fetch_add(latency_ns, std::memory_order_relaxed);
+  count.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t OpSamplingGuard::NowInNsec() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+OpSamplingProfiler& OpSamplingProfiler::Instance() {
+  static OpSamplingProfiler instance;
+  return instance;
+}
+
+bool OpSamplingProfiler::IsEnabled() {
+  return FLAGS_op_sampling_profiler_interval > 0;
+}
+
+bool OpSamplingProfiler::ShouldSample() {
+  thread_local int countdown = 0;
+  if (--countdown > 0) {
+    return false;
+  }
+  countdown = FLAGS_op_sampling_profiler_interval;
+  return true;
+}
+
+OpSamplingProfiler::ThreadOpStats* OpSamplingProfiler::GetThreadLocalStats() {
+  thread_local ThreadOpStats* stats = nullptr;
+  if (UNLIKELY(stats == nullptr)) {
+    auto new_stats = std::make_shared<ThreadOpStats>();
+    stats = new_stats.get();
+    std::lock_guard<std::mutex> guard(mutex_);
+    thread_stats_.emplace_back(std::move(new_stats));
+  }
+  return stats;
+}
+
+void OpSamplingProfiler::Record(const std::string& op_name,
+                                uint64_t latency_ns) {
+  if (UNLIKELY(!flushing_.load(std::memory_order_acquire))) {
+    StartFlushThread();
+  }
+
+  ThreadOpStats* stats = GetThreadLocalStats();
+  auto iter = stats->ops.find(op_name);
+  if (UNLIKELY(iter == stats->ops.end())) {
+    std::lock_guard<std::mutex> guard(stats->mutex);
+    iter = stats->ops
+               .emplace(op_name, std::make_unique<OpLatencyHistogram>())
+               .first;
+  }
+  iter->second->Add(latency_ns);
+}
+
+std::string OpSamplingProfiler::ExportText() {
+  struct Aggregated {
+    std::array<uint64_t, OpLatencyHistogram::kNumBuckets> buckets{};
+    uint64_t sum_ns{0};
+    uint64_t count{0};
+  };
+  // Sorted by op name to keep the output stable.
+  std::map<std::string, Aggregated> aggregated;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto& stats : thread_stats_) {
+      std::lock_guard<std::mutex> stats_guard(stats->mutex);
+      for (auto& op : stats->ops) {
+        auto& agg = aggregated[op.first];
+        for (size_t i = 0; i < OpLatencyHistogram::kNumBuckets; ++i) {
+          agg.buckets[i] +=
+              op.second->buckets[i].load(std::memory_order_relaxed);
+        }
+        agg.sum_ns += op.second->sum_ns.load(std::memory_order_relaxed);
+        agg.count += op.second->count.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  std::ostringstream os;
+  os << "# HELP paddle_op_sample_interval One in N operator executions are "
+        "sampled.\n";
+  os << "# TYPE paddle_op_sample_interval gauge\n";
+  os << "paddle_op_sample_interval " << FLAGS_op_sampling_profiler_interval
+     << "\n";
+  os << "# HELP paddle_op_latency_seconds Latency of the sampled operator "
+        "executions.\n";
+  os << "# TYPE paddle_op_latency_seconds histogram\n";
+  for (auto& op : aggregated) {
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < OpLatencyHistogram::kNumBuckets; ++i) {
+      cumulative += op.second.buckets[i];
+      os << "paddle_op_latency_seconds_bucket{op=\"" << op.first << "\",le=\"";
+      if (i + 1 < OpLatencyHistogram::kNumBuckets) {
+        os << std::setprecision(6) << static_cast<double>(1ULL << i) * 1e-6;
+      } else {
+        os << "+Inf";
+      }
+      os << "\"} " << cumulative << "\n";
+    }
+    os << "paddle_op_latency_seconds_sum{op=\"" << op.first << "\"} "
+       << std::setprecision(9) << static_cast<double>(op.second.sum_ns) * 1e-9
+       << "\n";
+    os << "paddle_op_latency_seconds_count{op=\"" << op.first << "\"} "
+       << op.second.count << "\n";
+  }
+  return os.str();
+}
+
+void OpSamplingProfiler::Flush() {
+  std::string path;
+  {
+    std::lock_guard<std::mutex> guard(flush_mutex_);
+    path = path_.empty() ? FLAGS_op_sampling_profiler_path : path_;
+  }
+  FlushTo(path);
+}
+
+void OpSamplingProfiler::FlushTo(const std::string& path) {
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream fout(tmp_path, std::ios::out | std::ios::trunc);
+    if (!fout.is_open()) {
+      LOG_FIRST_N(WARNING, 1) << "Cannot open " << tmp_path
+                              << " to flush the sampling profiler.";
+      return;
+    }
+    fout << ExportText();
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG_FIRST_N(WARNING, 1) << "Cannot rename " << tmp_path << " to " << path
+                            << " when flushing the sampling profiler.";
+  }
+}
+
+void OpSamplingProfiler::StartFlushThread() {
+  std::lock_guard<std::mutex> thread_guard(thread_mutex_);
+  if (flushing_.load(std::memory_order_acquire)) {
+    return;
+  }
+  // The thread of the previous enabled period has made its last flush.
+  if (flush_thread_.joinable()) {
+    flush_thread_.join();
+  }
+  {
+    std::lock_guard<std::mutex> guard(flush_mutex_);
+    path_ = FLAGS_op_sampling_profiler_path;
+    stop_ = false;
+  }
+  flushing_.store(true, std::memory_order_release);
+  flush_thread_ = std::thread([this]() {
+    std::unique_lock<std::mutex> lock(flush_mutex_);
+    while (true) {
+      flush_cv_.wait_for(
+          lock,
+          std::chrono::seconds(
+              std::max(FLAGS_op_sampling_profiler_flush_seconds, 1)),
+          [this]() { return stop_; });
+      if (stop_) {
+        break;
+      }
+      FlushTo(path_);
+      if (!IsEnabled()) {
+        VLOG(3) << "Stopped the sampling profiler.";
+        break;
+      }
+    }
+    flushing_.store(false, std::memory_order_release);
+  });
+  VLOG(3) << "Started the sampling profiler, one in "
+          << FLAGS_op_sampling_profiler_interval
+          << " operator executions are sampled and flushed to " << path_;
+}
+
+void OpSamplingProfiler::StopFlushThread() {
+  std::lock_guard<std::mutex> thread_guard(thread_mutex_);
+  if (!flush_thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(flush_mutex_);
+    stop_ = true;
+  }
+  flush_cv_.notify_all();
+  flush_thread_.join();
+  flushing_.store(false, std::memory_order_release);
+}
+
+void OpSamplingProfiler::Shutdown() {
+  StopFlushThread();
+  std::string path;
+  {
+    std::lock_guard<std::mutex> guard(flush_mutex_);
+    path = path_;
+  }
+  if (!path.empty()) {
+    FlushTo(path);
+  }
+}
+
+OpSamplingProfiler::~OpSamplingProfiler() { StopFlushThread(); }
+
+}  // namespace phi
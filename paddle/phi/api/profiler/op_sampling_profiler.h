@@ -0,0 +1,145 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+
+// Latency histogram of one operator type. The buckets are only written by the
+// owner thread, the exporter reads them with relaxed loads, so recording a
+// sample never takes a lock.
+struct OpLatencyHistogram {
+  // Bucket i counts the samples whose latency is less than 2^i microseconds,
+  // the last bucket counts the rest.
+  static constexpr size_t kNumBuckets = 22;
+
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets{};
+  std::atomic<uint64_t> sum_ns{0};
+  std::atomic<uint64_t> count{0};
+
+  void Add(uint64_t latency_ns);
+};
+
+// Always-on sampling profiler for operator execution. When
+// FLAGS_op_sampling_profiler_interval is N > 0, one in N executions of each
+// thread is timed and aggregated into per-op latency histograms, which are
+// flushed periodically in the Prometheus text exposition format to
+// FLAGS_op_sampling_profiler_path, read when the first sample is recorded.
+// Setting the interval to 0 makes a last flush and stops the flush thread
+// until the profiler is enabled again. Nothing is flushed at static
+// destruction, the process calls Shutdown to flush the final histograms.
+class TEST_API OpSamplingProfiler {
+ public:
+  static OpSamplingProfiler& Instance();
+
+  static bool IsEnabled();
+
+  // Returns true if the current execution on this thread should be timed.
+  static bool ShouldSample();
+
+  // Thread-safe, records a sampled latency of op_name.
+  void Record(const std::string& op_name, uint64_t latency_ns);
+
+  // Returns the aggregated histograms of all threads in the Prometheus text
+  // exposition format.
+  std::string ExportText();
+
+  // Write the histograms to the profiler path, or to
+  // FLAGS_op_sampling_profiler_path if no sample has been recorded. The file
+  // is replaced atomically, so a scraper never reads a partial file.
+  void Flush();
+
+  // Stops the flush thread and writes the final histograms if any sample has
+  // been recorded. Paddle calls it at exit of the Python interpreter.
+  void Shutdown();
+
+  ~OpSamplingProfiler();
+
+ private:
+  struct ThreadOpStats {
+    // Guards the insertion of new ops against the exporter, the lookup of
+    // existing ops on the owner thread is lock-free.
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<OpLatencyHistogram>> ops;
+  };
+
+  OpSamplingProfiler() = default;
+  DISABLE_COPY_AND_ASSIGN(OpSamplingProfiler);
+
+  ThreadOpStats* GetThreadLocalStats();
+
+  void StartFlushThread();
+
+  void StopFlushThread();
+
+  void FlushTo(const std::string& path);
+
+  std::mutex mutex_;
+  // Hold the stats of all threads, so that the samples of exited threads are
+  // still exported.
+  std::vector<std::shared_ptr<ThreadOpStats>> thread_stats_;
+
+  // Guards starting and stopping the flush thread.
+  std::mutex thread_mutex_;
+  std::atomic<bool> flushing_{false};
+  std::thread flush_thread_;
+  // Guards path_ and stop_.
+  std::mutex flush_mutex_;
+  std::condition_variable flush_cv_;
+  std::string path_;
+  bool stop_{false};
+};
+
+// Times the scope if the current execution is sampled.
+class OpSamplingGuard {
+ public:
+  explicit OpSamplingGuard(const std::string& op_name) {
+    if (UNLIKELY(OpSamplingProfiler::IsEnabled()) &&
+        OpSamplingProfiler::ShouldSample()) {
+      op_name_ = &op_name;
+      start_ns_ = NowInNsec();
+    }
+  }
+
+  ~OpSamplingGuard() {
+    if (UNLIKELY(op_name_ != nullptr)) {
+      OpSamplingProfiler::Instance().Record(*op_name_,
+                                            NowInNsec() - start_ns_);
+    }
+  }
+
+  DISABLE_COPY_AND_ASSIGN(OpSamplingGuard);
+
+ private:
+  static uint64_t NowInNsec();
+
+  const std::string* op_name_{nullptr};
+  uint64_t start_ns_{0};
+};
+
+}  // namespace phi
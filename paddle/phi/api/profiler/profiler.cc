@@ -24,6 +24,7 @@ limitations under the License. */
 
 #include "paddle/phi/api/profiler/common_event.h"
 #include "paddle/phi/api/profiler/device_tracer.h"
+#include "paddle/phi/api/profiler/hardware_counters.h"
 #include "paddle/phi/api/profiler/host_event_recorder.h"
 #include "paddle/phi/api/profiler/host_tracer.h"
 #include "paddle/phi/api/profiler/profiler_helper.h"
@@ -128,6 +129,10 @@ RecordEvent::RecordEvent(const char *name,
   role_ = role;
   type_ = type;
   start_ns_ = PosixInNsec();
+  if (UNLIKELY(type == TracerEventType::Operator &&
+               HardwareCounterReader::IsEnabled())) {
+    StartHardwareCounters();
+  }
 }
 
 RecordEvent::RecordEvent(const std::string &name,
@@ -160,6 +165,10 @@ RecordEvent::RecordEvent(const std::string &name,
   role_ = role;
   type_ = type;
   start_ns_ = PosixInNsec();
+  if (UNLIKELY(type == TracerEventType::Operator &&
+               HardwareCounterReader::IsEnabled())) {
+    StartHardwareCounters();
+  }
 }
 
 RecordEvent::RecordEvent(const std::string &name,
@@ -194,6 +203,10 @@ RecordEvent::RecordEvent(const std::string &name,
   name_ = new std::string(name);
   start_ns_ = PosixInNsec();
   attr_ = new std::string(attr);
+  if (UNLIKELY(type == TracerEventType::Operator &&
+               HardwareCounterReader::IsEnabled())) {
+    StartHardwareCounters();
+  }
 }
 
 void RecordEvent::OriginalConstruct(const std::string &name,
@@ -215,6 +228,10 @@ void RecordEvent::OriginalConstruct(const std::string &name,
   *name_ = e->name();
 }
 
+void RecordEvent::StartHardwareCounters() {
+  has_hw_counters_ = HardwareCounterReader::Read(&hw_counters_start_);
+}
+
 void RecordEvent::End() {
 #ifndef _WIN32
 #ifdef PADDLE_WITH_CUDA
@@ -225,7 +242,19 @@ void RecordEvent::End() {
 #endif
 #endif
   if (LIKELY(FLAGS_enable_host_event_recorder_hook && is_enabled_)) {
+    HardwareCounters hw_counters;
+    bool has_hw_counters = UNLIKELY(has_hw_counters_) &&
+                           HardwareCounterReader::Read(&hw_counters);
     uint64_t end_ns = PosixInNsec();
+    if (has_hw_counters) {
+      hw_counters.cycles -= hw_counters_start_.cycles;
+      hw_counters.instructions -= hw_counters_start_.instructions;
+      hw_counters.llc_misses -= hw_counters_start_.llc_misses;
+      hw_counters.branch_misses -= hw_counters_start_.branch_misses;
+      HostEventRecorder<CommonHardwareCounterEvent>::GetInstance().RecordEvent(
+          start_ns_, end_ns, hw_counters);
+    }
+    has_hw_counters_ = false;
     if (LIKELY(shallow_copy_name_ != nullptr)) {
       HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
           shallow_copy_name_, start_ns_, end_ns, role_, type_);
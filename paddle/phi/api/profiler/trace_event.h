@@ -148,6 +148,16 @@ struct MemsetEventInfo {
   uint32_t value;
 };
 
+// Hardware performance counters of a host event, only available when the
+// tracer is started with hardware counters enabled on Linux.
+struct HardwareCounters {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  // last level cache misses
+  uint64_t llc_misses = 0;
+  uint64_t branch_misses = 0;
+};
+
 struct HostTraceEvent {
   HostTraceEvent() = default;
   HostTraceEvent(const std::string& name,
@@ -174,6 +184,10 @@ struct HostTraceEvent {
   uint64_t process_id;
   // thread id of the record
   uint64_t thread_id;
+  // whether hw_counters is valid
+  bool has_hw_counters = false;
+  // hardware counters accumulated during the record
+  HardwareCounters hw_counters;
 };
 
 struct RuntimeTraceEvent {
@@ -271,17 +271,12 @@ uint64_t Generator::Random64() {
 }
 
 std::pair<uint64_t, uint64_t> Generator::IncrementOffset(uint64_t increment) {
-#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
-    defined(PADDLE_WITH_CUSTOM_DEVICE) || defined(PADDLE_WITH_XPU)
+  // NOTE: the CPU Philox kernels also draw from (seed, offset).
   std::lock_guard<std::mutex> lock(mu_);
   uint64_t offset = state().offset;
   state().offset = offset + increment;
   print_state_info();
   return std::make_pair(state().seed, offset);
-#else
-  PADDLE_THROW(common::errors::PermissionDenied(
-      "Increment Offset only support in CUDA place"));
-#endif
 }
 
 }  // namespace phi
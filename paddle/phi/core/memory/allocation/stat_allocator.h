@@ -15,6 +15,7 @@
 #pragma once
 
 #include "paddle/phi/core/memory/allocation/allocator.h"
+#include "paddle/phi/core/memory/memory_attribution.h"
 #include "paddle/phi/core/memory/stats.h"
 #include "paddle/phi/core/platform/profiler/mem_tracing.h"
 
@@ -43,12 +44,27 @@ class StatAllocator : public Allocator {
                              allocation->place(),
                              allocation->size(),
                              phi::TracerMemEventType::Free);
+    if (UNLIKELY(MemoryAttribution::IsEnabled() ||
+                 MemoryAttribution::Instance().HasLiveBlocks())) {
+      MemoryAttribution::Instance().OnFree(allocation->ptr());
+    }
     underlying_allocator_->Free(allocation);
   }
 
   phi::Allocation* AllocateImpl(size_t size) override {
-    phi::Allocator::AllocationPtr allocation =
-        underlying_allocator_->Allocate(size);
+    phi::Allocator::AllocationPtr allocation;
+    if (UNLIKELY(MemoryAttribution::IsEnabled())) {
+      try {
+        allocation = underlying_allocator_->Allocate(size);
+      } catch (BadAlloc&) {
+        LOG(WARNING) << "Failed to allocate " << size
+                     << " bytes, the memory attribution is:\n"
+                     << MemoryAttribution::Instance().Summary();
+        throw;
+      }
+    } else {
+      allocation = underlying_allocator_->Allocate(size);
+    }
 
     const phi::Place& place = allocation->place();
     if (phi::is_cpu_place(place) || phi::is_cuda_pinned_place(place)) {
@@ -62,6 +78,10 @@ class StatAllocator : public Allocator {
                              allocation->place(),
                              allocation->size(),
                              phi::TracerMemEventType::Allocate);
+    if (UNLIKELY(MemoryAttribution::IsEnabled())) {
+      MemoryAttribution::Instance().OnAllocate(
+          allocation->ptr(), allocation->size(), place);
+    }
     return allocation.release();
   }
 
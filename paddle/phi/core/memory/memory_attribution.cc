@@ -0,0 +1,390 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/memory_attribution.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/stats.h"
+#include "paddle/phi/core/os_info.h"
+#include "paddle/utils/string/printf.h"
+
+PHI_DEFINE_EXPORTED_bool(
+    enable_memory_attribution,
+    false,
+    "Attribute each allocation to the instruction that makes it, and record "
+    "a memory timeline of the executed instructions, just used for debug.");
+
+namespace paddle::memory {
+
+namespace {
+
+// Stop recording the timeline when it is too long, the attribution of the
+// allocations is still updated.
+constexpr size_t kMaxTimelineSamples = 1 << 20;
+
+struct ThreadAttributionState {
+  int tag = MemoryAttribution::kUntagged;
+  int64_t alloc_bytes = 0;
+  int64_t free_bytes = 0;
+};
+
+ThreadAttributionState& GetThreadState() {
+  static thread_local ThreadAttributionState state;
+  return state;
+}
+
+bool IsHostPlace(const phi::Place& place) {
+  return phi::is_cpu_place(place) || phi::is_cuda_pinned_place(place);
+}
+
+int64_t AllocatedBytes(const phi::Place& place) {
+  return IsHostPlace(place)
+             ? HostMemoryStatCurrentValue("Allocated", 0)
+             : DeviceMemoryStatCurrentValue("Allocated", place.GetDeviceId());
+}
+
+int64_t ReservedBytes(const phi::Place& place) {
+  return IsHostPlace(place)
+             ? HostMemoryStatCurrentValue("Reserved", 0)
+             : DeviceMemoryStatCurrentValue("Reserved", place.GetDeviceId());
+}
+
+double Fragmentation(int64_t allocated, int64_t reserved) {
+  return reserved > 0 ? 1.0 - static_cast<double>(allocated) / reserved : 0.0;
+}
+
+std::string FormatMB(int64_t bytes) {
+  return string::Sprintf("%.2f MB", static_cast<double>(bytes) / 1024 / 1024);
+}
+
+}  // namespace
+
+MemoryAttribution::MemoryAttribution() {
+  tag_names_.emplace_back("<untagged>");
+  tag_alloc_count_.push_back(0);
+  tag_alloc_bytes_.push_back(0);
+}
+
+MemoryAttribution& MemoryAttribution::Instance() {
+  static MemoryAttribution instance;
+  return instance;
+}
+
+bool MemoryAttribution::IsEnabled() { return FLAGS_enable_memory_attribution; }
+
+int MemoryAttribution::GetTag(const std::string& op_name, int64_t instr_id) {
+  std::string name = op_name + "(" + std::to_string(instr_id) + ")";
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto iter = tag_index_.find(name);
+  if (iter != tag_index_.end()) {
+    return iter->second;
+  }
+  int tag = static_cast<int>(tag_names_.size());
+  tag_names_.emplace_back(name);
+  tag_alloc_count_.push_back(0);
+  tag_alloc_bytes_.push_back(0);
+  tag_index_.emplace(std::move(name), tag);
+  return tag;
+}
+
+void MemoryAttribution::OnAllocate(const void* ptr,
+                                   size_t size,
+                                   const phi::Place& place) {
+  auto& thread_state = GetThreadState();
+  thread_state.alloc_bytes += static_cast<int64_t>(size);
+  int tag = thread_state.tag;
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  blocks_[ptr] = Block{tag, static_cast<int64_t>(size), place};
+  num_blocks_.store(blocks_.size(), std::memory_order_relaxed);
+  tag_alloc_count_[tag] += 1;
+  tag_alloc_bytes_[tag] += static_cast<int64_t>(size);
+
+  auto& state = places_[place];
+  if (state.tag_live_bytes.size() < tag_names_.size()) {
+    state.tag_live_bytes.resize(tag_names_.size(), 0);
+  }
+  state.tag_live_bytes[tag] += static_cast<int64_t>(size);
+  state.live_bytes += static_cast<int64_t>(size);
+  if (state.live_bytes > state.peak_bytes) {
+    state.peak_bytes = state.live_bytes;
+    state.tag_live_bytes_at_peak = state.tag_live_bytes;
+    state.allocated_at_peak = AllocatedBytes(place);
+    state.reserved_at_peak = ReservedBytes(place);
+  }
+}
+
+void MemoryAttribution::OnFree(const void* ptr) {
+  int64_t size = 0;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto iter = blocks_.find(ptr);
+    // allocated before attribution is enabled
+    if (iter == blocks_.end()) {
+      return;
+    }
+    const Block& block = iter->second;
+    size = block.size;
+    auto& state = places_[block.place];
+    state.tag_live_bytes[block.tag] -= size;
+    state.live_bytes -= size;
+    blocks_.erase(iter);
+    num_blocks_.store(blocks_.size(), std::memory_order_relaxed);
+  }
+  GetThreadState().free_bytes += size;
+}
+
+void MemoryAttribution::AddTimelineSample(const TimelineSample& sample) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (timeline_.size() >= kMaxTimelineSamples) {
+    LOG_FIRST_N(WARNING, 1) << "The memory timeline exceeds "
+                            << kMaxTimelineSamples
+                            << " instructions, the following instructions "
+                               "are not recorded.";
+    return;
+  }
+  timeline_.push_back(sample);
+  timeline_.back().live_bytes = places_[sample.place].live_bytes;
+}
+
+std::map<phi::Place, MemoryAttribution::PlaceStat>
+MemoryAttribution::GetPlaceStats() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::map<phi::Place, PlaceStat> stats;
+  for (const auto& [place, state] : places_) {
+    PlaceStat& stat = stats[place];
+    stat.live_bytes = state.live_bytes;
+    stat.peak_bytes = state.peak_bytes;
+    stat.allocated_at_peak = state.allocated_at_peak;
+    stat.reserved_at_peak = state.reserved_at_peak;
+    for (size_t tag = 0; tag < state.tag_live_bytes.size(); ++tag) {
+      int64_t live_at_peak = tag < state.tag_live_bytes_at_peak.size()
+                                 ? state.tag_live_bytes_at_peak[tag]
+                                 : 0;
+      if (live_at_peak == 0 && state.tag_live_bytes[tag] == 0) {
+        continue;
+      }
+      OpStat op;
+      op.name = tag_names_[tag];
+      op.alloc_count = tag_alloc_count_[tag];
+      op.alloc_bytes = tag_alloc_bytes_[tag];
+      op.live_bytes = state.tag_live_bytes[tag];
+      op.live_bytes_at_peak = live_at_peak;
+      stat.ops.emplace_back(std::move(op));
+    }
+    std::stable_sort(stat.ops.begin(),
+                     stat.ops.end(),
+                     [](const OpStat& a, const OpStat& b) {
+                       return a.live_bytes_at_peak > b.live_bytes_at_peak;
+                     });
+  }
+  return stats;
+}
+
+std::string MemoryAttribution::Summary(size_t top_k) {
+  std::ostringstream os;
+  for (const auto& [place, stat] : GetPlaceStats()) {
+    os << "---------- Memory attribution of " << place << " ----------\n"
+       << "Peak attributed memory: " << FormatMB(stat.peak_bytes)
+       << ", current: " << FormatMB(stat.live_bytes) << "\n"
+       << "Allocated / reserved at peak: " << FormatMB(stat.allocated_at_peak)
+       << " / " << FormatMB(stat.reserved_at_peak) << ", fragmentation: "
+       << string::Sprintf(
+              "%.2f%%",
+              Fragmentation(stat.allocated_at_peak, stat.reserved_at_peak) *
+                  100)
+       << "\n"
+       << "Top contributors at peak:\n";
+    os << std::left << std::setw(48) << "Op" << std::right << std::setw(16)
+       << "Live at peak" << std::setw(10) << "Ratio" << std::setw(12)
+       << "Allocs" << std::setw(16) << "Allocated" << std::setw(16) << "Live"
+       << "\n";
+    for (size_t i = 0; i < stat.ops.size() && i < top_k; ++i) {
+      const OpStat& op = stat.ops[i];
+      double ratio = stat.peak_bytes > 0 ? static_cast<double>(
+                                               op.live_bytes_at_peak) /
+                                               stat.peak_bytes * 100
+                                         : 0.0;
+      os << std::left << std::setw(48) << op.name << std::right
+         << std::setw(16) << FormatMB(op.live_bytes_at_peak) << std::setw(10)
+         << string::Sprintf("%.2f%%", ratio) << std::setw(12) << op.alloc_count
+         << std::setw(16) << FormatMB(op.alloc_bytes) << std::setw(16)
+         << FormatMB(op.live_bytes) << "\n";
+    }
+  }
+  return os.str();
+}
+
+std::string MemoryAttribution::ChromeTraceEvents(uint64_t start_ns) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  uint32_t pid = phi::GetProcessId();
+  std::ostringstream os;
+  for (const auto& sample : timeline_) {
+    if (sample.end_ns < start_ns) {
+      continue;
+    }
+    std::string place = sample.place.DebugString();
+    os << string::Sprintf(
+        R"JSON(
+  {
+    "name": "%s", "pid": %d, "tid": "%d(Memory)",
+    "ts": %d, "dur": %.3f,
+    "ph": "X", "cat": "MemoryAttribution",
+    "args": {
+      "place": "%s",
+      "alloc_bytes": %d,
+      "free_bytes": %d
+    }
+  },
+  {
+    "name": "Memory %s", "pid": %d,
+    "ts": %d,
+    "ph": "C", "cat": "MemoryAttribution",
+    "args": {
+      "live": %d,
+      "allocated": %d,
+      "reserved": %d
+    }
+  },
+  {
+    "name": "Fragmentation %s", "pid": %d,
+    "ts": %d,
+    "ph": "C", "cat": "MemoryAttribution",
+    "args": {
+      "fragmentation": %.4f
+    }
+  },)JSON",
+        tag_names_[sample.tag],
+        pid,
+        sample.thread_id,
+        sample.start_ns / 1000,
+        static_cast<double>(sample.end_ns - sample.start_ns) / 1000,
+        place,
+        sample.alloc_bytes,
+        sample.free_bytes,
+        place,
+        pid,
+        sample.end_ns / 1000,
+        sample.live_bytes,
+        sample.allocated,
+        sample.reserved,
+        place,
+        pid,
+        sample.end_ns / 1000,
+        Fragmentation(sample.allocated, sample.reserved));
+  }
+  return os.str();
+}
+
+void MemoryAttribution::ExportChromeTrace(const std::string& path) {
+  std::ofstream ofs(path, std::ios::out | std::ios::trunc);
+  PADDLE_ENFORCE_EQ(ofs.is_open(),
+                    true,
+                    common::errors::Unavailable(
+                        "Failed to open %s to export the memory timeline.",
+                        path));
+  ofs << R"JSON({
+  "displayTimeUnit": "ms",
+  "traceEvents": [)JSON"
+      << ChromeTraceEvents();
+  // peak contributors are shown as the metadata of the process
+  std::ostringstream contributors;
+  for (const auto& [place, stat] : GetPlaceStats()) {
+    contributors << place << ": peak " << FormatMB(stat.peak_bytes) << "; ";
+    for (size_t i = 0; i < stat.ops.size() && i < 10; ++i) {
+      contributors << stat.ops[i].name << " "
+                   << FormatMB(stat.ops[i].live_bytes_at_peak) << "; ";
+    }
+  }
+  ofs << string::Sprintf(
+      R"JSON(
+  {
+    "name": "process_labels", "pid": %d,
+    "ph": "M",
+    "args": {
+      "labels": "%s"
+    }
+  }
+  ]
+}
+)JSON",
+      phi::GetProcessId(),
+      contributors.str());
+}
+
+void MemoryAttribution::Reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& [place, state] : places_) {
+    state.peak_bytes = state.live_bytes;
+    state.tag_live_bytes_at_peak = state.tag_live_bytes;
+    state.allocated_at_peak = AllocatedBytes(place);
+    state.reserved_at_peak = ReservedBytes(place);
+  }
+  std::fill(tag_alloc_count_.begin(), tag_alloc_count_.end(), 0);
+  std::fill(tag_alloc_bytes_.begin(), tag_alloc_bytes_.end(), 0);
+  timeline_.clear();
+}
+
+MemoryAttributionGuard::MemoryAttributionGuard(const std::string& op_name,
+                                               int64_t instr_id,
+                                               const phi::Place& place) {
+  if (!MemoryAttribution::IsEnabled()) {
+    return;
+  }
+  enabled_ = true;
+  auto& state = GetThreadState();
+  prev_tag_ = state.tag;
+  prev_alloc_bytes_ = state.alloc_bytes;
+  prev_free_bytes_ = state.free_bytes;
+  state.tag = MemoryAttribution::Instance().GetTag(op_name, instr_id);
+  state.alloc_bytes = 0;
+  state.free_bytes = 0;
+  place_ = place;
+  start_ns_ = phi::PosixInNsec();
+}
+
+MemoryAttributionGuard::~MemoryAttributionGuard() {
+  if (!enabled_) {
+    return;
+  }
+  auto& state = GetThreadState();
+  MemoryAttribution::TimelineSample sample;
+  sample.tag = state.tag;
+  sample.place = place_;
+  sample.thread_id = phi::GetCurrentThreadSysId();
+  sample.start_ns = start_ns_;
+  sample.end_ns = phi::PosixInNsec();
+  sample.alloc_bytes = state.alloc_bytes;
+  sample.free_bytes = state.free_bytes;
+  sample.live_bytes = 0;
+  sample.allocated = AllocatedBytes(place_);
+  sample.reserved = ReservedBytes(place_);
+  MemoryAttribution::Instance().AddTimelineSample(sample);
+
+  // the memory of a nested instruction also counts for the outer one
+  state.tag = prev_tag_;
+  state.alloc_bytes += prev_alloc_bytes_;
+  state.free_bytes += prev_free_bytes_;
+}
+
+int MemoryAttributionGuard::CurrentTag() { return GetThreadState().tag; }
+
+}  // namespace paddle::memory
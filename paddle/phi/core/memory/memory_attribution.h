@@ -0,0 +1,174 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/utils/test_macros.h"
+
+namespace paddle {
+namespace memory {
+
+// Attributes every allocation made through StatAllocator to the instruction
+// running on the current thread, so that the contributors of a memory peak
+// can be found after an OOM. Enabled by FLAGS_enable_memory_attribution, it
+// takes a global lock on every allocation and is meant for debugging only.
+class TEST_API MemoryAttribution {
+ public:
+  static constexpr int kUntagged = 0;
+
+  struct OpStat {
+    // "<op name>(<instruction id>)", or "<untagged>"
+    std::string name;
+    int64_t alloc_count = 0;
+    int64_t alloc_bytes = 0;
+    // bytes allocated by the op and not freed yet
+    int64_t live_bytes = 0;
+    // live bytes of the op when the peak of its place was reached
+    int64_t live_bytes_at_peak = 0;
+  };
+
+  struct PlaceStat {
+    // bytes allocated while attribution is enabled and not freed yet
+    int64_t live_bytes = 0;
+    int64_t peak_bytes = 0;
+    // allocated and reserved bytes of the allocator when the peak is reached,
+    // including the memory allocated before attribution is enabled
+    int64_t allocated_at_peak = 0;
+    int64_t reserved_at_peak = 0;
+    // ops ordered by live_bytes_at_peak
+    std::vector<OpStat> ops;
+  };
+
+  // One executed instruction in the memory timeline.
+  struct TimelineSample {
+    int tag;
+    phi::Place place;
+    uint64_t thread_id;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    // bytes allocated and freed while the instruction runs
+    int64_t alloc_bytes;
+    int64_t free_bytes;
+    // attributed live bytes of the place after the instruction
+    int64_t live_bytes;
+    // allocator stats after the instruction
+    int64_t allocated;
+    int64_t reserved;
+  };
+
+  static MemoryAttribution& Instance();
+
+  static bool IsEnabled();
+
+  // Returns the tag of an instruction, creates it if not exists.
+  int GetTag(const std::string& op_name, int64_t instr_id);
+
+  void OnAllocate(const void* ptr, size_t size, const phi::Place& place);
+
+  void OnFree(const void* ptr);
+
+  // Returns true if a block allocated while attribution was enabled is not
+  // freed yet. Its free is still reported after attribution is disabled, so
+  // that the block does not stay in the tracker.
+  bool HasLiveBlocks() const {
+    return num_blocks_.load(std::memory_order_relaxed) > 0;
+  }
+
+  void AddTimelineSample(const TimelineSample& sample);
+
+  std::map<phi::Place, PlaceStat> GetPlaceStats();
+
+  // Human readable report of the peak contributors of each place, top_k ops
+  // are listed for each place.
+  std::string Summary(size_t top_k = 20);
+
+  // Returns the timeline samples ended after start_ns as Chrome Trace Event
+  // objects, each one is followed by a comma, so that they can be appended to
+  // the "traceEvents" list of the profiler's trace.
+  std::string ChromeTraceEvents(uint64_t start_ns = 0);
+
+  // Write the timeline and the peak contributors to a standalone Chrome
+  // Trace file.
+  void ExportChromeTrace(const std::string& path);
+
+  void Reset();
+
+ private:
+  struct Block {
+    int tag;
+    int64_t size;
+    phi::Place place;
+  };
+
+  struct PlaceState {
+    int64_t live_bytes = 0;
+    int64_t peak_bytes = 0;
+    int64_t allocated_at_peak = 0;
+    int64_t reserved_at_peak = 0;
+    // indexed by tag
+    std::vector<int64_t> tag_live_bytes;
+    std::vector<int64_t> tag_live_bytes_at_peak;
+  };
+
+  MemoryAttribution();
+  DISABLE_COPY_AND_ASSIGN(MemoryAttribution);
+
+  std::mutex mutex_;
+  std::vector<std::string> tag_names_;
+  std::unordered_map<std::string, int> tag_index_;
+  std::vector<int64_t> tag_alloc_count_;
+  std::vector<int64_t> tag_alloc_bytes_;
+  std::unordered_map<const void*, Block> blocks_;
+  // size of blocks_, read without the lock
+  std::atomic<size_t> num_blocks_{0};
+  std::map<phi::Place, PlaceState> places_;
+  std::vector<TimelineSample> timeline_;
+};
+
+// Attributes the allocations of the current thread to an instruction in the
+// scope, and appends the instruction to the memory timeline at the end.
+class TEST_API MemoryAttributionGuard {
+ public:
+  MemoryAttributionGuard(const std::string& op_name,
+                         int64_t instr_id,
+                         const phi::Place& place);
+
+  ~MemoryAttributionGuard();
+
+  DISABLE_COPY_AND_ASSIGN(MemoryAttributionGuard);
+
+  // Tag of the instruction running on the current thread.
+  static int CurrentTag();
+
+ private:
+  bool enabled_{false};
+  int prev_tag_{MemoryAttribution::kUntagged};
+  int64_t prev_alloc_bytes_{0};
+  int64_t prev_free_bytes_{0};
+  phi::Place place_;
+  uint64_t start_ns_{0};
+};
+
+}  // namespace memory
+}  // namespace paddle
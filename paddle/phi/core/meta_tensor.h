@@ -21,6 +21,14 @@ limitations under the License. */
 #include "paddle/phi/core/tensor_base.h"
 #include "paddle/phi/core/tensor_meta.h"
 
+namespace paddle {
+namespace framework {
+namespace interpreter {
+class InferMetaReplayer;
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
+
 namespace phi {
 
 struct TEST_API MetaConfig {
@@ -111,6 +119,11 @@ class TEST_API MetaTensor {
 
   TensorBase* tensor_ = nullptr;
   bool strided_kernel_used_ = false;
+
+ private:
+  // Reads and writes the metas of the wrapped DenseTensors to replay the
+  // results of InferMeta in the executor.
+  friend class paddle::framework::interpreter::InferMetaReplayer;
 };
 
 }  // namespace phi
@@ -17,6 +17,7 @@
 #include <codecvt>
 #include <iostream>
 #include <locale>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -25,6 +26,10 @@
 #include "paddle/phi/core/vocab/phi_tensor_base_vector.h"
 
 namespace phi {
+namespace funcs {
+class WordPieceTrie;
+}  // namespace funcs
+
 template <>
 struct PhiVectorType<std::string> {
   const char* type_name = "PhiVectorString";
@@ -50,6 +55,7 @@ class Vocab : public phi::ExtendedTensor,
   Vocab& operator=(
       const std::unordered_map<std::wstring, std::int32_t>& other) {
     this->data_ = other;
+    set_wordpiece_trie(nullptr);
     return *this;
   }
 
@@ -63,10 +69,14 @@ class Vocab : public phi::ExtendedTensor,
 
   size_t size() const { return data_.size(); }
 
-  void clear() { data_.clear(); }
+  void clear() {
+    data_.clear();
+    set_wordpiece_trie(nullptr);
+  }
 
   void emplace(const std::wstring& key, std::int32_t value) {
     data_.emplace(key, value);
+    set_wordpiece_trie(nullptr);
   }
 
   std::int32_t at(const std::wstring& key) { return data_.at(key); }
@@ -99,8 +109,22 @@ class Vocab : public phi::ExtendedTensor,
     return data_.end();
   }
 
+  /// \brief The WordPiece trie of faster_tokenizer built from this vocab,
+  /// or null. It lives as long as the vocab and is dropped by emplace, clear
+  /// and the assignment of a map. Code writing the ids through the iterators
+  /// must drop it with set_wordpiece_trie(nullptr).
+  std::shared_ptr<const funcs::WordPieceTrie> wordpiece_trie() const {
+    return std::atomic_load(&wordpiece_trie_);
+  }
+
+  void set_wordpiece_trie(
+      std::shared_ptr<const funcs::WordPieceTrie> trie) const {
+    std::atomic_store(&wordpiece_trie_, std::move(trie));
+  }
+
  private:
   std::unordered_map<std::wstring, std::int32_t> data_;
+  mutable std::shared_ptr<const funcs::WordPieceTrie> wordpiece_trie_;
 };
 
 // Note(YuanRisheng): PhiVector is essentially a vector that only used for PHI
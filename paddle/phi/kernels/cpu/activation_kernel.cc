@@ -17,17 +17,44 @@ limitations under the License. */
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/activation_functor.h"
+#include "paddle/phi/kernels/funcs/half_cpu_function.h"
 #include "paddle/phi/kernels/impl/activation_impl.h"
 
 namespace phi {
 
+// bfloat16 and float16 activations run the float functor, see
+// CPUActivationImpl.
+template <typename T>
+using CPUActivationType =
+    std::conditional_t<funcs::IsCPUHalf<T>::value, float, T>;
+
+template <typename T, typename Context, typename Functor>
+void CPUActivationImpl(const Context& dev_ctx,
+                       const DenseTensor& x,
+                       DenseTensor* out,
+                       const Functor& functor) {
+  if constexpr (funcs::IsCPUHalf<T>::value) {
+    const T* x_data = x.data<T>();
+    T* out_data = dev_ctx.template Alloc<T>(out);
+    auto& place = *dev_ctx.eigen_device();
+    funcs::HalfBlockForEach(x.numel(), [&](int64_t begin, int64_t size) {
+      float buffer[funcs::kCPUHalfBlock];
+      funcs::HalfToFloat(x_data + begin, size, buffer);
+      typename EigenVector<float>::Type block(buffer, size);
+      functor(place, block, block);
+      funcs::FloatToHalf(buffer, size, out_data + begin);
+    });
+  } else {
+    ActivationImpl<T, T, Context, Functor>(dev_ctx, x, out, functor);
+  }
+}
+
 #define DEFINE_CPU_ACTIVATION_KERNEL(name, functor_class)               \
   template <typename T, typename Context>                               \
   void name##Kernel(                                                    \
       const Context& dev_ctx, const DenseTensor& x, DenseTensor* out) { \
-    funcs::functor_class<T> functor;                                    \
-    ActivationImpl<T, T, Context, funcs::functor_class<T>>(             \
-        dev_ctx, x, out, functor);                                      \
+    funcs::functor_class<CPUActivationType<T>> functor;                 \
+    CPUActivationImpl<T>(dev_ctx, x, out, functor);                     \
   }
 
 #define DEFINE_CPU_ACTIVATION_KERNEL_WITH_INT_IN_FLOAT_OUT(name,           \
@@ -48,27 +75,25 @@ namespace phi {
                     const DenseTensor& x,                               \
                     float attr,                                         \
                     DenseTensor* out) {                                 \
-    funcs::functor_class<T> functor;                                    \
+    funcs::functor_class<CPUActivationType<T>> functor;                 \
     auto attrs = functor.GetAttrs();                                    \
     *(attrs[0].second) = attr;                                          \
-    ActivationImpl<T, T, Context, funcs::functor_class<T>>(             \
-        dev_ctx, x, out, functor);                                      \
+    CPUActivationImpl<T>(dev_ctx, x, out, functor);                     \
   }
 
-#define DEFINE_CPU_ACT_KERNEL_WITH_TWO_ATTRS(               \
-    name, functor_class, attr1, attr2)                      \
-  template <typename T, typename Context>                   \
-  void name##Kernel(const Context& dev_ctx,                 \
-                    const DenseTensor& x,                   \
-                    float attr1,                            \
-                    float attr2,                            \
-                    DenseTensor* out) {                     \
-    funcs::functor_class<T> functor;                        \
-    auto attrs = functor.GetAttrs();                        \
-    *(attrs[0].second) = attr1;                             \
-    *(attrs[1].second) = attr2;                             \
-    ActivationImpl<T, T, Context, funcs::functor_class<T>>( \
-        dev_ctx, x, out, functor);                          \
+#define DEFINE_CPU_ACT_KERNEL_WITH_TWO_ATTRS(           \
+    name, functor_class, attr1, attr2)                  \
+  template <typename T, typename Context>               \
+  void name##Kernel(const Context& dev_ctx,             \
+                    const DenseTensor& x,               \
+                    float attr1,                        \
+                    float attr2,                        \
+                    DenseTensor* out) {                 \
+    funcs::functor_class<CPUActivationType<T>> functor; \
+    auto attrs = functor.GetAttrs();                    \
+    *(attrs[0].second) = attr1;                         \
+    *(attrs[1].second) = attr2;                         \
+    CPUActivationImpl<T>(dev_ctx, x, out, functor);     \
   }
 
 DEFINE_CPU_ACTIVATION_KERNEL(Sin, SinFunctor)
@@ -127,7 +152,7 @@ template <typename T, typename Context>
 void HardSwishKernel(const Context& dev_ctx,
                      const DenseTensor& x,
                      DenseTensor* out) {
-  funcs::HardSwishFunctor<T> functor;
+  funcs::HardSwishFunctor<CPUActivationType<T>> functor;
   float threshold = 6;
   float scale = 6;
   float offset = 3;
@@ -135,30 +160,27 @@ void HardSwishKernel(const Context& dev_ctx,
   *(attrs[0].second) = threshold;
   *(attrs[1].second) = scale;
   *(attrs[2].second) = offset;
-  ActivationImpl<T, T, Context, funcs::HardSwishFunctor<T>>(
-      dev_ctx, x, out, functor);
+  CPUActivationImpl<T>(dev_ctx, x, out, functor);
 }
 
 template <typename T, typename Context>
 void SwishKernel(const Context& dev_ctx,
                  const DenseTensor& x,
                  DenseTensor* out) {
-  funcs::SwishFunctor<T> functor;
+  funcs::SwishFunctor<CPUActivationType<T>> functor;
   auto attrs = functor.GetAttrs();
   *(attrs[0].second) = 1.0;
-  ActivationImpl<T, T, Context, funcs::SwishFunctor<T>>(
-      dev_ctx, x, out, functor);
+  CPUActivationImpl<T>(dev_ctx, x, out, functor);
 }
 
 template <typename T, typename Context>
 void Relu6Kernel(const Context& dev_ctx,
                  const DenseTensor& x,
                  DenseTensor* out) {
-  funcs::Relu6Functor<T> functor;
+  funcs::Relu6Functor<CPUActivationType<T>> functor;
   auto attrs = functor.GetAttrs();
   *(attrs[0].second) = 6.0;
-  ActivationImpl<T, T, Context, funcs::Relu6Functor<T>>(
-      dev_ctx, x, out, functor);
+  CPUActivationImpl<T>(dev_ctx, x, out, functor);
 }
 
 template <typename T, typename Context>
@@ -166,18 +188,31 @@ void RoundKernel(const Context& dev_ctx,
                  const DenseTensor& x,
                  const int decimals,
                  DenseTensor* out) {
-  funcs::RoundFunctor<T> functor;
+  funcs::RoundFunctor<CPUActivationType<T>> functor;
   auto attrs = functor.GetAttrs();
   *(attrs[0].second) = decimals;
-  ActivationImpl<T, T, Context, funcs::RoundFunctor<T>>(
-      dev_ctx, x, out, functor);
+  CPUActivationImpl<T>(dev_ctx, x, out, functor);
 }
 
 }  // namespace phi
-PD_REGISTER_KERNEL(relu, CPU, ALL_LAYOUT, phi::ReluKernel, float, double) {}
+PD_REGISTER_KERNEL(relu,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::ReluKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
 
 #define PD_REGISTER_ACTIVATION_KERNEL(name, func) \
-  PD_REGISTER_KERNEL(name, CPU, ALL_LAYOUT, phi::func, float, double) {}
+  PD_REGISTER_KERNEL(name,                        \
+                     CPU,                         \
+                     ALL_LAYOUT,                  \
+                     phi::func,                   \
+                     float,                       \
+                     double,                      \
+                     phi::dtype::float16,         \
+                     phi::dtype::bfloat16) {}
 
 #define PD_REGISTER_ACTIVATION_KERNEL_WITH_COMPLEX(name, func) \
   PD_REGISTER_KERNEL(name,                                     \
@@ -186,6 +221,8 @@ PD_REGISTER_KERNEL(relu, CPU, ALL_LAYOUT, phi::ReluKernel, float, double) {}
                      phi::func,                                \
                      float,                                    \
                      double,                                   \
+                     phi::dtype::float16,                      \
+                     phi::dtype::bfloat16,                     \
                      phi::dtype::complex<float>,               \
                      phi::dtype::complex<double>) {}
 
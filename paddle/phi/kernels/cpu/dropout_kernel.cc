@@ -19,6 +19,7 @@
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/expand_kernel.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
+#include "paddle/phi/kernels/funcs/random_cpu_function.h"
 
 namespace phi {
 
@@ -82,6 +83,25 @@ void DropoutRawKernel(const Context& dev_ctx,
     } else {
       seed_data = fix_seed ? seed : 0;
     }
+    if (funcs::UseCPUPhilox()) {
+      auto seed_offset =
+          funcs::PhiloxSeedOffset(dev_ctx.GetGenerator(),
+                                  seed_data,
+                                  funcs::PhiloxNumBlocks<float>(size));
+      funcs::PhiloxUniformForEach<float>(
+          seed_offset.first, seed_offset.second, size, [&](int64_t i, float u) {
+            if (u < dropout_prob) {
+              mask_data[i] = 0;
+              y_data[i] = 0;
+            } else {
+              mask_data[i] = 1;
+              y_data[i] = upscale_in_train
+                              ? x_data[i] / static_cast<T>(1.0f - dropout_prob)
+                              : x_data[i];
+            }
+          });
+      return;
+    }
     std::shared_ptr<std::mt19937_64> engine;
     if (seed_data) {
       engine = std::make_shared<std::mt19937_64>();
@@ -153,23 +173,32 @@ void DropoutNdKernel(const Context& dev_ctx,
     } else {
       seed_data = fix_seed ? seed : 0;
     }
-    std::shared_ptr<std::mt19937_64> engine;
-    if (seed_data) {
-      engine = std::make_shared<std::mt19937_64>();
-      engine->seed(seed_data);
+    auto set_mask = [&](size_t i, bool keep) {
+      t_mask_data[i] = keep ? static_cast<T>(1) : static_cast<T>(0);
+      mask_data[i] = keep;
+    };
+    if (funcs::UseCPUPhilox()) {
+      auto seed_offset =
+          funcs::PhiloxSeedOffset(dev_ctx.GetGenerator(),
+                                  seed_data,
+                                  funcs::PhiloxNumBlocks<float>(size));
+      funcs::PhiloxUniformForEach<float>(
+          seed_offset.first, seed_offset.second, size, [&](int64_t i, float u) {
+            set_mask(i, u >= dropout_prob);
+          });
     } else {
-      engine = dev_ctx.GetGenerator()->GetCPUEngine();
-    }
+      std::shared_ptr<std::mt19937_64> engine;
+      if (seed_data) {
+        engine = std::make_shared<std::mt19937_64>();
+        engine->seed(seed_data);
+      } else {
+        engine = dev_ctx.GetGenerator()->GetCPUEngine();
+      }
 
-    std::uniform_real_distribution<float> dist(0, 1);
+      std::uniform_real_distribution<float> dist(0, 1);
 
-    for (size_t i = 0; i < size; ++i) {
-      if (dist(*engine) < dropout_prob) {
-        t_mask_data[i] = 0;
-        mask_data[i] = 0;
-      } else {
-        t_mask_data[i] = 1;
-        mask_data[i] = 1;
+      for (size_t i = 0; i < size; ++i) {
+        set_mask(i, dist(*engine) >= dropout_prob);
       }
     }
     auto& x_dims = x.dims();
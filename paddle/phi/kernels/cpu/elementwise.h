@@ -20,6 +20,7 @@ limitations under the License. */
 #include "paddle/phi/kernels/funcs/broadcast_function.h"
 #include "paddle/phi/kernels/funcs/common_shape.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
+#include "paddle/phi/kernels/funcs/half_cpu_function.h"
 
 namespace phi {
 
@@ -38,7 +39,8 @@ template <typename DevCtx, typename T>
 struct SameDimsAddFunctor<
     DevCtx,
     T,
-    typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    typename std::enable_if<std::is_floating_point<T>::value &&
+                            !funcs::IsCPUHalf<T>::value>::type> {
   void operator()(const DevCtx& dev_ctx,
                   const DenseTensor& x,
                   const DenseTensor& y,
@@ -67,6 +69,24 @@ struct SameDimsAddFunctor<
   }
 };
 
+// bfloat16 and float16 compute in float, see funcs::HalfBinaryCompute.
+template <typename DevCtx, typename T>
+struct SameDimsAddFunctor<
+    DevCtx,
+    T,
+    typename std::enable_if<funcs::IsCPUHalf<T>::value>::type> {
+  void operator()(const DevCtx& dev_ctx,
+                  const DenseTensor& x,
+                  const DenseTensor& y,
+                  DenseTensor* z) {
+    funcs::HalfBinaryCompute(x.data<T>(),
+                             y.data<T>(),
+                             dev_ctx.template Alloc<T>(z),
+                             x.numel(),
+                             [](float a, float b) { return a + b; });
+  }
+};
+
 // Subtract
 template <typename DevCtx, typename T, class Enable = void>
 struct SameDimsSubtractFunctor {
@@ -80,7 +100,8 @@ template <typename DevCtx, typename T>
 struct SameDimsSubtractFunctor<
     DevCtx,
     T,
-    typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    typename std::enable_if<std::is_floating_point<T>::value &&
+                            !funcs::IsCPUHalf<T>::value>::type> {
   void operator()(const DevCtx& dev_ctx,
                   const DenseTensor& x,
                   const DenseTensor& y,
@@ -108,6 +129,24 @@ struct SameDimsSubtractFunctor<
   }
 };
 
+// bfloat16 and float16 compute in float, see funcs::HalfBinaryCompute.
+template <typename DevCtx, typename T>
+struct SameDimsSubtractFunctor<
+    DevCtx,
+    T,
+    typename std::enable_if<funcs::IsCPUHalf<T>::value>::type> {
+  void operator()(const DevCtx& dev_ctx,
+                  const DenseTensor& x,
+                  const DenseTensor& y,
+                  DenseTensor* z) {
+    funcs::HalfBinaryCompute(x.data<T>(),
+                             y.data<T>(),
+                             dev_ctx.template Alloc<T>(z),
+                             x.numel(),
+                             [](float a, float b) { return a - b; });
+  }
+};
+
 // Divide
 template <typename DevCtx, typename T, class Enable = void>
 struct SameDimsDivideFunctor {
@@ -136,7 +175,8 @@ template <typename DevCtx, typename T>
 struct SameDimsDivideFunctor<
     DevCtx,
     T,
-    typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    typename std::enable_if<std::is_floating_point<T>::value &&
+                            !funcs::IsCPUHalf<T>::value>::type> {
   void operator()(const DevCtx& dev_ctx,
                   const DenseTensor& x,
                   const DenseTensor& y,
@@ -147,6 +187,24 @@ struct SameDimsDivideFunctor<
   }
 };
 
+// bfloat16 and float16 compute in float, see funcs::HalfBinaryCompute.
+template <typename DevCtx, typename T>
+struct SameDimsDivideFunctor<
+    DevCtx,
+    T,
+    typename std::enable_if<funcs::IsCPUHalf<T>::value>::type> {
+  void operator()(const DevCtx& dev_ctx,
+                  const DenseTensor& x,
+                  const DenseTensor& y,
+                  DenseTensor* z) {
+    funcs::HalfBinaryCompute(x.data<T>(),
+                             y.data<T>(),
+                             dev_ctx.template Alloc<T>(z),
+                             x.numel(),
+                             [](float a, float b) { return a / b; });
+  }
+};
+
 // Multiply
 template <typename DevCtx, typename T, class Enable = void>
 struct SameDimsMultiplyFunctor {
@@ -160,7 +218,8 @@ template <typename DevCtx, typename T>
 struct SameDimsMultiplyFunctor<
     DevCtx,
     T,
-    typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    typename std::enable_if<std::is_floating_point<T>::value &&
+                            !funcs::IsCPUHalf<T>::value>::type> {
   void operator()(const DevCtx& dev_ctx,
                   const DenseTensor& x,
                   const DenseTensor& y,
@@ -188,6 +247,24 @@ struct SameDimsMultiplyFunctor<
   }
 };
 
+// bfloat16 and float16 compute in float, see funcs::HalfBinaryCompute.
+template <typename DevCtx, typename T>
+struct SameDimsMultiplyFunctor<
+    DevCtx,
+    T,
+    typename std::enable_if<funcs::IsCPUHalf<T>::value>::type> {
+  void operator()(const DevCtx& dev_ctx,
+                  const DenseTensor& x,
+                  const DenseTensor& y,
+                  DenseTensor* z) {
+    funcs::HalfBinaryCompute(x.data<T>(),
+                             y.data<T>(),
+                             dev_ctx.template Alloc<T>(z),
+                             x.numel(),
+                             [](float a, float b) { return a * b; });
+  }
+};
+
 template <typename Functor>
 struct SameDimsElementwiseCompute {
   void operator()(const CPUContext& dev_ctx,
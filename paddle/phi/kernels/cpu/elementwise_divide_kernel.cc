@@ -65,5 +65,7 @@ PD_REGISTER_KERNEL(divide,
                    int,
                    int64_t,
                    bool,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
                    complex64,
                    complex128) {}
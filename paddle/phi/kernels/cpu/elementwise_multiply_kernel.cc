@@ -63,4 +63,5 @@ PD_REGISTER_KERNEL(multiply,
                    bool,
                    complex64,
                    complex128,
+                   phi::dtype::float16,
                    phi::dtype::bfloat16) {}
@@ -62,4 +62,5 @@ PD_REGISTER_KERNEL(subtract,
                    int64_t,
                    complex64,
                    complex128,
+                   phi::dtype::float16,
                    phi::dtype::bfloat16) {}
@@ -18,6 +18,7 @@
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/embedding_util.h"
+#include "paddle/phi/kernels/funcs/row_segments.h"
 
 namespace phi {
 
@@ -62,32 +63,38 @@ struct EmbeddingGradCPUFunctor {
         if (padding_idx_ != kNoPadding && ids_data[i] == padding_idx_) {
           // the gradient of padding_idx should be 0, already done by memset, so
           // do nothing.
-        } else {
-          PADDLE_ENFORCE_LT(
-              ids_data[i],
-              N,
-              common::errors::InvalidArgument(
-                  "Variable value (input) of "
-                  "OP(paddle.nn.functional.embedding) "
-                  "expected >= 0 and < %ld, but got %ld. Please check input "
-                  "value.",
-                  N,
-                  ids_data[i]));
-          PADDLE_ENFORCE_GE(
-              ids_data[i],
-              0,
-              common::errors::InvalidArgument(
-                  "Variable value (input) of "
-                  "OP(paddle.nn.functional.embedding) "
-                  "expected >= 0 and < %ld, but got %ld. Please check input "
-                  "value.",
-                  N,
-                  ids_data[i]));
-          for (int j = 0; j < D; ++j) {
-            d_table_data[ids_data[i] * D + j] += d_output_data[i * D + j];
-          }
+          continue;
         }
+        PADDLE_ENFORCE_LT(
+            ids_data[i],
+            N,
+            common::errors::InvalidArgument(
+                "Variable value (input) of "
+                "OP(paddle.nn.functional.embedding) "
+                "expected >= 0 and < %ld, but got %ld. Please check input "
+                "value.",
+                N,
+                ids_data[i]));
+        PADDLE_ENFORCE_GE(
+            ids_data[i],
+            0,
+            common::errors::InvalidArgument(
+                "Variable value (input) of "
+                "OP(paddle.nn.functional.embedding) "
+                "expected >= 0 and < %ld, but got %ld. Please check input "
+                "value.",
+                N,
+                ids_data[i]));
       }
+
+      // The duplicated ids are grouped, so every row of the table is
+      // accumulated by one thread instead of scattered writes.
+      auto segments = funcs::GroupRows(ids_data, ids_num, padding_idx_);
+      funcs::SegmentedRowSum<T>(
+          segments,
+          D,
+          [&](int64_t i) { return d_output_data + i * D; },
+          [&](int64_t g) { return d_table_data + segments.rows[g] * D; });
     }
   }
 
@@ -145,31 +152,35 @@ struct EmbeddingSparseGradCPUFunctor {
     // paddings makes no sense and we don't deal with it in backward.
     auto* d_table = weight_grad_;
     auto* d_output = &out_grad_;
-    d_table->set_rows(ids);
-
-    auto* d_table_value = d_table->mutable_value();
-    d_table_value->Resize({ids_num, table_dim[1]});
-
-    dev_ctx_.template Alloc<T>(d_table_value);
-
-    d_table->set_height(table_dim[0]);
-
-    auto* d_output_data = d_output->template data<T>();
-    auto* d_table_data = d_table_value->template data<T>();
-
     auto d_output_dims = d_output->dims();
     auto d_output_dims_2d =
         flatten_to_2d(d_output_dims, d_output_dims.size() - 1);
-    PADDLE_ENFORCE_EQ(d_table_value->dims(),
+    PADDLE_ENFORCE_EQ(common::make_ddim({ids_num, table_dim[1]}),
                       d_output_dims_2d,
                       common::errors::InvalidArgument(
                           "ShapeError: The shape of lookup_table@Grad and "
                           "output@Grad should be same. "
                           "But received lookup_table@Grad's shape = [%s], "
                           "output@Grad's shape = [%s].",
-                          d_table_value->dims(),
+                          common::make_ddim({ids_num, table_dim[1]}),
                           d_output_dims_2d));
-    memcpy(d_table_data, d_output_data, sizeof(T) * d_output->numel());
+
+    // The gradients of the duplicated ids are summed here, so the rows of
+    // d_table are unique and sorted, and the sparse optimizers can use it
+    // without merging it again.
+    const int64_t D = table_dim[1];
+    auto segments = funcs::GroupRows(ids.data(), ids_num);
+    d_table->set_rows(segments.rows);
+    d_table->set_height(table_dim[0]);
+    auto* d_table_value = d_table->mutable_value();
+    d_table_value->Resize({segments.size(), D});
+    auto* d_table_data = dev_ctx_.template Alloc<T>(d_table_value);
+    auto* d_output_data = d_output->template data<T>();
+    funcs::SegmentedRowSum<T>(
+        segments,
+        D,
+        [&](int64_t i) { return d_output_data + i * D; },
+        [&](int64_t g) { return d_table_data + g * D; });
   }
 
  private:
@@ -14,6 +14,7 @@
 
 #include <utf8proc.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -22,6 +23,7 @@
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/core/vocab/string_array.h"
+#include "paddle/phi/kernels/funcs/wordpiece_trie.h"
 
 namespace phi {
 
@@ -46,7 +48,8 @@ using InvVocab = unordered_map<int, wstring>;
 class BasicTokenizer {
  public:
   explicit BasicTokenizer(bool do_lower_case = true);
-  void Tokenize(const string& text, vector<wstring>* res) const;
+  // Splits the UTF-8 text into UTF-8 words.
+  void Tokenize(const string& text, vector<string>* res) const;
 
  private:
   wchar_t do_lower_case(wchar_t ch) const;
@@ -59,10 +62,11 @@ class WordPieceTokenizer {
   explicit WordPieceTokenizer(const phi::Vocab* vocab,
                               const wstring& unk_token = L"[UNK]",
                               const size_t max_input_chars_per_word = 100);
-  void Tokenize(const wstring& text, vector<int64_t>* output) const;
+  void Tokenize(const string& text, vector<int64_t>* output) const;
 
  private:
   const phi::Vocab* vocab_;
+  std::shared_ptr<const funcs::WordPieceTrie> trie_;
   wstring unk_token_{L"[UNK]"};
   int64_t unk_token_id_;
   size_t max_input_chars_per_word_;
@@ -114,6 +118,7 @@ class BertTokenizer {
   wstring unk_token_, pad_token_, cls_token_, mask_token_, sep_token_;
   string padding_site_;
   const phi::Vocab* vocab_;
+  std::shared_ptr<const funcs::WordPieceTrie> trie_;
   BasicTokenizer basic_tokenizer_;
   WordPieceTokenizer word_piece_tokenizer_;
   int64_t unk_token_id_, cls_token_id_, mask_token_id_, pad_token_id_,
@@ -169,21 +174,34 @@ wchar_t BasicTokenizer::do_lower_case(wchar_t ch) const {
   return new_ch;
 }
 
-void BasicTokenizer::Tokenize(const string& text, vector<wstring>* res) const {
-  std::wstring unicode_text;
-  bool status = phi::ConvertStrToWstr(text, &unicode_text);
-  if (!status) {
-    // String is converted into wstring failedly.
-    return;
-  }
-  std::wstring cache_text = L"";
+// Appends the UTF-8 encoding of the code point to str.
+inline void AppendUtf8(utf8proc_int32_t ch, string* str) {
+  utf8proc_uint8_t buf[4];
+  auto len = utf8proc_encode_char(ch, buf);
+  str->append(reinterpret_cast<const char*>(buf), len);
+}
+
+void BasicTokenizer::Tokenize(const string& text, vector<string>* res) const {
+  const auto* data = reinterpret_cast<const utf8proc_uint8_t*>(text.data());
+  const auto len = static_cast<utf8proc_ssize_t>(text.size());
+  vector<string> words;
+  string cache_text;
   auto PushCacheText = [&]() {
     if (!cache_text.empty()) {
-      res->emplace_back(cache_text);
-      cache_text = L"";
+      words.emplace_back(std::move(cache_text));
+      cache_text.clear();
     }
   };
-  for (auto& ch : unicode_text) {
+  utf8proc_ssize_t pos = 0;
+  while (pos < len) {
+    utf8proc_int32_t ch;
+    auto ch_len = utf8proc_iterate(data + pos, len - pos, &ch);
+    if (ch_len < 0) {
+      // The text is not valid UTF-8.
+      VLOG(3) << "The string " << text << " is not valid UTF-8.";
+      return;
+    }
+    pos += ch_len;
     if (ch == 0 || ch == 0xfffd || IsControl(ch)) {
       continue;
     }
@@ -192,14 +210,18 @@ void BasicTokenizer::Tokenize(const string& text, vector<wstring>* res) const {
     }
     if (IsChineseChar(ch) || IsPunctuation(ch)) {
       PushCacheText();
-      res->emplace_back(std::wstring{ch});
+      words.emplace_back();
+      AppendUtf8(ch, &words.back());
     } else if (IsWhiteSpace(ch)) {
       PushCacheText();
     } else {
-      cache_text += ch;
+      AppendUtf8(ch, &cache_text);
     }
   }
   PushCacheText();
+  res->insert(res->end(),
+              std::make_move_iterator(words.begin()),
+              std::make_move_iterator(words.end()));
 }
 
 WordPieceTokenizer::WordPieceTokenizer(
@@ -207,55 +229,24 @@ WordPieceTokenizer::WordPieceTokenizer(
     const wstring& unk_token /* = L"[UNK]"*/,
     const size_t max_input_chars_per_word /* = 100 */)
     : vocab_(vocab),
+      trie_(funcs::WordPieceTrie::Get(vocab)),
       unk_token_(unk_token),
       max_input_chars_per_word_(max_input_chars_per_word) {
   unk_token_id_ = vocab_->at(unk_token_);
 }
 
-void WordPieceTokenizer::Tokenize(const wstring& text,
+// Greedy longest-match-first WordPiece, matched on the UTF-8 bytes of the
+// word by the LinMaxMatch trie of the vocab.
+void WordPieceTokenizer::Tokenize(const string& text,
                                   vector<int64_t>* token_ids) const {
-  size_t len = text.size();
-  if (len > max_input_chars_per_word_) {
-    token_ids->emplace_back(unk_token_id_);
-    return;
-  }
-
-  auto it = vocab_->find(text);
-  if (it != vocab_->end()) {
-    token_ids->emplace_back(it->second);
-    return;
-  }
-
-  size_t start = 0;
-  vector<int64_t> wordpiece_ids;
-  while (start < len) {
-    size_t end = len;
-    std::wstring cur_substr;
-    int64_t cur_substr_id = 0;
-    while (start < end) {
-      std::wstring sub = text.substr(start, end - start);
-      if (start > 0) {
-        sub.insert(0, L"##");
-      }
-      auto it = vocab_->find(sub);
-      if (it != vocab_->end()) {
-        cur_substr = sub;
-        cur_substr_id = it->second;
-        break;
-      }
-      end -= 1;
-    }
-
-    if (cur_substr.empty()) {
-      token_ids->emplace_back(unk_token_id_);
-      return;
-    } else {
-      start = end;
-      wordpiece_ids.emplace_back(cur_substr_id);
-    }
+  // count the characters, i.e. the bytes that are not UTF-8 continuations
+  size_t num_chars = 0;
+  for (char ch : text) {
+    num_chars += (static_cast<uint8_t>(ch) & 0xC0) != 0x80;
   }
-  for (auto& token_id : wordpiece_ids) {
-    token_ids->emplace_back(token_id);
+  if (num_chars > max_input_chars_per_word_ ||
+      !trie_->Tokenize(text.data(), text.size(), token_ids)) {
+    token_ids->emplace_back(unk_token_id_);
   }
 }
 
@@ -275,6 +266,7 @@ BertTokenizer::BertTokenizer(const phi::Vocab* vocab,
       sep_token_(sep_token),
       padding_site_(padding_site),
       vocab_(vocab),
+      trie_(funcs::WordPieceTrie::Get(vocab)),
       basic_tokenizer_(do_lower_case_),
       word_piece_tokenizer_(vocab_, unk_token) {
   unk_token_id_ = vocab_->at(unk_token_);
@@ -294,28 +286,25 @@ BertTokenizer::BertTokenizer(const phi::Vocab* vocab,
 
 void BertTokenizer::Tokenize(const string& text,
                              vector<int64_t>* split_token_ids) const {
-  std::vector<std::wstring> tmp_tokens;
+  std::vector<std::string> tmp_tokens;
   basic_tokenizer_.Tokenize(text, &tmp_tokens);
   if (tmp_tokens.empty()) return;
   split_token_ids->reserve(tmp_tokens.size());
-  for (auto& w_token : tmp_tokens) {
-    const auto& vec_size = w_token.size();
-    if (vec_size == 1) {
-      if (IsChineseChar(w_token[0])) {
-        auto vocab_it = vocab_->find(w_token);
-        if (vocab_it != vocab_->end()) {
-          split_token_ids->emplace_back(vocab_it->second);
-        } else {
-          split_token_ids->emplace_back(unk_token_id_);
-        }
-      } else {
-        word_piece_tokenizer_.Tokenize(w_token, split_token_ids);
-      }
-    } else if (vec_size > 1) {
-      word_piece_tokenizer_.Tokenize(w_token, split_token_ids);
-    } else {
+  for (auto& token : tmp_tokens) {
+    if (token.empty()) {
       continue;
     }
+    const auto* data = reinterpret_cast<const utf8proc_uint8_t*>(token.data());
+    utf8proc_int32_t ch;
+    auto ch_len = utf8proc_iterate(
+        data, static_cast<utf8proc_ssize_t>(token.size()), &ch);
+    if (ch_len == static_cast<utf8proc_ssize_t>(token.size()) &&
+        IsChineseChar(ch)) {
+      int64_t id = trie_->Find(token.data(), token.size());
+      split_token_ids->emplace_back(id >= 0 ? id : unk_token_id_);
+    } else {
+      word_piece_tokenizer_.Tokenize(token, split_token_ids);
+    }
   }
 }
 
@@ -409,19 +398,17 @@ int BertTokenizer::Encode(
       if (pair_ids.empty()) return 0;
     }
   } else {
-    std::wstring unicode_text;
-    bool status_a = phi::ConvertStrToWstr(text, &unicode_text);
-    if (!status_a) {
-      return 0;
-    }
-    for (size_t i = 0; i < unicode_text.size(); i++) {
-      wstring token = unicode_text.substr(i, 1);
-      auto it = vocab_->find(token);
-      if (it != vocab_->end()) {
-        ids.emplace_back(it->second);
-      } else {
-        ids.emplace_back(unk_token_id_);
+    const auto* data = reinterpret_cast<const utf8proc_uint8_t*>(text.data());
+    const auto len = static_cast<utf8proc_ssize_t>(text.size());
+    for (utf8proc_ssize_t pos = 0; pos < len;) {
+      utf8proc_int32_t ch;
+      auto ch_len = utf8proc_iterate(data + pos, len - pos, &ch);
+      if (ch_len < 0) {
+        return 0;
       }
+      int64_t id = trie_->Find(text.data() + pos, ch_len);
+      ids.emplace_back(id >= 0 ? id : unk_token_id_);
+      pos += ch_len;
     }
   }
 
@@ -16,9 +16,30 @@
 
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/norm_distribution.h"
+#include "paddle/phi/kernels/funcs/random_cpu_function.h"
 
 namespace phi {
 
+template <typename T, typename Context>
+void PhiloxGaussian(const Context& dev_ctx,
+                    float mean,
+                    float std,
+                    int seed,
+                    int64_t size,
+                    T* data) {
+  using MT = funcs::PhiloxComputeType<T>;
+  auto seed_offset = funcs::PhiloxSeedOffset(
+      dev_ctx.GetGenerator(), seed, funcs::PhiloxNumBlocks<MT>(size));
+  funcs::PhiloxNormalForEach<MT>(seed_offset.first,
+                                 seed_offset.second,
+                                 size,
+                                 static_cast<MT>(mean),
+                                 static_cast<MT>(std),
+                                 [&](int64_t i, MT z) {
+                                   data[i] = static_cast<T>(z);
+                                 });
+}
+
 template <typename T, typename Context>
 void GaussianKernel(const Context& dev_ctx,
                     const IntArray& shape,
@@ -30,6 +51,12 @@ void GaussianKernel(const Context& dev_ctx,
   out->Resize(common::make_ddim(shape.GetData()));
   int64_t size = out->numel();
   T* data = dev_ctx.template Alloc<T>(out);
+  if constexpr (funcs::kIsPhiloxType<T>) {
+    if (funcs::UseCPUPhilox()) {
+      PhiloxGaussian<T>(dev_ctx, mean, std, seed, size, data);
+      return;
+    }
+  }
   std::shared_ptr<std::mt19937_64> engine;
   if (seed) {
     engine = std::make_shared<std::mt19937_64>();
@@ -50,6 +77,12 @@ void GaussianInplaceKernel(const Context& dev_ctx,
   T* data = dev_ctx.template Alloc<T>(out);
 
   int64_t size = out->numel();
+  if constexpr (funcs::kIsPhiloxType<T>) {
+    if (funcs::UseCPUPhilox()) {
+      PhiloxGaussian<T>(dev_ctx, mean, std, seed, size, data);
+      return;
+    }
+  }
   std::shared_ptr<std::mt19937_64> engine;
   if (seed) {
     engine = std::make_shared<std::mt19937_64>();
@@ -25,6 +25,7 @@
 #include "paddle/phi/kernels/funcs/blas/blas_impl.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/eigen/eigen_function.h"
+#include "paddle/phi/kernels/funcs/half_cpu_function.h"
 
 namespace phi {
 
@@ -92,15 +93,38 @@ void GeluKernel(const Context& dev_ctx,
                 const DenseTensor& x,
                 bool approximate,
                 DenseTensor* out) {
-  dev_ctx.template Alloc<T>(out);
-  auto eigen_out = EigenVector<T>::Flatten(*out);
-  auto eigen_x = EigenVector<T>::Flatten(x);
-  auto& dev = *dev_ctx.eigen_device();
+  if constexpr (funcs::IsCPUHalf<T>::value) {
+    // bfloat16 and float16 run the float functor on float blocks.
+    const T* x_data = x.data<T>();
+    T* out_data = dev_ctx.template Alloc<T>(out);
+    auto& dev = *dev_ctx.eigen_device();
+    funcs::HalfBlockForEach(x.numel(), [&](int64_t begin, int64_t size) {
+      float x_buffer[funcs::kCPUHalfBlock];
+      float out_buffer[funcs::kCPUHalfBlock];
+      funcs::HalfToFloat(x_data + begin, size, x_buffer);
+      typename EigenVector<float>::Type eigen_x(x_buffer, size);
+      typename EigenVector<float>::Type eigen_out(out_buffer, size);
+      GeluFunctor<float>()(dev, eigen_x, eigen_out, approximate);
+      funcs::FloatToHalf(out_buffer, size, out_data + begin);
+    });
+  } else {
+    dev_ctx.template Alloc<T>(out);
+    auto eigen_out = EigenVector<T>::Flatten(*out);
+    auto eigen_x = EigenVector<T>::Flatten(x);
+    auto& dev = *dev_ctx.eigen_device();
 
-  GeluFunctor<T> functor;
-  functor(dev, eigen_x, eigen_out, approximate);
+    GeluFunctor<T> functor;
+    functor(dev, eigen_x, eigen_out, approximate);
+  }
 }
 
 }  // namespace phi
 
-PD_REGISTER_KERNEL(gelu, CPU, ALL_LAYOUT, phi::GeluKernel, float, double) {}
+PD_REGISTER_KERNEL(gelu,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::GeluKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
@@ -14,18 +14,72 @@
 
 #include "paddle/phi/kernels/layer_norm_grad_kernel.h"
 
+#include <vector>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
-#include "paddle/phi/core/tensor_utils.h"
-#include "paddle/phi/kernels/cpu/elementwise.h"
-#include "paddle/phi/kernels/funcs/blas/blas.h"
-#include "paddle/phi/kernels/funcs/elementwise_base.h"
-#include "paddle/phi/kernels/funcs/elementwise_functor.h"
-#include "paddle/phi/kernels/funcs/layer_norm_util.h"
-#include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/norm_cpu_function.h"
 
 namespace phi {
 
+// Writes a column sum of the compute type to the gradient of a parameter,
+// which has the type of the parameter.
+template <typename T, typename MT, typename Context>
+void StoreLayerNormParamGrad(const Context& dev_ctx,
+                             const std::vector<MT>& grad,
+                             DenseTensor* out) {
+  const int64_t n = static_cast<int64_t>(grad.size());
+  if (out->dtype() == DataType::FLOAT32) {
+    funcs::CPUNormStore(grad.data(), n, dev_ctx.template Alloc<float>(out));
+  } else {
+    funcs::CPUNormStore(grad.data(), n, dev_ctx.template Alloc<T>(out));
+  }
+}
+
+template <typename T, typename P, typename Context>
+void LayerNormGradCPUImpl(const Context& dev_ctx,
+                          const DenseTensor& x,
+                          const DenseTensor* scale,
+                          const DenseTensor& mean,
+                          const DenseTensor& variance,
+                          const DenseTensor& out_grad,
+                          float epsilon,
+                          int64_t left,
+                          int64_t right,
+                          DenseTensor* x_grad,
+                          DenseTensor* scale_grad,
+                          DenseTensor* bias_grad) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  funcs::CPUNormArgs<T, P> args;
+  args.rows = left;
+  args.cols = right;
+  args.x = x.data<T>();
+  args.scale = scale ? scale->data<P>() : nullptr;
+  const MT* mean_data = mean.data<MT>();
+  const MT* var_data = variance.data<MT>();
+  const MT eps = static_cast<MT>(epsilon);
+  std::vector<MT> dscale(scale_grad ? right : 0);
+  std::vector<MT> dbias(bias_grad ? right : 0);
+  funcs::CPUNormBackward<false>(
+      args,
+      out_grad.data<T>(),
+      [&](int64_t r, MT* row_mean, MT* rstd) {
+        *row_mean = mean_data[r];
+        *rstd = static_cast<MT>(1) / std::sqrt(var_data[r] + eps);
+      },
+      x_grad ? dev_ctx.template Alloc<T>(x_grad) : nullptr,
+      scale_grad ? dscale.data() : nullptr,
+      bias_grad ? dbias.data() : nullptr);
+  if (scale_grad) {
+    StoreLayerNormParamGrad<T>(dev_ctx, dscale, scale_grad);
+  }
+  if (bias_grad) {
+    StoreLayerNormParamGrad<T>(dev_ctx, dbias, bias_grad);
+  }
+}
+
+// The gradients of the row normalization of LayerNormKernel, computed from
+// one pass over the rows of x and out_grad, see funcs::CPUNormBackward.
 template <typename T, typename Context>
 void LayerNormGradKernel(const Context& dev_ctx,
                          const DenseTensor& x,
@@ -40,120 +94,50 @@ void LayerNormGradKernel(const Context& dev_ctx,
                          DenseTensor* scale_grad,
                          DenseTensor* bias_grad) {
   auto* scale = scale_opt.get_ptr();
-  auto d_y = out_grad;
-
-  // init output
-  auto* d_x = x_grad;
-  auto* d_scale = scale_grad;
-  auto* d_bias = bias_grad;
-
-  const auto& x_dims = x.dims();
-  auto matrix_dim = common::flatten_to_2d(x_dims, begin_norm_axis);
-  int left = static_cast<int>(matrix_dim[0]);
-  int right = static_cast<int>(matrix_dim[1]);
-  DDim matrix_shape({left, right});
-  DDim var_shape({left});
-
-  d_y.Resize(matrix_shape);
-  // resize mean and var to match the shape of resized d_y for broadcast (Resize
-  // will not modify the underline data)
-  auto mean_tmp = mean;
-  mean_tmp.Resize(var_shape);
-  auto variance_tmp = variance;
-  variance_tmp.Resize(var_shape);
-
-  funcs::ColwiseSum2D<phi::CPUContext, T> colwise_sum(left, right, dev_ctx);
-  DenseTensor x_tmp = x;
-
-  DenseTensor temp;
-  DenseTensor temp_norm;
-  if (d_scale || d_x) {
-    x_tmp.Resize(matrix_shape);
-    temp.Resize(matrix_shape);
-    dev_ctx.template Alloc<T>(&temp);
-
-    temp_norm.Resize(matrix_shape);
-    dev_ctx.template Alloc<T>(&temp_norm);
-    // get x_norm
-    phi::funcs::ElementwiseCompute<funcs::SubtractFunctor<T>, T>(
-        dev_ctx, x_tmp, mean_tmp, funcs::SubtractFunctor<T>(), &temp_norm, 0);
-    phi::funcs::ElementwiseCompute<funcs::DivAndSqrtFunctor<T>, T>(
-        dev_ctx,
-        temp_norm,
-        variance_tmp,
-        funcs::DivAndSqrtFunctor<T>(static_cast<T>(epsilon)),
-        &temp_norm,
-        0);
-  }
-
-  if (d_bias) {
-    dev_ctx.template Alloc<T>(d_bias);
-    colwise_sum(dev_ctx, d_y, d_bias);
-  }
-  if (d_scale) {
-    dev_ctx.template Alloc<T>(d_scale);
-    phi::funcs::ElementwiseCompute<funcs::MultiplyFunctor<T>, T>(
-        dev_ctx, temp_norm, d_y, funcs::MultiplyFunctor<T>(), &temp, 0);
-    colwise_sum(dev_ctx, temp, d_scale);
-  }
-
-  if (d_x) {
-    DDim vec_shape({left});
-    dev_ctx.template Alloc<T>(d_x);
-    auto dx_dim = d_x->dims();
-    DenseTensor temp_vec;
-    temp_vec.Resize(vec_shape);
-    dev_ctx.template Alloc<T>(&temp_vec);
-
-    funcs::RowwiseMean2D<phi::CPUContext, T> row_mean(left, right, dev_ctx);
-
-    if (d_scale) {
-      // dy_dx
-      phi::funcs::ElementwiseCompute<funcs::MultiplyFunctor<T>, T>(
-          dev_ctx, d_y, *scale, funcs::MultiplyFunctor<T>(), &temp, 1);
-      phi::Copy<Context>(dev_ctx, temp, dev_ctx.GetPlace(), false, d_x);
-
-      // dy_dmean_dx
-      row_mean(dev_ctx, temp, &temp_vec);
-      phi::funcs::ElementwiseCompute<funcs::SubtractFunctor<T>, T>(
-          dev_ctx, *d_x, temp_vec, funcs::SubtractFunctor<T>(), d_x, 0);
-
-      // dy_var_dx
-      phi::funcs::ElementwiseCompute<funcs::MultiplyFunctor<T>, T>(
-          dev_ctx, temp, temp_norm, funcs::MultiplyFunctor<T>(), &temp, 0);
-    } else {
-      // dy_dx
-      phi::Copy<Context>(dev_ctx, d_y, dev_ctx.GetPlace(), false, d_x);
-
-      // dy_dmean_dx
-      row_mean(dev_ctx, d_y, &temp_vec);
-      phi::funcs::ElementwiseCompute<funcs::SubtractFunctor<T>, T>(
-          dev_ctx, *d_x, temp_vec, funcs::SubtractFunctor<T>(), d_x, 0);
-
-      // dy_var_dx
-      phi::funcs::ElementwiseCompute<funcs::MultiplyFunctor<T>, T>(
-          dev_ctx, d_y, temp_norm, funcs::MultiplyFunctor<T>(), &temp, 0);
+  auto matrix_dim = common::flatten_to_2d(x.dims(), begin_norm_axis);
+  const int64_t left = matrix_dim[0];
+  const int64_t right = matrix_dim[1];
+  if constexpr (funcs::IsCPUHalf<T>::value) {
+    if (scale && scale->dtype() == DataType::FLOAT32) {
+      LayerNormGradCPUImpl<T, float>(dev_ctx,
+                                     x,
+                                     scale,
+                                     mean,
+                                     variance,
+                                     out_grad,
+                                     epsilon,
+                                     left,
+                                     right,
+                                     x_grad,
+                                     scale_grad,
+                                     bias_grad);
+      return;
     }
-    // dy_var_dx
-    row_mean(dev_ctx, temp, &temp_vec);
-    phi::funcs::ElementwiseCompute<funcs::MultiplyFunctor<T>, T>(
-        dev_ctx, temp_norm, temp_vec, funcs::MultiplyFunctor<T>(), &temp, 0);
-    phi::funcs::ElementwiseCompute<funcs::SubtractFunctor<T>, T>(
-        dev_ctx, *d_x, temp, funcs::SubtractFunctor<T>(), d_x, 0);
-
-    phi::funcs::ElementwiseCompute<funcs::DivAndSqrtFunctor<T>, T>(
-        dev_ctx,
-        *d_x,
-        variance_tmp,
-        funcs::DivAndSqrtFunctor<T>(static_cast<T>(epsilon)),
-        d_x,
-        0);
-    d_x->Resize(dx_dim);
   }
+  LayerNormGradCPUImpl<T, T>(dev_ctx,
+                             x,
+                             scale,
+                             mean,
+                             variance,
+                             out_grad,
+                             epsilon,
+                             left,
+                             right,
+                             x_grad,
+                             scale_grad,
+                             bias_grad);
 }
 
 }  // namespace phi
 
-PD_REGISTER_KERNEL(
-    layer_norm_grad, CPU, ALL_LAYOUT, phi::LayerNormGradKernel, float, double) {
+PD_REGISTER_KERNEL(layer_norm_grad,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::LayerNormGradKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(2).SetDataType(phi::DataType::UNDEFINED);
 }
@@ -27,6 +27,8 @@ PD_REGISTER_KERNEL(matmul,
                    double,
                    int32_t,
                    int64_t,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
                    phi::dtype::complex<float>,
                    phi::dtype::complex<double>) {}
 
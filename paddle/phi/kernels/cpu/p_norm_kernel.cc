@@ -17,9 +17,8 @@
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/common_shape.h"
-#include "paddle/phi/kernels/funcs/eigen/common.h"
-#include "paddle/phi/kernels/funcs/eigen/eigen_function.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/reduce_cpu_function.h"
 
 namespace phi {
 
@@ -68,31 +67,33 @@ void PNormKernel(const Context& dev_ctx,
                           "The dims of Input(X) should be greater than 0."));
   }
 
-  auto* place = dev_ctx.eigen_device();
-
-  Eigen::DSizes<int, 3> shape(pre, n, post);
-  Eigen::DSizes<int, 2> norm_shape(pre, post);
-
-  auto x_e = phi::EigenVector<T>::Flatten(*in_x);
-  auto norm_e = phi::EigenVector<T>::Flatten(*out);
-
-  auto xr = x_e.reshape(shape);
-  auto norm = norm_e.reshape(norm_shape);
-
+  const T* x_data = in_x->data<T>();
+  T* out_data = out->data<T>();
   // p=0 means number of non-zero elements of (xr)
   // p=inf means the maximum of |xr|
   // p=-inf means the minimum of |xr|
   // otherwise, Lp-norm = pow(sum(pow(|xr|, p)), 1/p)
-  Eigen::DSizes<int, 1> rdim(1);
+  const auto mode = funcs::GetCPUSumMode();
   if (porder == 0) {
-    norm.device(*place) = (xr != xr.constant(0)).template cast<T>().sum(rdim);
+    funcs::ReduceCPU(
+        funcs::CPUNonZeroCountOp<T>(), x_data, pre, n, post, out_data, mode);
   } else if (porder == INFINITY) {
-    norm.device(*place) = xr.abs().maximum(rdim);
+    funcs::ReduceCPU(
+        funcs::CPUAbsMaxOrMinOp<T, true>(), x_data, pre, n, post, out_data);
   } else if (porder == -INFINITY) {
-    norm.device(*place) = xr.abs().minimum(rdim);
+    funcs::ReduceCPU(
+        funcs::CPUAbsMaxOrMinOp<T, false>(), x_data, pre, n, post, out_data);
+  } else if (porder == 1) {
+    funcs::ReduceCPU(
+        funcs::CPUPNormOp<T, 1>(porder), x_data, pre, n, post, out_data, mode);
+  } else if (porder == 2) {
+    funcs::ReduceCPU(
+        funcs::CPUPNormOp<T, 2>(porder), x_data, pre, n, post, out_data, mode);
   } else {
-    norm.device(*place) = xr.abs().pow(porder).sum(rdim).pow(1.0f / porder);
+    funcs::ReduceCPU(
+        funcs::CPUPNormOp<T, 0>(porder), x_data, pre, n, post, out_data, mode);
   }
 }
+
 }  // namespace phi
 PD_REGISTER_KERNEL(p_norm, CPU, ALL_LAYOUT, phi::PNormKernel, float, double) {}
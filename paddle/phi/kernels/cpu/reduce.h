@@ -15,13 +15,104 @@
 #pragma once
 
 #include <set>
+#include <type_traits>
 
 #include "paddle/phi/core/visit_type.h"
 #include "paddle/phi/kernels/cast_kernel.h"
+#include "paddle/phi/kernels/funcs/reduce_cpu_function.h"
 #include "paddle/phi/kernels/funcs/reduce_function.h"
+#include "paddle/phi/kernels/funcs/reduce_functor.h"
 
 namespace phi {
 
+namespace detail {
+
+template <typename T>
+constexpr bool kIsCPUReduceReal =
+    (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) ||
+    std::is_same<T, phi::dtype::float16>::value ||
+    std::is_same<T, phi::dtype::bfloat16>::value;
+
+template <typename T>
+constexpr bool kIsCPUReduceComplex =
+    std::is_same<T, phi::dtype::complex<float>>::value ||
+    std::is_same<T, phi::dtype::complex<double>>::value;
+
+// The op of funcs::ReduceCPU computing Functor over T, or void if it is
+// computed by the Eigen reduction, e.g. over bool.
+template <typename Functor, typename T>
+struct CPUReduceOpOf {
+  using type = void;
+};
+
+template <typename T>
+struct CPUReduceOpOf<funcs::SumFunctor, T> {
+  using type =
+      std::conditional_t<kIsCPUReduceReal<T> || kIsCPUReduceComplex<T>,
+                         funcs::CPUSumOp<T>,
+                         void>;
+};
+
+template <typename T>
+struct CPUReduceOpOf<funcs::MeanFunctor, T> {
+  using type =
+      std::conditional_t<kIsCPUReduceReal<T> || kIsCPUReduceComplex<T>,
+                         funcs::CPUMeanOp<T>,
+                         void>;
+};
+
+template <typename T>
+struct CPUReduceOpOf<funcs::ProdFunctor, T> {
+  using type =
+      std::conditional_t<kIsCPUReduceReal<T> || kIsCPUReduceComplex<T>,
+                         funcs::CPUProdOp<T>,
+                         void>;
+};
+
+template <typename T>
+struct CPUReduceOpOf<funcs::MaxFunctor, T> {
+  using type =
+      std::conditional_t<kIsCPUReduceReal<T>, funcs::CPUMaxOp<T>, void>;
+};
+
+template <typename T>
+struct CPUReduceOpOf<funcs::MinFunctor, T> {
+  using type =
+      std::conditional_t<kIsCPUReduceReal<T>, funcs::CPUMinOp<T>, void>;
+};
+
+// Reduces input of OutT by Functor with funcs::ReduceCPU, or with the Eigen
+// reduction of funcs::ReduceKernelImpl for the functors and types it does not
+// support.
+template <typename DeviceContext, typename T, typename OutT, typename Functor>
+void ReduceKernelImplCPU(const DeviceContext& dev_ctx,
+                         const DenseTensor& input,
+                         DenseTensor* output,
+                         const std::vector<int64_t>& dims,
+                         bool keep_dim,
+                         bool reduce_all) {
+  using Op = typename CPUReduceOpOf<Functor, OutT>::type;
+  if constexpr (std::is_same<Op, void>::value) {
+    funcs::ReduceKernelImpl<DeviceContext, T, OutT, Functor>(
+        dev_ctx, input, output, dims, keep_dim, reduce_all);
+  } else {
+    PADDLE_ENFORCE_GT(input.numel(),
+                      0,
+                      common::errors::InvalidArgument(
+                          "Tensor need be reduced must not empty."));
+    OutT* out_data = dev_ctx.template Alloc<OutT>(output);
+    funcs::ReduceCPU(Op(),
+                     input.data<OutT>(),
+                     common::vectorize<int64_t>(input.dims()),
+                     dims,
+                     reduce_all,
+                     out_data,
+                     funcs::GetCPUSumMode());
+  }
+}
+
+}  // namespace detail
+
 template <typename DeviceContext, typename T, typename Functor>
 void Reduce(const DeviceContext& dev_ctx,
             const DenseTensor& x,
@@ -49,7 +140,7 @@ void Reduce(const DeviceContext& dev_ctx,
     // do reduce sum
     PD_VISIT_ALL_TYPES(
         x.dtype(), "ReduceKernelImpl", ([&] {
-          phi::funcs::ReduceKernelImpl<DeviceContext, T, data_t, Functor>(
+          detail::ReduceKernelImplCPU<DeviceContext, T, data_t, Functor>(
               dev_ctx, x, out, dims, keep_dim, reduce_all);
         }));
 
@@ -60,7 +151,7 @@ void Reduce(const DeviceContext& dev_ctx,
     // do reduce sum
     PD_VISIT_ALL_TYPES(
         out_dtype, "ReduceKernelImpl", ([&] {
-          phi::funcs::ReduceKernelImpl<DeviceContext, T, data_t, Functor>(
+          detail::ReduceKernelImplCPU<DeviceContext, T, data_t, Functor>(
               dev_ctx, tmp_tensor, out, dims, keep_dim, reduce_all);
         }));
   }
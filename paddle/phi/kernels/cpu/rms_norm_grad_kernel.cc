@@ -0,0 +1,110 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/rms_norm_grad_kernel.h"
+
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/norm_cpu_function.h"
+
+namespace phi {
+
+// The gradients of RmsNormKernel from one pass over the rows of x and
+// out_grad, see funcs::CPUNormBackward. With residual, x + residual + bias
+// is rebuilt and x_grad is its gradient.
+template <typename T, typename Context>
+void RmsNormGradKernel(const Context& dev_ctx,
+                       const DenseTensor& x,
+                       const paddle::optional<DenseTensor>& bias,
+                       const paddle::optional<DenseTensor>& residual,
+                       const DenseTensor& norm_weight,
+                       const paddle::optional<DenseTensor>& norm_bias,
+                       const DenseTensor& inv_var,
+                       const DenseTensor& out_grad,
+                       const float epsilon UNUSED,
+                       const int begin_norm_axis,
+                       const float quant_scale,
+                       DenseTensor* x_grad,
+                       DenseTensor* norm_weight_grad,
+                       DenseTensor* norm_bias_grad) {
+  if (quant_scale > 0.0f) {
+    PADDLE_THROW(common::errors::Unimplemented(
+        "quantization is not supported in CPU rms_norm_grad yet"));
+  }
+  auto matrix_dim = common::flatten_to_2d(x.dims(), begin_norm_axis);
+  const int64_t rows = matrix_dim[0];
+  const int64_t cols = matrix_dim[1];
+  PADDLE_ENFORCE_EQ(
+      norm_weight.numel(),
+      cols,
+      common::errors::InvalidArgument(
+          "The product from begin_norm_axis to the last axis of input tensor "
+          "x, i.e., cols(%d) must be equal to the norm_weight tensor's "
+          "numel(%d).",
+          cols,
+          norm_weight.numel()));
+  PADDLE_ENFORCE_EQ(
+      inv_var.numel(),
+      rows,
+      common::errors::InvalidArgument(
+          "The product from 0 to begin_norm_axis of input tensor x, i.e., "
+          "rows(%d) must be equal to the inv_var tensor's numel(%d).",
+          rows,
+          inv_var.numel()));
+
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  funcs::CPUNormArgs<T> args;
+  args.rows = rows;
+  args.cols = cols;
+  args.x = x.data<T>();
+  args.scale = norm_weight.data<T>();
+  if (residual) {
+    args.residual = residual->data<T>();
+    args.bias = bias ? bias->data<T>() : nullptr;
+  }
+  const float* inv_var_data = inv_var.data<float>();
+  std::vector<MT> dscale(norm_weight_grad ? cols : 0);
+  std::vector<MT> dnorm_bias(norm_bias && norm_bias_grad ? cols : 0);
+  funcs::CPUNormBackward<true>(
+      args,
+      out_grad.data<T>(),
+      [&](int64_t r, MT* mean, MT* rstd) {
+        *mean = static_cast<MT>(0);
+        *rstd = static_cast<MT>(inv_var_data[r]);
+      },
+      x_grad ? dev_ctx.template Alloc<T>(x_grad) : nullptr,
+      dscale.empty() ? nullptr : dscale.data(),
+      dnorm_bias.empty() ? nullptr : dnorm_bias.data());
+  if (!dscale.empty()) {
+    funcs::CPUNormStore(
+        dscale.data(), cols, dev_ctx.template Alloc<T>(norm_weight_grad));
+  }
+  if (!dnorm_bias.empty()) {
+    funcs::CPUNormStore(
+        dnorm_bias.data(), cols, dev_ctx.template Alloc<T>(norm_bias_grad));
+  }
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(rms_norm_grad,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::RmsNormGradKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
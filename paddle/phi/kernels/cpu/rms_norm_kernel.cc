@@ -0,0 +1,121 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/rms_norm_kernel.h"
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/norm_cpu_function.h"
+
+namespace phi {
+
+// RMSNorm(x + residual + bias) in one pass over each row, see
+// funcs::CPUNormForward. Like the GPU kernel, bias is only added together
+// with residual, and out is quantized to int8 or float8_e4m3fn when its
+// type says so.
+template <typename T, typename Context>
+void RmsNormKernel(const Context& dev_ctx,
+                   const DenseTensor& x,
+                   const paddle::optional<DenseTensor>& bias,
+                   const paddle::optional<DenseTensor>& residual,
+                   const DenseTensor& norm_weight,
+                   const paddle::optional<DenseTensor>& norm_bias,
+                   const float epsilon,
+                   const int begin_norm_axis,
+                   const float quant_scale,
+                   const int quant_round_type,
+                   const float quant_max_bound,
+                   const float quant_min_bound,
+                   DenseTensor* out,
+                   DenseTensor* residual_out,
+                   DenseTensor* inv_var) {
+  const bool quant = out->dtype() == phi::DataType::INT8 ||
+                     out->dtype() == phi::DataType::FLOAT8_E4M3FN;
+  if (quant) {
+    PADDLE_ENFORCE_EQ(quant_scale != 0.0f,
+                      true,
+                      common::errors::InvalidArgument(
+                          "Quant rms_norm'output, must has quant_scale, "
+                          "quant_scale!=0, but quant_scale = %f ",
+                          quant_scale));
+    PADDLE_ENFORCE_EQ(quant_round_type == 0 || quant_round_type == 1,
+                      true,
+                      common::errors::InvalidArgument(
+                          "Quant rms_norm'output, must has quant_round_type, "
+                          "quant_round_type = 0 or quant_round_type = 1, but "
+                          "quant_round_type = %d ",
+                          quant_round_type));
+  }
+
+  auto matrix_dim = common::flatten_to_2d(x.dims(), begin_norm_axis);
+  const int64_t rows = matrix_dim[0];
+  const int64_t cols = matrix_dim[1];
+  PADDLE_ENFORCE_EQ(
+      norm_weight.numel(),
+      cols,
+      common::errors::InvalidArgument(
+          "The product from begin_norm_axis to the last axis of input tensor "
+          "x, i.e., cols(%d) must be equal to the norm_weight tensor's "
+          "numel(%d).",
+          cols,
+          norm_weight.numel()));
+
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  funcs::CPUNormArgs<T> args;
+  args.rows = rows;
+  args.cols = cols;
+  args.epsilon = epsilon;
+  args.x = x.data<T>();
+  args.scale = norm_weight.data<T>();
+  args.norm_bias = norm_bias ? norm_bias->data<T>() : nullptr;
+  if (residual) {
+    args.residual = residual->data<T>();
+    args.bias = bias ? bias->data<T>() : nullptr;
+    args.residual_out = dev_ctx.template Alloc<T>(residual_out);
+  }
+  float* inv_var_data =
+      inv_var ? dev_ctx.template Alloc<float>(inv_var) : nullptr;
+  auto stats = [&](int64_t r, MT, MT, MT rstd) {
+    if (inv_var_data) {
+      inv_var_data[r] = static_cast<float>(rstd);
+    }
+  };
+
+  funcs::CPUNormQuant quantizer{
+      quant_scale, quant_round_type, quant_max_bound, quant_min_bound};
+  if (out->dtype() == phi::DataType::INT8) {
+    funcs::CPUNormForward<true>(
+        args, dev_ctx.template Alloc<int8_t>(out), &quantizer, stats);
+  } else if (out->dtype() == phi::DataType::FLOAT8_E4M3FN) {
+    funcs::CPUNormForward<true>(
+        args,
+        dev_ctx.template Alloc<phi::dtype::float8_e4m3fn>(out),
+        &quantizer,
+        stats);
+  } else {
+    funcs::CPUNormForward<true>(
+        args, dev_ctx.template Alloc<T>(out), nullptr, stats);
+  }
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(rms_norm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::RmsNormKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
@@ -15,6 +15,7 @@
 #include "paddle/phi/kernels/uniform_kernel.h"
 
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/random_cpu_function.h"
 #include "paddle/phi/kernels/funcs/uniform_real_distribution.h"
 
 namespace phi {
@@ -30,6 +31,18 @@ void UniformKernel(const Context &dev_ctx,
   out->Resize(common::make_ddim(shape.GetData()));
   T *data = dev_ctx.template Alloc<T>(out);
   auto size = out->numel();
+  if (funcs::UseCPUPhilox()) {
+    using MT = funcs::PhiloxComputeType<T>;
+    auto seed_offset = funcs::PhiloxSeedOffset(
+        dev_ctx.GetGenerator(), seed, funcs::PhiloxNumBlocks<MT>(size));
+    const MT low = min.to<MT>();
+    const MT range = max.to<MT>() - low;
+    funcs::PhiloxUniformForEach<MT>(
+        seed_offset.first, seed_offset.second, size, [&](int64_t i, MT u) {
+          data[i] = static_cast<T>(low + u * range);
+        });
+    return;
+  }
   std::shared_ptr<std::mt19937_64> engine;
   if (seed) {
     engine = std::make_shared<std::mt19937_64>();
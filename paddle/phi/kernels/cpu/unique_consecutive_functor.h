@@ -17,6 +17,7 @@
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/kernels/funcs/concat_and_split_functor.h"
+#include "paddle/phi/kernels/funcs/cpu_sort.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/funcs/unique_functor.h"
 
@@ -31,49 +32,39 @@ static void UniqueConsecutiveFlattenedTensor(const Context& context,
                                              DenseTensor* inverse,
                                              DenseTensor* count) {
   const InT* in_data = in.data<InT>();
-  std::vector<InT> out_vec(in.numel());
-  std::vector<IndexT> inverse_vec(in.numel());
-  std::vector<IndexT> counts_vec(in.numel());
-  memcpy(out_vec.data(), in_data, in.numel() * sizeof(InT));
-  InT* p = out_vec.data();
-  int64_t last = 0;
-  IndexT* q = counts_vec.data();
-  for (int64_t i = 0; i < in.numel(); i++) {
-    if (in_data[i] != *p) {
-      *(++p) = in_data[i];
-      if (return_counts) {
-        *(q++) = i - last;
-        last = i;
-      }
-    }
-    if (return_inverse) {
-      inverse_vec[i] = p - out_vec.data();
-    }
-  }
-
-  bool is_empty = in.numel() == 0;
-  int64_t output_size = is_empty ? 0 : (p - out_vec.data() + 1);
-
-  if (return_counts) {
-    if (!is_empty) *q = in.numel() - last;
-    counts_vec.resize(output_size);
-  }
-  out_vec.resize(output_size);
+  const int64_t numel = in.numel();
+  // The runs of equal elements are found in parallel, and as before NaN !=
+  // NaN makes every NaN a run of its own.
+  std::vector<int64_t> starts = phi::funcs::SegmentStarts(
+      numel, [&](int64_t i) { return in_data[i] != in_data[i - 1]; });
+  const int64_t output_size = static_cast<int64_t>(starts.size()) - 1;
 
   out->Resize(common::make_ddim({output_size}));
   auto* out_data = context.template Alloc<InT>(out);
-  std::copy(out_vec.begin(), out_vec.end(), out_data);
-
+  IndexT* inverse_data = nullptr;
   if (return_inverse) {
-    inverse->Resize(common::make_ddim({in.numel()}));
-    auto* inverse_data = context.template Alloc<IndexT>(inverse);
-    std::copy(inverse_vec.begin(), inverse_vec.end(), inverse_data);
+    inverse->Resize(common::make_ddim({numel}));
+    inverse_data = context.template Alloc<IndexT>(inverse);
   }
-
+  IndexT* counts_data = nullptr;
   if (return_counts) {
-    count->Resize(common::make_ddim({out->numel()}));
-    auto* counts_data = context.template Alloc<IndexT>(count);
-    std::copy(counts_vec.begin(), counts_vec.end(), counts_data);
+    count->Resize(common::make_ddim({output_size}));
+    counts_data = context.template Alloc<IndexT>(count);
+  }
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (numel >= phi::funcs::kCPUSortParallelNumel)
+#endif
+  for (int64_t g = 0; g < output_size; ++g) {
+    out_data[g] = in_data[starts[g]];
+    if (inverse_data != nullptr) {
+      std::fill(inverse_data + starts[g],
+                inverse_data + starts[g + 1],
+                static_cast<IndexT>(g));
+    }
+    if (counts_data != nullptr) {
+      counts_data[g] = static_cast<IndexT>(starts[g + 1] - starts[g]);
+    }
   }
 }
 
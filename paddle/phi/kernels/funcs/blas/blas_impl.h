@@ -24,6 +24,7 @@
 
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/complex.h"
+#include "paddle/phi/kernels/funcs/half_cpu_function.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
 namespace phi {
@@ -45,6 +46,107 @@ static void axpy(
 template <typename T>
 struct CBlas;
 
+// The GEMMs of bfloat16 and float16, which compute in float (see HalfGemm).
+template <typename T>
+struct CBlasHalfGemm {
+  template <typename Layout, typename Trans>
+  static void GEMM(Layout layout UNUSED,
+                   Trans trans_a,
+                   Trans trans_b,
+                   int M,
+                   int N,
+                   int K,
+                   T alpha,
+                   const T *A,
+                   int lda,
+                   const T *B,
+                   int ldb,
+                   T beta,
+                   T *C,
+                   int ldc) {
+    HalfGemm<T>(trans_a != CblasNoTrans,
+                trans_b != CblasNoTrans,
+                M,
+                N,
+                K,
+                static_cast<float>(alpha),
+                A,
+                lda,
+                B,
+                ldb,
+                static_cast<float>(beta),
+                C,
+                ldc);
+  }
+
+  // Y = alpha * op(A) * X + beta * Y, as the GEMM of a one column X.
+  template <typename Layout, typename Trans>
+  static void GEMV(Layout layout UNUSED,
+                   Trans trans_a,
+                   int M,
+                   int N,
+                   T alpha,
+                   const T *A,
+                   int lda,
+                   const T *X,
+                   int incx,
+                   T beta,
+                   T *Y,
+                   int incy) {
+    const bool trans = trans_a != CblasNoTrans;
+    HalfGemm<T>(trans,
+                false,
+                trans ? N : M,
+                1,
+                trans ? M : N,
+                static_cast<float>(alpha),
+                A,
+                lda,
+                X,
+                incx,
+                static_cast<float>(beta),
+                Y,
+                incy);
+  }
+
+  template <typename Layout, typename Trans>
+  static void GEMM_BATCH(Layout layout,
+                         const Trans *trans_a,
+                         const Trans *trans_b,
+                         const int *M,
+                         const int *N,
+                         const int *K,
+                         const T *alpha,
+                         const T **A,
+                         const int *lda,
+                         const T **B,
+                         const int *ldb,
+                         const T *beta,
+                         T **C,
+                         const int *ldc,
+                         int group_count,
+                         const int *group_size) {
+    for (int g = 0, i = 0; g < group_count; ++g) {
+      for (int end = i + group_size[g]; i < end; ++i) {
+        GEMM(layout,
+             trans_a[g],
+             trans_b[g],
+             M[g],
+             N[g],
+             K[g],
+             alpha[g],
+             A[i],
+             lda[g],
+             B[i],
+             ldb[g],
+             beta[g],
+             C[i],
+             ldc[g]);
+      }
+    }
+  }
+};
+
 template <>
 struct CBlas<int8_t> {
   template <typename... ARGS>
@@ -64,7 +166,8 @@ struct CBlas<int16_t> {
 };
 
 template <>
-struct CBlas<phi::dtype::bfloat16> {
+struct CBlas<phi::dtype::bfloat16>
+    : public CBlasHalfGemm<phi::dtype::bfloat16> {
   template <typename... ARGS>
   static void AXPY(ARGS... args) {
     detail::axpy(args...);
@@ -954,12 +1057,8 @@ struct CBlas<phi::dtype::complex<double>> {
 #endif
 
 template <>
-struct CBlas<phi::dtype::float16> {
-  static void GEMM(...) {
-    PADDLE_THROW(common::errors::Unimplemented(
-        "float16 GEMM not supported on CPU, please check your code"));
-  }
-
+struct CBlas<phi::dtype::float16>
+    : public CBlasHalfGemm<phi::dtype::float16> {
   static void SMM_GEMM(...) {
     PADDLE_THROW(common::errors::Unimplemented(
         "float16 SMM_GEMM not supported on CPU, please check your code"));
@@ -992,12 +1091,6 @@ struct CBlas<phi::dtype::float16> {
     PADDLE_THROW(common::errors::Unimplemented(
         "float16 ASUM not supported on CPU, please check your code"));
   };
-#ifdef PADDLE_WITH_MKLML
-  static void GEMM_BATCH(...) {
-    PADDLE_THROW(common::errors::Unimplemented(
-        "float16 GEMM_BATCH not supported on CPU, please check your code"));
-  }
-#endif
 };
 
 #ifdef PADDLE_WITH_MKLML
@@ -0,0 +1,248 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/blas/packed_weight_cache.h"
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+
+PHI_DEFINE_EXPORTED_bool(
+    use_packed_weight_cache,
+    true,
+    "Whether to pack the constant weights of CPU fc and matmul once with "
+    "MKL and reuse the packed weights. It takes effect only for the "
+    "weights registered to PackedWeightCache, e.g. the parameters of an "
+    "inference predictor.");
+
+namespace phi {
+namespace funcs {
+
+PackedWeightCache& PackedWeightCache::Instance() {
+  static PackedWeightCache cache;
+  return cache;
+}
+
+bool PackedWeightCache::IsEnabled() {
+#ifdef PADDLE_WITH_MKLML
+  return FLAGS_use_packed_weight_cache;
+#else
+  return false;
+#endif
+}
+
+void PackedWeightCache::RegisterConstant(const DenseTensor& weight) {
+  if (!IsEnabled() || !weight.IsInitialized() ||
+      weight.place().GetType() != AllocationType::CPU ||
+      (weight.dtype() != DataType::FLOAT32 &&
+       weight.dtype() != DataType::FLOAT64) ||
+      weight.dims().size() < 2) {
+    return;
+  }
+  std::unique_lock<std::shared_mutex> guard(mutex_);
+  auto& entry = entries_[weight.data()];
+  if (entry.holder.lock() != weight.Holder()) {
+    entry = Entry();
+    entry.holder = weight.Holder();
+  }
+  entry.version_ref.ShareInplaceVersionCounterWith(weight);
+}
+
+bool PackedWeightCache::IsConstant(const void* data) {
+  std::shared_lock<std::shared_mutex> guard(mutex_);
+  auto it = entries_.find(data);
+  return it != entries_.end() && !it->second.holder.expired();
+}
+
+void PackedWeightCache::Invalidate(const void* data) {
+  std::unique_lock<std::shared_mutex> guard(mutex_);
+  entries_.erase(data);
+}
+
+void PackedWeightCache::ReleaseExpired() {
+  std::unique_lock<std::shared_mutex> guard(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.holder.expired()) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void PackedWeightCache::Clear() {
+  std::unique_lock<std::shared_mutex> guard(mutex_);
+  entries_.clear();
+}
+
+size_t PackedWeightCache::Size() {
+  std::shared_lock<std::shared_mutex> guard(mutex_);
+  size_t size = 0;
+  for (auto& item : entries_) {
+    if (item.second.packed) {
+      ++size;
+    }
+  }
+  return size;
+}
+
+template <typename T>
+std::shared_ptr<const T> PackedWeightCache::Get(const CPUContext& dev_ctx,
+                                                const T* data,
+                                                bool trans,
+                                                int N,
+                                                int K) {
+#ifdef PADDLE_WITH_MKLML
+  auto IsPacked = [&](const Entry& entry, uint32_t version) {
+    return entry.packed && entry.packed_version == version &&
+           entry.trans == trans && entry.N == N && entry.K == K;
+  };
+
+  std::shared_ptr<Allocation> holder;
+  uint32_t version = 0;
+  {
+    std::shared_lock<std::shared_mutex> guard(mutex_);
+    auto it = entries_.find(data);
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+    auto& entry = it->second;
+    holder = entry.holder.lock();
+    if (holder) {
+      version = entry.version_ref.InplaceVersionCounter().CurrentVersion();
+      if (IsPacked(entry, version)) {
+        return std::static_pointer_cast<const T>(entry.packed);
+      }
+    }
+  }
+  if (!holder) {
+    // The allocation is freed, and data may be reused by another tensor.
+    std::unique_lock<std::shared_mutex> guard(mutex_);
+    auto it = entries_.find(data);
+    if (it != entries_.end() && it->second.holder.expired()) {
+      entries_.erase(it);
+    }
+    return nullptr;
+  }
+
+  // Pack without holding the lock, other weights are looked up meanwhile.
+  auto blas = GetBlas<CPUContext, T>(dev_ctx);
+  T* packed_data = blas.GEMM_ALLOC(CblasBMatrix, 1, N, K);
+  PADDLE_ENFORCE_NOT_NULL(
+      packed_data,
+      common::errors::ResourceExhausted(
+          "Failed to allocate the packed weight of [%d, %d] by GEMM_ALLOC.",
+          K,
+          N));
+  std::shared_ptr<void> packed(packed_data, [](void* ptr) {
+    CBlas<T>::GEMM_FREE(static_cast<T*>(ptr));
+  });
+  blas.GEMM_PACK(CblasBMatrix,
+                 trans ? CblasTrans : CblasNoTrans,
+                 1,
+                 N,
+                 K,
+                 static_cast<T>(1),
+                 data,
+                 trans ? K : N,
+                 packed_data);
+  VLOG(4) << "Pack the constant weight " << data << " of [" << K << ", " << N
+          << "], trans: " << trans;
+
+  std::unique_lock<std::shared_mutex> guard(mutex_);
+  auto it = entries_.find(data);
+  if (it == entries_.end() || it->second.holder.lock() != holder) {
+    // Invalidated while packing, the packed weight is only used by this call.
+    return std::static_pointer_cast<const T>(packed);
+  }
+  auto& entry = it->second;
+  if (IsPacked(entry, version)) {
+    // Another thread has packed the same weight.
+    return std::static_pointer_cast<const T>(entry.packed);
+  }
+  entry.packed = packed;
+  entry.packed_version = version;
+  entry.trans = trans;
+  entry.N = N;
+  entry.K = K;
+  return std::static_pointer_cast<const T>(packed);
+#else
+  return nullptr;
+#endif
+}
+
+template <typename T>
+bool PackedGEMM(const CPUContext& dev_ctx,
+                bool trans_b,
+                int M,
+                int N,
+                int K,
+                const T* A,
+                const T* B,
+                T beta,
+                T* C) {
+#ifdef PADDLE_WITH_MKLML
+  if (!PackedWeightCache::IsEnabled() || M <= 0 || N <= 0 || K <= 0) {
+    return false;
+  }
+  auto packed = PackedWeightCache::Instance().Get<T>(dev_ctx, B, trans_b, N, K);
+  if (!packed) {
+    return false;
+  }
+  auto blas = GetBlas<CPUContext, T>(dev_ctx);
+  blas.GEMM_COMPUTE(CblasNoTrans,
+                    CblasPacked,
+                    M,
+                    N,
+                    K,
+                    A,
+                    K,
+                    packed.get(),
+                    trans_b ? K : N,
+                    beta,
+                    C,
+                    N);
+  return true;
+#else
+  return false;
+#endif
+}
+
+template std::shared_ptr<const float> PackedWeightCache::Get<float>(
+    const CPUContext&, const float*, bool, int, int);
+template std::shared_ptr<const double> PackedWeightCache::Get<double>(
+    const CPUContext&, const double*, bool, int, int);
+
+template bool PackedGEMM<float>(const CPUContext&,
+                                bool,
+                                int,
+                                int,
+                                int,
+                                const float*,
+                                const float*,
+                                float,
+                                float*);
+template bool PackedGEMM<double>(const CPUContext&,
+                                 bool,
+                                 int,
+                                 int,
+                                 int,
+                                 const double*,
+                                 const double*,
+                                 double,
+                                 double*);
+
+}  // namespace funcs
+}  // namespace phi
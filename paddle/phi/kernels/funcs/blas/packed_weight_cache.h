@@ -0,0 +1,110 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+namespace funcs {
+
+// Keeps the MKL packed form (cblas_?gemm_pack) of constant GEMM weights, so
+// that small-batch fc and matmul do not repack the weight on every call.
+//
+// Only the tensors registered by RegisterConstant, e.g. the parameters of an
+// inference predictor, are packed. A weight is packed on its first use, and
+// repacked when its inplace version changes. The packed weight is released
+// when the weight's allocation is freed (see ReleaseExpired) or by
+// Invalidate/Clear. Code that writes to a registered weight in place without
+// bumping its inplace version must call Invalidate.
+//
+// Without MKLML, or with FLAGS_use_packed_weight_cache off, nothing is
+// registered and the kernels fall back to the plain GEMM.
+class TEST_API PackedWeightCache {
+ public:
+  static PackedWeightCache& Instance();
+
+  static bool IsEnabled();
+
+  // Marks a float or double CPU tensor as constant. It is a no-op when the
+  // cache is disabled.
+  void RegisterConstant(const DenseTensor& weight);
+
+  bool IsConstant(const void* data);
+
+  // Drops the packed form of the weight at data, and unregisters it.
+  void Invalidate(const void* data);
+
+  // Drops the weights whose allocations have been freed.
+  void ReleaseExpired();
+
+  void Clear();
+
+  // Number of packed weights.
+  size_t Size();
+
+  // Returns the packed form of the row-major weight B at data, which is
+  // [K, N], or [N, K] if trans, packed on the first call. Returns nullptr if
+  // data is not a registered constant. Hits only take the shared lock, and
+  // the weight is packed outside of the lock.
+  template <typename T>
+  std::shared_ptr<const T> Get(const CPUContext& dev_ctx,
+                               const T* data,
+                               bool trans,
+                               int N,
+                               int K);
+
+ private:
+  struct Entry {
+    std::weak_ptr<Allocation> holder;
+    // shares the inplace version counter of the registered tensor
+    DenseTensor version_ref;
+    uint32_t packed_version = 0;
+    bool trans = false;
+    int N = 0;
+    int K = 0;
+    std::shared_ptr<void> packed;
+  };
+
+  PackedWeightCache() = default;
+  DISABLE_COPY_AND_ASSIGN(PackedWeightCache);
+
+  std::shared_mutex mutex_;
+  std::unordered_map<const void*, Entry> entries_;
+};
+
+// C[M, N] = A[M, K] * op(B) + beta * C with the packed B, where op(B) is B^T
+// if trans_b. Returns false without touching C if B is not a registered
+// constant, so the caller falls back to the plain GEMM.
+template <typename T>
+bool PackedGEMM(const CPUContext& dev_ctx,
+                bool trans_b,
+                int M,
+                int N,
+                int K,
+                const T* A,
+                const T* B,
+                T beta,
+                T* C);
+
+}  // namespace funcs
+}  // namespace phi
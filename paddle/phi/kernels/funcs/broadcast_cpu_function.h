@@ -0,0 +1,346 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <numeric>
+#include <vector>
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/kernels/funcs/dims_simplifier.h"
+
+namespace phi {
+namespace funcs {
+
+// Broadcasts smaller than this run on the calling thread.
+constexpr int64_t kCPUBroadcastParallelNumel = 1 << 15;
+
+// Layout of a binary broadcast on CPU. The dims are merged by
+// BroadcastDimsSimplifier and stored innermost first, so that the innermost
+// dim is a contiguous run of the output, and each input either runs along it
+// (stride 1) or repeats one element over it (stride 0).
+struct CPUBroadcastLayout {
+  enum Operand { kX = 0, kY, kOut, kNumOperands };
+
+  int rank;
+  int64_t numel;
+  std::vector<int64_t> out_dims;
+  // strides of x, y and out on each dim, 0 on the broadcast dims of an input
+  std::array<std::vector<int64_t>, kNumOperands> strides;
+
+  CPUBroadcastLayout(const int *x_dims_array,
+                     const int *y_dims_array,
+                     const int *out_dims_array,
+                     int max_dim) {
+    using DimVector = BroadcastDimsSimplifier::DimVector;
+    DimVector out(out_dims_array, out_dims_array + max_dim);
+    numel = std::accumulate(
+        out.begin(), out.end(), int64_t{1}, std::multiplies<int64_t>());
+    if (numel == 0 || max_dim == 0) {
+      // Nothing to simplify, keep a rank-1 layout so that InnerSize() works.
+      rank = 1;
+      out_dims = {numel};
+      for (auto &stride : strides) {
+        stride = {1};
+      }
+      return;
+    }
+    BroadcastDimsSimplifier simplifier(
+        {DimVector(x_dims_array, x_dims_array + max_dim),
+         DimVector(y_dims_array, y_dims_array + max_dim)},
+        out,
+        0);
+    // BroadcastDimsSimplifier only merges one run of 1s of each input, e.g.
+    // y = [1, 64, 1, 1] is kept as is, so merge the adjacent dims on which
+    // both inputs are either broadcast or not once more.
+    std::array<DimVector, kNumOperands> dims = {
+        simplifier.in_dims[kX], simplifier.in_dims[kY], simplifier.out_dims};
+    rank = 0;
+    for (int k = 0; k < simplifier.rank; ++k) {
+      bool mergeable = rank > 0;
+      for (int i = 0; mergeable && i < kOut; ++i) {
+        mergeable = (dims[i][rank - 1] == 1) == (dims[i][k] == 1);
+      }
+      if (mergeable || (rank > 0 && dims[kOut][k] == 1)) {
+        for (auto &dim : dims) {
+          dim[rank - 1] *= dim[k];
+        }
+      } else if (rank > 0 && dims[kOut][rank - 1] == 1) {
+        for (auto &dim : dims) {
+          dim[rank - 1] = dim[k];
+        }
+      } else {
+        for (auto &dim : dims) {
+          dim[rank] = dim[k];
+        }
+        ++rank;
+      }
+    }
+    out_dims.assign(dims[kOut].begin(), dims[kOut].begin() + rank);
+    for (int i = 0; i < kNumOperands; ++i) {
+      strides[i].resize(rank);
+      int64_t stride = 1;
+      for (int k = 0; k < rank; ++k) {
+        strides[i][k] = dims[i][k] == 1 ? 0 : stride;
+        stride *= dims[i][k];
+      }
+    }
+  }
+
+  int64_t InnerSize() const { return out_dims[0]; }
+  int64_t OuterSize() const {
+    return InnerSize() == 0 ? 0 : numel / InnerSize();
+  }
+};
+
+// Walks the rows (all the dims but the innermost one) of a broadcast in order,
+// dims[0] varying fastest, and tracks the offset of each operand in the row.
+// Only the starting row is decomposed with divisions, the following ones are
+// reached by adding strides.
+template <int NumOperands>
+class BroadcastRowIterator {
+ public:
+  BroadcastRowIterator(
+      const std::vector<int64_t> &dims,
+      const std::array<std::vector<int64_t>, NumOperands> &strides,
+      int64_t row)
+      : dims_(dims), strides_(strides), index_(dims.size(), 0) {
+    offsets_.fill(0);
+    for (size_t k = 0; k < dims_.size(); ++k) {
+      index_[k] = row % dims_[k];
+      row /= dims_[k];
+      for (int n = 0; n < NumOperands; ++n) {
+        offsets_[n] += index_[k] * strides_[n][k];
+      }
+    }
+  }
+
+  void Next() {
+    for (size_t k = 0; k < dims_.size(); ++k) {
+      ++index_[k];
+      for (int n = 0; n < NumOperands; ++n) {
+        offsets_[n] += strides_[n][k];
+      }
+      if (index_[k] < dims_[k]) {
+        return;
+      }
+      for (int n = 0; n < NumOperands; ++n) {
+        offsets_[n] -= dims_[k] * strides_[n][k];
+      }
+      index_[k] = 0;
+    }
+  }
+
+  int64_t Offset(int n) const { return offsets_[n]; }
+
+ private:
+  const std::vector<int64_t> &dims_;
+  const std::array<std::vector<int64_t>, NumOperands> &strides_;
+  std::vector<int64_t> index_;
+  std::array<int64_t, NumOperands> offsets_;
+};
+
+// Splits [0, num_rows) into one contiguous range per thread. Exceptions
+// thrown by the callback (e.g. integer division by zero) are rethrown on the
+// calling thread.
+template <typename Callback>
+void BroadcastParallelFor(int64_t num_rows,
+                          int64_t row_size,
+                          const Callback &callback) {
+#ifdef PADDLE_WITH_MKLML
+  if (num_rows > 1 && num_rows * row_size >= kCPUBroadcastParallelNumel &&
+      !omp_in_parallel()) {
+    const int num_threads = static_cast<int>(
+        std::min<int64_t>(omp_get_max_threads(), num_rows));
+    std::exception_ptr exception = nullptr;
+#pragma omp parallel for num_threads(num_threads)
+    for (int t = 0; t < num_threads; ++t) {
+      try {
+        callback(num_rows * t / num_threads, num_rows * (t + 1) / num_threads);
+      } catch (...) {
+#pragma omp critical
+        if (!exception) {
+          exception = std::current_exception();
+        }
+      }
+    }
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+    return;
+  }
+#endif
+  callback(0, num_rows);
+}
+
+// Computes one contiguous run of the output. The loops over a contiguous
+// input and a splatted scalar are kept separate, so that the compiler can
+// vectorize each of them.
+template <typename InT, typename OutT, typename Functor>
+inline void BroadcastBinaryRun(const InT *x,
+                               int64_t x_stride,
+                               const InT *y,
+                               int64_t y_stride,
+                               OutT *out,
+                               int64_t n,
+                               Functor func) {
+  if (x_stride != 0 && y_stride != 0) {
+    for (int64_t i = 0; i < n; ++i) {
+      out[i] = func(x[i], y[i]);
+    }
+  } else if (x_stride != 0) {
+    const InT b = *y;
+    for (int64_t i = 0; i < n; ++i) {
+      out[i] = func(x[i], b);
+    }
+  } else if (y_stride != 0) {
+    const InT a = *x;
+    for (int64_t i = 0; i < n; ++i) {
+      out[i] = func(a, y[i]);
+    }
+  } else {
+    std::fill(out, out + n, static_cast<OutT>(func(*x, *y)));
+  }
+}
+
+// out = func(x, y), with x and y broadcast to the output as described by
+// layout.
+template <typename InT, typename OutT, typename Functor>
+void BroadcastBinaryCPU(const CPUBroadcastLayout &layout,
+                        const InT *x,
+                        const InT *y,
+                        OutT *out,
+                        Functor func) {
+  using Layout = CPUBroadcastLayout;
+  const int64_t inner = layout.InnerSize();
+  const int64_t outer = layout.OuterSize();
+  if (outer == 0) {
+    return;
+  }
+  const int64_t x_stride = layout.strides[Layout::kX][0];
+  const int64_t y_stride = layout.strides[Layout::kY][0];
+
+  std::vector<int64_t> row_dims(layout.out_dims.begin() + 1,
+                                layout.out_dims.end());
+  std::array<std::vector<int64_t>, 2> row_strides;
+  for (int n = 0; n < 2; ++n) {
+    row_strides[n].assign(layout.strides[n].begin() + 1,
+                          layout.strides[n].end());
+  }
+
+  BroadcastParallelFor(outer, inner, [&](int64_t begin, int64_t end) {
+    BroadcastRowIterator<2> iter(row_dims, row_strides, begin);
+    for (int64_t row = begin; row < end; ++row, iter.Next()) {
+      BroadcastBinaryRun(x + iter.Offset(Layout::kX),
+                         x_stride,
+                         y + iter.Offset(Layout::kY),
+                         y_stride,
+                         out + row * inner,
+                         inner,
+                         func);
+    }
+  });
+}
+
+// Gradient of a binary broadcast for one input: d[i] is the sum of
+// op(x, y, out, dout) over all the output elements which input element i is
+// broadcast to. The rows of the output are reordered so that the rows reduced
+// into one row of d are consecutive, then each thread owns a range of rows of
+// d and no atomics are needed. The sum is accumulated in MPType.
+template <typename T, typename Tout, typename OP>
+void BroadcastGradReduceCPU(const CPUBroadcastLayout &layout,
+                            CPUBroadcastLayout::Operand target,
+                            const T *x,
+                            const T *y,
+                            const Tout *out,
+                            const Tout *dout,
+                            T *d,
+                            OP op) {
+  using Layout = CPUBroadcastLayout;
+  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
+  const int64_t inner = layout.InnerSize();
+  const int64_t outer = layout.OuterSize();
+  const int64_t x_stride = layout.strides[Layout::kX][0];
+  const int64_t y_stride = layout.strides[Layout::kY][0];
+  const bool reduce_inner = layout.strides[target][0] == 0 && inner > 1;
+
+  // reduced dims first, so that they vary fastest
+  std::vector<int64_t> row_dims;
+  std::array<std::vector<int64_t>, Layout::kNumOperands> row_strides;
+  int64_t reduce_rows = 1;
+  for (int pass = 0; pass < 2; ++pass) {
+    for (int k = 1; k < layout.rank; ++k) {
+      bool reduced = layout.strides[target][k] == 0 && layout.out_dims[k] > 1;
+      if (reduced != (pass == 0)) {
+        continue;
+      }
+      row_dims.push_back(layout.out_dims[k]);
+      for (int n = 0; n < Layout::kNumOperands; ++n) {
+        row_strides[n].push_back(layout.strides[n][k]);
+      }
+      if (reduced) {
+        reduce_rows *= layout.out_dims[k];
+      }
+    }
+  }
+  const int64_t d_rows = outer / reduce_rows;
+
+  auto reduce_rows_of_d = [&](int64_t begin, int64_t end) {
+    std::vector<MPType> acc(reduce_inner ? 1 : inner);
+    BroadcastRowIterator<Layout::kNumOperands> iter(
+        row_dims, row_strides, begin * reduce_rows);
+    for (int64_t d_row = begin; d_row < end; ++d_row) {
+      T *d_data = d + iter.Offset(target);
+      std::fill(acc.begin(), acc.end(), static_cast<MPType>(0));
+      for (int64_t r = 0; r < reduce_rows; ++r, iter.Next()) {
+        const T *x_data = x + iter.Offset(Layout::kX);
+        const T *y_data = y + iter.Offset(Layout::kY);
+        const Tout *out_data = out + iter.Offset(Layout::kOut);
+        const Tout *dout_data = dout + iter.Offset(Layout::kOut);
+        if (reduce_inner) {
+          MPType sum = static_cast<MPType>(0);
+          for (int64_t i = 0; i < inner; ++i) {
+            sum += static_cast<MPType>(op(x_data[i * x_stride],
+                                          y_data[i * y_stride],
+                                          out_data[i],
+                                          dout_data[i]));
+          }
+          acc[0] += sum;
+        } else {
+          for (int64_t i = 0; i < inner; ++i) {
+            acc[i] += static_cast<MPType>(op(x_data[i * x_stride],
+                                             y_data[i * y_stride],
+                                             out_data[i],
+                                             dout_data[i]));
+          }
+        }
+      }
+      for (size_t i = 0; i < acc.size(); ++i) {
+        d_data[i] = static_cast<T>(acc[i]);
+      }
+    }
+  };
+  BroadcastParallelFor(d_rows, reduce_rows * inner, reduce_rows_of_d);
+}
+
+}  // namespace funcs
+}  // namespace phi
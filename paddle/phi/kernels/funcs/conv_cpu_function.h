@@ -0,0 +1,662 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+
+COMMON_DECLARE_string(cpu_conv2d_algo);
+
+namespace phi {
+namespace funcs {
+
+// The algorithms of the CPU conv2d engine. They all read NCHW inputs and
+// KCRS filters and write NCHW outputs.
+enum class CPUConvAlgo {
+  // im2col (or vol2col) + GEMM of ConvKernelImpl, one sample and group
+  // after the other.
+  kLegacy,
+  // im2col + GEMM of the (sample, group) pairs in parallel, each thread with
+  // its own column buffer. Skips im2col for 1x1 convs of stride 1.
+  kIm2ColGemm,
+  // Direct conv of blocks of kCPUConvDirectBlock output channels, from
+  // filters packed by block, for convs with a short reduction, e.g. the
+  // first layer of a network, where im2col costs as much as the GEMM.
+  kDirect,
+  // Direct conv of each channel, for groups == input channels.
+  kDepthwise,
+  // Winograd F(2x2, 3x3) and F(4x4, 3x3) for 3x3 convs of stride 1,
+  // which do 2.25x and 4x less multiplications than the direct conv.
+  kWinogradF23,
+  kWinogradF43,
+};
+
+constexpr int64_t kCPUConvDirectBlock = 8;
+constexpr int64_t kCPUConvDirectTileW = 4;
+// Tiles transformed and multiplied together by a Winograd conv.
+constexpr int64_t kCPUConvWinogradTileBlock = 128;
+
+struct CPUConv2DShape {
+  int64_t batch;
+  int64_t in_channels;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_channels;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+  int64_t pad_top;
+  int64_t pad_left;
+  int64_t groups;
+
+  bool IsKernel(int64_t kh, int64_t kw, int64_t stride) const {
+    return kernel_h == kh && kernel_w == kw && stride_h == stride &&
+           stride_w == stride && dilation_h == 1 && dilation_w == 1;
+  }
+};
+
+inline bool CPUConvAlgoSupports(CPUConvAlgo algo, const CPUConv2DShape& s) {
+  switch (algo) {
+    case CPUConvAlgo::kDepthwise:
+      return s.groups > 1 && s.groups == s.in_channels &&
+             s.out_channels % s.in_channels == 0;
+    case CPUConvAlgo::kDirect:
+      return s.groups == 1;
+    case CPUConvAlgo::kWinogradF23:
+    case CPUConvAlgo::kWinogradF43:
+      return s.groups == 1 && s.IsKernel(3, 3, 1);
+    default:
+      return true;
+  }
+}
+
+// Picks the algorithm of a conv, or the one FLAGS_cpu_conv2d_algo forces if
+// it supports the conv. The thresholds come from the ResNet and MobileNet
+// layers of test_cpu_conv. kDirect lost to im2col + GEMM on all of them, so
+// it only runs when forced.
+inline CPUConvAlgo SelectCPUConvAlgo(const CPUConv2DShape& s) {
+  const std::string& forced = FLAGS_cpu_conv2d_algo;
+  CPUConvAlgo algo = CPUConvAlgo::kIm2ColGemm;
+  if (forced == "legacy") {
+    return CPUConvAlgo::kLegacy;
+  } else if (forced == "im2col") {
+    return CPUConvAlgo::kIm2ColGemm;
+  } else if (forced == "direct") {
+    algo = CPUConvAlgo::kDirect;
+  } else if (forced == "depthwise") {
+    algo = CPUConvAlgo::kDepthwise;
+  } else if (forced == "winograd_f23") {
+    algo = CPUConvAlgo::kWinogradF23;
+  } else if (forced == "winograd_f43") {
+    algo = CPUConvAlgo::kWinogradF43;
+  }
+  if (algo != CPUConvAlgo::kIm2ColGemm && CPUConvAlgoSupports(algo, s)) {
+    return algo;
+  }
+
+  if (CPUConvAlgoSupports(CPUConvAlgo::kDepthwise, s)) {
+    return CPUConvAlgo::kDepthwise;
+  }
+  // Below 32 channels the transforms cost more than the GEMMs save, and
+  // F(4x4, 3x3) wastes most of its tiles on small outputs.
+  const int64_t out_size = std::min(s.out_h, s.out_w);
+  if (s.groups == 1 && s.IsKernel(3, 3, 1) && s.in_channels >= 32 &&
+      s.out_channels >= 32 && out_size >= 12) {
+    return out_size >= 24 ? CPUConvAlgo::kWinogradF43
+                          : CPUConvAlgo::kWinogradF23;
+  }
+  return CPUConvAlgo::kIm2ColGemm;
+}
+
+inline int CPUConvNumThreads() {
+#ifdef PADDLE_WITH_MKLML
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+// Calls f(task, thread) for the tasks [0, n), in parallel if there are
+// several of them.
+template <typename F>
+void CPUConvParallelFor(int64_t n, const F& f) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for schedule(static) if (n > 1)
+#endif
+  for (int64_t task = 0; task < n; ++task) {
+#ifdef PADDLE_WITH_MKLML
+    f(task, omp_get_thread_num());
+#else
+    f(task, 0);
+#endif
+  }
+}
+
+// The outputs [*begin, *end) of a row whose inputs o * stride + offset fall
+// into [0, in_size).
+inline void CPUConvValidRange(int64_t offset,
+                              int64_t stride,
+                              int64_t in_size,
+                              int64_t out_size,
+                              int64_t* begin,
+                              int64_t* end) {
+  // ceil((-offset) / stride) and floor((in_size - 1 - offset) / stride),
+  // for numerators of any sign.
+  auto floor_div = [](int64_t a, int64_t b) {
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+  };
+  *begin = std::max<int64_t>(0, -floor_div(offset, stride));
+  *end = std::min<int64_t>(out_size,
+                           floor_div(in_size - 1 - offset, stride) + 1);
+  *end = std::max(*begin, *end);
+}
+
+// Writes the columns [channels * kernel_h * kernel_w, out_h * out_w] of the
+// channels planes of one sample and group.
+template <typename T>
+void CPUConvIm2Col(const CPUConv2DShape& s,
+                   const T* im,
+                   int64_t channels,
+                   T* col) {
+  for (int64_t c = 0; c < channels; ++c) {
+    for (int64_t kh = 0; kh < s.kernel_h; ++kh) {
+      for (int64_t kw = 0; kw < s.kernel_w; ++kw) {
+        const T* plane = im + c * s.in_h * s.in_w;
+        const int64_t w_offset = kw * s.dilation_w - s.pad_left;
+        int64_t ow_begin, ow_end;
+        CPUConvValidRange(
+            w_offset, s.stride_w, s.in_w, s.out_w, &ow_begin, &ow_end);
+        for (int64_t oh = 0; oh < s.out_h; ++oh, col += s.out_w) {
+          const int64_t ih = oh * s.stride_h - s.pad_top + kh * s.dilation_h;
+          if (ih < 0 || ih >= s.in_h) {
+            std::fill(col, col + s.out_w, static_cast<T>(0));
+            continue;
+          }
+          const T* row = plane + ih * s.in_w;
+          std::fill(col, col + ow_begin, static_cast<T>(0));
+          if (s.stride_w == 1) {
+            std::copy(row + ow_begin + w_offset,
+                      row + ow_end + w_offset,
+                      col + ow_begin);
+          } else {
+            for (int64_t ow = ow_begin; ow < ow_end; ++ow) {
+              col[ow] = row[ow * s.stride_w + w_offset];
+            }
+          }
+          std::fill(col + ow_end, col + s.out_w, static_cast<T>(0));
+        }
+      }
+    }
+  }
+}
+
+// gemm(m, n, k, a, b, c) computes the row major c[m, n] = a[m, k] * b[k, n].
+template <typename T, typename Gemm>
+void CPUConvIm2ColGemm(const CPUConv2DShape& s,
+                       const T* input,
+                       const T* filter,
+                       T* output,
+                       const Gemm& gemm) {
+  const int64_t in_step = s.in_channels / s.groups;
+  const int64_t out_step = s.out_channels / s.groups;
+  const int64_t col_rows = in_step * s.kernel_h * s.kernel_w;
+  const int64_t out_size = s.out_h * s.out_w;
+  const bool need_col = !(s.IsKernel(1, 1, 1) && s.pad_top == 0 &&
+                          s.pad_left == 0 && s.in_h == s.out_h &&
+                          s.in_w == s.out_w);
+  std::vector<std::vector<T>> cols(CPUConvNumThreads());
+  CPUConvParallelFor(s.batch * s.groups, [&](int64_t task, int thread) {
+    const int64_t n = task / s.groups, g = task % s.groups;
+    const T* im = input + (n * s.in_channels + g * in_step) * s.in_h * s.in_w;
+    const T* col = im;
+    if (need_col) {
+      auto& buffer = cols[thread];
+      buffer.resize(col_rows * out_size);
+      CPUConvIm2Col(s, im, in_step, buffer.data());
+      col = buffer.data();
+    }
+    gemm(out_step,
+         out_size,
+         col_rows,
+         filter + g * out_step * col_rows,
+         col,
+         output + (n * s.out_channels + g * out_step) * out_size);
+  });
+}
+
+template <typename T>
+void CPUConvDepthwise(const CPUConv2DShape& s,
+                      const T* input,
+                      const T* filter,
+                      T* output) {
+  const int64_t multiplier = s.out_channels / s.in_channels;
+  const int64_t kernel_size = s.kernel_h * s.kernel_w;
+  CPUConvParallelFor(s.batch * s.out_channels, [&](int64_t task, int) {
+    const int64_t n = task / s.out_channels, k = task % s.out_channels;
+    const T* plane =
+        input + (n * s.in_channels + k / multiplier) * s.in_h * s.in_w;
+    const T* w = filter + k * kernel_size;
+    T* out = output + task * s.out_h * s.out_w;
+    std::fill(out, out + s.out_h * s.out_w, static_cast<T>(0));
+    for (int64_t kw = 0; kw < s.kernel_w; ++kw) {
+      const int64_t w_offset = kw * s.dilation_w - s.pad_left;
+      int64_t ow_begin, ow_end;
+      CPUConvValidRange(
+          w_offset, s.stride_w, s.in_w, s.out_w, &ow_begin, &ow_end);
+      for (int64_t oh = 0; oh < s.out_h; ++oh) {
+        T* out_row = out + oh * s.out_w;
+        for (int64_t kh = 0; kh < s.kernel_h; ++kh) {
+          const int64_t ih = oh * s.stride_h - s.pad_top + kh * s.dilation_h;
+          if (ih < 0 || ih >= s.in_h) {
+            continue;
+          }
+          const T* row = plane + ih * s.in_w + w_offset;
+          const T weight = w[kh * s.kernel_w + kw];
+          if (s.stride_w == 1) {
+            for (int64_t ow = ow_begin; ow < ow_end; ++ow) {
+              out_row[ow] += weight * row[ow];
+            }
+          } else {
+            for (int64_t ow = ow_begin; ow < ow_end; ++ow) {
+              out_row[ow] += weight * row[ow * s.stride_w];
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+// Direct conv of groups == 1 on a zero padded copy of the input, so its
+// inner loop needs no bounds checks. The filters of kCPUConvDirectBlock
+// output channels are packed together, and the kCPUConvDirectBlock x
+// kCPUConvDirectTileW outputs of a block and a tile of a row stay in
+// registers while the loop runs over the input channels and the kernel.
+template <typename T>
+void CPUConvDirect(const CPUConv2DShape& s,
+                   const T* input,
+                   const T* filter,
+                   T* output) {
+  constexpr int64_t kBlock = kCPUConvDirectBlock;
+  constexpr int64_t kTile = kCPUConvDirectTileW;
+  const int64_t reduce_size = s.in_channels * s.kernel_h * s.kernel_w;
+  const int64_t num_blocks = (s.out_channels + kBlock - 1) / kBlock;
+  const int64_t tiles_w = (s.out_w + kTile - 1) / kTile;
+  // The last tile of a row may read past out_w, into the padding.
+  const int64_t padded_h = std::max(
+      s.pad_top + s.in_h,
+      (s.out_h - 1) * s.stride_h + (s.kernel_h - 1) * s.dilation_h + 1);
+  const int64_t padded_w = std::max(
+      s.pad_left + s.in_w,
+      (tiles_w * kTile - 1) * s.stride_w + (s.kernel_w - 1) * s.dilation_w + 1);
+  const int64_t padded_size = padded_h * padded_w;
+  std::vector<T> padded(s.batch * s.in_channels * padded_size);
+  CPUConvParallelFor(s.batch * s.in_channels, [&](int64_t task, int) {
+    T* dst = padded.data() + task * padded_size;
+    const T* src = input + task * s.in_h * s.in_w;
+    std::fill(dst, dst + padded_size, static_cast<T>(0));
+    for (int64_t h = 0; h < s.in_h; ++h) {
+      std::copy(src + h * s.in_w,
+                src + (h + 1) * s.in_w,
+                dst + (s.pad_top + h) * padded_w + s.pad_left);
+    }
+  });
+  // packed[block][c][kh][kw][j] = filter[block * kBlock + j][c][kh][kw].
+  std::vector<T> packed(num_blocks * reduce_size * kBlock, static_cast<T>(0));
+  for (int64_t k = 0; k < s.out_channels; ++k) {
+    T* dst = packed.data() + (k / kBlock) * reduce_size * kBlock + k % kBlock;
+    for (int64_t r = 0; r < reduce_size; ++r) {
+      dst[r * kBlock] = filter[k * reduce_size + r];
+    }
+  }
+
+  CPUConvParallelFor(s.batch * num_blocks, [&](int64_t task, int) {
+    const int64_t n = task / num_blocks, block = task % num_blocks;
+    const int64_t block_size =
+        std::min(kBlock, s.out_channels - block * kBlock);
+    const T* in = padded.data() + n * s.in_channels * padded_size;
+    const T* w_block = packed.data() + block * reduce_size * kBlock;
+    T* out = output + (n * s.out_channels + block * kBlock) * s.out_h * s.out_w;
+    for (int64_t oh = 0; oh < s.out_h; ++oh) {
+      for (int64_t tile = 0; tile < tiles_w; ++tile) {
+        T acc[kTile][kBlock] = {};
+        const T* base =
+            in + oh * s.stride_h * padded_w + tile * kTile * s.stride_w;
+        const T* w = w_block;
+        for (int64_t c = 0; c < s.in_channels; ++c) {
+          for (int64_t kh = 0; kh < s.kernel_h; ++kh) {
+            const T* row =
+                base + c * padded_size + kh * s.dilation_h * padded_w;
+            for (int64_t kw = 0; kw < s.kernel_w; ++kw, w += kBlock) {
+              const T* x = row + kw * s.dilation_w;
+              for (int64_t q = 0; q < kTile; ++q) {
+                const T value = x[q * s.stride_w];
+                for (int64_t j = 0; j < kBlock; ++j) {
+                  acc[q][j] += value * w[j];
+                }
+              }
+            }
+          }
+        }
+        const int64_t count = std::min(kTile, s.out_w - tile * kTile);
+        for (int64_t j = 0; j < block_size; ++j) {
+          T* out_row = out + (j * s.out_h + oh) * s.out_w + tile * kTile;
+          for (int64_t q = 0; q < count; ++q) {
+            out_row[q] = acc[q][j];
+          }
+        }
+      }
+    }
+  });
+}
+
+// The transforms of Winograd F(M x M, 3 x 3) (Lavin and Gray, "Fast
+// Algorithms for Convolutional Neural Networks"): a tile of alpha x alpha
+// inputs d and a filter g give the M x M outputs
+//   A^T [(G g G^T) .* (B^T d B)] A,  alpha = M + 2.
+template <int M>
+struct CPUWinograd;
+
+template <>
+struct CPUWinograd<2> {
+  static constexpr int kAlpha = 4;
+  static constexpr float kBT[4][4] = {
+      {1, 0, -1, 0}, {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, 0, -1}};
+  static constexpr float kG[4][3] = {
+      {1, 0, 0}, {0.5, 0.5, 0.5}, {0.5, -0.5, 0.5}, {0, 0, 1}};
+  static constexpr float kAT[2][4] = {{1, 1, 1, 0}, {0, 1, -1, -1}};
+};
+
+template <>
+struct CPUWinograd<4> {
+  static constexpr int kAlpha = 6;
+  static constexpr float kBT[6][6] = {{4, 0, -5, 0, 1, 0},
+                                      {0, -4, -4, 1, 1, 0},
+                                      {0, 4, -4, -1, 1, 0},
+                                      {0, -2, -1, 2, 1, 0},
+                                      {0, 2, -1, -2, 1, 0},
+                                      {0, 4, 0, -5, 0, 1}};
+  static constexpr float kG[6][3] = {{1.0f / 4, 0, 0},
+                                     {-1.0f / 6, -1.0f / 6, -1.0f / 6},
+                                     {-1.0f / 6, 1.0f / 6, -1.0f / 6},
+                                     {1.0f / 24, 1.0f / 12, 1.0f / 6},
+                                     {1.0f / 24, -1.0f / 12, 1.0f / 6},
+                                     {0, 0, 1}};
+  static constexpr float kAT[4][6] = {{1, 1, 1, 1, 1, 0},
+                                      {0, 1, -1, 2, -2, 0},
+                                      {0, 1, 1, 4, 4, 0},
+                                      {0, 1, -1, 8, -8, 1}};
+};
+
+// out[r][c] = sum_i sum_j left[r][i] * in[i][j] * left[c][j], i.e.
+// left * in * left^T for row major matrices.
+template <typename T, int R, int N, typename L>
+inline void CPUWinogradSandwich(const L (&left)[R][N],
+                                const T (&in)[N][N],
+                                T (&out)[R][R]) {
+  T tmp[R][N];
+  for (int r = 0; r < R; ++r) {
+    for (int j = 0; j < N; ++j) {
+      T sum = 0;
+      for (int i = 0; i < N; ++i) {
+        sum += static_cast<T>(left[r][i]) * in[i][j];
+      }
+      tmp[r][j] = sum;
+    }
+  }
+  for (int r = 0; r < R; ++r) {
+    for (int c = 0; c < R; ++c) {
+      T sum = 0;
+      for (int j = 0; j < N; ++j) {
+        sum += tmp[r][j] * static_cast<T>(left[c][j]);
+      }
+      out[r][c] = sum;
+    }
+  }
+}
+
+template <typename T, int M, typename Gemm>
+void CPUConvWinograd(const CPUConv2DShape& s,
+                     const T* input,
+                     const T* filter,
+                     T* output,
+                     const Gemm& gemm) {
+  using W = CPUWinograd<M>;
+  constexpr int kAlpha = W::kAlpha;
+  constexpr int kElems = kAlpha * kAlpha;
+  const int64_t C = s.in_channels, K = s.out_channels;
+
+  // u[e][k][c]: the transformed filters, one K x C matrix per element.
+  std::vector<T> u(kElems * K * C);
+  CPUConvParallelFor(K, [&](int64_t k, int) {
+    for (int64_t c = 0; c < C; ++c) {
+      const T* g = filter + (k * C + c) * 9;
+      T gt[kAlpha][3];
+      for (int r = 0; r < kAlpha; ++r) {
+        for (int j = 0; j < 3; ++j) {
+          gt[r][j] = static_cast<T>(W::kG[r][0]) * g[j] +
+                     static_cast<T>(W::kG[r][1]) * g[3 + j] +
+                     static_cast<T>(W::kG[r][2]) * g[6 + j];
+        }
+      }
+      for (int r = 0; r < kAlpha; ++r) {
+        for (int q = 0; q < kAlpha; ++q) {
+          u[((r * kAlpha + q) * K + k) * C + c] =
+              gt[r][0] * static_cast<T>(W::kG[q][0]) +
+              gt[r][1] * static_cast<T>(W::kG[q][1]) +
+              gt[r][2] * static_cast<T>(W::kG[q][2]);
+        }
+      }
+    }
+  });
+
+  const int64_t tiles_h = (s.out_h + M - 1) / M;
+  const int64_t tiles_w = (s.out_w + M - 1) / M;
+  const int64_t num_tiles = tiles_h * tiles_w;
+  const int64_t block = std::min(kCPUConvWinogradTileBlock, num_tiles);
+  const int64_t num_blocks = (num_tiles + block - 1) / block;
+  std::vector<std::vector<T>> vs(CPUConvNumThreads());
+  std::vector<std::vector<T>> ms(CPUConvNumThreads());
+  CPUConvParallelFor(s.batch * num_blocks, [&](int64_t task, int thread) {
+    const int64_t n = task / num_blocks;
+    const int64_t first = (task % num_blocks) * block;
+    const int64_t count = std::min(block, num_tiles - first);
+    // v[e][c][t] and m[e][k][t] for the tiles [first, first + count).
+    auto& v = vs[thread];
+    auto& m = ms[thread];
+    v.resize(kElems * C * block);
+    m.resize(kElems * K * block);
+
+    for (int64_t c = 0; c < C; ++c) {
+      const T* plane = input + (n * C + c) * s.in_h * s.in_w;
+      for (int64_t t = 0; t < count; ++t) {
+        const int64_t ih0 = (first + t) / tiles_w * M - s.pad_top;
+        const int64_t iw0 = (first + t) % tiles_w * M - s.pad_left;
+        T d[kAlpha][kAlpha];
+        for (int i = 0; i < kAlpha; ++i) {
+          for (int j = 0; j < kAlpha; ++j) {
+            const int64_t ih = ih0 + i, iw = iw0 + j;
+            d[i][j] = (ih >= 0 && ih < s.in_h && iw >= 0 && iw < s.in_w)
+                          ? plane[ih * s.in_w + iw]
+                          : static_cast<T>(0);
+          }
+        }
+        T transformed[kAlpha][kAlpha];
+        CPUWinogradSandwich(W::kBT, d, transformed);
+        for (int e = 0; e < kElems; ++e) {
+          v[(e * C + c) * block + t] = transformed[e / kAlpha][e % kAlpha];
+        }
+      }
+    }
+
+    for (int e = 0; e < kElems; ++e) {
+      // The GEMMs run on count columns out of the block columns of v and m.
+      gemm(K,
+           count,
+           C,
+           block,
+           u.data() + e * K * C,
+           v.data() + e * C * block,
+           m.data() + e * K * block);
+    }
+
+    for (int64_t k = 0; k < K; ++k) {
+      T* out = output + (n * K + k) * s.out_h * s.out_w;
+      for (int64_t t = 0; t < count; ++t) {
+        T tile[kAlpha][kAlpha];
+        for (int e = 0; e < kElems; ++e) {
+          tile[e / kAlpha][e % kAlpha] = m[(e * K + k) * block + t];
+        }
+        T y[M][M];
+        CPUWinogradSandwich(W::kAT, tile, y);
+        const int64_t oh0 = (first + t) / tiles_w * M;
+        const int64_t ow0 = (first + t) % tiles_w * M;
+        const int64_t rows = std::min<int64_t>(M, s.out_h - oh0);
+        const int64_t cols = std::min<int64_t>(M, s.out_w - ow0);
+        for (int64_t i = 0; i < rows; ++i) {
+          for (int64_t j = 0; j < cols; ++j) {
+            out[(oh0 + i) * s.out_w + ow0 + j] = y[i][j];
+          }
+        }
+      }
+    }
+  });
+}
+
+// Runs a conv2d with algo, which must support it. gemm(m, n, k, ldb, a, b,
+// c) computes the row major c[m, n] = a[m, k] * b[k, n], where b and c have
+// ldb columns (the leading dimension) and a has k.
+template <typename T, typename Gemm>
+void CPUConv2D(CPUConvAlgo algo,
+               const CPUConv2DShape& s,
+               const T* input,
+               const T* filter,
+               T* output,
+               const Gemm& gemm) {
+  switch (algo) {
+    case CPUConvAlgo::kDepthwise:
+      CPUConvDepthwise(s, input, filter, output);
+      break;
+    case CPUConvAlgo::kDirect:
+      CPUConvDirect(s, input, filter, output);
+      break;
+    case CPUConvAlgo::kWinogradF23:
+      CPUConvWinograd<T, 2>(s, input, filter, output, gemm);
+      break;
+    case CPUConvAlgo::kWinogradF43:
+      CPUConvWinograd<T, 4>(s, input, filter, output, gemm);
+      break;
+    default:
+      CPUConvIm2ColGemm(
+          s,
+          input,
+          filter,
+          output,
+          [&](int64_t m, int64_t n, int64_t k, const T* a, const T* b, T* c) {
+            gemm(m, n, k, n, a, b, c);
+          });
+      break;
+  }
+}
+
+// Runs the NCHW conv2d of ConvKernelImpl, whose paddings went through
+// UpdatePaddingAndDilation, unless the selected algorithm is kLegacy.
+// Returns whether it ran the conv.
+template <typename T>
+bool RunCPUConv2D(const CPUContext& dev_ctx,
+                  const DenseTensor& input,
+                  const DenseTensor& filter,
+                  const std::vector<int>& strides,
+                  const std::vector<int>& paddings,
+                  const std::vector<int>& dilations,
+                  int groups,
+                  DenseTensor* output) {
+  const auto& in_dims = input.dims();
+  const auto& filter_dims = filter.dims();
+  const auto& out_dims = output->dims();
+  if (in_dims.size() != 4 || input.numel() == 0 || output->numel() == 0) {
+    return false;
+  }
+  CPUConv2DShape s;
+  s.batch = in_dims[0];
+  s.in_channels = in_dims[1];
+  s.in_h = in_dims[2];
+  s.in_w = in_dims[3];
+  s.out_channels = out_dims[1];
+  s.out_h = out_dims[2];
+  s.out_w = out_dims[3];
+  s.kernel_h = filter_dims[2];
+  s.kernel_w = filter_dims[3];
+  s.stride_h = strides[0];
+  s.stride_w = strides[1];
+  s.dilation_h = dilations[0];
+  s.dilation_w = dilations[1];
+  // paddings are {top, bottom, left, right}.
+  s.pad_top = paddings[0];
+  s.pad_left = paddings[2];
+  s.groups = groups;
+  CPUConvAlgo algo = SelectCPUConvAlgo(s);
+  if (algo == CPUConvAlgo::kLegacy) {
+    return false;
+  }
+
+  auto blas = GetBlas<CPUContext, T>(dev_ctx);
+  CPUConv2D(algo,
+            s,
+            input.data<T>(),
+            filter.data<T>(),
+            dev_ctx.template Alloc<T>(output),
+            [&](int64_t m,
+                int64_t n,
+                int64_t k,
+                int64_t ldb,
+                const T* a,
+                const T* b,
+                T* c) {
+              blas.GEMM(CblasNoTrans,
+                        CblasNoTrans,
+                        static_cast<int>(m),
+                        static_cast<int>(n),
+                        static_cast<int>(k),
+                        static_cast<T>(1),
+                        a,
+                        static_cast<int>(k),
+                        b,
+                        static_cast<int>(ldb),
+                        static_cast<T>(0),
+                        c,
+                        static_cast<int>(ldb));
+            });
+  return true;
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,286 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/kernels/funcs/radix_sort.h"
+
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+namespace phi {
+namespace funcs {
+
+// Batches of rows with fewer elements than it run on one thread.
+constexpr int64_t kCPUSortParallelNumel = 1 << 14;
+// The top k of a row is selected with a heap when k * kTopKHeapRatio is
+// smaller than the row, and with a full sort otherwise.
+constexpr int64_t kTopKHeapRatio = 64;
+// Elements scanned at once by the heap top k before touching the heap.
+constexpr int64_t kTopKBlockSize = 16;
+
+// The order of the CPU sort kernels, in which NaNs are equal to each other
+// and greater than all numbers.
+template <typename T>
+struct SortOrder {
+  explicit SortOrder(bool descending) : descending(descending) {}
+
+  static bool IsNan(const T& v) { return std::isnan(static_cast<double>(v)); }
+
+  // Whether a goes strictly before b.
+  bool operator()(const T& a, const T& b) const {
+    if (descending) {
+      return (IsNan(a) && !IsNan(b)) || a > b;
+    }
+    return (!IsNan(a) && IsNan(b)) || a < b;
+  }
+
+  bool descending;
+};
+
+// Whether a and b are equal in SortOrder.
+template <typename T>
+inline bool SameSortKey(const T& a, const T& b) {
+  if constexpr (IsRadixSortable<T>::value) {
+    return RadixKeyTraits<T>::ToBits(a) == RadixKeyTraits<T>::ToBits(b);
+  } else {
+    SortOrder<T> less(false);
+    return !less(a, b) && !less(b, a);
+  }
+}
+
+// Sorts keys[0, n) stably in SortOrder and moves values[0, n) with them.
+// The integer and floating point keys are radix sorted, and other types,
+// such as float16, fall back to std::stable_sort.
+template <typename KeyT, typename ValueT>
+void SortPairs(KeyT* keys, ValueT* values, int64_t n, bool descending = false) {
+  if constexpr (IsRadixSortable<KeyT>::value) {
+    RadixSortPairs(keys, values, n, descending);
+  } else {
+    std::vector<std::pair<KeyT, ValueT>> pairs(n);
+    for (int64_t i = 0; i < n; ++i) {
+      pairs[i] = std::make_pair(keys[i], values[i]);
+    }
+    SortOrder<KeyT> order(descending);
+    std::stable_sort(
+        pairs.begin(), pairs.end(), [&](const auto& a, const auto& b) {
+          return order(a.first, b.first);
+        });
+    for (int64_t i = 0; i < n; ++i) {
+      keys[i] = pairs[i].first;
+      values[i] = pairs[i].second;
+    }
+  }
+}
+
+// Splits [0, num_rows) into one contiguous range per thread when the rows
+// are many, and otherwise runs callback(0, num_rows) on the calling thread,
+// which leaves the threads to the radix sort of every row.
+template <typename Callback>
+void SortParallelFor(int64_t num_rows,
+                     int64_t row_size,
+                     const Callback& callback) {
+#ifdef PADDLE_WITH_MKLML
+  const int max_threads = omp_get_max_threads();
+  if (num_rows > 1 && num_rows * row_size >= kCPUSortParallelNumel &&
+      (num_rows >= max_threads || row_size < kRadixSortParallelNumel) &&
+      !omp_in_parallel()) {
+    const int num_threads =
+        static_cast<int>(std::min<int64_t>(max_threads, num_rows));
+#pragma omp parallel for num_threads(num_threads)
+    for (int t = 0; t < num_threads; ++t) {
+      callback(num_rows * t / num_threads, num_rows * (t + 1) / num_threads);
+    }
+    return;
+  }
+#endif
+  callback(0, num_rows);
+}
+
+// Returns the start of every segment of [0, n), where is_head(i) tells
+// whether i > 0 starts a new segment, followed by n.
+template <typename IsHead>
+std::vector<int64_t> SegmentStarts(int64_t n, const IsHead& is_head) {
+  if (n == 0) {
+    return std::vector<int64_t>(1, 0);
+  }
+  const int num_threads = detail::RadixSortNumThreads(n);
+  const int64_t chunk = (n + num_threads - 1) / num_threads;
+  auto chunk_begin = [&](int t) { return std::max<int64_t>(1, t * chunk); };
+  auto chunk_end = [&](int t) { return std::min(n, (t + 1) * chunk); };
+
+  std::vector<int64_t> offsets(num_threads + 1, 0);
+  detail::RadixSortForEachThread(num_threads, [&](int t) {
+    int64_t count = 0;
+    for (int64_t i = chunk_begin(t); i < chunk_end(t); ++i) {
+      count += is_head(i) ? 1 : 0;
+    }
+    offsets[t + 1] = count;
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  const int64_t num_segments = offsets[num_threads] + 1;
+  std::vector<int64_t> starts(num_segments + 1);
+  starts[0] = 0;
+  starts[num_segments] = n;
+  detail::RadixSortForEachThread(num_threads, [&](int t) {
+    int64_t pos = offsets[t] + 1;
+    for (int64_t i = chunk_begin(t); i < chunk_end(t); ++i) {
+      if (is_head(i)) {
+        starts[pos++] = i;
+      }
+    }
+  });
+  return starts;
+}
+
+namespace detail {
+
+// Whether any of data[0, n) may beat the threshold. The loop has no branch,
+// so that the compiler vectorizes it; the blocks it rejects are skipped
+// without touching the heap.
+template <typename T>
+inline bool TopKBlockMayBeat(const T* data,
+                             int64_t n,
+                             const T& threshold,
+                             bool largest) {
+  bool hit = false;
+  if (largest) {
+    for (int64_t i = 0; i < n; ++i) {
+      hit |= (data[i] > threshold) | (data[i] != data[i]);
+    }
+  } else {
+    if (threshold != threshold) {
+      return true;
+    }
+    for (int64_t i = 0; i < n; ++i) {
+      hit |= data[i] < threshold;
+    }
+  }
+  return hit;
+}
+
+// Selects the k best of data[begin, end) with a heap whose front is the
+// worst of them, and returns them best first.
+template <typename T, typename IndexT, typename Better>
+std::vector<std::pair<T, IndexT>> TopKHeap(const T* data,
+                                           int64_t begin,
+                                           int64_t end,
+                                           int64_t k,
+                                           bool largest,
+                                           const Better& better) {
+  k = std::min(k, end - begin);
+  std::vector<std::pair<T, IndexT>> heap;
+  heap.reserve(k);
+  for (int64_t i = begin; i < begin + k; ++i) {
+    heap.emplace_back(data[i], static_cast<IndexT>(i));
+  }
+  std::make_heap(heap.begin(), heap.end(), better);
+  if (k == 0) {
+    return heap;
+  }
+  for (int64_t i = begin + k; i < end; i += kTopKBlockSize) {
+    const int64_t block_end = std::min(end, i + kTopKBlockSize);
+    const T& threshold = heap.front().first;
+    if (!TopKBlockMayBeat(data + i, block_end - i, threshold, largest)) {
+      continue;
+    }
+    for (int64_t j = i; j < block_end; ++j) {
+      std::pair<T, IndexT> item(data[j], static_cast<IndexT>(j));
+      if (better(item, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), better);
+        heap.back() = item;
+        std::push_heap(heap.begin(), heap.end(), better);
+      }
+    }
+  }
+  std::sort_heap(heap.begin(), heap.end(), better);
+  return heap;
+}
+
+}  // namespace detail
+
+// Writes the k best of data[0, n) to out_values and out_indices, best first:
+// the largest ones if largest, and the smallest ones otherwise, in SortOrder
+// with ties broken by the lower index. A small k is selected with a heap,
+// split into one chunk per thread for a long row, and a large k with a full
+// radix sort.
+template <typename T, typename IndexT>
+void TopK(const T* data,
+          int64_t n,
+          int64_t k,
+          bool largest,
+          T* out_values,
+          IndexT* out_indices) {
+  if (k <= 0) {
+    return;
+  }
+  if (k * kTopKHeapRatio >= n) {
+    std::vector<T> keys(data, data + n);
+    std::vector<IndexT> indices(n);
+    std::iota(indices.begin(), indices.end(), static_cast<IndexT>(0));
+    SortPairs(keys.data(), indices.data(), n, largest);
+    std::copy(keys.begin(), keys.begin() + k, out_values);
+    std::copy(indices.begin(), indices.begin() + k, out_indices);
+    return;
+  }
+
+  SortOrder<T> order(largest);
+  auto better = [&order](const std::pair<T, IndexT>& a,
+                         const std::pair<T, IndexT>& b) {
+    if (order(a.first, b.first)) {
+      return true;
+    }
+    if (order(b.first, a.first)) {
+      return false;
+    }
+    return a.second < b.second;
+  };
+  std::vector<std::pair<T, IndexT>> best;
+  const int num_threads = detail::RadixSortNumThreads(n);
+  if (num_threads == 1) {
+    best = detail::TopKHeap<T, IndexT>(data, 0, n, k, largest, better);
+  } else {
+    const int64_t chunk = (n + num_threads - 1) / num_threads;
+    std::vector<std::vector<std::pair<T, IndexT>>> thread_best(num_threads);
+    detail::RadixSortForEachThread(num_threads, [&](int t) {
+      thread_best[t] =
+          detail::TopKHeap<T, IndexT>(data,
+                                      std::min(n, t * chunk),
+                                      std::min(n, (t + 1) * chunk),
+                                      k,
+                                      largest,
+                                      better);
+    });
+    for (const auto& items : thread_best) {
+      best.insert(best.end(), items.begin(), items.end());
+    }
+    std::partial_sort(best.begin(), best.begin() + k, best.end(), better);
+  }
+  for (int64_t i = 0; i < k; ++i) {
+    out_values[i] = best[i].first;
+    out_indices[i] = best[i].second;
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
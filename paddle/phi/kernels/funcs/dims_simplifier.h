@@ -50,6 +50,32 @@ struct BroadcastDimsSimplifier {
         in_dims[j] = common::vectorize<int64_t>(ins[j]->dims());
       }
     }
+    Simplify(axis);
+  }
+
+  // Same as above, but takes the dims of inputs directly, so that it can be
+  // used when the inputs are not wrapped by DenseTensor, e.g. by the CPU
+  // broadcast functions working on dims arrays.
+  BroadcastDimsSimplifier(const std::vector<DimVector> &ins_dims,
+                          const DimVector &dims,
+                          int axis) {
+    N = std::max(static_cast<int>(ins_dims.size()), 2);
+    in_dims.resize(N);
+    rank = static_cast<int>(dims.size());
+    out_dims = dims;
+    if (ins_dims.size() == 1) {
+      in_dims[0] = ins_dims[0];
+      in_dims[1] = out_dims;
+    } else {
+      for (int j = 0; j < N; ++j) {
+        in_dims[j] = ins_dims[j];
+      }
+    }
+    Simplify(axis);
+  }
+
+ private:
+  void Simplify(int axis) {
     ExtendInputDimensions(axis);
 
     // To Merge the dimensions of input_tensors while the consecutive
@@ -101,7 +127,6 @@ struct BroadcastDimsSimplifier {
     }
   }
 
- private:
   // To compensate the lackage of input_tensors' dimension with axis.
   void ExtendInputDimensions(int axis) {
     for (auto &in_dim : in_dims) {
@@ -223,6 +248,40 @@ struct BroadcastDimsSimplifier {
   }
 };
 
+// Simplify the dims of a reduction: the dims of size 1 are dropped and the
+// adjacent dims that are both reduced or both kept are merged, so that the
+// input is viewed as groups of dims that are alternately reduced and kept,
+// outermost first.
+struct ReduceDimsSimplifier {
+  ReduceDimsSimplifier(const std::vector<int64_t> &x_dims,
+                       const std::vector<int64_t> &reduce_axes,
+                       bool reduce_all) {
+    const int rank = static_cast<int>(x_dims.size());
+    std::vector<bool> reduced(rank, reduce_all);
+    for (int64_t axis : reduce_axes) {
+      reduced[axis < 0 ? axis + rank : axis] = true;
+    }
+    for (int i = 0; i < rank; ++i) {
+      if (x_dims[i] == 1) {
+        continue;
+      }
+      if (!dims.empty() && is_reduced.back() == reduced[i]) {
+        dims.back() *= x_dims[i];
+      } else {
+        dims.push_back(x_dims[i]);
+        is_reduced.push_back(reduced[i]);
+      }
+    }
+    if (dims.empty()) {
+      dims.push_back(1);
+      is_reduced.push_back(true);
+    }
+  }
+
+  std::vector<int64_t> dims;
+  std::vector<bool> is_reduced;
+};
+
 // Simplify the input dims and permute dims if possible.
 struct PermuteDimsSimplifier {
  public:
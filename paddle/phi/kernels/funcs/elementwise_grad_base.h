@@ -21,6 +21,7 @@ limitations under the License. */
 #include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/kernels/funcs/broadcast_cpu_function.h"
 #include "paddle/phi/kernels/funcs/common_shape.h"
 #include "paddle/phi/kernels/funcs/elementwise_utils.h"
 #include "paddle/phi/kernels/funcs/for_range.h"
@@ -63,39 +64,43 @@ void CommonGradBroadcastCPU(const DenseTensor &x,
                             const CPUContext &ctx,
                             DX_OP dx_op,
                             DY_OP dy_op) {
-  std::vector<int> index_array(max_dim, 0);
   const T *x_data = x.data<T>();
   const T *y_data = y.data<T>();
   const Tout *out_data = out.data<Tout>();
   const Tout *dout_data = dout.data<Tout>();
   T *dx_data = dx == nullptr ? nullptr : ctx.Alloc<T>(dx);
   T *dy_data = dy == nullptr ? nullptr : ctx.Alloc<T>(dy);
-  if (dx_data != nullptr) {
-    memset(dx_data, 0, dx->numel() * sizeof(T));
-  }
-  if (dy_data != nullptr) {
-    memset(dy_data, 0, dy->numel() * sizeof(T));
-  }
-  const int out_size = std::accumulate(
-      out_dims_array, out_dims_array + max_dim, 1, std::multiplies<int>());
-  int x_index, y_index;
-  for (int out_index = 0; out_index < out_size; ++out_index) {
-    x_index = GetElementwiseIndex(x_dims_array, max_dim, index_array.data());
-    y_index = GetElementwiseIndex(y_dims_array, max_dim, index_array.data());
+  CPUBroadcastLayout layout(
+      x_dims_array, y_dims_array, out_dims_array, max_dim);
+  if (layout.numel == 0) {
+    // The inputs may still have elements, e.g. x = [1] and y = [0].
     if (dx_data != nullptr) {
-      dx_data[x_index] += dx_op(x_data[x_index],
-                                y_data[y_index],
-                                out_data[out_index],
-                                dout_data[out_index]);
+      memset(dx_data, 0, dx->numel() * sizeof(T));
     }
     if (dy_data != nullptr) {
-      dy_data[y_index] += dy_op(x_data[x_index],
-                                y_data[y_index],
-                                out_data[out_index],
-                                dout_data[out_index]);
+      memset(dy_data, 0, dy->numel() * sizeof(T));
     }
-
-    UpdateElementwiseIndexArray(out_dims_array, max_dim, index_array.data());
+    return;
+  }
+  if (dx_data != nullptr) {
+    BroadcastGradReduceCPU<T, Tout>(layout,
+                                    CPUBroadcastLayout::kX,
+                                    x_data,
+                                    y_data,
+                                    out_data,
+                                    dout_data,
+                                    dx_data,
+                                    dx_op);
+  }
+  if (dy_data != nullptr) {
+    BroadcastGradReduceCPU<T, Tout>(layout,
+                                    CPUBroadcastLayout::kY,
+                                    x_data,
+                                    y_data,
+                                    out_data,
+                                    dout_data,
+                                    dy_data,
+                                    dy_op);
   }
 }
 
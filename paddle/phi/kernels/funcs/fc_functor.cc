@@ -14,8 +14,12 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/funcs/fc_functor.h"
 
+#include <vector>
+
 #include "paddle/phi/backends/all_context.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/blas/packed_weight_cache.h"
+#include "paddle/phi/kernels/funcs/half_cpu_function.h"
 #include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 namespace phi {
@@ -63,7 +67,10 @@ void FCFunctor<DeviceContext, T>::operator()(const DeviceContext& context,
               static_cast<T>(0.0),
               Y1_data,
               NN);
-  } else {
+  } else if constexpr (IsCPUHalf<T>::value) {
+    blas.MatMul(M, N, K, X, W, Y);
+  } else if (!PackedGEMM<T>(
+                 context, false, M, N, K, X, W, static_cast<T>(0), Y)) {
     blas.MatMul(M, N, K, X, W, Y);
   }
   if (B == nullptr) {
@@ -81,24 +88,43 @@ void FCFunctor<DeviceContext, T>::operator()(const DeviceContext& context,
         errors::PermissionDenied("When bias is NULL, relu can not be true."));
     return;
   }
-  auto compute = relu ? phi::jit::KernelFuncs<phi::jit::VAddReluTuple<T>,
-                                              phi::CPUPlace>::Cache()
-                            .At(N)
-                      : phi::jit::KernelFuncs<phi::jit::VAddTuple<T>,
-                                              phi::CPUPlace>::Cache()
-                            .At(N);
+  if constexpr (IsCPUHalf<T>::value) {
+    // The jit kernels are float only, add the bias in float instead.
+    std::vector<float> bias(N);
+    HalfToFloat(B, N, bias.data());
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < M; i++) {
+      T* dst = Y + i * N;
+      const T* src = (padding_weights) ? Y1_data + i * (N + 4) : dst;
+      for (int j = 0; j < N; j++) {
+        float y = HalfToFloat(src[j]) + bias[j];
+        dst[j] = FloatToHalf<T>(relu && y < 0.0f ? 0.0f : y);
+      }
+    }
+  } else {
+    auto compute = relu ? phi::jit::KernelFuncs<phi::jit::VAddReluTuple<T>,
+                                                phi::CPUPlace>::Cache()
+                              .At(N)
+                        : phi::jit::KernelFuncs<phi::jit::VAddTuple<T>,
+                                                phi::CPUPlace>::Cache()
+                              .At(N);
 #ifdef PADDLE_WITH_MKLML
 #pragma omp parallel for
 #endif
-  for (int i = 0; i < M; i++) {
-    T* dst = Y + i * N;
-    T* src = (padding_weights) ? Y1_data + i * (N + 4) : dst;
-    compute(B, src, dst, N);
+    for (int i = 0; i < M; i++) {
+      T* dst = Y + i * N;
+      T* src = (padding_weights) ? Y1_data + i * (N + 4) : dst;
+      compute(B, src, dst, N);
+    }
   }
 }
 
 template class FCFunctor<CPUContext, float>;
 template class FCFunctor<CPUContext, double>;
+template class FCFunctor<CPUContext, phi::dtype::float16>;
+template class FCFunctor<CPUContext, phi::dtype::bfloat16>;
 
 }  // namespace funcs
 }  // namespace phi
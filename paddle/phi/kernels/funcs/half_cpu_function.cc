@@ -0,0 +1,358 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/half_cpu_function.h"
+
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+
+// _mm512_dpbf16_ps needs GCC 10 or clang 9.
+#if defined(__x86_64__) && !defined(_WIN32) &&        \
+    ((defined(__clang__) && __clang_major__ >= 9) || \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 10))
+#define PADDLE_CPU_HALF_WITH_AVX512_BF16
+#include <immintrin.h>
+#endif
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+// Copies the rows x cols matrix at src, with leading dimension ld, to the
+// dense float matrix at dst.
+template <typename T>
+void HalfMatrixToFloat(
+    const T* src, int rows, int cols, int ld, float* dst) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (static_cast<int64_t>(rows) * cols > \
+                             kCPUHalfBlock)
+#endif
+  for (int r = 0; r < rows; ++r) {
+    HalfToFloat(src + static_cast<int64_t>(r) * ld,
+                cols,
+                dst + static_cast<int64_t>(r) * cols);
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void HalfGemmByFloat(bool trans_a,
+                     bool trans_b,
+                     int M,
+                     int N,
+                     int K,
+                     float alpha,
+                     const T* A,
+                     int lda,
+                     const T* B,
+                     int ldb,
+                     float beta,
+                     T* C,
+                     int ldc) {
+  const int a_rows = trans_a ? K : M, a_cols = trans_a ? M : K;
+  const int b_rows = trans_b ? N : K, b_cols = trans_b ? K : N;
+  std::vector<float> a(static_cast<int64_t>(a_rows) * a_cols);
+  std::vector<float> b(static_cast<int64_t>(b_rows) * b_cols);
+  std::vector<float> c(static_cast<int64_t>(M) * N);
+  HalfMatrixToFloat(A, a_rows, a_cols, lda, a.data());
+  HalfMatrixToFloat(B, b_rows, b_cols, ldb, b.data());
+  if (beta != 0.0f) {
+    HalfMatrixToFloat(C, M, N, ldc, c.data());
+  }
+  CBlas<float>::GEMM(CblasRowMajor,
+                     trans_a ? CblasTrans : CblasNoTrans,
+                     trans_b ? CblasTrans : CblasNoTrans,
+                     M,
+                     N,
+                     K,
+                     alpha,
+                     a.data(),
+                     std::max(a_cols, 1),
+                     b.data(),
+                     std::max(b_cols, 1),
+                     beta,
+                     c.data(),
+                     std::max(N, 1));
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (static_cast<int64_t>(M) * N > kCPUHalfBlock)
+#endif
+  for (int m = 0; m < M; ++m) {
+    FloatToHalf(c.data() + static_cast<int64_t>(m) * N,
+                N,
+                C + static_cast<int64_t>(m) * ldc);
+  }
+}
+
+#ifdef PADDLE_CPU_HALF_WITH_AVX512_BF16
+
+namespace {
+
+// The micro kernel multiplies kBf16MR rows of A by kBf16NR columns of B,
+// whose kBf16MR x kBf16NR float products stay in 16 zmm registers. A is
+// packed as pairs of consecutive k, one 32 bit word per row and pair, and B
+// as kBf16NR columns of pairs per pair, the operands of vdpbf16ps.
+constexpr int64_t kBf16MR = 8;
+constexpr int64_t kBf16NR = 32;
+// The pairs of k, rows and columns of a block. A block of B is 32 KB, a
+// block of A 8 KB per micro kernel and the block of C 384 KB.
+constexpr int64_t kBf16KCPairs = 256;
+constexpr int64_t kBf16MC = 96;
+constexpr int64_t kBf16NC = 1024;
+
+__attribute__((target("avx512f,avx512bf16"))) void Bf16MicroKernel(
+    int64_t pairs,
+    const uint32_t* a,
+    const uint16_t* b,
+    float* c,
+    int64_t ldc,
+    bool accumulate) {
+  __m512 acc[kBf16MR][2];
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kBf16MR; ++i) {
+    acc[i][0] = accumulate ? _mm512_loadu_ps(c + i * ldc) : _mm512_setzero_ps();
+    acc[i][1] =
+        accumulate ? _mm512_loadu_ps(c + i * ldc + 16) : _mm512_setzero_ps();
+  }
+  for (int64_t p = 0; p < pairs; ++p) {
+    __m512bh b0 = (__m512bh)_mm512_loadu_si512(b);
+    __m512bh b1 = (__m512bh)_mm512_loadu_si512(b + kBf16NR);
+#pragma GCC unroll 8
+    for (int64_t i = 0; i < kBf16MR; ++i) {
+      __m512bh ai = (__m512bh)_mm512_set1_epi32(static_cast<int>(a[i]));
+      acc[i][0] = _mm512_dpbf16_ps(acc[i][0], ai, b0);
+      acc[i][1] = _mm512_dpbf16_ps(acc[i][1], ai, b1);
+    }
+    a += kBf16MR;
+    b += 2 * kBf16NR;
+  }
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kBf16MR; ++i) {
+    _mm512_storeu_ps(c + i * ldc, acc[i][0]);
+    _mm512_storeu_ps(c + i * ldc + 16, acc[i][1]);
+  }
+}
+
+}  // namespace
+
+#endif
+
+bool Bf16GemmAVX512(bool trans_a,
+                    bool trans_b,
+                    int M,
+                    int N,
+                    int K,
+                    float alpha,
+                    const dtype::bfloat16* A,
+                    int lda,
+                    const dtype::bfloat16* B,
+                    int ldb,
+                    float beta,
+                    dtype::bfloat16* C,
+                    int ldc) {
+#ifdef PADDLE_CPU_HALF_WITH_AVX512_BF16
+  if (!backends::cpu::MayIUse(backends::cpu::avx512_bf16)) {
+    return false;
+  }
+  auto a_at = [&](int64_t m, int64_t k) -> uint32_t {
+    return (trans_a ? A[k * lda + m] : A[m * lda + k]).x;
+  };
+  auto b_at = [&](int64_t k, int64_t n) -> uint16_t {
+    return (trans_b ? B[n * ldb + k] : B[k * ldb + n]).x;
+  };
+  const int64_t pairs = (K + 1) / 2;
+  for (int64_t jc = 0; jc < N; jc += kBf16NC) {
+    const int64_t nc = std::min<int64_t>(kBf16NC, N - jc);
+    const int64_t panels = (nc + kBf16NR - 1) / kBf16NR;
+    const int64_t ldcb = panels * kBf16NR;
+    // packed_b[panel][pair][column][2], zero padded past K and N.
+    std::vector<uint16_t> packed_b(panels * pairs * kBf16NR * 2);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int64_t panel = 0; panel < panels; ++panel) {
+      uint16_t* dst = packed_b.data() + panel * pairs * kBf16NR * 2;
+      for (int64_t p = 0; p < pairs; ++p) {
+        for (int64_t j = 0; j < kBf16NR; ++j, dst += 2) {
+          const int64_t n = jc + panel * kBf16NR + j;
+          const bool valid = n < N;
+          dst[0] = valid ? b_at(2 * p, n) : 0;
+          dst[1] = valid && 2 * p + 1 < K ? b_at(2 * p + 1, n) : 0;
+        }
+      }
+    }
+
+    const int64_t num_row_blocks = (M + kBf16MC - 1) / kBf16MC;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int64_t block = 0; block < num_row_blocks; ++block) {
+      const int64_t ic = block * kBf16MC;
+      const int64_t mc = std::min<int64_t>(kBf16MC, M - ic);
+      const int64_t row_panels = (mc + kBf16MR - 1) / kBf16MR;
+      std::vector<uint32_t> packed_a(row_panels * kBf16KCPairs * kBf16MR);
+      std::vector<float> c(row_panels * kBf16MR * ldcb);
+      for (int64_t pc = 0; pc < pairs; pc += kBf16KCPairs) {
+        const int64_t kp = std::min<int64_t>(kBf16KCPairs, pairs - pc);
+        // packed_a[row panel][pair][row], zero padded past K and M.
+        uint32_t* dst = packed_a.data();
+        for (int64_t rp = 0; rp < row_panels; ++rp) {
+          for (int64_t p = pc; p < pc + kp; ++p) {
+            for (int64_t i = 0; i < kBf16MR; ++i) {
+              const int64_t m = ic + rp * kBf16MR + i;
+              const bool valid = m < M;
+              uint32_t lo = valid ? a_at(m, 2 * p) : 0;
+              uint32_t hi = valid && 2 * p + 1 < K ? a_at(m, 2 * p + 1) : 0;
+              *dst++ = lo | (hi << 16);
+            }
+          }
+        }
+        for (int64_t panel = 0; panel < panels; ++panel) {
+          const uint16_t* b_panel =
+              packed_b.data() + (panel * pairs + pc) * kBf16NR * 2;
+          for (int64_t rp = 0; rp < row_panels; ++rp) {
+            Bf16MicroKernel(kp,
+                            packed_a.data() + rp * kp * kBf16MR,
+                            b_panel,
+                            c.data() + rp * kBf16MR * ldcb + panel * kBf16NR,
+                            ldcb,
+                            pc > 0);
+          }
+        }
+      }
+      for (int64_t i = 0; i < mc; ++i) {
+        dtype::bfloat16* out = C + (ic + i) * ldc + jc;
+        const float* sum = c.data() + i * ldcb;
+        for (int64_t j = 0; j < nc; ++j) {
+          float value = alpha * sum[j];
+          if (beta != 0.0f) {
+            value += beta * HalfToFloat(out[j]);
+          }
+          out[j] = FloatToHalf<dtype::bfloat16>(value);
+        }
+      }
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+template <typename T>
+void HalfGemm(bool trans_a,
+              bool trans_b,
+              int M,
+              int N,
+              int K,
+              float alpha,
+              const T* A,
+              int lda,
+              const T* B,
+              int ldb,
+              float beta,
+              T* C,
+              int ldc) {
+  if (M <= 0 || N <= 0) {
+    return;
+  }
+  if (K <= 0) {
+    for (int m = 0; m < M; ++m) {
+      for (int n = 0; n < N; ++n) {
+        T& out = C[static_cast<int64_t>(m) * ldc + n];
+        out = FloatToHalf<T>(beta == 0.0f ? 0.0f : beta * HalfToFloat(out));
+      }
+    }
+    return;
+  }
+  if constexpr (std::is_same<T, dtype::bfloat16>::value) {
+    if (Bf16GemmAVX512(trans_a,
+                       trans_b,
+                       M,
+                       N,
+                       K,
+                       alpha,
+                       A,
+                       lda,
+                       B,
+                       ldb,
+                       beta,
+                       C,
+                       ldc)) {
+      return;
+    }
+  }
+  HalfGemmByFloat(
+      trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+template TEST_API void HalfGemm<dtype::bfloat16>(bool,
+                                                 bool,
+                                                 int,
+                                                 int,
+                                                 int,
+                                                 float,
+                                                 const dtype::bfloat16*,
+                                                 int,
+                                                 const dtype::bfloat16*,
+                                                 int,
+                                                 float,
+                                                 dtype::bfloat16*,
+                                                 int);
+template TEST_API void HalfGemm<dtype::float16>(bool,
+                                                bool,
+                                                int,
+                                                int,
+                                                int,
+                                                float,
+                                                const dtype::float16*,
+                                                int,
+                                                const dtype::float16*,
+                                                int,
+                                                float,
+                                                dtype::float16*,
+                                                int);
+template TEST_API void HalfGemmByFloat<dtype::bfloat16>(
+    bool,
+    bool,
+    int,
+    int,
+    int,
+    float,
+    const dtype::bfloat16*,
+    int,
+    const dtype::bfloat16*,
+    int,
+    float,
+    dtype::bfloat16*,
+    int);
+template TEST_API void HalfGemmByFloat<dtype::float16>(bool,
+                                                       bool,
+                                                       int,
+                                                       int,
+                                                       int,
+                                                       float,
+                                                       const dtype::float16*,
+                                                       int,
+                                                       const dtype::float16*,
+                                                       int,
+                                                       float,
+                                                       dtype::float16*,
+                                                       int);
+
+}  // namespace funcs
+}  // namespace phi
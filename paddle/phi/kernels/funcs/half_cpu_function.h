@@ -0,0 +1,181 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+namespace funcs {
+
+// The 16 bit floating point types the CPU kernels store, but compute in
+// float: each kernel converts a block of kCPUHalfBlock elements to float,
+// computes on it while it is in the cache and converts the results back.
+template <typename T>
+struct IsCPUHalf
+    : std::integral_constant<bool,
+                             std::is_same<T, dtype::bfloat16>::value ||
+                                 std::is_same<T, dtype::float16>::value> {};
+
+constexpr int64_t kCPUHalfBlock = 4096;
+
+inline float HalfToFloat(dtype::bfloat16 x) {
+  uint32_t bits = static_cast<uint32_t>(x.x) << 16;
+  float f;
+  std::memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+inline float HalfToFloat(dtype::float16 x) { return static_cast<float>(x); }
+
+// Rounds to the nearest even like the bfloat16 constructor, without its
+// branches, so that the conversion loops vectorize.
+template <typename T>
+inline T FloatToHalf(float f);
+
+template <>
+inline dtype::bfloat16 FloatToHalf<dtype::bfloat16>(float f) {
+  uint32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  uint32_t rounded = (bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16;
+  bool is_nan = (bits & 0x7FFFFFFFu) > 0x7F800000u;
+  return dtype::raw_uint16_to_bfloat16(
+      static_cast<uint16_t>(is_nan ? 0x7FFFu : rounded));
+}
+
+template <>
+inline dtype::float16 FloatToHalf<dtype::float16>(float f) {
+  return static_cast<dtype::float16>(f);
+}
+
+template <typename T>
+void HalfToFloat(const T* x, int64_t n, float* y) {
+  for (int64_t i = 0; i < n; ++i) {
+    y[i] = HalfToFloat(x[i]);
+  }
+}
+
+template <typename T>
+void FloatToHalf(const float* x, int64_t n, T* y) {
+  for (int64_t i = 0; i < n; ++i) {
+    y[i] = FloatToHalf<T>(x[i]);
+  }
+}
+
+// Calls f(begin, size) for the blocks of kCPUHalfBlock elements of [0, n),
+// in parallel if there are several of them.
+template <typename F>
+void HalfBlockForEach(int64_t n, const F& f) {
+  const int64_t num_blocks = (n + kCPUHalfBlock - 1) / kCPUHalfBlock;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (num_blocks > 1)
+#endif
+  for (int64_t block = 0; block < num_blocks; ++block) {
+    const int64_t begin = block * kCPUHalfBlock;
+    f(begin, std::min(kCPUHalfBlock, n - begin));
+  }
+}
+
+// out[i] = op(x[i]) for float ops on half inputs. out may be x.
+template <typename T, typename Op>
+void HalfUnaryCompute(const T* x, T* out, int64_t n, const Op& op) {
+  HalfBlockForEach(n, [&](int64_t begin, int64_t size) {
+    float buffer[kCPUHalfBlock];
+    HalfToFloat(x + begin, size, buffer);
+    for (int64_t i = 0; i < size; ++i) {
+      buffer[i] = op(buffer[i]);
+    }
+    FloatToHalf(buffer, size, out + begin);
+  });
+}
+
+// out[i] = op(x[i], y[i]) for float ops on half inputs. out may be x or y.
+template <typename T, typename Op>
+void HalfBinaryCompute(
+    const T* x, const T* y, T* out, int64_t n, const Op& op) {
+  HalfBlockForEach(n, [&](int64_t begin, int64_t size) {
+    float x_buffer[kCPUHalfBlock];
+    float y_buffer[kCPUHalfBlock];
+    HalfToFloat(x + begin, size, x_buffer);
+    HalfToFloat(y + begin, size, y_buffer);
+    for (int64_t i = 0; i < size; ++i) {
+      x_buffer[i] = op(x_buffer[i], y_buffer[i]);
+    }
+    FloatToHalf(x_buffer, size, out + begin);
+  });
+}
+
+// C = alpha * op(A) * op(B) + beta * C for row major bfloat16 or float16
+// matrices, accumulated in float. bfloat16 runs on the AVX512-BF16 dot
+// products when the CPU has them. Otherwise, and for float16, the operands
+// are converted to float for the float GEMM of the BLAS library.
+template <typename T>
+TEST_API void HalfGemm(bool trans_a,
+                       bool trans_b,
+                       int M,
+                       int N,
+                       int K,
+                       float alpha,
+                       const T* A,
+                       int lda,
+                       const T* B,
+                       int ldb,
+                       float beta,
+                       T* C,
+                       int ldc);
+
+// The float GEMM path of HalfGemm.
+template <typename T>
+TEST_API void HalfGemmByFloat(bool trans_a,
+                              bool trans_b,
+                              int M,
+                              int N,
+                              int K,
+                              float alpha,
+                              const T* A,
+                              int lda,
+                              const T* B,
+                              int ldb,
+                              float beta,
+                              T* C,
+                              int ldc);
+
+// The AVX512-BF16 path of HalfGemm, returns false if the CPU or the
+// compiler does not support it.
+TEST_API bool Bf16GemmAVX512(bool trans_a,
+                             bool trans_b,
+                             int M,
+                             int N,
+                             int K,
+                             float alpha,
+                             const dtype::bfloat16* A,
+                             int lda,
+                             const dtype::bfloat16* B,
+                             int ldb,
+                             float beta,
+                             dtype::bfloat16* C,
+                             int ldc);
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,413 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/float8_e4m3fn.h"
+#include "paddle/phi/kernels/funcs/half_cpu_function.h"
+
+namespace phi {
+namespace funcs {
+
+// The row normalizations of the CPU layer_norm, rms_norm and
+// fused_bias_residual_layernorm kernels, over [rows, cols] row major data.
+// Each thread normalizes whole rows: it reads a row once into a buffer of
+// the compute type, adding the residual and the bias on the way, takes the
+// statistics of the buffer while it is in the cache and writes the
+// normalized row from it. The backward works the same way.
+
+// Converts n elements of a row between T and its compute type.
+template <typename T, typename MT>
+void CPUNormLoad(const T* x, int64_t n, MT* y) {
+  if constexpr (IsCPUHalf<T>::value) {
+    HalfToFloat(x, n, y);
+  } else {
+    for (int64_t i = 0; i < n; ++i) {
+      y[i] = static_cast<MT>(x[i]);
+    }
+  }
+}
+
+template <typename MT, typename T>
+void CPUNormStore(const MT* x, int64_t n, T* y) {
+  if constexpr (IsCPUHalf<T>::value) {
+    FloatToHalf(x, n, y);
+  } else {
+    for (int64_t i = 0; i < n; ++i) {
+      y[i] = static_cast<T>(x[i]);
+    }
+  }
+}
+
+constexpr int64_t kCPUNormLanes = 16;
+constexpr int64_t kCPUNormBlock = 256;
+
+// sum(f(x[i])) for i in [0, n), in kCPUNormLanes lanes so that the loop
+// vectorizes.
+template <typename MT, typename F>
+MT CPUNormLaneSum(const MT* x, int64_t n, const F& f) {
+  MT lane_sum[kCPUNormLanes] = {};
+  const int64_t end = n / kCPUNormLanes * kCPUNormLanes;
+  for (int64_t i = 0; i < end; i += kCPUNormLanes) {
+    for (int64_t l = 0; l < kCPUNormLanes; ++l) {
+      lane_sum[l] += f(x[i + l]);
+    }
+  }
+  MT sum = 0;
+  for (int64_t l = 0; l < kCPUNormLanes; ++l) {
+    sum += lane_sum[l];
+  }
+  for (int64_t i = end; i < n; ++i) {
+    sum += f(x[i]);
+  }
+  return sum;
+}
+
+// Mean and variance of x[0, n). The mean and the squared deviations of each
+// block of kCPUNormBlock elements are summed in two passes over the block
+// while it is in the L1 cache, and the blocks are merged with the parallel
+// form of Welford's algorithm (Chan et al.). Unlike E[x^2] - E[x]^2, this
+// does not lose the variance of rows with a large mean to cancellation.
+template <typename MT>
+void CPUNormMeanVar(const MT* x, int64_t n, MT* mean, MT* var) {
+  MT row_mean = 0;
+  MT row_m2 = 0;
+  int64_t count = 0;
+  for (int64_t begin = 0; begin < n; begin += kCPUNormBlock) {
+    const int64_t size = std::min(kCPUNormBlock, n - begin);
+    const MT* block = x + begin;
+    const MT block_mean =
+        CPUNormLaneSum(block, size, [](MT v) { return v; }) /
+        static_cast<MT>(size);
+    const MT block_m2 = CPUNormLaneSum(block, size, [block_mean](MT v) {
+      const MT d = v - block_mean;
+      return d * d;
+    });
+    const int64_t total = count + size;
+    const MT delta = block_mean - row_mean;
+    const MT weight = static_cast<MT>(size) / static_cast<MT>(total);
+    row_mean += delta * weight;
+    row_m2 += block_m2 + delta * delta * static_cast<MT>(count) * weight;
+    count = total;
+  }
+  *mean = row_mean;
+  *var = n > 0 ? row_m2 / static_cast<MT>(n) : static_cast<MT>(0);
+}
+
+template <typename MT>
+MT CPUNormMeanSquare(const MT* x, int64_t n) {
+  const MT sum = CPUNormLaneSum(x, n, [](MT v) { return v * v; });
+  return n > 0 ? sum / static_cast<MT>(n) : static_cast<MT>(0);
+}
+
+// The operands of a row normalization. The rows of
+// h = x + residual_alpha * residual + bias are normalized, and written to
+// residual_out if it is set. Optional operands are null. scale and
+// norm_bias may have another type than x, e.g. float for bfloat16 x.
+template <typename T, typename P = T>
+struct CPUNormArgs {
+  int64_t rows = 0;
+  int64_t cols = 0;
+  float epsilon = 0.0f;
+  const T* x = nullptr;
+  const T* residual = nullptr;
+  const T* bias = nullptr;
+  float residual_alpha = 1.0f;
+  const P* scale = nullptr;
+  const P* norm_bias = nullptr;
+  T* residual_out = nullptr;
+};
+
+// Loads row r of h into the buffer h and writes it to residual_out if it is
+// set. tmp holds the converted residual of half types.
+template <typename T, typename P, typename MT>
+void CPUNormLoadRow(const CPUNormArgs<T, P>& args,
+                    int64_t r,
+                    const MT* bias,
+                    MT* h,
+                    MT* tmp) {
+  const int64_t cols = args.cols;
+  const T* x = args.x + r * cols;
+  const T* residual =
+      args.residual != nullptr ? args.residual + r * cols : nullptr;
+  T* residual_out =
+      args.residual_out != nullptr ? args.residual_out + r * cols : nullptr;
+  const MT alpha = static_cast<MT>(args.residual_alpha);
+  if constexpr (IsCPUHalf<T>::value) {
+    CPUNormLoad(x, cols, h);
+    if (residual != nullptr) {
+      CPUNormLoad(residual, cols, tmp);
+      for (int64_t j = 0; j < cols; ++j) {
+        h[j] += alpha * tmp[j];
+      }
+    }
+    if (bias != nullptr) {
+      for (int64_t j = 0; j < cols; ++j) {
+        h[j] += bias[j];
+      }
+    }
+  } else {
+    if (residual != nullptr && bias != nullptr) {
+      for (int64_t j = 0; j < cols; ++j) {
+        h[j] = static_cast<MT>(x[j]) + alpha * static_cast<MT>(residual[j]) +
+               bias[j];
+      }
+    } else if (residual != nullptr) {
+      for (int64_t j = 0; j < cols; ++j) {
+        h[j] = static_cast<MT>(x[j]) + alpha * static_cast<MT>(residual[j]);
+      }
+    } else {
+      for (int64_t j = 0; j < cols; ++j) {
+        h[j] = static_cast<MT>(x[j]);
+      }
+      if (bias != nullptr) {
+        for (int64_t j = 0; j < cols; ++j) {
+          h[j] += bias[j];
+        }
+      }
+    }
+  }
+  if (residual_out != nullptr) {
+    CPUNormStore(h, cols, residual_out);
+  }
+}
+
+// The scale, bias and norm_bias of args in the compute type, empty if they
+// are not set.
+template <typename MT, typename V>
+std::vector<MT> CPUNormParam(const V* param, int64_t n) {
+  std::vector<MT> data;
+  if (param != nullptr) {
+    data.resize(n);
+    CPUNormLoad(param, n, data.data());
+  }
+  return data;
+}
+
+// Stores normalized rows quantized like the GPU kernels:
+// clip(round(max_bound * scale * y), min_bound, max_bound), rounding half
+// to even for round_type 0 and half away from zero for 1. float8_e4m3fn
+// outputs are not rounded.
+struct CPUNormQuant {
+  float scale;
+  int round_type;
+  float max_bound;
+  float min_bound;
+
+  template <typename MT, typename OutT>
+  void operator()(const MT* y, int64_t n, OutT* out) const {
+    const float factor = max_bound * scale;
+    for (int64_t i = 0; i < n; ++i) {
+      float value = factor * static_cast<float>(y[i]);
+      if constexpr (std::is_same<OutT, int8_t>::value) {
+        value = round_type == 0 ? std::nearbyint(value) : std::round(value);
+      }
+      value = std::min(std::max(value, min_bound), max_bound);
+      out[i] = static_cast<OutT>(value);
+    }
+  }
+};
+
+// Normalizes the rows of h into y = (h - mean) * rstd * scale + norm_bias,
+// or y = h * rstd * scale + norm_bias for rms norm (kRms), where
+// rstd = 1 / sqrt(var + epsilon) and var is the mean square of h for rms
+// norm. Writes y to out, quantized by quant if it is set, and calls
+// stats(r, mean, var, rstd) for each row r, with mean = 0 for rms norm.
+// If out is null, only residual_out is written.
+template <bool kRms, typename T, typename P, typename OutT, typename Stats>
+void CPUNormForward(const CPUNormArgs<T, P>& args,
+                    OutT* out,
+                    const CPUNormQuant* quant,
+                    const Stats& stats) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  const int64_t cols = args.cols;
+  const auto bias = CPUNormParam<MT>(args.bias, cols);
+  // Missing scales are ones and missing norm biases zeros, so that the
+  // normalization is a single loop.
+  auto scale = CPUNormParam<MT>(args.scale, cols);
+  if (scale.empty()) {
+    scale.assign(cols, static_cast<MT>(1));
+  }
+  auto norm_bias = CPUNormParam<MT>(args.norm_bias, cols);
+  if (norm_bias.empty()) {
+    norm_bias.assign(cols, static_cast<MT>(0));
+  }
+  const MT epsilon = static_cast<MT>(args.epsilon);
+  // Half and quantized outputs are normalized in the buffer and converted,
+  // the others are written directly.
+  constexpr bool kDirect = std::is_same<OutT, T>::value &&
+                           !IsCPUHalf<T>::value &&
+                           std::is_same<MT, T>::value;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel if (args.rows > 1)
+#endif
+  {
+    std::vector<MT> h(cols);
+    std::vector<MT> tmp(
+        IsCPUHalf<T>::value && args.residual != nullptr ? cols : 0);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp for
+#endif
+    for (int64_t r = 0; r < args.rows; ++r) {
+      CPUNormLoadRow(
+          args, r, bias.empty() ? nullptr : bias.data(), h.data(), tmp.data());
+      if (out == nullptr) {
+        continue;
+      }
+      MT mean = 0;
+      MT var = 0;
+      if constexpr (kRms) {
+        var = CPUNormMeanSquare(h.data(), cols);
+      } else {
+        CPUNormMeanVar(h.data(), cols, &mean, &var);
+      }
+      const MT rstd = static_cast<MT>(1) / std::sqrt(var + epsilon);
+      stats(r, mean, var, rstd);
+      OutT* y = out + r * cols;
+      if constexpr (kDirect) {
+        if (quant == nullptr) {
+          for (int64_t j = 0; j < cols; ++j) {
+            y[j] = (h[j] - mean) * rstd * scale[j] + norm_bias[j];
+          }
+          continue;
+        }
+      }
+      for (int64_t j = 0; j < cols; ++j) {
+        h[j] = (h[j] - mean) * rstd * scale[j] + norm_bias[j];
+      }
+      if (quant != nullptr) {
+        (*quant)(h.data(), cols, y);
+      } else {
+        CPUNormStore(h.data(), cols, y);
+      }
+    }
+  }
+}
+
+// The column sums of CPUNormBackward are taken over at most
+// kCPUNormGradChunks fixed chunks of rows, each summed in row order into its
+// own slot, and the slots are added in chunk order. The chunks only depend on
+// the number of rows, so the gradients do not depend on the threads.
+constexpr int64_t kCPUNormGradChunks = 64;
+
+// The gradients of CPUNormForward for the output gradient dy: dx, which is
+// also the gradient of residual and bias, and the column sums
+// dscale = sum(dy * xhat) and dnorm_bias = sum(dy), where xhat is the
+// normalized h. row_stats(r, &mean, &rstd) gives the statistics of the
+// forward. The outputs that are null are not computed.
+template <bool kRms, typename T, typename P, typename MT, typename RowStats>
+void CPUNormBackward(const CPUNormArgs<T, P>& args,
+                     const T* dy,
+                     const RowStats& row_stats,
+                     T* dx,
+                     MT* dscale,
+                     MT* dnorm_bias) {
+  const int64_t cols = args.cols;
+  const auto bias = CPUNormParam<MT>(args.bias, cols);
+  const auto scale = CPUNormParam<MT>(args.scale, cols);
+  const int64_t num_chunks =
+      std::max<int64_t>(1, std::min(args.rows, kCPUNormGradChunks));
+  const int64_t chunk_rows = (args.rows + num_chunks - 1) / num_chunks;
+  std::vector<MT> chunk_dscale(dscale != nullptr ? num_chunks * cols : 0);
+  std::vector<MT> chunk_dnorm_bias(dnorm_bias != nullptr ? num_chunks * cols
+                                                         : 0);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel if (num_chunks > 1)
+#endif
+  {
+    std::vector<MT> h(cols);
+    std::vector<MT> g(cols);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp for
+#endif
+    for (int64_t c = 0; c < num_chunks; ++c) {
+      MT* local_dscale =
+          chunk_dscale.empty() ? nullptr : chunk_dscale.data() + c * cols;
+      MT* local_dnorm_bias = chunk_dnorm_bias.empty()
+                                 ? nullptr
+                                 : chunk_dnorm_bias.data() + c * cols;
+      const int64_t row_end = std::min(args.rows, (c + 1) * chunk_rows);
+      for (int64_t r = c * chunk_rows; r < row_end; ++r) {
+        CPUNormLoadRow(
+            args, r, bias.empty() ? nullptr : bias.data(), h.data(), g.data());
+        CPUNormLoad(dy + r * cols, cols, g.data());
+        MT mean = 0;
+        MT rstd = 0;
+        row_stats(r, &mean, &rstd);
+        // h becomes xhat, g the gradient of xhat.
+        for (int64_t j = 0; j < cols; ++j) {
+          h[j] = (h[j] - mean) * rstd;
+        }
+        if (local_dscale != nullptr) {
+          for (int64_t j = 0; j < cols; ++j) {
+            local_dscale[j] += g[j] * h[j];
+          }
+        }
+        if (local_dnorm_bias != nullptr) {
+          for (int64_t j = 0; j < cols; ++j) {
+            local_dnorm_bias[j] += g[j];
+          }
+        }
+        if (dx == nullptr) {
+          continue;
+        }
+        if (!scale.empty()) {
+          for (int64_t j = 0; j < cols; ++j) {
+            g[j] *= scale[j];
+          }
+        }
+        MT sum_g = 0;
+        MT sum_g_xhat = 0;
+        for (int64_t j = 0; j < cols; ++j) {
+          sum_g += g[j];
+          sum_g_xhat += g[j] * h[j];
+        }
+        const MT mean_g = kRms ? static_cast<MT>(0) : sum_g / cols;
+        const MT mean_g_xhat = sum_g_xhat / cols;
+        for (int64_t j = 0; j < cols; ++j) {
+          g[j] = rstd * (g[j] - mean_g - h[j] * mean_g_xhat);
+        }
+        CPUNormStore(g.data(), cols, dx + r * cols);
+      }
+    }
+  }
+  auto reduce_chunks = [&](const std::vector<MT>& chunks, MT* out) {
+    std::fill(out, out + cols, static_cast<MT>(0));
+    for (int64_t c = 0; c < num_chunks; ++c) {
+      const MT* chunk = chunks.data() + c * cols;
+      for (int64_t j = 0; j < cols; ++j) {
+        out[j] += chunk[j];
+      }
+    }
+  };
+  if (dscale != nullptr) {
+    reduce_chunks(chunk_dscale, dscale);
+  }
+  if (dnorm_bias != nullptr) {
+    reduce_chunks(chunk_dnorm_bias, dnorm_bias);
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
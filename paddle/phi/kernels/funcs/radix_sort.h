@@ -0,0 +1,248 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+namespace phi {
+namespace funcs {
+
+// Arrays shorter than it are sorted by one thread.
+constexpr int64_t kRadixSortParallelNumel = 1 << 16;
+// Arrays shorter than it are sorted by std::stable_sort.
+constexpr int64_t kRadixSortMinNumel = 256;
+
+// Maps a key to unsigned bits with the same order.
+template <typename KeyT, typename Enable = void>
+struct RadixKeyTraits {
+  static_assert(std::is_integral<KeyT>::value,
+                "RadixSort only supports integral and floating point keys.");
+  using Bits = typename std::make_unsigned<KeyT>::type;
+
+  static Bits ToBits(KeyT key) {
+    Bits bits = static_cast<Bits>(key);
+    if (std::is_signed<KeyT>::value) {
+      bits ^= Bits(1) << (sizeof(Bits) * 8 - 1);
+    }
+    return bits;
+  }
+};
+
+// Floating point keys are ordered as the sort kernels compare them: -0.0
+// equals 0.0, and NaNs of any sign and payload are equal and greater than
+// +inf.
+template <typename KeyT>
+struct RadixKeyTraits<
+    KeyT,
+    typename std::enable_if<std::is_floating_point<KeyT>::value>::type> {
+  using Bits = typename std::conditional<sizeof(KeyT) == 4,
+                                         uint32_t,
+                                         uint64_t>::type;
+  static_assert(sizeof(KeyT) == sizeof(Bits),
+                "RadixSort only supports float and double keys.");
+
+  static Bits ToBits(KeyT key) {
+    if (std::isnan(key)) {
+      return ~Bits(0);
+    }
+    if (key == 0) {
+      key = 0;
+    }
+    Bits bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    const Bits sign = Bits(1) << (sizeof(Bits) * 8 - 1);
+    return (bits & sign) ? ~bits : (bits | sign);
+  }
+};
+
+template <typename KeyT>
+struct IsRadixSortable
+    : std::integral_constant<bool,
+                             (std::is_integral<KeyT>::value &&
+                              !std::is_same<KeyT, bool>::value) ||
+                                 std::is_same<KeyT, float>::value ||
+                                 std::is_same<KeyT, double>::value> {};
+
+namespace detail {
+
+inline int RadixSortNumThreads(int64_t n) {
+#ifdef PADDLE_WITH_MKLML
+  if (n >= kRadixSortParallelNumel && !omp_in_parallel()) {
+    return std::max(1, omp_get_max_threads());
+  }
+#endif
+  return 1;
+}
+
+// Runs func(thread_id) for thread_id in [0, num_threads).
+template <typename Func>
+void RadixSortForEachThread(int num_threads, const Func& func) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(num_threads) schedule(static, 1)
+#endif
+  for (int t = 0; t < num_threads; ++t) {
+    func(t);
+  }
+}
+
+template <typename KeyT, typename ValueT, bool kHasValues>
+void RadixSortImpl(KeyT* keys, ValueT* values, int64_t n, bool descending) {
+  using Traits = RadixKeyTraits<KeyT>;
+  using Bits = typename Traits::Bits;
+  if (n <= 1) {
+    return;
+  }
+  // Descending order is the ascending order of the complemented bits.
+  const Bits flip = descending ? static_cast<Bits>(~Bits(0)) : Bits(0);
+  auto to_bits = [flip](KeyT key) {
+    return static_cast<Bits>(Traits::ToBits(key) ^ flip);
+  };
+  auto less = [&](KeyT a, KeyT b) { return to_bits(a) < to_bits(b); };
+  if (n < kRadixSortMinNumel) {
+    if constexpr (kHasValues) {
+      std::vector<std::pair<KeyT, ValueT>> pairs(n);
+      for (int64_t i = 0; i < n; ++i) {
+        pairs[i] = std::make_pair(keys[i], values[i]);
+      }
+      std::stable_sort(
+          pairs.begin(), pairs.end(), [&](const auto& a, const auto& b) {
+            return less(a.first, b.first);
+          });
+      for (int64_t i = 0; i < n; ++i) {
+        keys[i] = pairs[i].first;
+        values[i] = pairs[i].second;
+      }
+    } else {
+      std::stable_sort(keys, keys + n, less);
+    }
+    return;
+  }
+
+  const int num_threads = RadixSortNumThreads(n);
+  const int64_t chunk = (n + num_threads - 1) / num_threads;
+  auto chunk_begin = [&](int t) { return std::min(n, t * chunk); };
+
+  // The passes over the bytes that are the same for all keys are skipped.
+  const Bits first = to_bits(keys[0]);
+  std::vector<Bits> thread_diff(num_threads, 0);
+  RadixSortForEachThread(num_threads, [&](int t) {
+    Bits diff = 0;
+    for (int64_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i) {
+      diff |= to_bits(keys[i]) ^ first;
+    }
+    thread_diff[t] = diff;
+  });
+  Bits diff = 0;
+  for (Bits d : thread_diff) {
+    diff |= d;
+  }
+  if (diff == 0) {
+    return;
+  }
+
+  std::vector<KeyT> key_buffer(n);
+  std::vector<ValueT> value_buffer(kHasValues ? n : 0);
+  KeyT* src_keys = keys;
+  KeyT* dst_keys = key_buffer.data();
+  ValueT* src_values = values;
+  ValueT* dst_values = value_buffer.data();
+  std::vector<std::array<int64_t, 256>> offsets(num_threads);
+
+  for (int shift = 0; shift < static_cast<int>(sizeof(Bits) * 8);
+       shift += 8) {
+    if (((diff >> shift) & 0xFF) == 0) {
+      continue;
+    }
+    auto digit = [&](KeyT key) {
+      return static_cast<int>((to_bits(key) >> shift) & 0xFF);
+    };
+    RadixSortForEachThread(num_threads, [&](int t) {
+      auto& count = offsets[t];
+      count.fill(0);
+      for (int64_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i) {
+        ++count[digit(src_keys[i])];
+      }
+    });
+    // Digit-major, thread-minor exclusive scan keeps the sort stable.
+    int64_t offset = 0;
+    for (int d = 0; d < 256; ++d) {
+      for (int t = 0; t < num_threads; ++t) {
+        int64_t count = offsets[t][d];
+        offsets[t][d] = offset;
+        offset += count;
+      }
+    }
+    RadixSortForEachThread(num_threads, [&](int t) {
+      auto& offset = offsets[t];
+      for (int64_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i) {
+        int64_t pos = offset[digit(src_keys[i])]++;
+        dst_keys[pos] = src_keys[i];
+        if constexpr (kHasValues) {
+          dst_values[pos] = src_values[i];
+        }
+      }
+    });
+    std::swap(src_keys, dst_keys);
+    std::swap(src_values, dst_values);
+  }
+
+  if (src_keys != keys) {
+    RadixSortForEachThread(num_threads, [&](int t) {
+      std::copy(src_keys + chunk_begin(t),
+                src_keys + chunk_begin(t + 1),
+                keys + chunk_begin(t));
+      if constexpr (kHasValues) {
+        std::copy(src_values + chunk_begin(t),
+                  src_values + chunk_begin(t + 1),
+                  values + chunk_begin(t));
+      }
+    });
+  }
+}
+
+}  // namespace detail
+
+// Sorts keys[0, n) with a stable LSD radix sort, 8 bits per pass, in
+// ascending order or, if descending, in descending order. The array is split
+// into one chunk per OpenMP thread, which makes the histogram and the scatter
+// of every pass parallel.
+template <typename KeyT>
+void RadixSort(KeyT* keys, int64_t n, bool descending = false) {
+  detail::RadixSortImpl<KeyT, char, false>(keys, nullptr, n, descending);
+}
+
+// Sorts keys[0, n) stably and moves values[0, n) with them.
+template <typename KeyT, typename ValueT>
+void RadixSortPairs(KeyT* keys,
+                    ValueT* values,
+                    int64_t n,
+                    bool descending = false) {
+  detail::RadixSortImpl<KeyT, ValueT, true>(keys, values, n, descending);
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,204 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/generator.h"
+
+COMMON_DECLARE_bool(cpu_random_use_philox);
+
+namespace phi {
+namespace funcs {
+
+// Blocks generated together, so the rounds vectorize across counters.
+constexpr int64_t kPhiloxBatch = 16;
+// Random numbers below which the generation stays on one thread.
+constexpr int64_t kCPURandomParallelNumel = 1 << 14;
+
+// The types the Philox path of the CPU random kernels supports, and the
+// precision it computes them in.
+template <typename T>
+constexpr bool kIsPhiloxType = std::is_same<T, float>::value ||
+                               std::is_same<T, double>::value ||
+                               std::is_same<T, phi::dtype::float16>::value ||
+                               std::is_same<T, phi::dtype::bfloat16>::value;
+
+template <typename T>
+using PhiloxComputeType = typename phi::dtype::MPTypeTrait<T>::Type;
+
+inline bool UseCPUPhilox() { return FLAGS_cpu_random_use_philox; }
+
+// Philox-4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2,
+// 3"): block c of the stream keyed by seed is the 4 words Philox produces
+// for the 128-bit counter c. Any block can be computed independently, so
+// the kernels split a tensor among threads without changing its values.
+// Writes blocks [first, first + kPhiloxBatch) to words[word][block].
+inline void PhiloxBatch(uint64_t seed,
+                        uint64_t first,
+                        uint32_t words[4][kPhiloxBatch]) {
+  constexpr uint64_t kM0 = 0xD2511F53, kM1 = 0xCD9E8D57;
+  constexpr uint32_t kW0 = 0x9E3779B9, kW1 = 0xBB67AE85;
+  uint32_t c0[kPhiloxBatch], c1[kPhiloxBatch];
+  uint32_t c2[kPhiloxBatch], c3[kPhiloxBatch];
+  for (int64_t i = 0; i < kPhiloxBatch; ++i) {
+    const uint64_t counter = first + i;
+    c0[i] = static_cast<uint32_t>(counter);
+    c1[i] = static_cast<uint32_t>(counter >> 32);
+    c2[i] = 0;
+    c3[i] = 0;
+  }
+  uint32_t k0 = static_cast<uint32_t>(seed);
+  uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+  for (int round = 0; round < 10; ++round) {
+    for (int64_t i = 0; i < kPhiloxBatch; ++i) {
+      const uint64_t p0 = kM0 * c0[i];
+      const uint64_t p1 = kM1 * c2[i];
+      const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[i] ^ k0;
+      const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[i] ^ k1;
+      c1[i] = static_cast<uint32_t>(p1);
+      c3[i] = static_cast<uint32_t>(p0);
+      c0[i] = n0;
+      c2[i] = n2;
+    }
+    k0 += kW0;
+    k1 += kW1;
+  }
+  std::copy(c0, c0 + kPhiloxBatch, words[0]);
+  std::copy(c1, c1 + kPhiloxBatch, words[1]);
+  std::copy(c2, c2 + kPhiloxBatch, words[2]);
+  std::copy(c3, c3 + kPhiloxBatch, words[3]);
+}
+
+// Calls f(block, words) for the blocks [0, num_blocks) of the stream keyed
+// by seed, starting at counter offset, in parallel for large streams.
+template <typename F>
+void PhiloxForEachBlock(uint64_t seed,
+                        uint64_t offset,
+                        int64_t num_blocks,
+                        const F& f) {
+  const int64_t num_batches = (num_blocks + kPhiloxBatch - 1) / kPhiloxBatch;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (num_blocks * 4 >= kCPURandomParallelNumel)
+#endif
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    uint32_t words[4][kPhiloxBatch];
+    const int64_t first = batch * kPhiloxBatch;
+    PhiloxBatch(seed, offset + first, words);
+    const int64_t count = std::min(kPhiloxBatch, num_blocks - first);
+    for (int64_t i = 0; i < count; ++i) {
+      const uint32_t block[4] = {
+          words[0][i], words[1][i], words[2][i], words[3][i]};
+      f(first + i, block);
+    }
+  }
+}
+
+// A float takes one word of a block, a double two.
+template <typename T>
+constexpr int64_t PhiloxValuesPerBlock() {
+  return std::is_same<T, double>::value ? 2 : 4;
+}
+
+template <typename T>
+int64_t PhiloxNumBlocks(int64_t n) {
+  return (n + PhiloxValuesPerBlock<T>() - 1) / PhiloxValuesPerBlock<T>();
+}
+
+// Uniform in [0, 1) from the high bits of one (float) or two (double) words.
+template <typename T>
+inline T PhiloxUniform(const uint32_t* words) {
+  if constexpr (std::is_same<T, double>::value) {
+    const uint64_t bits = (static_cast<uint64_t>(words[0]) << 32) | words[1];
+    return static_cast<double>(bits >> 11) * 0x1.0p-53;
+  } else {
+    return static_cast<float>(words[0] >> 8) * 0x1.0p-24f;
+  }
+}
+
+// Returns the (seed, offset) to draw num_blocks blocks from. An op with a
+// fixed seed always starts at offset 0, otherwise the generator advances
+// its offset past the blocks, as the GPU kernels do.
+inline std::pair<uint64_t, uint64_t> PhiloxSeedOffset(Generator* generator,
+                                                      int seed,
+                                                      int64_t num_blocks) {
+  if (seed) {
+    return {static_cast<uint64_t>(seed), 0};
+  }
+  return generator->IncrementOffset(static_cast<uint64_t>(num_blocks));
+}
+
+// Calls f(i, u) for i in [0, n) with u uniform in [0, 1) of type T (float
+// or double). Element i always gets the same number for a (seed, offset).
+template <typename T, typename F>
+void PhiloxUniformForEach(uint64_t seed,
+                          uint64_t offset,
+                          int64_t n,
+                          const F& f) {
+  constexpr int64_t kValues = PhiloxValuesPerBlock<T>();
+  constexpr int64_t kWords = 4 / kValues;
+  PhiloxForEachBlock(
+      seed, offset, PhiloxNumBlocks<T>(n), [&](int64_t block, const auto& w) {
+        const int64_t first = block * kValues;
+        const int64_t count = std::min(kValues, n - first);
+        for (int64_t j = 0; j < count; ++j) {
+          f(first + j, PhiloxUniform<T>(w + j * kWords));
+        }
+      });
+}
+
+// Calls f(i, z) for i in [0, n) with z drawn from N(mean, std) by the
+// Box-Muller transform of pairs of uniforms.
+template <typename T, typename F>
+void PhiloxNormalForEach(uint64_t seed,
+                         uint64_t offset,
+                         int64_t n,
+                         T mean,
+                         T std,
+                         const F& f) {
+  constexpr int64_t kValues = PhiloxValuesPerBlock<T>();
+  constexpr int64_t kWords = 4 / kValues;
+  constexpr T kTwoPi = static_cast<T>(6.283185307179586476925286766559);
+  PhiloxForEachBlock(
+      seed, offset, PhiloxNumBlocks<T>(n), [&](int64_t block, const auto& w) {
+        const int64_t first = block * kValues;
+        const int64_t count = std::min(kValues, n - first);
+        T z[kValues];
+        for (int64_t j = 0; j < kValues; j += 2) {
+          // 1 - u is in (0, 1], so the log is finite.
+          const T u1 = static_cast<T>(1) - PhiloxUniform<T>(w + j * kWords);
+          const T u2 = PhiloxUniform<T>(w + (j + 1) * kWords);
+          const T r = std::sqrt(static_cast<T>(-2) * std::log(u1));
+          z[j] = r * std::cos(kTwoPi * u2);
+          z[j + 1] = r * std::sin(kTwoPi * u2);
+        }
+        for (int64_t j = 0; j < count; ++j) {
+          f(first + j, mean + std * z[j]);
+        }
+      });
+}
+
+}  // namespace funcs
+}  // namespace phi
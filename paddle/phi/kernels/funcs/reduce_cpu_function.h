@@ -0,0 +1,570 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include "paddle/common/flags.h"
+#include "paddle/common/macros.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/kernels/funcs/dims_simplifier.h"
+
+COMMON_DECLARE_bool(cpu_reduce_use_kahan_sum);
+
+namespace phi {
+namespace funcs {
+
+// Reductions smaller than this run on the calling thread.
+constexpr int64_t kCPUReduceParallelNumel = 1 << 15;
+// Runs of up to this many elements (or rows of a strided reduction) are
+// accumulated in order, and longer runs are split in halves, so that the
+// pairwise sum has an error growing with the log of the length.
+constexpr int64_t kCPUReduceBlock = 1024;
+// Independent accumulators of a contiguous run, which the compiler keeps in
+// SIMD registers.
+constexpr int kCPUReduceLanes = 16;
+// Outputs accumulated together by a strided reduction.
+constexpr int64_t kCPUReduceTile = 64;
+// A pass with fewer tasks of kCPUReduceTile outputs than this splits its
+// reduced dim into chunks of at least kCPUReduceChunkRows rows, and of at
+// most kCPUReduceMaxChunks chunks, which are reduced in parallel.
+constexpr int64_t kCPUReduceSplitTasks = 16;
+constexpr int64_t kCPUReduceChunkRows = 16 * kCPUReduceBlock;
+constexpr int64_t kCPUReduceMaxChunks = 256;
+
+enum class CPUSumMode {
+  kPairwise,
+  // Compensated summation, for the sums of floating point ops only.
+  kKahan,
+};
+
+inline CPUSumMode GetCPUSumMode() {
+  return FLAGS_cpu_reduce_use_kahan_sum ? CPUSumMode::kKahan
+                                        : CPUSumMode::kPairwise;
+}
+
+// The ops of ReduceCPU. An op maps each input to an accumulator with
+// Transform, combines accumulators with Combine, which is associative and
+// has Identity as identity, and maps the final accumulator of n inputs to the
+// output with Finalize. kIsSum marks the ops whose Combine is the addition of
+// floating point numbers, to which CPUSumMode::kKahan applies.
+
+template <typename T>
+struct CPUSumOp {
+  using AccT = typename phi::dtype::MPTypeTrait<T>::Type;
+  static constexpr bool kIsSum = std::is_floating_point<AccT>::value;
+
+  AccT Identity() const { return static_cast<AccT>(0); }
+  AccT Transform(const T& x) const { return static_cast<AccT>(x); }
+  AccT Combine(const AccT& a, const AccT& b) const { return a + b; }
+  T Finalize(const AccT& a, int64_t n UNUSED) const {
+    return static_cast<T>(a);
+  }
+};
+
+template <typename T>
+struct CPUMeanOp : public CPUSumOp<T> {
+  using AccT = typename CPUSumOp<T>::AccT;
+
+  T Finalize(const AccT& a, int64_t n) const {
+    return static_cast<T>(a / static_cast<AccT>(n));
+  }
+};
+
+template <typename T>
+struct CPUProdOp {
+  using AccT = typename phi::dtype::MPTypeTrait<T>::Type;
+  static constexpr bool kIsSum = false;
+
+  AccT Identity() const { return static_cast<AccT>(1); }
+  AccT Transform(const T& x) const { return static_cast<AccT>(x); }
+  AccT Combine(const AccT& a, const AccT& b) const { return a * b; }
+  T Finalize(const AccT& a, int64_t n UNUSED) const {
+    return static_cast<T>(a);
+  }
+};
+
+// max and min propagate NaN, as Eigen::PropagateNaN.
+template <typename T, bool IsMax>
+struct CPUMaxOrMinOp {
+  using AccT = typename phi::dtype::MPTypeTrait<T>::Type;
+  static constexpr bool kIsSum = false;
+
+  AccT Identity() const {
+    using Limits = std::numeric_limits<AccT>;
+    if (Limits::has_infinity) {
+      return IsMax ? -Limits::infinity() : Limits::infinity();
+    }
+    return IsMax ? Limits::lowest() : Limits::max();
+  }
+  AccT Transform(const T& x) const { return static_cast<AccT>(x); }
+  AccT Combine(const AccT& a, const AccT& b) const {
+    const bool keep_a = IsMax ? a > b : a < b;
+    return (keep_a || a != a) ? a : b;  // NOLINT
+  }
+  T Finalize(const AccT& a, int64_t n UNUSED) const {
+    return static_cast<T>(a);
+  }
+};
+
+template <typename T>
+using CPUMaxOp = CPUMaxOrMinOp<T, true>;
+template <typename T>
+using CPUMinOp = CPUMaxOrMinOp<T, false>;
+
+// log(sum(exp(x))), accumulated online as the running max and the sum of
+// exp(x - max), so that it takes a single pass over x.
+template <typename T>
+struct CPULogsumexpOp {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  struct AccT {
+    MT max;
+    MT sum;
+  };
+  static constexpr bool kIsSum = false;
+
+  AccT Identity() const {
+    return {-std::numeric_limits<MT>::infinity(), static_cast<MT>(0)};
+  }
+  AccT Transform(const T& x) const {
+    return {static_cast<MT>(x), static_cast<MT>(1)};
+  }
+  AccT Combine(const AccT& a, const AccT& b) const {
+    if (b.max <= a.max) {
+      // The weights of equal maxes are 1 even if they are infinite.
+      return {a.max, a.sum + (b.max == a.max ? b.sum : Scaled(b, a.max))};
+    }
+    if (a.max < b.max) {
+      return {b.max, Scaled(a, b.max) + b.sum};
+    }
+    const MT nan = std::numeric_limits<MT>::quiet_NaN();
+    return {nan, nan};
+  }
+  T Finalize(const AccT& a, int64_t n UNUSED) const {
+    return static_cast<T>(a.max + std::log(a.sum));
+  }
+
+ private:
+  static MT Scaled(const AccT& a, MT max) {
+    return a.sum == static_cast<MT>(0) ? a.sum : a.sum * std::exp(a.max - max);
+  }
+};
+
+// The p-norm of x: the number of non-zero elements for p = 0, max(|x|) for
+// p = inf, min(|x|) for p = -inf and sum(|x|^p)^(1/p) otherwise, where
+// Order is 1 or 2 for those p and 0 for any other one.
+template <typename T, int Order>
+struct CPUPNormOp {
+  using AccT = typename phi::dtype::MPTypeTrait<T>::Type;
+  static constexpr bool kIsSum = std::is_floating_point<AccT>::value;
+
+  explicit CPUPNormOp(float porder) : porder(static_cast<AccT>(porder)) {}
+
+  AccT Identity() const { return static_cast<AccT>(0); }
+  AccT Transform(const T& x) const {
+    const AccT v = static_cast<AccT>(x);
+    if (Order == 1) {
+      return std::abs(v);
+    } else if (Order == 2) {
+      return v * v;
+    }
+    return std::pow(std::abs(v), porder);
+  }
+  AccT Combine(const AccT& a, const AccT& b) const { return a + b; }
+  T Finalize(const AccT& a, int64_t n UNUSED) const {
+    if (Order == 1) {
+      return static_cast<T>(a);
+    } else if (Order == 2) {
+      return static_cast<T>(std::sqrt(a));
+    }
+    return static_cast<T>(std::pow(a, static_cast<AccT>(1) / porder));
+  }
+
+  AccT porder;
+};
+
+template <typename T>
+struct CPUNonZeroCountOp : public CPUSumOp<T> {
+  using AccT = typename CPUSumOp<T>::AccT;
+
+  AccT Transform(const T& x) const {
+    const AccT zero = static_cast<AccT>(0);
+    return static_cast<AccT>(x) != zero ? static_cast<AccT>(1) : zero;
+  }
+};
+
+template <typename T, bool IsMax>
+struct CPUAbsMaxOrMinOp : public CPUMaxOrMinOp<T, IsMax> {
+  using AccT = typename CPUMaxOrMinOp<T, IsMax>::AccT;
+
+  AccT Transform(const T& x) const { return std::abs(static_cast<AccT>(x)); }
+};
+
+namespace detail {
+
+// Reduces the n elements of a contiguous run. Each block is accumulated in
+// kCPUReduceLanes interleaved accumulators, which the compiler vectorizes
+// without reassociating the floating point additions itself.
+template <typename Op, typename In, typename Load>
+typename Op::AccT ReduceRun(const Op& op,
+                            const In* x,
+                            int64_t n,
+                            const Load& load,
+                            CPUSumMode mode) {
+  using AccT = typename Op::AccT;
+  if constexpr (Op::kIsSum) {
+    if (mode == CPUSumMode::kKahan) {
+      AccT sum[kCPUReduceLanes], comp[kCPUReduceLanes];
+      std::fill(sum, sum + kCPUReduceLanes, op.Identity());
+      std::fill(comp, comp + kCPUReduceLanes, op.Identity());
+      int64_t i = 0;
+      for (; i + kCPUReduceLanes <= n; i += kCPUReduceLanes) {
+        for (int k = 0; k < kCPUReduceLanes; ++k) {
+          const AccT y = load(x[i + k]) - comp[k];
+          const AccT t = sum[k] + y;
+          comp[k] = (t - sum[k]) - y;
+          sum[k] = t;
+        }
+      }
+      for (int k = 0; i < n; ++i, ++k) {
+        const AccT y = load(x[i]) - comp[k];
+        const AccT t = sum[k] + y;
+        comp[k] = (t - sum[k]) - y;
+        sum[k] = t;
+      }
+      AccT total = op.Identity();
+      for (int k = 0; k < kCPUReduceLanes; ++k) {
+        total += sum[k] - comp[k];
+      }
+      return total;
+    }
+  }
+  if (n > kCPUReduceBlock) {
+    const int64_t half = (n / 2 + kCPUReduceLanes - 1) / kCPUReduceLanes *
+                         kCPUReduceLanes;
+    return op.Combine(ReduceRun(op, x, half, load, mode),
+                      ReduceRun(op, x + half, n - half, load, mode));
+  }
+  AccT acc[kCPUReduceLanes];
+  std::fill(acc, acc + kCPUReduceLanes, op.Identity());
+  int64_t i = 0;
+  for (; i + kCPUReduceLanes <= n; i += kCPUReduceLanes) {
+    for (int k = 0; k < kCPUReduceLanes; ++k) {
+      acc[k] = op.Combine(acc[k], load(x[i + k]));
+    }
+  }
+  for (int k = 0; i < n; ++i, ++k) {
+    acc[k] = op.Combine(acc[k], load(x[i]));
+  }
+  for (int width = kCPUReduceLanes / 2; width > 0; width /= 2) {
+    for (int k = 0; k < width; ++k) {
+      acc[k] = op.Combine(acc[k], acc[k + width]);
+    }
+  }
+  return acc[0];
+}
+
+// Reduces the rows x[r * stride, r * stride + width) for r in [0, rows)
+// into acc[0, width), where width <= kCPUReduceTile. The loop over a row
+// runs along contiguous elements, so it is vectorized.
+template <typename Op, typename In, typename Load>
+void ReduceRows(const Op& op,
+                const In* x,
+                int64_t rows,
+                int64_t stride,
+                int64_t width,
+                const Load& load,
+                CPUSumMode mode,
+                typename Op::AccT* acc) {
+  using AccT = typename Op::AccT;
+  if constexpr (Op::kIsSum) {
+    if (mode == CPUSumMode::kKahan) {
+      AccT comp[kCPUReduceTile];
+      std::fill(acc, acc + width, op.Identity());
+      std::fill(comp, comp + width, op.Identity());
+      for (int64_t r = 0; r < rows; ++r) {
+        const In* row = x + r * stride;
+        for (int64_t j = 0; j < width; ++j) {
+          const AccT y = load(row[j]) - comp[j];
+          const AccT t = acc[j] + y;
+          comp[j] = (t - acc[j]) - y;
+          acc[j] = t;
+        }
+      }
+      for (int64_t j = 0; j < width; ++j) {
+        acc[j] -= comp[j];
+      }
+      return;
+    }
+  }
+  if (rows > kCPUReduceBlock) {
+    const int64_t half = rows / 2;
+    AccT right[kCPUReduceTile];
+    ReduceRows(op, x, half, stride, width, load, mode, acc);
+    ReduceRows(
+        op, x + half * stride, rows - half, stride, width, load, mode, right);
+    for (int64_t j = 0; j < width; ++j) {
+      acc[j] = op.Combine(acc[j], right[j]);
+    }
+    return;
+  }
+  std::fill(acc, acc + width, op.Identity());
+  for (int64_t r = 0; r < rows; ++r) {
+    const In* row = x + r * stride;
+    for (int64_t j = 0; j < width; ++j) {
+      acc[j] = op.Combine(acc[j], load(row[j]));
+    }
+  }
+}
+
+inline int CPUReduceNumThreads(int64_t numel) {
+#ifdef PADDLE_WITH_MKLML
+  if (numel >= kCPUReduceParallelNumel && !omp_in_parallel()) {
+    return omp_get_max_threads();
+  }
+#endif
+  return 1;
+}
+
+// Reduces x viewed as [outer, reduce, inner] over its middle dim, and calls
+// store(i, acc) with the accumulator of the i-th of the outer * inner
+// outputs. A pass with few outputs over a long reduced dim splits it into
+// chunks, whose partial results are combined in order. The chunks only
+// depend on the shape, and the threads only run whole tasks or whole
+// chunks, so that the result does not depend on the number of threads.
+template <typename Op, typename In, typename Load, typename Store>
+void ReducePass(const Op& op,
+                const In* x,
+                int64_t outer,
+                int64_t reduce,
+                int64_t inner,
+                const Load& load,
+                CPUSumMode mode,
+                const Store& store) {
+  using AccT = typename Op::AccT;
+  const int64_t tiles_per_row = (inner + kCPUReduceTile - 1) / kCPUReduceTile;
+  const int64_t group = inner > 1 ? kCPUReduceTile / inner : 1;
+  const int64_t num_tasks = outer * tiles_per_row;
+  const int num_threads = CPUReduceNumThreads(outer * reduce * inner);
+
+  auto run_task = [&](int64_t task, int64_t begin, int64_t end, AccT* acc) {
+    const int64_t o = task / tiles_per_row;
+    const int64_t i0 = task % tiles_per_row * kCPUReduceTile;
+    const In* base = x + (o * reduce + begin) * inner;
+    const int64_t rows = end - begin;
+    if (inner == 1) {
+      acc[0] = ReduceRun(op, base, rows, load, mode);
+    } else if (group > 1) {
+      // A narrow inner dim: group rows are reduced as one contiguous row of
+      // group * inner elements, whose columns are folded afterwards.
+      const int64_t wide = group * inner;
+      const int64_t grouped_rows = rows / group;
+      AccT wide_acc[kCPUReduceTile];
+      ReduceRows(op, base, grouped_rows, wide, wide, load, mode, wide_acc);
+      ReduceRows(op,
+                 base + grouped_rows * wide,
+                 rows - grouped_rows * group,
+                 inner,
+                 inner,
+                 load,
+                 mode,
+                 acc);
+      for (int64_t j = 0; j < wide; ++j) {
+        acc[j % inner] = op.Combine(acc[j % inner], wide_acc[j]);
+      }
+    } else {
+      const int64_t width = std::min(kCPUReduceTile, inner - i0);
+      ReduceRows(op, base + i0, rows, inner, width, load, mode, acc);
+    }
+  };
+  auto store_task = [&](int64_t task, const AccT* acc) {
+    const int64_t o = task / tiles_per_row;
+    const int64_t i0 = task % tiles_per_row * kCPUReduceTile;
+    const int64_t width = std::min(kCPUReduceTile, inner - i0);
+    for (int64_t j = 0; j < width; ++j) {
+      store(o * inner + i0 + j, acc[j]);
+    }
+  };
+
+  int64_t chunk_rows = reduce;
+  if (num_tasks < kCPUReduceSplitTasks && reduce >= 2 * kCPUReduceChunkRows) {
+    chunk_rows = std::max(
+        kCPUReduceChunkRows,
+        (reduce + kCPUReduceMaxChunks - 1) / kCPUReduceMaxChunks);
+  }
+  const int64_t num_chunks = (reduce + chunk_rows - 1) / chunk_rows;
+  if (num_chunks <= 1) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(num_threads) if (num_threads > 1)
+#endif
+    for (int64_t task = 0; task < num_tasks; ++task) {
+      AccT acc[kCPUReduceTile];
+      run_task(task, 0, reduce, acc);
+      store_task(task, acc);
+    }
+    return;
+  }
+
+  // Few outputs over a long reduced dim, e.g. a reduce_all.
+  std::vector<AccT> partial(num_chunks * num_tasks * kCPUReduceTile);
+  const int chunk_threads =
+      static_cast<int>(std::min<int64_t>(num_threads, num_chunks));
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(chunk_threads) if (chunk_threads > 1)
+#endif
+  for (int64_t c = 0; c < num_chunks; ++c) {
+    const int64_t begin = c * chunk_rows;
+    const int64_t end = std::min(reduce, begin + chunk_rows);
+    for (int64_t task = 0; task < num_tasks; ++task) {
+      run_task(task,
+               begin,
+               end,
+               partial.data() + (c * num_tasks + task) * kCPUReduceTile);
+    }
+  }
+  for (int64_t task = 0; task < num_tasks; ++task) {
+    AccT* acc = partial.data() + task * kCPUReduceTile;
+    for (int64_t c = 1; c < num_chunks; ++c) {
+      const AccT* other =
+          partial.data() + (c * num_tasks + task) * kCPUReduceTile;
+      for (int64_t j = 0; j < kCPUReduceTile; ++j) {
+        acc[j] = op.Combine(acc[j], other[j]);
+      }
+    }
+    store_task(task, acc);
+  }
+}
+
+}  // namespace detail
+
+// Reduces x viewed as [outer, reduce, inner] over its middle dim into the
+// outer * inner elements of out.
+template <typename Op, typename T, typename OutT>
+void ReduceCPU(const Op& op,
+               const T* x,
+               int64_t outer,
+               int64_t reduce,
+               int64_t inner,
+               OutT* out,
+               CPUSumMode mode = CPUSumMode::kPairwise) {
+  detail::ReducePass(
+      op,
+      x,
+      outer,
+      reduce,
+      inner,
+      [&op](const T& v) { return op.Transform(v); },
+      mode,
+      [&](int64_t i, const typename Op::AccT& acc) {
+        out[i] = op.Finalize(acc, reduce);
+      });
+}
+
+// Reduces x of x_dims over reduce_axes, or over all of its dims if
+// reduce_all, into out. The dims are merged by ReduceDimsSimplifier, and
+// each group of reduced dims is reduced by one [outer, reduce, inner] pass,
+// innermost first, with the accumulators of the passes but the last one
+// kept in a buffer.
+template <typename Op, typename T, typename OutT>
+void ReduceCPU(const Op& op,
+               const T* x,
+               const std::vector<int64_t>& x_dims,
+               const std::vector<int64_t>& reduce_axes,
+               bool reduce_all,
+               OutT* out,
+               CPUSumMode mode = CPUSumMode::kPairwise) {
+  using AccT = typename Op::AccT;
+  ReduceDimsSimplifier simplifier(x_dims, reduce_axes, reduce_all);
+  std::vector<int64_t> dims = simplifier.dims;
+  std::vector<bool> is_reduced = simplifier.is_reduced;
+  int64_t reduce_numel = 1;
+  for (size_t g = 0; g < dims.size(); ++g) {
+    reduce_numel *= is_reduced[g] ? dims[g] : 1;
+  }
+  if (std::find(is_reduced.begin(), is_reduced.end(), true) ==
+      is_reduced.end()) {
+    // Only dims of size 1 are reduced.
+    dims.push_back(1);
+    is_reduced.push_back(true);
+  }
+
+  std::vector<AccT> src, dst;
+  bool first = true;
+  while (true) {
+    const int g = static_cast<int>(
+        std::find(is_reduced.rbegin(), is_reduced.rend(), true).base() -
+        is_reduced.begin() - 1);
+    int64_t outer = 1, inner = 1;
+    for (int k = 0; k < g; ++k) {
+      outer *= dims[k];
+    }
+    for (size_t k = g + 1; k < dims.size(); ++k) {
+      inner *= dims[k];
+    }
+    const int64_t reduce = dims[g];
+    dims.erase(dims.begin() + g);
+    is_reduced.erase(is_reduced.begin() + g);
+    const bool last = std::find(is_reduced.begin(), is_reduced.end(), true) ==
+                      is_reduced.end();
+
+    auto store = [&](int64_t i, const AccT& acc) {
+      if (last) {
+        out[i] = op.Finalize(acc, reduce_numel);
+      } else {
+        dst[i] = acc;
+      }
+    };
+    if (!last) {
+      dst.resize(outer * inner);
+    }
+    if (first) {
+      detail::ReducePass(
+          op,
+          x,
+          outer,
+          reduce,
+          inner,
+          [&op](const T& v) { return op.Transform(v); },
+          mode,
+          store);
+    } else {
+      detail::ReducePass(
+          op,
+          src.data(),
+          outer,
+          reduce,
+          inner,
+          [](const AccT& v) { return v; },
+          mode,
+          store);
+    }
+    if (last) {
+      return;
+    }
+    first = false;
+    src.swap(dst);
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,181 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "paddle/common/errors.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/funcs/cpu_sort.h"
+
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+namespace phi {
+namespace funcs {
+
+// The positions of a list of row ids grouped by id: rows[g] is the g-th
+// distinct id in ascending order, and positions[starts[g], starts[g + 1])
+// are the positions of its occurrences in ascending order.
+struct RowSegments {
+  std::vector<int64_t> rows;
+  std::vector<int64_t> starts;
+  std::vector<int64_t> positions;
+
+  int64_t size() const { return static_cast<int64_t>(rows.size()); }
+};
+
+// Groups ids[0, n) by a parallel radix sort. The occurrences of skip_id are
+// left out, unless it is negative.
+inline RowSegments GroupRows(const int64_t* ids,
+                             int64_t n,
+                             int64_t skip_id = -1) {
+  RowSegments segments;
+  std::vector<int64_t> keys;
+  keys.reserve(n);
+  segments.positions.reserve(n);
+  for (int64_t i = 0; i < n; ++i) {
+    if (skip_id < 0 || ids[i] != skip_id) {
+      keys.push_back(ids[i]);
+      segments.positions.push_back(i);
+    }
+  }
+  const int64_t num = static_cast<int64_t>(keys.size());
+  RadixSortPairs(keys.data(), segments.positions.data(), num);
+  segments.starts = SegmentStarts(
+      num, [&](int64_t i) { return keys[i] != keys[i - 1]; });
+  const int64_t num_rows = static_cast<int64_t>(segments.starts.size()) - 1;
+  segments.rows.resize(num_rows);
+  for (int64_t g = 0; g < num_rows; ++g) {
+    segments.rows[g] = keys[segments.starts[g]];
+  }
+  return segments;
+}
+
+// Sums the rows of every segment: dst_row(g)[0, width) = the sum of
+// src_row(p)[0, width) for p in the segment g, added in the order of the
+// positions. The segments are reduced in parallel and each one on a single
+// thread, so that a hot row is accumulated in cache without atomics and
+// the result does not depend on the number of threads.
+template <typename T, typename SrcRow, typename DstRow>
+void SegmentedRowSum(const RowSegments& segments,
+                     int64_t width,
+                     const SrcRow& src_row,
+                     const DstRow& dst_row) {
+  const int64_t num_rows = segments.size();
+  const auto& starts = segments.starts;
+  const auto& positions = segments.positions;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for schedule(dynamic, 16) \
+    if (static_cast<int64_t>(positions.size()) * width >= \
+        kCPUSortParallelNumel)
+#endif
+  for (int64_t g = 0; g < num_rows; ++g) {
+    T* out = dst_row(g);
+    const T* first = src_row(positions[starts[g]]);
+    std::copy(first, first + width, out);
+    for (int64_t p = starts[g] + 1; p < starts[g + 1]; ++p) {
+      const T* in = src_row(positions[p]);
+      for (int64_t j = 0; j < width; ++j) {
+        out[j] += in[j];
+      }
+    }
+  }
+}
+
+// Visits the rows of a parameter with num_param_rows rows of width elements
+// that a row-sparse gradient updates: update(row, grad_row) is called once
+// per distinct row of segments with the sum of its gradient rows, which is
+// read in place when the row occurs once and merged into a per-thread
+// buffer otherwise, so that no merged copy of the gradient is allocated.
+// Unless lazy_mode, the other rows of the parameter are visited too, with a
+// null grad_row. Every row is visited by a single thread.
+template <typename T, typename Update>
+void SparseRowUpdate(const RowSegments& segments,
+                     const T* grad_data,
+                     int64_t width,
+                     int64_t num_param_rows,
+                     bool lazy_mode,
+                     const Update& update) {
+  const int64_t num_rows = segments.size();
+  const auto& rows = segments.rows;
+  const auto& starts = segments.starts;
+  const auto& positions = segments.positions;
+  if (num_rows > 0) {
+    PADDLE_ENFORCE_EQ(
+        rows.front() >= 0 && rows.back() < num_param_rows,
+        true,
+        common::errors::InvalidArgument(
+            "The rows of the gradient should be in the range [0, %d), but "
+            "the rows range from %d to %d.",
+            num_param_rows,
+            rows.front(),
+            rows.back()));
+  }
+  auto merged_row = [&](int64_t g, T* buffer) -> const T* {
+    const T* first = grad_data + positions[starts[g]] * width;
+    if (starts[g + 1] - starts[g] == 1) {
+      return first;
+    }
+    std::copy(first, first + width, buffer);
+    for (int64_t p = starts[g] + 1; p < starts[g + 1]; ++p) {
+      const T* in = grad_data + positions[p] * width;
+      for (int64_t j = 0; j < width; ++j) {
+        buffer[j] += in[j];
+      }
+    }
+    return buffer;
+  };
+
+  const int64_t num_visited = lazy_mode ? num_rows : num_param_rows;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel if (num_visited * width >= kCPUSortParallelNumel)
+#endif
+  {
+    std::vector<T> buffer(width);
+    if (lazy_mode) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp for schedule(dynamic, 16)
+#endif
+      for (int64_t g = 0; g < num_rows; ++g) {
+        update(rows[g], merged_row(g, buffer.data()));
+      }
+    } else {
+      int thread_id = 0, num_threads = 1;
+#ifdef PADDLE_WITH_MKLML
+      thread_id = omp_get_thread_num();
+      num_threads = omp_get_num_threads();
+#endif
+      const int64_t begin = num_visited * thread_id / num_threads;
+      const int64_t end = num_visited * (thread_id + 1) / num_threads;
+      int64_t g = std::lower_bound(rows.begin(), rows.end(), begin) -
+                  rows.begin();
+      for (int64_t row = begin; row < end; ++row) {
+        if (g < num_rows && rows[g] == row) {
+          update(row, merged_row(g++, buffer.data()));
+        } else {
+          update(row, static_cast<const T*>(nullptr));
+        }
+      }
+    }
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
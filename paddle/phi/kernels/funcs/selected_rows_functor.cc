@@ -15,12 +15,14 @@ limitations under the License. */
 #include "paddle/phi/kernels/funcs/selected_rows_functor.h"
 
 #include <algorithm>
+#include <functional>
 #include <map>
 #include <set>
 #include <vector>
 
 #include "paddle/common/ddim.h"
 #include "paddle/phi/core/mixed_vector.h"
+#include "paddle/phi/kernels/funcs/radix_sort.h"
 
 #ifdef PADDLE_WITH_XPU
 #include "paddle/phi/backends/xpu/enforce_xpu.h"
@@ -540,7 +542,7 @@ struct MergeAddImpl {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
+    std::vector<int64_t> all_rows;
     size_t row_num = 0;
     for (auto* input : inputs) {
       if (input->rows().empty()) {
@@ -556,25 +558,32 @@ struct MergeAddImpl {
                         common::errors::InvalidArgument(
                             "All inputs should have same height."));
       row_num += input->rows().size();
-      merged_row_set.insert(input->rows().begin(), input->rows().end());
+      all_rows.insert(
+          all_rows.end(), input->rows().begin(), input->rows().end());
+    }
+    // The rows produced by the CPU sparse gradients are usually unique and
+    // sorted already, which is checked before sorting a copy of them.
+    const bool is_strict_sorted =
+        std::adjacent_find(all_rows.begin(),
+                           all_rows.end(),
+                           std::greater_equal<int64_t>()) == all_rows.end();
+    std::vector<int64_t> merge_rows(all_rows);
+    if (!is_strict_sorted) {
+      phi::funcs::RadixSort(merge_rows.data(),
+                            static_cast<int64_t>(merge_rows.size()));
+      merge_rows.erase(std::unique(merge_rows.begin(), merge_rows.end()),
+                       merge_rows.end());
     }
 
     out.set_height(input_height);
     DenseTensor* out_tensor = out.mutable_value();
     out_tensor->Resize(common::make_ddim(
-        {static_cast<int64_t>(merged_row_set.size()), input_width}));
+        {static_cast<int64_t>(merge_rows.size()), input_width}));
     auto* out_data = context.template Alloc<T>(out_tensor);
 
-    if (merged_row_set.size() == row_num && !sorted_result) {
+    if (merge_rows.size() == row_num && (!sorted_result || is_strict_sorted)) {
       // no duplicated ids, just concat the result together
-      std::vector<int64_t> merge_rows;
-      merge_rows.reserve(row_num);
-      // concat rows
-      for (auto* in : inputs) {
-        merge_rows.insert(
-            merge_rows.end(), in->rows().begin(), in->rows().end());
-      }
-      out.set_rows(merge_rows);
+      out.set_rows(all_rows);
       auto in_place = inputs[0]->place();
       auto out_place = out.place();
       int64_t copied_numel = 0;
@@ -589,13 +598,6 @@ struct MergeAddImpl {
         copied_numel += static_cast<int64_t>(in_numel);
       }
     } else {
-      std::vector<int64_t> merge_rows(merged_row_set.begin(),
-                                      merged_row_set.end());
-
-      if (sorted_result) {
-        std::sort(merge_rows.begin(), merge_rows.end());
-      }
-
       out.set_rows(merge_rows);
 
       phi::funcs::SetConstant<DeviceContext, T> constant_functor;
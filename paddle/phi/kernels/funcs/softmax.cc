@@ -14,7 +14,13 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/funcs/softmax.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 #include "paddle/phi/kernels/funcs/softmax_impl.h"
 
 namespace phi::funcs {
@@ -24,4 +30,338 @@ template class SoftmaxFunctor<phi::CPUContext, double>;
 template class SoftmaxGradFunctor<phi::CPUContext, float>;
 template class SoftmaxGradFunctor<phi::CPUContext, double>;
 
+namespace {
+
+// Softmax of fewer elements runs on the calling thread.
+constexpr int64_t kSoftmaxParallelNumel = 1 << 14;
+
+template <typename T>
+using ExpFunc = typename jit::VExpTuple<T>::func_type;
+
+// The jit kernel cache is thread local, so the kernel is got before the
+// parallel region and shared by all the threads.
+template <typename T>
+ExpFunc<T> GetExpFunc(int n) {
+  return jit::KernelFuncs<jit::VExpTuple<T>, phi::CPUPlace>::Cache().At(n);
+}
+
+// Calls func(row, buffer) for each row in [0, num_rows), the rows are split
+// across threads when built with MKLML. buffer is a scratch of buffer_size
+// elements owned by the thread.
+template <typename T, typename Func>
+void ParallelForRows(int64_t num_rows,
+                     int64_t row_size,
+                     int64_t buffer_size,
+                     const Func& func) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel if (num_rows > 1 && \
+                         num_rows * row_size >= kSoftmaxParallelNumel)
+#endif
+  {
+    std::vector<T> buffer(buffer_size);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp for
+#endif
+    for (int64_t row = 0; row < num_rows; ++row) {
+      func(row, buffer.data());
+    }
+  }
+}
+
+// Shifted logits are clipped to kThreshold before exp, the same as ValueClip
+// in softmax_impl.h.
+template <typename T>
+inline T ShiftAndClip(T x, T max_val) {
+  const T kThreshold = static_cast<T>(-64.);
+  T v = x - max_val;
+  return v < kThreshold ? kThreshold : v;
+}
+
+// Softmax of one contiguous row of n elements, mask is optional. The row is
+// small enough to stay in cache between the passes: max, shift, exp in place
+// with the jit kernel, sum and normalize. In log mode exp is written to buffer
+// and the row keeps the shifted logits.
+template <typename T>
+void SoftmaxRow(const T* x,
+                const T* mask,
+                T* y,
+                T* buffer,
+                int n,
+                bool log_mode,
+                ExpFunc<T> exp_func) {
+  const T* src = x;
+  if (mask != nullptr) {
+    for (int i = 0; i < n; ++i) {
+      y[i] = x[i] + mask[i];
+    }
+    src = y;
+  }
+  const T max_val = *std::max_element(src, src + n);
+  for (int i = 0; i < n; ++i) {
+    y[i] = ShiftAndClip(src[i], max_val);
+  }
+  T* exp_y = log_mode ? buffer : y;
+  exp_func(y, exp_y, n);
+  T sum = static_cast<T>(0);
+  for (int i = 0; i < n; ++i) {
+    sum += exp_y[i];
+  }
+  if (log_mode) {
+    const T log_sum = std::log(sum);
+    for (int i = 0; i < n; ++i) {
+      y[i] -= log_sum;
+    }
+  } else {
+    const T scale = static_cast<T>(1) / sum;
+    for (int i = 0; i < n; ++i) {
+      y[i] *= scale;
+    }
+  }
+}
+
+// Softmax along the axis of one [axis_dim, num_remain] block. The max and sum
+// of the num_remain columns are accumulated row by row, so that all the loops
+// run over contiguous memory. buffer holds num_remain accumulators, followed
+// by the exp of the block in log mode.
+template <typename T>
+void SoftmaxBlock(const T* x,
+                  T* y,
+                  T* buffer,
+                  int axis_dim,
+                  int num_remain,
+                  bool log_mode,
+                  ExpFunc<T> exp_func) {
+  const int n = axis_dim * num_remain;
+  T* acc = buffer;
+  std::fill(acc, acc + num_remain, -std::numeric_limits<T>::infinity());
+  for (int a = 0; a < axis_dim; ++a) {
+    const T* x_row = x + a * num_remain;
+    for (int r = 0; r < num_remain; ++r) {
+      acc[r] = std::max(acc[r], x_row[r]);
+    }
+  }
+  for (int a = 0; a < axis_dim; ++a) {
+    const T* x_row = x + a * num_remain;
+    T* y_row = y + a * num_remain;
+    for (int r = 0; r < num_remain; ++r) {
+      y_row[r] = ShiftAndClip(x_row[r], acc[r]);
+    }
+  }
+  T* exp_y = log_mode ? buffer + num_remain : y;
+  exp_func(y, exp_y, n);
+  std::fill(acc, acc + num_remain, static_cast<T>(0));
+  for (int a = 0; a < axis_dim; ++a) {
+    const T* e_row = exp_y + a * num_remain;
+    for (int r = 0; r < num_remain; ++r) {
+      acc[r] += e_row[r];
+    }
+  }
+  for (int r = 0; r < num_remain; ++r) {
+    acc[r] = log_mode ? std::log(acc[r]) : static_cast<T>(1) / acc[r];
+  }
+  for (int a = 0; a < axis_dim; ++a) {
+    T* y_row = y + a * num_remain;
+    if (log_mode) {
+      for (int r = 0; r < num_remain; ++r) {
+        y_row[r] -= acc[r];
+      }
+    } else {
+      for (int r = 0; r < num_remain; ++r) {
+        y_row[r] *= acc[r];
+      }
+    }
+  }
+}
+
+// softmax: dx = (dy - sum(dy * y)) * y
+// log_softmax: dx = dy - exp(y) * sum(dy)
+template <typename T>
+void SoftmaxGradRow(const T* y,
+                    const T* dy,
+                    T* dx,
+                    T* buffer,
+                    int n,
+                    bool log_mode,
+                    ExpFunc<T> exp_func) {
+  T sum = static_cast<T>(0);
+  if (log_mode) {
+    for (int i = 0; i < n; ++i) {
+      sum += dy[i];
+    }
+    exp_func(y, buffer, n);
+    for (int i = 0; i < n; ++i) {
+      dx[i] = dy[i] - buffer[i] * sum;
+    }
+  } else {
+    for (int i = 0; i < n; ++i) {
+      sum += dy[i] * y[i];
+    }
+    for (int i = 0; i < n; ++i) {
+      dx[i] = (dy[i] - sum) * y[i];
+    }
+  }
+}
+
+template <typename T>
+void SoftmaxGradBlock(const T* y,
+                      const T* dy,
+                      T* dx,
+                      T* buffer,
+                      int axis_dim,
+                      int num_remain,
+                      bool log_mode,
+                      ExpFunc<T> exp_func) {
+  const int n = axis_dim * num_remain;
+  T* acc = buffer;
+  std::fill(acc, acc + num_remain, static_cast<T>(0));
+  if (log_mode) {
+    for (int a = 0; a < axis_dim; ++a) {
+      const T* dy_row = dy + a * num_remain;
+      for (int r = 0; r < num_remain; ++r) {
+        acc[r] += dy_row[r];
+      }
+    }
+    T* exp_y = buffer + num_remain;
+    exp_func(y, exp_y, n);
+    for (int a = 0; a < axis_dim; ++a) {
+      const int offset = a * num_remain;
+      for (int r = 0; r < num_remain; ++r) {
+        dx[offset + r] = dy[offset + r] - exp_y[offset + r] * acc[r];
+      }
+    }
+  } else {
+    for (int a = 0; a < axis_dim; ++a) {
+      const int offset = a * num_remain;
+      for (int r = 0; r < num_remain; ++r) {
+        acc[r] += dy[offset + r] * y[offset + r];
+      }
+    }
+    for (int a = 0; a < axis_dim; ++a) {
+      const int offset = a * num_remain;
+      for (int r = 0; r < num_remain; ++r) {
+        dx[offset + r] = (dy[offset + r] - acc[r]) * y[offset + r];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void SoftmaxCPU(const T* x,
+                T* y,
+                int64_t batch_size,
+                int axis_dim,
+                int num_remain,
+                bool log_mode) {
+  const int num_classes = axis_dim * num_remain;
+  auto exp_func = GetExpFunc<T>(num_classes);
+  if (num_remain == 1) {
+    ParallelForRows<T>(batch_size,
+                       num_classes,
+                       log_mode ? num_classes : 0,
+                       [&](int64_t row, T* buffer) {
+                         SoftmaxRow<T>(x + row * num_classes,
+                                       nullptr,
+                                       y + row * num_classes,
+                                       buffer,
+                                       num_classes,
+                                       log_mode,
+                                       exp_func);
+                       });
+  } else {
+    ParallelForRows<T>(batch_size,
+                       num_classes,
+                       num_remain + (log_mode ? num_classes : 0),
+                       [&](int64_t row, T* buffer) {
+                         SoftmaxBlock<T>(x + row * num_classes,
+                                         y + row * num_classes,
+                                         buffer,
+                                         axis_dim,
+                                         num_remain,
+                                         log_mode,
+                                         exp_func);
+                       });
+  }
+}
+
+template <typename T>
+void SoftmaxGradCPU(const T* y,
+                    const T* dy,
+                    T* dx,
+                    int64_t batch_size,
+                    int axis_dim,
+                    int num_remain,
+                    bool log_mode) {
+  const int num_classes = axis_dim * num_remain;
+  auto exp_func = GetExpFunc<T>(num_classes);
+  if (num_remain == 1) {
+    ParallelForRows<T>(batch_size,
+                       num_classes,
+                       log_mode ? num_classes : 0,
+                       [&](int64_t row, T* buffer) {
+                         SoftmaxGradRow<T>(y + row * num_classes,
+                                           dy + row * num_classes,
+                                           dx + row * num_classes,
+                                           buffer,
+                                           num_classes,
+                                           log_mode,
+                                           exp_func);
+                       });
+  } else {
+    ParallelForRows<T>(batch_size,
+                       num_classes,
+                       num_remain + (log_mode ? num_classes : 0),
+                       [&](int64_t row, T* buffer) {
+                         SoftmaxGradBlock<T>(y + row * num_classes,
+                                             dy + row * num_classes,
+                                             dx + row * num_classes,
+                                             buffer,
+                                             axis_dim,
+                                             num_remain,
+                                             log_mode,
+                                             exp_func);
+                       });
+  }
+}
+
+template <typename T>
+void MaskedSoftmaxCPU(const T* x,
+                      const T* mask,
+                      T* y,
+                      int64_t batch_size,
+                      int64_t num_heads,
+                      int64_t seq_len,
+                      int num_classes) {
+  auto exp_func = GetExpFunc<T>(num_classes);
+  ParallelForRows<T>(
+      batch_size * num_heads * seq_len,
+      num_classes,
+      0,
+      [&](int64_t row, T* buffer) {
+        // the mask is shared by the heads
+        const int64_t mask_row =
+            row / (num_heads * seq_len) * seq_len + row % seq_len;
+        SoftmaxRow<T>(x + row * num_classes,
+                      mask + mask_row * num_classes,
+                      y + row * num_classes,
+                      buffer,
+                      num_classes,
+                      false,
+                      exp_func);
+      });
+}
+
+template void SoftmaxCPU<float>(const float*, float*, int64_t, int, int, bool);
+template void SoftmaxCPU<double>(
+    const double*, double*, int64_t, int, int, bool);
+template void SoftmaxGradCPU<float>(
+    const float*, const float*, float*, int64_t, int, int, bool);
+template void SoftmaxGradCPU<double>(
+    const double*, const double*, double*, int64_t, int, int, bool);
+template void MaskedSoftmaxCPU<float>(
+    const float*, const float*, float*, int64_t, int64_t, int64_t, int);
+template void MaskedSoftmaxCPU<double>(
+    const double*, const double*, double*, int64_t, int64_t, int64_t, int);
+
 }  // namespace phi::funcs
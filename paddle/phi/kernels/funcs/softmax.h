@@ -37,6 +37,39 @@ class SoftmaxGradFunctor {
                   phi::DenseTensor* x_grad);
 };
 
+// Softmax of x viewed as [batch_size, axis_dim, num_remain] along axis_dim on
+// CPU, with the batches split across threads. Computes log_softmax instead if
+// log_mode is true. Implemented for float and double.
+template <typename T>
+void SoftmaxCPU(const T* x,
+                T* y,
+                int64_t batch_size,
+                int axis_dim,
+                int num_remain,
+                bool log_mode = false);
+
+// Gradient of SoftmaxCPU, y is the output of the forward.
+template <typename T>
+void SoftmaxGradCPU(const T* y,
+                    const T* dy,
+                    T* dx,
+                    int64_t batch_size,
+                    int axis_dim,
+                    int num_remain,
+                    bool log_mode = false);
+
+// y = softmax(x + mask) along the last dim, where x is
+// [batch_size, num_heads, seq_len, num_classes] and mask is
+// [batch_size, 1, seq_len, num_classes].
+template <typename T>
+void MaskedSoftmaxCPU(const T* x,
+                      const T* mask,
+                      T* y,
+                      int64_t batch_size,
+                      int64_t num_heads,
+                      int64_t seq_len,
+                      int num_classes);
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 template <typename T, typename DeviceContext>
 class SoftmaxCUDNNFunctor {
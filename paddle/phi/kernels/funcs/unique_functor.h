@@ -13,11 +13,13 @@
 // limitations under the License.
 
 #pragma once
-#include <set>
+#include <numeric>
+#include <vector>
 
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/utils/data_type.h"
 #include "paddle/phi/kernels/funcs/concat_and_split_functor.h"
+#include "paddle/phi/kernels/funcs/cpu_sort.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
 namespace phi {
@@ -40,15 +42,6 @@ struct UniqueOpFunctor {
 
   template <typename IndexT>
   void apply() const {
-    auto* in_data = in_->data<InT>();
-    auto* index_data = context_.template Alloc<IndexT>(index_);
-
-    int64_t j = 0;
-
-    // TODO(fangzeyang): Should optimize performance here.
-    std::unordered_map<InT, int64_t> dict;
-    std::vector<InT> uniq;
-
     PADDLE_ENFORCE_LT(
         in_->numel(),
         pow(2, 31),
@@ -57,53 +50,51 @@ struct UniqueOpFunctor {
             "but received num is %d.",
             in_->numel()));
 
-    for (auto i = 0; i < in_->numel(); i++) {
-      auto it = dict.find(in_data[i]);
-      if (it == dict.end()) {
-        dict.emplace(std::make_pair(in_data[i], j));
-        uniq.emplace_back(in_data[i]);
-        index_data[i] = static_cast<IndexT>(j);
-        j++;
-      } else {
-        index_data[i] = static_cast<IndexT>(it->second);
-      }
+    const InT* in_data = in_->data<InT>();
+    const int64_t numel = in_->numel();
+    auto* index_data = context_.template Alloc<IndexT>(index_);
+
+    // Equal elements are grouped by a stable sort, so the first element of a
+    // group is its first occurrence, and every NaN is a group of its own as
+    // NaN != NaN.
+    std::vector<InT> keys(in_data, in_data + numel);
+    std::vector<int64_t> positions(numel);
+    std::iota(positions.begin(), positions.end(), 0);
+    SortPairs(keys.data(), positions.data(), numel);
+    std::vector<int64_t> starts = SegmentStarts(numel, [&](int64_t i) {
+      return keys[i] != keys[i - 1];
+    });
+    const int64_t num_uniq = static_cast<int64_t>(starts.size()) - 1;
+
+    // The groups are ordered by their first occurrences.
+    std::vector<int64_t> first_positions(num_uniq);
+    std::vector<int64_t> order(num_uniq);
+    for (int64_t g = 0; g < num_uniq; ++g) {
+      first_positions[g] = positions[starts[g]];
+      order[g] = g;
     }
+    RadixSortPairs(first_positions.data(), order.data(), num_uniq);
 
+    out_->Resize(common::make_ddim({num_uniq}));
+    auto* out_data = context_.template Alloc<InT>(out_);
+    IndexT* count_data = nullptr;
     if (count_ != nullptr) {
-      // Resize the count tensor dims to allocate the memory
-      count_->Resize(common::make_ddim({static_cast<int64_t>(uniq.size())}));
-      IndexT* count_data = context_.template Alloc<IndexT>(count_);
-      // init count_data to 0
-      memset(count_data, 0, uniq.size() * sizeof(IndexT));
-
-      const auto& index_type = index_->dtype();
-      bool index_type_match =
-          index_type == DataType::INT32 || index_type == DataType::INT64;
-      PADDLE_ENFORCE_EQ(index_type_match,
-                        true,
-                        common::errors::InvalidArgument(
-                            "Index holds the wrong type, it holds %s, "
-                            "but desires to be %s or %s",
-                            DataTypeToString(index_type),
-                            DataTypeToString(DataType::INT32),
-                            DataTypeToString(DataType::INT64)));
-
-      if (index_type == DataType::INT32) {
-        for (auto i = 0; i < in_->numel(); ++i) {
-          const IndexT& index = index_data[i];
-          count_data[static_cast<int32_t>(index)] += static_cast<IndexT>(1);
-        }
-      } else {
-        for (auto i = 0; i < in_->numel(); ++i) {
-          const IndexT& index = index_data[i];
-          count_data[static_cast<int64_t>(index)] += static_cast<IndexT>(1);
-        }
+      count_->Resize(common::make_ddim({num_uniq}));
+      count_data = context_.template Alloc<IndexT>(count_);
+    }
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (numel >= kCPUSortParallelNumel)
+#endif
+    for (int64_t j = 0; j < num_uniq; ++j) {
+      const int64_t g = order[j];
+      out_data[j] = keys[starts[g]];
+      for (int64_t i = starts[g]; i < starts[g + 1]; ++i) {
+        index_data[positions[i]] = static_cast<IndexT>(j);
+      }
+      if (count_data != nullptr) {
+        count_data[j] = static_cast<IndexT>(starts[g + 1] - starts[g]);
       }
     }
-
-    out_->Resize(common::make_ddim({static_cast<int64_t>(uniq.size())}));
-    auto* out_data = context_.template Alloc<InT>(out_);
-    std::memcpy(out_data, uniq.data(), uniq.size() * sizeof(InT));
   }
 };
 
@@ -140,51 +131,51 @@ static void UniqueFlattenedTensor(const Context& context,
                                   bool return_inverse,
                                   bool return_counts) {
   const InT* in_data = in.data<InT>();
-  std::set<InT> unique(in_data, in_data + in.numel());
-  out->Resize(common::make_ddim({static_cast<int64_t>(unique.size())}));
+  const int64_t numel = in.numel();
+  // The stable sort keeps the equal elements in their order in the input, so
+  // the first element of a group is its first occurrence.
+  std::vector<InT> keys(in_data, in_data + numel);
+  std::vector<IndexT> positions(numel);
+  std::iota(positions.begin(), positions.end(), IndexT(0));
+  SortPairs(keys.data(), positions.data(), numel);
+  std::vector<int64_t> starts = SegmentStarts(numel, [&](int64_t i) {
+    return !SameSortKey(keys[i], keys[i - 1]);
+  });
+  const int64_t num_uniq = static_cast<int64_t>(starts.size()) - 1;
+
+  out->Resize(common::make_ddim({num_uniq}));
   auto* out_data = context.template Alloc<InT>(out);
-  std::copy(unique.begin(), unique.end(), out_data);
-
+  IndexT* indices_data = nullptr;
   if (return_index) {
-    indices->Resize(common::make_ddim({out->numel()}));
-    auto indices_data = context.template Alloc<IndexT>(indices);
-    std::unordered_map<InT, IndexT> indices_map;
-    indices_map.reserve(out->numel());
-    for (int64_t i = 0; i < in.numel(); ++i) {
-      if (indices_map.find(in_data[i]) != indices_map.end()) continue;
-      indices_map[in_data[i]] = i;
-    }
-    for (int64_t i = 0; i < out->numel(); ++i) {
-      indices_data[i] = indices_map[out_data[i]];
-    }
+    indices->Resize(common::make_ddim({num_uniq}));
+    indices_data = context.template Alloc<IndexT>(indices);
   }
-
+  IndexT* inverse_data = nullptr;
   if (return_inverse) {
-    index->Resize(common::make_ddim({in.numel()}));
-    auto inverse_data = context.template Alloc<IndexT>(index);
-    std::unordered_map<InT, IndexT> inverse_map;
-    inverse_map.reserve(out->numel());
-    for (int64_t i = 0; i < out->numel(); ++i) {
-      inverse_map[out_data[i]] = i;
-    }
-    for (int64_t i = 0; i < in.numel(); ++i) {
-      inverse_data[i] = inverse_map[in_data[i]];
-    }
+    index->Resize(common::make_ddim({numel}));
+    inverse_data = context.template Alloc<IndexT>(index);
   }
-
+  IndexT* count_data = nullptr;
   if (return_counts) {
-    count->Resize(common::make_ddim({out->numel()}));
-    auto count_data = context.template Alloc<IndexT>(count);
-    std::unordered_map<InT, IndexT> counts_map;
-    counts_map.reserve(out->numel());
-    for (int64_t i = 0; i < out->numel(); ++i) {
-      counts_map[out_data[i]] = 0;
+    count->Resize(common::make_ddim({num_uniq}));
+    count_data = context.template Alloc<IndexT>(count);
+  }
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (numel >= kCPUSortParallelNumel)
+#endif
+  for (int64_t g = 0; g < num_uniq; ++g) {
+    out_data[g] = keys[starts[g]];
+    if (indices_data != nullptr) {
+      indices_data[g] = positions[starts[g]];
     }
-    for (int64_t i = 0; i < in.numel(); i++) {
-      counts_map[in_data[i]] += 1;
+    if (inverse_data != nullptr) {
+      for (int64_t i = starts[g]; i < starts[g + 1]; ++i) {
+        inverse_data[positions[i]] = static_cast<IndexT>(g);
+      }
     }
-    for (int64_t i = 0; i < out->numel(); i++) {
-      count_data[i] = counts_map[out_data[i]];
+    if (count_data != nullptr) {
+      count_data[g] = static_cast<IndexT>(starts[g + 1] - starts[g]);
     }
   }
 }
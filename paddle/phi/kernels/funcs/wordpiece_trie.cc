@@ -0,0 +1,203 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/wordpiece_trie.h"
+
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace phi {
+namespace funcs {
+
+namespace {
+const char kSuffixIndicator[] = "##";
+}  // namespace
+
+WordPieceTrie::WordPieceTrie(const Vocab& vocab) {
+  // Build a pointer-based trie, then flatten the edges of each node.
+  std::vector<std::map<uint8_t, int32_t>> children(1);
+  std::vector<int32_t> token_ids(1, kNull);
+  auto insert = [&](const std::string& key) {
+    int32_t node = root_;
+    for (char ch : key) {
+      auto label = static_cast<uint8_t>(ch);
+      auto it = children[node].find(label);
+      if (it == children[node].end()) {
+        int32_t child = static_cast<int32_t>(children.size());
+        children[node].emplace(label, child);
+        children.emplace_back();
+        token_ids.push_back(kNull);
+        node = child;
+      } else {
+        node = it->second;
+      }
+    }
+    return node;
+  };
+
+  suffix_root_ = insert(kSuffixIndicator);
+  std::string key;
+  for (const auto& item : vocab) {
+    try {
+      ConvertWstrToStr(item.first, &key);
+    } catch (std::range_error& e) {
+      VLOG(3) << "Skip the token " << item.second
+              << " which can not be converted to UTF-8.";
+      continue;
+    }
+    if (key.empty()) {
+      continue;
+    }
+    token_ids[insert(key)] = item.second;
+  }
+
+  nodes_.resize(children.size());
+  for (size_t i = 0; i < children.size(); ++i) {
+    auto& node = nodes_[i];
+    node.first_edge = static_cast<int32_t>(edge_labels_.size());
+    node.num_edges = static_cast<int32_t>(children[i].size());
+    node.token_id = token_ids[i];
+    for (const auto& edge : children[i]) {
+      edge_labels_.push_back(edge.first);
+      edge_targets_.push_back(edge.second);
+    }
+  }
+  BuildFailureLinks();
+}
+
+int32_t WordPieceTrie::Child(int32_t node, uint8_t label) const {
+  const auto& n = nodes_[node];
+  const uint8_t* begin = edge_labels_.data() + n.first_edge;
+  const uint8_t* end = begin + n.num_edges;
+  const uint8_t* it = n.num_edges <= 8 ? std::find(begin, end, label)
+                                       : std::lower_bound(begin, end, label);
+  if (it == end || *it != label) {
+    return kNull;
+  }
+  return edge_targets_[n.first_edge + (it - begin)];
+}
+
+// The failure link of a node v is the node to continue from when no edge of
+// v matches the next byte, and its failure pops are the tokens recognized
+// before jumping there. Following the paper, for v = child(u, c):
+//  - if v is a token, f(v) is the suffix root and F(v) = [v];
+//  - otherwise, z walks the failure links from f(u), collecting their pops
+//    into Z, until z has an edge c. Then f(v) = child(z, c) and
+//    F(v) = F(u) + Z.
+// The root and the suffix root have no failure link.
+void WordPieceTrie::BuildFailureLinks() {
+  std::queue<int32_t> queue;
+  queue.push(root_);
+  std::vector<int32_t> pops;
+  while (!queue.empty()) {
+    int32_t u = queue.front();
+    queue.pop();
+    for (int32_t e = 0; e < nodes_[u].num_edges; ++e) {
+      uint8_t label = edge_labels_[nodes_[u].first_edge + e];
+      int32_t v = edge_targets_[nodes_[u].first_edge + e];
+      queue.push(v);
+      if (v == suffix_root_) {
+        continue;
+      }
+      if (nodes_[v].token_id != kNull) {
+        nodes_[v].failure = suffix_root_;
+        nodes_[v].pops_begin = static_cast<int32_t>(pops_.size());
+        pops_.push_back(nodes_[v].token_id);
+        nodes_[v].pops_end = static_cast<int32_t>(pops_.size());
+        continue;
+      }
+      pops.assign(pops_.begin() + nodes_[u].pops_begin,
+                  pops_.begin() + nodes_[u].pops_end);
+      int32_t z = nodes_[u].failure;
+      while (z != kNull && Child(z, label) == kNull) {
+        pops.insert(pops.end(),
+                    pops_.begin() + nodes_[z].pops_begin,
+                    pops_.begin() + nodes_[z].pops_end);
+        z = nodes_[z].failure;
+      }
+      if (z != kNull) {
+        nodes_[v].failure = Child(z, label);
+        nodes_[v].pops_begin = static_cast<int32_t>(pops_.size());
+        pops_.insert(pops_.end(), pops.begin(), pops.end());
+        nodes_[v].pops_end = static_cast<int32_t>(pops_.size());
+      }
+    }
+  }
+}
+
+std::shared_ptr<const WordPieceTrie> WordPieceTrie::Get(const Vocab* vocab) {
+  auto trie = vocab->wordpiece_trie();
+  if (trie == nullptr) {
+    // Two threads may both build the trie of a new vocab, the later one is
+    // kept, which is the same.
+    trie = std::make_shared<WordPieceTrie>(*vocab);
+    vocab->set_wordpiece_trie(trie);
+    VLOG(3) << "Build the WordPiece trie of " << vocab->size()
+            << " tokens with " << trie->NumNodes() << " nodes.";
+  }
+  return trie;
+}
+
+int64_t WordPieceTrie::Find(const char* data, size_t len) const {
+  int32_t node = root_;
+  for (size_t i = 0; i < len && node != kNull; ++i) {
+    node = Child(node, static_cast<uint8_t>(data[i]));
+  }
+  return node == kNull ? -1 : nodes_[node].token_id;
+}
+
+bool WordPieceTrie::Tokenize(const char* data,
+                             size_t len,
+                             std::vector<int64_t>* ids) const {
+  const size_t num_ids = ids->size();
+  auto fail = [&]() {
+    ids->resize(num_ids);
+    return false;
+  };
+  auto pop = [&](int32_t node) {
+    ids->insert(ids->end(),
+                pops_.begin() + nodes_[node].pops_begin,
+                pops_.begin() + nodes_[node].pops_end);
+  };
+
+  int32_t u = root_;
+  for (size_t i = 0; i < len; ++i) {
+    auto label = static_cast<uint8_t>(data[i]);
+    int32_t v;
+    while ((v = Child(u, label)) == kNull) {
+      if (nodes_[u].failure == kNull) {
+        return fail();
+      }
+      pop(u);
+      u = nodes_[u].failure;
+    }
+    u = v;
+  }
+  while (u != root_ && u != suffix_root_) {
+    if (nodes_[u].failure == kNull) {
+      return fail();
+    }
+    pop(u);
+    u = nodes_[u].failure;
+  }
+  return true;
+}
+
+}  // namespace funcs
+}  // namespace phi
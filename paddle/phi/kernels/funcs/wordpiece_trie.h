@@ -0,0 +1,81 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/core/vocab/string_array.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+namespace funcs {
+
+// A byte-level trie of a WordPiece vocabulary with the failure links and
+// failure pops of LinMaxMatch ("Fast WordPiece Tokenization", Song et al.,
+// 2021). It gives the same tokens as the greedy longest-match-first WordPiece,
+// in time linear in the length of the word and without building substrings.
+//
+// Tokens starting with the suffix indicator "##" continue a word, the others
+// start a word. Words and tokens are UTF-8 strings, and words must not start
+// with "##", as BasicTokenizer splits '#' off as punctuation.
+class TEST_API WordPieceTrie {
+ public:
+  explicit WordPieceTrie(const Vocab& vocab);
+
+  // Returns the trie of vocab. It is built on the first call and kept in the
+  // vocab for the later calls, until the vocab changes or is destroyed.
+  static std::shared_ptr<const WordPieceTrie> Get(const Vocab* vocab);
+
+  // Returns the id of the token equal to the string, or -1.
+  int64_t Find(const char* data, size_t len) const;
+
+  // Appends the ids of the WordPiece tokens of the word to ids. Returns false
+  // and appends nothing if the word can not be covered by the vocabulary.
+  bool Tokenize(const char* data, size_t len, std::vector<int64_t>* ids) const;
+
+  size_t NumNodes() const { return nodes_.size(); }
+
+ private:
+  static constexpr int32_t kNull = -1;
+
+  struct Node {
+    int32_t first_edge = 0;
+    int32_t num_edges = 0;
+    int32_t token_id = kNull;
+    // failure link, and the range of token ids in pops_ to emit when it is
+    // followed
+    int32_t failure = kNull;
+    int32_t pops_begin = 0;
+    int32_t pops_end = 0;
+  };
+
+  int32_t Child(int32_t node, uint8_t label) const;
+
+  void BuildFailureLinks();
+
+  std::vector<Node> nodes_;
+  // edges of a node are contiguous and sorted by label
+  std::vector<uint8_t> edge_labels_;
+  std::vector<int32_t> edge_targets_;
+  std::vector<int32_t> pops_;
+  int32_t root_ = 0;
+  int32_t suffix_root_ = kNull;
+};
+
+}  // namespace funcs
+}  // namespace phi
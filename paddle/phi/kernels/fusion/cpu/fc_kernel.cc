@@ -16,4 +16,11 @@
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/impl/fc_kernel_impl.h"
 
-PD_REGISTER_KERNEL(fc, CPU, ALL_LAYOUT, phi::fusion::FCKernel, float, double) {}
+PD_REGISTER_KERNEL(fc,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FCKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
@@ -0,0 +1,135 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "paddle/common/errors.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+namespace phi {
+namespace fusion {
+
+// out[i] = layer_norm(embs[0][ids[0][i]] + ... + embs[n-1][ids[n-1][i]]),
+// computed row by row so the summed embeddings stay in cache.
+template <typename T, typename Context>
+void EmbeddingEltWiseLayerNormKernel(
+    const Context& dev_ctx,
+    const std::vector<const DenseTensor*>& ids,
+    const std::vector<const DenseTensor*>& embs,
+    const DenseTensor& bias,
+    const DenseTensor& scale,
+    const float epsilon,
+    DenseTensor* out) {
+  PADDLE_ENFORCE_GE(
+      epsilon,
+      0.0f,
+      common::errors::InvalidArgument(
+          "'epsilon' is %f, but it should be between 0.0 and 0.001", epsilon));
+  PADDLE_ENFORCE_LE(
+      epsilon,
+      0.001f,
+      common::errors::InvalidArgument(
+          "'epsilon' is %f, but it should be between 0.0 and 0.001.", epsilon));
+  const int input_num = static_cast<int>(ids.size());
+  PADDLE_ENFORCE_EQ(
+      input_num,
+      static_cast<int>(embs.size()),
+      common::errors::InvalidArgument(
+          "The number of ids (%d) should be equal to the number of embs (%d).",
+          input_num,
+          embs.size()));
+
+  const int64_t rows = ids[0]->numel();
+  const int64_t hidden = embs[0]->dims()[1];
+  std::vector<const int64_t*> ids_data(input_num);
+  std::vector<const T*> embs_data(input_num);
+  for (int i = 0; i < input_num; ++i) {
+    PADDLE_ENFORCE_EQ(
+        ids[i]->numel(),
+        rows,
+        common::errors::InvalidArgument(
+            "All ids should have the same numel, but the numel of ids[%d] "
+            "is %d and the numel of ids[0] is %d.",
+            i,
+            ids[i]->numel(),
+            rows));
+    ids_data[i] = ids[i]->data<int64_t>();
+    embs_data[i] = embs[i]->data<T>();
+    // The ids are checked here, as the parallel loop below can not throw.
+    const int64_t vocab_size = embs[i]->dims()[0];
+    for (int64_t r = 0; r < rows; ++r) {
+      PADDLE_ENFORCE_EQ(
+          ids_data[i][r] >= 0 && ids_data[i][r] < vocab_size,
+          true,
+          common::errors::InvalidArgument(
+              "The id %d of ids[%d] is out of the range [0, %d).",
+              ids_data[i][r],
+              i,
+              vocab_size));
+    }
+  }
+
+  const T* bias_data = bias.data<T>();
+  const T* scale_data = scale.data<T>();
+  T* out_data = dev_ctx.template Alloc<T>(out);
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t r = 0; r < rows; ++r) {
+    T* out_row = out_data + r * hidden;
+    for (int i = 0; i < input_num; ++i) {
+      const T* emb_row = embs_data[i] + ids_data[i][r] * hidden;
+      if (i == 0) {
+        std::copy(emb_row, emb_row + hidden, out_row);
+      } else {
+        for (int64_t j = 0; j < hidden; ++j) {
+          out_row[j] += emb_row[j];
+        }
+      }
+    }
+
+    T mean = 0;
+    for (int64_t j = 0; j < hidden; ++j) {
+      mean += out_row[j];
+    }
+    mean /= hidden;
+    T variance = 0;
+    for (int64_t j = 0; j < hidden; ++j) {
+      T diff = out_row[j] - mean;
+      variance += diff * diff;
+    }
+    variance /= hidden;
+    const T inv_std = static_cast<T>(1) / std::sqrt(variance + epsilon);
+    for (int64_t j = 0; j < hidden; ++j) {
+      out_row[j] = (out_row[j] - mean) * inv_std * scale_data[j] + bias_data[j];
+    }
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_embedding_eltwise_layernorm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::EmbeddingEltWiseLayerNormKernel,
+                   float) {}
@@ -234,11 +234,28 @@ void FusedLayerNormAvxKernel(const Context& dev_ctx,
                   var_out);
   }
 }
+
+// Not registered, fused_layernorm_kernel.cc dispatches the float
+// fused_bias_residual_layernorm without quantization here on the CPUs with
+// AVX512.
+template void FusedLayerNormAvxKernel<float, CPUContext>(
+    const CPUContext& dev_ctx,
+    const DenseTensor& x,
+    const paddle::optional<DenseTensor>& bias,
+    const paddle::optional<DenseTensor>& residual,
+    const paddle::optional<DenseTensor>& norm_weight,
+    const paddle::optional<DenseTensor>& norm_bias,
+    const float epsilon,
+    const float residual_alpha,
+    const int begin_norm_axis,
+    const float quant_scale,
+    const int quant_round_type,
+    const float quant_max_bound,
+    const float quant_min_bound,
+    DenseTensor* out,
+    DenseTensor* residual_out,
+    DenseTensor* mean,
+    DenseTensor* variance);
+
 }  // namespace fusion
 }  // namespace phi
-
-PD_REGISTER_KERNEL(fused_bias_residual_layernorm,
-                   CPU,
-                   ALL_LAYOUT,
-                   phi::fusion::FusedLayerNormAvxKernel,
-                   float) {}
@@ -0,0 +1,181 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/norm_cpu_function.h"
+
+namespace phi {
+namespace fusion {
+
+#if defined(PADDLE_WITH_AVX) && defined(PADDLE_WITH_AVX512F) && \
+    defined(PADDLE_WITH_MKLML)
+// In fused_layer_norm_avx_kernel.cc, still faster on the float rows of the
+// residual add + layer_norm than funcs::CPUNormForward.
+template <typename T, typename Context>
+void FusedLayerNormAvxKernel(const Context& dev_ctx,
+                             const DenseTensor& x,
+                             const paddle::optional<DenseTensor>& bias,
+                             const paddle::optional<DenseTensor>& residual,
+                             const paddle::optional<DenseTensor>& norm_weight,
+                             const paddle::optional<DenseTensor>& norm_bias,
+                             const float epsilon,
+                             const float residual_alpha,
+                             const int begin_norm_axis,
+                             const float quant_scale,
+                             const int quant_round_type,
+                             const float quant_max_bound,
+                             const float quant_min_bound,
+                             DenseTensor* out,
+                             DenseTensor* residual_out,
+                             DenseTensor* mean,
+                             DenseTensor* variance);
+#endif
+
+// LayerNorm(x + residual_alpha * residual + bias) in one pass over each row,
+// see funcs::CPUNormForward. Follows the GPU kernel: bias is only added
+// together with residual, norm_weight and norm_bias are float, variance
+// holds 1 / sqrt(var + epsilon), out is quantized to int8 or float8_e4m3fn
+// when its type says so, and without norm_weight and norm_bias only
+// x + residual_alpha * residual + bias is written to out.
+template <typename T, typename Context>
+void FusedLayerNormKernel(const Context& dev_ctx,
+                          const DenseTensor& x,
+                          const paddle::optional<DenseTensor>& bias,
+                          const paddle::optional<DenseTensor>& residual,
+                          const paddle::optional<DenseTensor>& norm_weight,
+                          const paddle::optional<DenseTensor>& norm_bias,
+                          const float epsilon,
+                          const float residual_alpha,
+                          const int begin_norm_axis,
+                          const float quant_scale,
+                          const int quant_round_type,
+                          const float quant_max_bound,
+                          const float quant_min_bound,
+                          DenseTensor* out,
+                          DenseTensor* residual_out,
+                          DenseTensor* mean,
+                          DenseTensor* variance) {
+  if (out->dtype() == phi::DataType::INT8 ||
+      out->dtype() == phi::DataType::FLOAT8_E4M3FN) {
+    PADDLE_ENFORCE_EQ(
+        quant_scale != 0.0f,
+        true,
+        common::errors::InvalidArgument(
+            "Quant fused_bias_residual_layernorm'output, must has quant_scale, "
+            "quant_scale!=0, but quant_scale = %f ",
+            quant_scale));
+    PADDLE_ENFORCE_EQ(quant_round_type == 0 || quant_round_type == 1,
+                      true,
+                      common::errors::InvalidArgument(
+                          "Quant fused_bias_residual_layernorm'output, must "
+                          "has quant_round_type, "
+                          "quant_round_type = 0 or quant_round_type = 1, but "
+                          "quant_round_type = %d ",
+                          quant_round_type));
+  }
+
+#if defined(PADDLE_WITH_AVX) && defined(PADDLE_WITH_AVX512F) && \
+    defined(PADDLE_WITH_MKLML)
+  if (std::is_same<T, float>::value && out->dtype() == phi::DataType::FLOAT32 &&
+      (norm_weight || norm_bias) &&
+      backends::cpu::MayIUse(backends::cpu::avx512f)) {
+    FusedLayerNormAvxKernel<float, CPUContext>(dev_ctx,
+                                               x,
+                                               bias,
+                                               residual,
+                                               norm_weight,
+                                               norm_bias,
+                                               epsilon,
+                                               residual_alpha,
+                                               begin_norm_axis,
+                                               quant_scale,
+                                               quant_round_type,
+                                               quant_max_bound,
+                                               quant_min_bound,
+                                               out,
+                                               residual_out,
+                                               mean,
+                                               variance);
+    return;
+  }
+#endif
+
+  auto matrix_dim = common::flatten_to_2d(x.dims(), begin_norm_axis);
+  funcs::CPUNormArgs<T, float> args;
+  args.rows = matrix_dim[0];
+  args.cols = matrix_dim[1];
+  args.epsilon = epsilon;
+  args.x = x.data<T>();
+  args.residual_alpha = residual_alpha;
+  args.scale = norm_weight ? norm_weight->data<float>() : nullptr;
+  args.norm_bias = norm_bias ? norm_bias->data<float>() : nullptr;
+  if (residual) {
+    args.residual = residual->data<T>();
+    args.bias = bias ? bias->data<T>() : nullptr;
+  }
+
+  if (residual && !norm_weight && !norm_bias) {
+    args.residual_out = dev_ctx.template Alloc<T>(out);
+    funcs::CPUNormForward<false>(
+        args,
+        static_cast<T*>(nullptr),
+        nullptr,
+        [](int64_t, float, float, float) {});
+    return;
+  }
+  if (residual) {
+    args.residual_out = dev_ctx.template Alloc<T>(residual_out);
+  }
+  float* mean_data = dev_ctx.template Alloc<float>(mean);
+  float* variance_data = dev_ctx.template Alloc<float>(variance);
+  auto stats = [&](int64_t r, float row_mean, float, float rstd) {
+    mean_data[r] = row_mean;
+    variance_data[r] = rstd;
+  };
+
+  funcs::CPUNormQuant quantizer{
+      quant_scale, quant_round_type, quant_max_bound, quant_min_bound};
+  if (out->dtype() == phi::DataType::INT8) {
+    funcs::CPUNormForward<false>(
+        args, dev_ctx.template Alloc<int8_t>(out), &quantizer, stats);
+  } else if (out->dtype() == phi::DataType::FLOAT8_E4M3FN) {
+    funcs::CPUNormForward<false>(
+        args,
+        dev_ctx.template Alloc<phi::dtype::float8_e4m3fn>(out),
+        &quantizer,
+        stats);
+  } else {
+    funcs::CPUNormForward<false>(
+        args, dev_ctx.template Alloc<T>(out), nullptr, stats);
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_bias_residual_layernorm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedLayerNormKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->InputAt(3).SetDataType(phi::DataType::FLOAT32);
+  kernel->InputAt(4).SetDataType(phi::DataType::FLOAT32);
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(2).SetDataType(phi::DataType::FLOAT32);
+  kernel->OutputAt(3).SetDataType(phi::DataType::FLOAT32);
+}
@@ -13,8 +13,7 @@
 // limitations under the License.
 
 #include "paddle/phi/core/kernel_registry.h"
-#include "paddle/phi/kernels/elementwise_add_kernel.h"
-#include "paddle/phi/kernels/softmax_kernel.h"
+#include "paddle/phi/kernels/funcs/softmax.h"
 
 namespace phi::fusion {
 
@@ -52,8 +51,18 @@ void FusedSoftmaxMaskKernel(const Context& dev_ctx,
             idx,
             mask_dim[idx]));
   }
-  DenseTensor t = phi::Add<T, Context>(dev_ctx, x, mask);
-  SoftmaxKernel<T, Context>(dev_ctx, t, 3, out);  // axis for softmax
+  dev_ctx.template Alloc<T>(out);
+  if (out->numel() == 0) {
+    return;
+  }
+  // softmax(x + mask) along the last axis, without materializing x + mask
+  funcs::MaskedSoftmaxCPU<T>(x.data<T>(),
+                             mask.data<T>(),
+                             out->data<T>(),
+                             x_dim[0],
+                             x_dim[1],
+                             x_dim[2],
+                             static_cast<int>(x_dim[3]));
 }
 
 }  // namespace phi::fusion
@@ -18,6 +18,7 @@
 #include "paddle/phi/kernels/cpu/conv_util.h"
 #include "paddle/phi/kernels/funcs/batch_norm_utils.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/conv_cpu_function.h"
 #include "paddle/phi/kernels/funcs/im2col.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/funcs/vol2col.h"
@@ -70,6 +71,24 @@ void ConvKernelImpl(const Context& dev_ctx,
   UpdatePaddingAndDilation(
       &paddings, &dilations, padding_algorithm, in_data_dims, strides, ksize);
 
+  if constexpr (std::is_same<Context, CPUContext>::value &&
+                std::is_floating_point<T>::value) {
+    if (ksize.size() == 2U &&
+        phi::funcs::RunCPUConv2D<T>(dev_ctx,
+                                    transformed_input,
+                                    filter,
+                                    strides,
+                                    paddings,
+                                    dilations,
+                                    groups,
+                                    &transformed_output)) {
+      if (channel_last) {
+        TransToChannelLast<Context, T>(dev_ctx, &transformed_output, output);
+      }
+      return;
+    }
+  }
+
   const int batch_size = static_cast<int>(transformed_input.dims()[0]);
 
   // filter_shape_vec:
@@ -16,55 +16,17 @@
 #include <type_traits>
 #include <vector>
 
-#include "paddle/phi/common/amp_type_traits.h"
-#include "paddle/phi/kernels/funcs/eigen/common.h"
-#include "paddle/phi/kernels/funcs/eigen/eigen_function.h"
+#include "paddle/phi/kernels/funcs/reduce_cpu_function.h"
 #include "paddle/phi/kernels/funcs/reduce_function.h"
 #include "paddle/phi/kernels/logsumexp_kernel.h"
 
 namespace phi {
 
-#define HANDLE_DIM(NDIM, RDIM)                                         \
-  if (ndim == NDIM && rdim == RDIM) {                                  \
-    funcs::ReduceFunctor<Context, T, NDIM, RDIM, LogsumexpFunctor<T>>( \
-        dev_ctx, x, out, axis, keepdim);                               \
-  }
-
-template <typename T>
-struct LogsumexpFunctor {
-  template <typename Context, typename X, typename Y, typename Dim>
-  void operator()(const Context& place, X* x, Y* y, const Dim& dim) {
-    using MT = typename phi::dtype::MPTypeTrait<T>::Type;
-    auto x_dim = x->dimensions();
-    auto t_dim = x_dim;
-    for (int i = 0; i < static_cast<int>(dim.size()); i++) {
-      t_dim[dim[i]] = 1;
-    }
-
-    auto r_dim = x_dim;
-    for (int i = 0; i < static_cast<int>(r_dim.size()); i++) {
-      r_dim[i] = 1;
-    }
-    for (int i = 0; i < static_cast<int>(dim.size()); i++) {
-      r_dim[dim[i]] = x_dim[dim[i]];
-    }
-
-    auto x_mt = (*x).template cast<MT>();
-    auto y_dim = y->dimensions();
-    auto x_max = x_mt.maximum(dim).eval();
-    y->device(place) =
-        (x_max +
-         (x_mt - x_max.reshape(t_dim).broadcast(r_dim)).exp().sum(dim).log())
-            .reshape(y_dim)
-            .template cast<T>();
-  }
-};
-
 template <typename T, typename Context>
 void LogsumexpKernel(const Context& dev_ctx,
                      const DenseTensor& x,
                      const std::vector<int>& axis_in,
-                     bool keepdim,
+                     bool keepdim UNUSED,
                      bool reduce_all,
                      DenseTensor* out) {
   std::vector<int64_t> axis;
@@ -83,39 +45,14 @@ void LogsumexpKernel(const Context& dev_ctx,
                       errors::InvalidArgument(
                           "The dims of Input(X) should be greater than 0."));
   }
-  if (reduce_all) {
-    // Flatten and reduce 1-D tensor
-    auto input = phi::EigenVector<T>::Flatten(x);
-    auto output = phi::EigenScalar<T>::From(*out);
-    auto& place = *dev_ctx.eigen_device();
-    auto reduce_dim = Eigen::array<int, 1>({{0}});
-    LogsumexpFunctor<T>()(place, &input, &output, reduce_dim);
-  } else {
-    int ndim = x.dims().size();
-    int rdim = axis.size();
-    if (ndim > 4) {
-      PADDLE_THROW(common::errors::Unimplemented(
-          "Unsupported dimensions, please keep maximum dimensions of input "
-          "data less than 4."));
-    }
-
-    // comments for accelerating compiling temporarily.
-    // HANDLE_DIM(6, 5);
-    // HANDLE_DIM(6, 4);
-    // HANDLE_DIM(6, 3);
-    // HANDLE_DIM(6, 2);
-    // HANDLE_DIM(6, 1);
-    // HANDLE_DIM(5, 4);
-    // HANDLE_DIM(5, 3);
-    // HANDLE_DIM(5, 2);
-    // HANDLE_DIM(5, 1);
-    HANDLE_DIM(4, 3);
-    HANDLE_DIM(4, 2);
-    HANDLE_DIM(4, 1);
-    HANDLE_DIM(3, 2);
-    HANDLE_DIM(3, 1);
-    HANDLE_DIM(2, 1);
-  }
+  // The max and the sum of exp(x - max) are accumulated in one pass by
+  // CPULogsumexpOp, over any rank.
+  funcs::ReduceCPU(funcs::CPULogsumexpOp<T>(),
+                   x.data<T>(),
+                   common::vectorize<int64_t>(x_dim),
+                   axis,
+                   reduce_all,
+                   out->data<T>());
 }
 
 }  // namespace phi
@@ -21,6 +21,7 @@ limitations under the License. */
 #include "paddle/phi/kernels/autotune/cache_base.h"
 #include "paddle/phi/kernels/cast_kernel.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/blas/packed_weight_cache.h"
 #ifdef PADDLE_WITH_HIP
 #include "paddle/phi/kernels/funcs/blas/blaslt_impl.hip.h"
 #else
@@ -107,6 +108,34 @@ static void IndexIncreaseFromDims(const int ndim,
   }
 }
 
+// Out[M, N] = X[M, K] * op(Y) with the prepacked Y on CPU, returns false if
+// Y is not a registered constant weight.
+template <typename Context, typename T>
+static bool MatMulWithPackedWeight(const Context& dev_ctx,
+                                   const T* x_data,
+                                   const T* y_data,
+                                   bool trans_y,
+                                   int M,
+                                   int N,
+                                   int K,
+                                   bool flag,
+                                   T* out_data) {
+  if constexpr (std::is_same<Context, phi::CPUContext>::value &&
+                (std::is_same<T, float>::value ||
+                 std::is_same<T, double>::value)) {
+    return phi::funcs::PackedGEMM<T>(dev_ctx,
+                                     trans_y,
+                                     M,
+                                     N,
+                                     K,
+                                     x_data,
+                                     y_data,
+                                     static_cast<T>(flag),
+                                     out_data);
+  }
+  return false;
+}
+
 // The general implementation with blas.
 template <typename Context, typename T>
 void MatMulFunctionImplWithBlas(
@@ -383,6 +412,18 @@ void MatMulFunctionImplWithBlas(
   if (out_batch_size == 0) return;
   if (x_batch_size == 1 && y_batch_size == 1) {
     VLOG(3) << "MatMul's case 8";
+    if (!trans_x &&
+        MatMulWithPackedWeight<Context, T>(dev_ctx,
+                                           x_data,
+                                           y_data,
+                                           trans_y,
+                                           M,
+                                           N,
+                                           K,
+                                           flag,
+                                           dev_ctx.template Alloc<T>(Out))) {
+      return;
+    }
     blas.GEMM(trans_x ? CblasTrans : CblasNoTrans,
               trans_y ? CblasTrans : CblasNoTrans,
               M,
@@ -423,6 +464,17 @@ void MatMulFunctionImplWithBlas(
   } else if (y_batch_size == 1) {
     if (!trans_x) {
       VLOG(3) << "MatMul's case 11";
+      if (MatMulWithPackedWeight<Context, T>(dev_ctx,
+                                             x_data,
+                                             y_data,
+                                             trans_y,
+                                             x_batch_size * M,
+                                             N,
+                                             K,
+                                             flag,
+                                             dev_ctx.template Alloc<T>(Out))) {
+        return;
+      }
       blas.GEMM(CblasNoTrans,
                 trans_y ? CblasTrans : CblasNoTrans,
                 x_batch_size * M,
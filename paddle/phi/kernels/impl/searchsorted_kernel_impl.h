@@ -16,8 +16,11 @@
 
 #include <math.h>
 
+#include <type_traits>
+
 #include "paddle/common/ddim.h"
 #include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/kernels/funcs/cpu_sort.h"
 #include "paddle/phi/kernels/funcs/for_range.h"
 
 namespace phi {
@@ -186,7 +189,6 @@ class SearchSortedFunctor {
       seq_size = 1;
     }
 
-    funcs::ForRange<Context> for_range(context_, value_->numel());
     GpuAndCpuSearchSortedCompute<T1, T2, OutType>
         gpu_and_cpu_search_sorted_compute(sequence_data,
                                           value_data,
@@ -195,7 +197,21 @@ class SearchSortedFunctor {
                                           val_size,
                                           seq_size,
                                           out_data_);
-    for_range(gpu_and_cpu_search_sorted_compute);
+    if constexpr (std::is_same<Context, phi::CPUContext>::value) {
+      // The values are searched independently, split across the threads.
+      const int64_t search_cost =
+          static_cast<int64_t>(std::log2(seq_size + 1)) + 1;
+      funcs::SortParallelFor(
+          value_->numel(), search_cost, [&](int64_t begin, int64_t end) {
+            auto compute = gpu_and_cpu_search_sorted_compute;
+            for (int64_t i = begin; i < end; ++i) {
+              compute(i);
+            }
+          });
+    } else {
+      funcs::ForRange<Context> for_range(context_, value_->numel());
+      for_range(gpu_and_cpu_search_sorted_compute);
+    }
   }
 
  private:
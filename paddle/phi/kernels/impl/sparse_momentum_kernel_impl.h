@@ -15,6 +15,7 @@
 #pragma once
 
 #include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -24,6 +25,7 @@
 #include "paddle/phi/core/compat/convert_utils.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/for_range.h"
+#include "paddle/phi/kernels/funcs/radix_sort.h"
 #include "paddle/utils/optional.h"
 
 #ifdef __NVCC__
@@ -376,21 +378,10 @@ void InnerCompute(const Context& dev_ctx,
         dev_ctx.stream())));
 #endif
   } else if (dev_ctx.GetPlace().GetType() == phi::AllocationType::CPU) {
-    std::vector<std::pair<IndexT, IndexT>> vec_tosort;
     auto index_ptr = index->data<IndexT>();
-    for (IndexT i = 0; i < num_index; i++) {
-      vec_tosort.push_back({index_ptr[i], i});
-    }
-    std::sort(vec_tosort.begin(),
-              vec_tosort.end(),
-              [](const std::pair<IndexT, IndexT>& k1,
-                 const std::pair<IndexT, IndexT>& k2) {
-                return k1.first < k2.first;
-              });
-    for (IndexT i = 0; i < num_index; i++) {
-      sorted_index_ptr[i] = vec_tosort[i].first;
-      grad_index_ptr[i] = vec_tosort[i].second;
-    }
+    std::copy(index_ptr, index_ptr + num_index, sorted_index_ptr);
+    std::iota(grad_index_ptr, grad_index_ptr + num_index, IndexT(0));
+    phi::funcs::RadixSortPairs(sorted_index_ptr, grad_index_ptr, num_index);
   } else {
     PADDLE_THROW(common::errors::Unimplemented(
         "sparse_momentum %s is not supported.", dev_ctx.GetPlace()));
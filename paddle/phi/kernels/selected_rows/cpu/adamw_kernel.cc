@@ -22,10 +22,130 @@
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/kernels/adam_kernel.h"
 #include "paddle/phi/kernels/funcs/adam_functors.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
+#include "paddle/phi/kernels/funcs/row_segments.h"
 #include "paddle/phi/kernels/selected_rows/adam_kernel.h"
 
 namespace phi::sr {
 
+// Fuses the weight decay into the adam update of the rows of param, which
+// are visited by funcs::SparseRowUpdate and updated by the jit adamw kernel.
+// In lazy_mode the rows without gradient are only decayed, as the unfused
+// path below decays every row of param before its lazy adam update.
+template <typename T, typename Context>
+void AdamwSparseRowKernel(const Context& dev_ctx,
+                          const DenseTensor& param,
+                          const SelectedRows& grad,
+                          const DenseTensor& learning_rate,
+                          const DenseTensor& moment1,
+                          const DenseTensor& moment2,
+                          const paddle::optional<DenseTensor>& moment2_max,
+                          const DenseTensor& beta1_pow,
+                          const DenseTensor& beta2_pow,
+                          const Scalar& beta1,
+                          const Scalar& beta2,
+                          const Scalar& epsilon,
+                          float lr_ratio,
+                          float coeff,
+                          bool lazy_mode,
+                          bool use_global_beta_pow,
+                          bool amsgrad,
+                          DenseTensor* param_out,
+                          DenseTensor* moment1_out,
+                          DenseTensor* moment2_out,
+                          DenseTensor* moment2_max_out,
+                          DenseTensor* beta1_pow_out,
+                          DenseTensor* beta2_pow_out) {
+  T beta1_ = beta1.to<T>();
+  T beta2_ = beta2.to<T>();
+  T epsilon_ = epsilon.to<T>();
+  T coeff_ = static_cast<T>(coeff);
+  T lr_ratio_ = static_cast<T>(lr_ratio);
+
+  PADDLE_ENFORCE_EQ(
+      beta1_pow_out->numel(),
+      1,
+      errors::InvalidArgument("beta1 pow output size should be 1, but received "
+                              "value is:%d.",
+                              beta1_pow_out->numel()));
+  PADDLE_ENFORCE_EQ(
+      beta2_pow_out->numel(),
+      1,
+      errors::InvalidArgument("beta2 pow output size should be 1, but received "
+                              "value is:%d.",
+                              beta2_pow_out->numel()));
+
+  const auto& grad_rows = grad.rows();
+  auto segments = funcs::GroupRows(
+      grad_rows.data(), static_cast<int64_t>(grad_rows.size()));
+  const T* grad_data = grad.value().template data<T>();
+  const int64_t row_numel =
+      grad.value().numel() / static_cast<int64_t>(grad_rows.size());
+  const int64_t param_rows = param.numel() / row_numel;
+
+  T beta1_p = beta1_pow.data<T>()[0];
+  T beta2_p = beta2_pow.data<T>()[0];
+  if (!use_global_beta_pow) {
+    dev_ctx.template Alloc<T>(beta1_pow_out)[0] = beta1_ * beta1_p;
+    dev_ctx.template Alloc<T>(beta2_pow_out)[0] = beta2_ * beta2_p;
+  }
+
+  T* param_out_ptr = dev_ctx.template Alloc<T>(param_out);
+  T* mom1_out_ptr = dev_ctx.template Alloc<T>(moment1_out);
+  T* mom2_out_ptr = dev_ctx.template Alloc<T>(moment2_out);
+  T* mom2_max_out_ptr =
+      amsgrad ? dev_ctx.template Alloc<T>(moment2_max_out) : nullptr;
+  T old_lr = learning_rate.data<T>()[0];
+  T learning_rate_ =
+      learning_rate.data<T>()[0] * (sqrt(1 - beta2_p) / (1 - beta1_p));
+  T eps = epsilon_ * sqrt(1 - beta2_p);
+  const T decay = old_lr * lr_ratio_ * coeff_;
+
+  const T* param_ptr = param.data<T>();
+  const T* mom1_ptr = moment1.data<T>();
+  const T* mom2_ptr = moment2.data<T>();
+  const T* mom2_max_ptr = amsgrad ? moment2_max.get().data<T>() : nullptr;
+
+  auto adamw =
+      phi::jit::KernelFuncs<phi::jit::AdamWTuple<T>, phi::CPUPlace>::Cache().At(
+          phi::jit::adamw_attr_t(beta1_, beta2_, coeff_, amsgrad));
+  const std::vector<T> zeros(row_numel, static_cast<T>(0));
+  // Every row is visited, since the rows without gradient are decayed too.
+  funcs::SparseRowUpdate<T>(
+      segments,
+      grad_data,
+      row_numel,
+      param_rows,
+      false,
+      [&](int64_t row, const T* grad_row) {
+        const int64_t offset = row * row_numel;
+        if (lazy_mode && grad_row == nullptr) {
+          for (int64_t j = offset; j < offset + row_numel; ++j) {
+            param_out_ptr[j] = param_ptr[j] - decay * param_ptr[j];
+          }
+          return;
+        }
+        adamw(beta1_,
+              beta2_,
+              -learning_rate_,
+              eps,
+              old_lr,
+              lr_ratio_,
+              coeff_,
+              row_numel,
+              grad_row ? grad_row : zeros.data(),
+              mom1_ptr + offset,
+              mom2_ptr + offset,
+              amsgrad ? mom2_max_ptr + offset : nullptr,
+              param_ptr + offset,
+              mom1_out_ptr + offset,
+              mom2_out_ptr + offset,
+              amsgrad ? mom2_max_out_ptr + offset : nullptr,
+              param_out_ptr + offset,
+              amsgrad);
+      });
+}
+
 template <typename T, typename Context>
 void AdamwDenseParamSparseGradKernel(
     const Context& dev_ctx,
@@ -100,6 +220,33 @@ void AdamwDenseParamSparseGradKernel(
     return;
   }
 
+  if (!master_param.is_initialized() && !grad.rows().empty()) {
+    AdamwSparseRowKernel<T, Context>(dev_ctx,
+                                     param,
+                                     grad,
+                                     learning_rate,
+                                     moment1,
+                                     moment2,
+                                     moment2_max,
+                                     beta1_pow,
+                                     beta2_pow,
+                                     beta1,
+                                     beta2,
+                                     epsilon,
+                                     lr_ratio,
+                                     coeff,
+                                     lazy_mode,
+                                     use_global_beta_pow,
+                                     amsgrad,
+                                     param_out,
+                                     moment1_out,
+                                     moment2_out,
+                                     moment2_max_out,
+                                     beta1_pow_out,
+                                     beta2_pow_out);
+    return;
+  }
+
   auto* param_ =
       master_param.is_initialized() ? master_param.get_ptr() : &param;
   T coeff_ = static_cast<T>(coeff);
@@ -14,8 +14,11 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/sparse/coalesce_kernel.h"
 
+#include <numeric>
+
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/visit_type.h"
+#include "paddle/phi/kernels/funcs/radix_sort.h"
 #include "paddle/phi/kernels/funcs/sparse/flatten_indices.h"
 
 namespace phi::sparse {
@@ -46,19 +49,21 @@ void CoalesceCooCPUKernel(const CPUContext& dev_ctx,
   const int64_t stride =
       x.dims().size() == sparse_dim ? 1 : x.values().dims()[1];
 
-  std::map<IntT, std::vector<int64_t>> indices_to_index;
-  for (uint64_t i = 0; i < x_indexs.size(); i++) {
-    IntT index = x_indexs[i];
-    if (indices_to_index.find(index) == indices_to_index.end()) {
-      std::vector<int64_t> indexs;
-      indexs.push_back(static_cast<int>(i));
-      indices_to_index[index] = indexs;
-    } else {
-      indices_to_index[index].push_back(i);
+  // Sort the flattened indices with their positions. The sort is stable, so
+  // the duplicates of an index are summed in their original order.
+  const int64_t nnz = x.nnz();
+  std::vector<int64_t> positions(nnz);
+  std::iota(positions.begin(), positions.end(), 0);
+  phi::funcs::RadixSortPairs(x_indexs.data(), positions.data(), nnz);
+
+  std::vector<int64_t> segment_starts;
+  for (int64_t i = 0; i < nnz; ++i) {
+    if (i == 0 || x_indexs[i] != x_indexs[i - 1]) {
+      segment_starts.push_back(i);
     }
   }
-
-  const int64_t out_nnz = indices_to_index.size();
+  const int64_t out_nnz = static_cast<int64_t>(segment_starts.size());
+  segment_starts.push_back(nnz);
 
   out_indices.Resize({x_indices.dims()[0], out_nnz});
   if (out_values.dims().size() == 1) {
@@ -69,23 +74,27 @@ void CoalesceCooCPUKernel(const CPUContext& dev_ctx,
 
   IntT* out_indices_ptr = out_indices.data<IntT>();
   T* out_values_ptr = out_values.data<T>();
-  auto iter = indices_to_index.begin();
 
   Dim<DDim::kMaxRank> const_dims;
   for (int i = 0; i < x.dims().size(); i++) {
     const_dims[i] = x.dims()[i];
   }
 
-  for (int i = 0; iter != indices_to_index.end(); iter++, i++) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (nnz * stride >= (1 << 15))
+#endif
+  for (int64_t i = 0; i < out_nnz; i++) {
+    const int64_t begin = segment_starts[i], end = segment_starts[i + 1];
     phi::funcs::sparse::IndexToCoordinate(
-        iter->first, const_dims, out_nnz, sparse_dim, i, out_indices_ptr);
-    memcpy(out_values_ptr + i * stride,
-           x_values_ptr + iter->second[0] * stride,
+        x_indexs[begin], const_dims, out_nnz, sparse_dim, i, out_indices_ptr);
+    T* out_row = out_values_ptr + i * stride;
+    memcpy(out_row,
+           x_values_ptr + positions[begin] * stride,
            stride * sizeof(T));
-    for (uint64_t j = 1; j < iter->second.size(); j++) {
-      for (int k = 0; k < stride; k++) {
-        out_values_ptr[i * stride + k] +=
-            x_values_ptr[iter->second[j] * stride + k];
+    for (int64_t j = begin + 1; j < end; j++) {
+      const T* x_row = x_values_ptr + positions[j] * stride;
+      for (int64_t k = 0; k < stride; k++) {
+        out_row[k] += x_row[k];
       }
     }
   }
@@ -14,13 +14,19 @@ limitations under the License. */
 
 #pragma once
 
-#include <set>
+#include <algorithm>
+#include <vector>
+
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
 
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/sparse_coo_tensor.h"
 #include "paddle/phi/core/tensor_meta.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/radix_sort.h"
 #include "paddle/phi/kernels/sparse/conv_kernel.h"
 
 namespace phi {
@@ -28,9 +34,76 @@ namespace sparse {
 
 using Dims4D = phi::funcs::sparse::Dims4D;
 
+// The rulebook and the feature maps are built by one thread below it.
+constexpr int64_t kSparseConvParallelNumel = 1 << 14;
+
+inline int SparseConvNumThreads(int64_t numel) {
+#ifdef PADDLE_WITH_MKLML
+  if (numel >= kSparseConvParallelNumel && !omp_in_parallel()) {
+    return std::max(1, omp_get_max_threads());
+  }
+#endif
+  return 1;
+}
+
+// An open addressing hash set of flattened point indices, which are not
+// negative. Lookups are read-only and can run on many threads.
+template <typename IntT>
+class PointHashSet {
+ public:
+  explicit PointHashSet(int64_t n) {
+    int64_t capacity = 16;
+    while (capacity < 2 * n) {
+      capacity <<= 1;
+      ++bits_;
+    }
+    mask_ = capacity - 1;
+    slots_.assign(capacity, kEmpty);
+  }
+
+  void Insert(IntT key) {
+    for (int64_t slot = Slot(key);; slot = (slot + 1) & mask_) {
+      if (slots_[slot] == key) {
+        return;
+      }
+      if (slots_[slot] == kEmpty) {
+        slots_[slot] = key;
+        return;
+      }
+    }
+  }
+
+  bool Contains(IntT key) const {
+    for (int64_t slot = Slot(key);; slot = (slot + 1) & mask_) {
+      if (slots_[slot] == key) {
+        return true;
+      }
+      if (slots_[slot] == kEmpty) {
+        return false;
+      }
+    }
+  }
+
+ private:
+  static constexpr IntT kEmpty = -1;
+
+  // Fibonacci hashing, which spreads the neighbouring indices of a voxel grid
+  // over the table.
+  int64_t Slot(IntT key) const {
+    return static_cast<int64_t>(
+        (static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL) >> (64 - bits_));
+  }
+
+  std::vector<IntT> slots_;
+  int64_t mask_ = 0;
+  int bits_ = 4;
+};
+
 // such as: kernel(3, 3, 3), kernel_size = 27
 // counter_per_weight: (kernel_size)
-// TODO(zhangkaihuo): optimize performance with multithreading
+// The input points are split into one chunk per thread. Every thread counts
+// and then writes the rules of its chunk for all kernel offsets, at offsets
+// that keep the rules ordered by kernel offset and then by input point.
 template <typename T, typename Context, typename IntT = int>
 void ProductRuleBook(const Context& dev_ctx,
                      const SparseCooTensor& x,
@@ -50,8 +123,6 @@ void ProductRuleBook(const Context& dev_ctx,
                          : kernel_sizes[0] * kernel_sizes[1] * kernel_sizes[2];
   memset(counter_per_kernel, 0, kernel_size * sizeof(int));
 
-  int rulebook_len = 0;
-  // calc the rulebook_len
   const auto& x_dims = x.dims();
 
   int xdim0, xdim1, xdim2, xdim3;
@@ -98,38 +169,61 @@ void ProductRuleBook(const Context& dev_ctx,
   const Dims4D c_strides(sdim0, sdim1, sdim2, sdim3);
   const Dims4D c_dilations(ddim0, ddim1, ddim2, ddim3);
 
-  std::set<IntT> hash_in;
+  auto f_in_point =
+      [&](int64_t i, IntT* batch, IntT* in_x, IntT* in_y, IntT* in_z) {
+        *batch = indices_ptr[i];
+        *in_z = is2D ? 0 : indices_ptr[i + non_zero_num];
+        *in_y = is2D ? indices_ptr[i + non_zero_num]
+                     : indices_ptr[i + 2 * non_zero_num];
+        *in_x = is2D ? indices_ptr[i + 2 * non_zero_num]
+                     : indices_ptr[i + 3 * non_zero_num];
+      };
+
+  PointHashSet<IntT> hash_in(subm ? non_zero_num : 0);
   if (subm) {
-    for (int i = 0; i < non_zero_num; i++) {
-      IntT batch = indices_ptr[i];
-      IntT in_z = is2D ? 0 : indices_ptr[i + non_zero_num];
-      IntT in_y = is2D ? indices_ptr[i + non_zero_num]
-                       : indices_ptr[i + 2 * non_zero_num];
-      IntT in_x = is2D ? indices_ptr[i + 2 * non_zero_num]
-                       : indices_ptr[i + 3 * non_zero_num];
-      IntT index = phi::funcs::sparse::PointToIndex<Dims4D>(
-          batch, in_x, in_y, in_z, c_x_dims);
-      hash_in.insert(index);
+    for (int64_t i = 0; i < non_zero_num; i++) {
+      IntT batch, in_x, in_y, in_z;
+      f_in_point(i, &batch, &in_x, &in_y, &in_z);
+      hash_in.Insert(phi::funcs::sparse::PointToIndex<Dims4D>(
+          batch, in_x, in_y, in_z, c_x_dims));
     }
   }
 
-  auto f_calc_rulebook = [&](IntT* rulebook_ptr) {
-    int kernel_index = 0, rulebook_index = 0;
+  const int num_threads =
+      SparseConvNumThreads(non_zero_num * static_cast<int64_t>(kernel_size));
+  const int64_t chunk = (non_zero_num + num_threads - 1) / num_threads;
+  // offsets[kernel_index * num_threads + thread_id]
+  std::vector<int64_t> offsets(kernel_size * num_threads, 0);
+  int64_t rulebook_len = 0;
+
+  auto f_calc_rulebook = [&](int thread_id, IntT* rulebook_ptr) {
+    const int64_t begin = std::min(non_zero_num, thread_id * chunk);
+    const int64_t end = std::min(non_zero_num, begin + chunk);
+    int kernel_index = 0;
     int zceil = is2D ? 1 : kernel_sizes[0];
     int yceil = is2D ? kernel_sizes[0] : kernel_sizes[1];
     int xceil = is2D ? kernel_sizes[1] : kernel_sizes[2];
     for (int kz = 0; kz < zceil; kz++) {
       for (int ky = 0; ky < yceil; ky++) {
-        for (int kx = 0; kx < xceil; kx++) {
-          ++kernel_index;
-          for (int64_t i = 0; i < non_zero_num; i++) {
-            IntT batch = indices_ptr[i];
-            IntT in_z = is2D ? 0 : indices_ptr[i + non_zero_num];
-            IntT in_y = is2D ? indices_ptr[i + non_zero_num]
-                             : indices_ptr[i + 2 * non_zero_num];
-            IntT in_x = is2D ? indices_ptr[i + 2 * non_zero_num]
-                             : indices_ptr[i + 3 * non_zero_num];
-
+        for (int kx = 0; kx < xceil; kx++, kernel_index++) {
+          // a local copy avoids false sharing between the threads
+          int64_t offset = offsets[kernel_index * num_threads + thread_id];
+          for (int64_t i = begin; i < end; i++) {
+            IntT batch, in_x, in_y, in_z;
+            f_in_point(i, &batch, &in_x, &in_y, &in_z);
+            if (!phi::funcs::sparse::Check(c_x_dims,
+                                           c_kernel_dims,
+                                           c_paddings,
+                                           c_dilations,
+                                           c_strides,
+                                           in_x,
+                                           in_y,
+                                           in_z,
+                                           kx,
+                                           ky,
+                                           kz)) {
+              continue;
+            }
             IntT out_z =
                 is2D ? 0
                      : (in_z + paddings[0] - kz * dilations[0]) / strides[0];
@@ -137,53 +231,59 @@ void ProductRuleBook(const Context& dev_ctx,
                 (in_y + c_paddings[2] - ky * c_dilations[2]) / c_strides[2];
             IntT out_x =
                 (in_x + c_paddings[3] - kx * c_dilations[3]) / c_strides[3];
-            if (phi::funcs::sparse::Check(c_x_dims,
-                                          c_kernel_dims,
-                                          c_paddings,
-                                          c_dilations,
-                                          c_strides,
-                                          in_x,
-                                          in_y,
-                                          in_z,
-                                          kx,
-                                          ky,
-                                          kz)) {
-              if (subm) {
-                IntT out_index = phi::funcs::sparse::PointToIndex<Dims4D>(
-                    batch, out_x, out_y, out_z, c_out_dims);
-                if (hash_in.find(out_index) == hash_in.end()) {
-                  continue;
-                }
-              }
-
-              if (rulebook_ptr == nullptr) {
-                counter_per_kernel[kernel_index - 1] += 1;
-                ++rulebook_len;
-              } else {
-                rulebook_ptr[rulebook_index] = kernel_index - 1;
-                rulebook_ptr[rulebook_index + rulebook_len] = i;  // in_i
-                rulebook_ptr[rulebook_index + rulebook_len * 2] =
-                    phi::funcs::sparse::PointToIndex<Dims4D>(
-                        batch, out_x, out_y, out_z, c_out_dims);  // out_index
-                ++rulebook_index;
-              }
+            IntT out_index = phi::funcs::sparse::PointToIndex<Dims4D>(
+                batch, out_x, out_y, out_z, c_out_dims);
+            if (subm && !hash_in.Contains(out_index)) {
+              continue;
+            }
+
+            if (rulebook_ptr == nullptr) {
+              ++offset;
+            } else {
+              const int64_t rulebook_index = offset++;
+              rulebook_ptr[rulebook_index] = kernel_index;
+              rulebook_ptr[rulebook_index + rulebook_len] = i;  // in_i
+              rulebook_ptr[rulebook_index + rulebook_len * 2] = out_index;
             }
           }
+          offsets[kernel_index * num_threads + thread_id] = offset;
         }
       }
     }
   };
 
-  f_calc_rulebook(nullptr);
+  // calc the rulebook_len
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(num_threads) schedule(static, 1)
+#endif
+  for (int t = 0; t < num_threads; t++) {
+    f_calc_rulebook(t, nullptr);
+  }
+  for (int k = 0; k < kernel_size; k++) {
+    for (int t = 0; t < num_threads; t++) {
+      const int64_t count = offsets[k * num_threads + t];
+      offsets[k * num_threads + t] = rulebook_len;
+      rulebook_len += count;
+      counter_per_kernel[k] += static_cast<int>(count);
+    }
+  }
+
   // alloc the rulebook
   *rulebook = phi::Empty(dev_ctx,
                          DenseTensorMeta(phi::CppTypeToDataType<IntT>::Type(),
                                          {3, rulebook_len},
                                          DataLayout::NCHW));
   IntT* rulebook_ptr = rulebook->data<IntT>();
-  f_calc_rulebook(rulebook_ptr);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(num_threads) schedule(static, 1)
+#endif
+  for (int t = 0; t < num_threads; t++) {
+    f_calc_rulebook(t, rulebook_ptr);
+  }
 }
 
+// Replaces the out_index of every rule by the rank of the output point, and
+// sets the indices of out to the output points in ascending order.
 template <typename T, typename Context, typename IntT = int>
 void UpdateRulebookAndOutIndex(const Context& dev_ctx,
                                const SparseCooTensor& x,
@@ -194,14 +294,14 @@ void UpdateRulebookAndOutIndex(const Context& dev_ctx,
                                SparseCooTensor* out) {
   const bool is2D = out_dims.size() == 4 ? true : false;
 
-  std::set<IntT> out_indexs;
-  int n = rulebook->dims()[1];
+  const int64_t n = rulebook->dims()[1];
   IntT* rulebook_ptr = rulebook->data<IntT>();
-  for (int i = 0; i < n; i++) {
-    out_indexs.insert(rulebook_ptr[i + n * 2]);
-  }
+  std::vector<IntT> out_indexs(rulebook_ptr + n * 2, rulebook_ptr + n * 3);
+  phi::funcs::RadixSort(out_indexs.data(), n);
+  out_indexs.erase(std::unique(out_indexs.begin(), out_indexs.end()),
+                   out_indexs.end());
 
-  int out_non_zero_num = out_indexs.size();
+  const int64_t out_non_zero_num = static_cast<int64_t>(out_indexs.size());
   const int64_t sparse_dim = is2D ? 3 : 4;
   DenseTensorMeta indices_meta(phi::CppTypeToDataType<IntT>::Type(),
                                {sparse_dim, out_non_zero_num},
@@ -211,7 +311,6 @@ void UpdateRulebookAndOutIndex(const Context& dev_ctx,
   phi::DenseTensor out_indices = phi::Empty(dev_ctx, std::move(indices_meta));
   phi::DenseTensor out_values = phi::Empty(dev_ctx, std::move(values_meta));
   IntT* out_indices_ptr = out_indices.data<IntT>();
-  int i = 0;
 
   int odim0, odim1, odim2, odim3;
   odim0 = out_dims[0];
@@ -220,8 +319,12 @@ void UpdateRulebookAndOutIndex(const Context& dev_ctx,
   odim3 = is2D ? 1 : out_dims[1];
   const Dims4D c_out_dims(odim0, odim1, odim2, odim3);
 
-  for (auto it = out_indexs.begin(); it != out_indexs.end(); it++, i++) {
-    const IntT index = *it;
+  const int num_threads = SparseConvNumThreads(n);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(num_threads)
+#endif
+  for (int64_t i = 0; i < out_non_zero_num; i++) {
+    const IntT index = out_indexs[i];
     IntT batch, x, y, z;
     phi::funcs::sparse::IndexToPoint<Dims4D>(
         index, c_out_dims, &batch, &x, &y, &z);
@@ -235,10 +338,14 @@ void UpdateRulebookAndOutIndex(const Context& dev_ctx,
       out_indices_ptr[i + out_non_zero_num * 3] = x;
     }
   }
-  for (i = 0; i < n; i++) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(num_threads)
+#endif
+  for (int64_t i = 0; i < n; i++) {
     IntT out_index = rulebook_ptr[i + n * 2];
     rulebook_ptr[i + n * 2] =
-        std::distance(out_indexs.begin(), out_indexs.find(out_index));
+        std::lower_bound(out_indexs.begin(), out_indexs.end(), out_index) -
+        out_indexs.begin();
   }
 
   out->SetMember(out_indices, out_values, out_dims, true);
@@ -247,6 +354,11 @@ void UpdateRulebookAndOutIndex(const Context& dev_ctx,
 template <typename T, typename IntT = int>
 void Gather(
     const T* x, const IntT* indexs, const int n, const int channels, T* out) {
+  const int num_threads =
+      SparseConvNumThreads(static_cast<int64_t>(n) * channels);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(num_threads)
+#endif
   for (int i = 0; i < n; i++) {
     IntT real_i = indexs[i];
     memcpy(out + i * channels, x + real_i * channels, channels * sizeof(T));
@@ -264,5 +376,45 @@ void Scatter(
   }
 }
 
+// Same as memset(out, 0) followed by Scatter, where indexs are in
+// [0, out_n). The rows of x are grouped by their output row with a counting
+// sort, so every output row is summed by one thread, in the order of Scatter.
+template <typename T, typename IntT = int>
+void ParallelScatter(const T* x,
+                     const IntT* indexs,
+                     const int n,
+                     const int channels,
+                     const int64_t out_n,
+                     T* out) {
+  std::vector<int64_t> row_offsets(out_n + 1, 0);
+  for (int i = 0; i < n; i++) {
+    ++row_offsets[indexs[i] + 1];
+  }
+  for (int64_t r = 0; r < out_n; r++) {
+    row_offsets[r + 1] += row_offsets[r];
+  }
+  std::vector<int> rows(n);
+  std::vector<int64_t> fill(row_offsets.begin(), row_offsets.end() - 1);
+  for (int i = 0; i < n; i++) {
+    rows[fill[indexs[i]]++] = i;
+  }
+
+  const int num_threads =
+      SparseConvNumThreads(static_cast<int64_t>(n) * channels);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(num_threads)
+#endif
+  for (int64_t r = 0; r < out_n; r++) {
+    T* out_row = out + r * channels;
+    memset(out_row, 0, channels * sizeof(T));
+    for (int64_t j = row_offsets[r]; j < row_offsets[r + 1]; j++) {
+      const T* x_row = x + static_cast<int64_t>(rows[j]) * channels;
+      for (int c = 0; c < channels; c++) {
+        out_row[c] += x_row[c];
+      }
+    }
+  }
+}
+
 }  // namespace sparse
 }  // namespace phi
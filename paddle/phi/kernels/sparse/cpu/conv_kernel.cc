@@ -172,9 +172,12 @@ void Conv3dCooCPUKernel(const CPUContext& dev_ctx,
 
   // 4. scatter
   T* out_values_ptr = out->mutable_values()->data<T>();
-  memset(out_values_ptr, 0, sizeof(T) * out->nnz() * out_channels);
-  Scatter<T, IntT>(
-      out_features_ptr, rulebook_ptr + n * 2, n, out_channels, out_values_ptr);
+  ParallelScatter<T, IntT>(out_features_ptr,
+                           rulebook_ptr + n * 2,
+                           n,
+                           out_channels,
+                           out->nnz(),
+                           out_values_ptr);
 }
 
 template <typename T, typename Context>
@@ -16,6 +16,7 @@
 
 #include <any>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -89,6 +90,14 @@ class IR_API Pass {
 
   const detail::PassInfo& pass_info() const { return pass_info_; }
 
+  // Returns a new pass configured as this one, which a worker thread of a
+  // parallel pipeline runs concurrently with the copies of the other threads,
+  // see PassManager::EnableMultiThreading. A pass opts in by overriding it
+  // when it only changes the operation it is applied on. The default returns
+  // null, and a pass holding kParamScopeAttr never runs in parallel. The
+  // copy shares the attributes of this pass.
+  virtual std::unique_ptr<Pass> CloneForThread() const { return nullptr; }
+
   // Get a reference to the attributed previously set.
   template <typename AttrType>
   AttrType& Get(const std::string& attr_name) const {
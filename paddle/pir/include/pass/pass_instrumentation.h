@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <string>
 
 #include "paddle/pir/include/core/type_id.h"
 
@@ -44,6 +46,14 @@ class PassInstrumentation {
   // A callback to run after a pass is executed.
   virtual void RunAfterPass(Pass* pass, Operation* op) {}
 
+  // A callback to run before the pipeline is applied to the operations nested
+  // in op.
+  virtual void RunBeforeNestedPipelines(Operation* op) {}
+
+  // A callback to run after the pipeline has been applied to the operations
+  // nested in op, num_threads is the number of threads used to run them.
+  virtual void RunAfterNestedPipelines(Operation* op, size_t num_threads) {}
+
   // A callback to run before a analysis is executed.
   virtual void RunBeforeAnalysis(const std::string& name,
                                  TypeId id,
@@ -74,10 +84,20 @@ class IR_API PassInstrumentor {
 
   void RunAfterPass(Pass* pass, Operation* op);
 
+  void RunBeforeNestedPipelines(Operation* op);
+
+  void RunAfterNestedPipelines(Operation* op, size_t num_threads);
+
   void RunBeforeAnalysis(const std::string& name, TypeId id, Operation* op);
 
   void RunAfterAnalysis(const std::string& name, TypeId id, Operation* op);
 
+  // Mark a run of nested pipelines on the worker threads, the callbacks are
+  // serialized only while such a run is in progress.
+  void EnterParallelRun();
+
+  void ExitParallelRun();
+
   // TODO(liuyuanle): Add other hooks.
 
  private:
@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "paddle/pir/include/pass/pass.h"
@@ -42,7 +43,10 @@ class IR_API PassManager {
 
   bool empty() const { return passes_.empty(); }
 
-  void clear() { passes_.clear(); }
+  void clear() {
+    passes_.clear();
+    ResetThreadPassManagers();
+  }
 
   IrContext *context() const { return context_; }
 
@@ -50,6 +54,7 @@ class IR_API PassManager {
 
   void AddPass(std::unique_ptr<Pass> pass) {
     passes_.emplace_back(std::move(pass));
+    ResetThreadPassManagers();
   }
 
   class IRPrinterOption {
@@ -115,6 +120,19 @@ class IR_API PassManager {
 
   void AddInstrumentation(std::unique_ptr<PassInstrumentation> pi);
 
+  // Apply the pipeline to independent nested operations in parallel with
+  // num_threads threads. A nested operation is independent if it has regions
+  // and does not use any value defined outside of it. Each thread works on its
+  // own copy of the passes, made by Pass::CloneForThread, so the pipeline runs
+  // sequentially unless every pass opts in.
+  void EnableMultiThreading(size_t num_threads);
+
+  size_t num_threads() const { return num_threads_; }
+
+  // Returns true if every pass can be copied for the worker threads of the
+  // parallel pipeline.
+  bool CanCloneForThread();
+
   void SetValueReplacedHook(const VALUE_REPLACED_HOOK_FUNC &hook) {
     value_replaced_hook_ = hook;
   }
@@ -124,7 +142,20 @@ class IR_API PassManager {
 
   bool Run(Operation *op);
 
- private:
+  // Returns num single-threaded copies of this pass manager for the worker
+  // threads of the parallel pipeline. They are made on the first call and
+  // kept for the later runs, until a pass is added.
+  std::vector<PassManager *> ThreadPassManagers(size_t num);
+
+  // Returns a copy of this pass manager with the clones of the passes, or
+  // null if a pass can not be cloned.
+  std::unique_ptr<PassManager> CloneForThread() const;
+
+  void ResetThreadPassManagers() {
+    thread_pms_.clear();
+    can_clone_for_thread_.reset();
+  }
+
   IrContext *context_;
 
   uint8_t opt_level_;
@@ -133,6 +164,12 @@ class IR_API PassManager {
 
   bool disable_log_{false};
 
+  size_t num_threads_{1};
+
+  // The copies of ThreadPassManagers, and whether the passes can be copied.
+  std::vector<std::unique_ptr<PassManager>> thread_pms_;
+  std::optional<bool> can_clone_for_thread_;
+
   std::vector<std::unique_ptr<Pass>> passes_;
 
   std::unique_ptr<Pass> pass_adaptor_;
@@ -14,6 +14,13 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "paddle/pir/include/core/block_argument.h"
 #include "paddle/pir/include/core/ir_context.h"
 #include "paddle/pir/include/core/operation.h"
 #include "paddle/pir/include/core/program.h"
@@ -105,24 +112,158 @@ void detail::PassAdaptor::Run(Operation* op, uint8_t opt_level, bool verify) {
   RunImpl(op, opt_level, verify);
 }
 
+namespace {
+// Returns true if no operation nested in op uses a value defined outside of
+// op, so that the nested ir of op can be transformed independently.
+bool IsIsolatedFromAbove(Operation* op) {
+  auto IsDefinedInside = [op](Value value) {
+    Operation* def_op = nullptr;
+    if (auto arg = value.dyn_cast<BlockArgument>()) {
+      def_op = arg.owner()->GetParentOp();
+    } else {
+      def_op = value.defining_op();
+    }
+    for (; def_op; def_op = def_op->GetParentOp()) {
+      if (def_op == op) return true;
+    }
+    return false;
+  };
+
+  bool isolated = true;
+  op->Walk([&](Operation* nested_op) {
+    if (!isolated || nested_op == op) return;
+    for (uint32_t i = 0; i < nested_op->num_operands(); ++i) {
+      Value value = nested_op->operand_source(i);
+      if (value && !IsDefinedInside(value)) {
+        isolated = false;
+        return;
+      }
+    }
+  });
+  return isolated;
+}
+}  // namespace
+
 void detail::PassAdaptor::RunImpl(Operation* op,
                                   uint8_t opt_level,
                                   bool verify) {
   auto last_am = analysis_manager();
+  auto* instrumentor = last_am.GetPassInstrumentor();
 
+  std::vector<Operation*> nested_ops;
   for (size_t i = 0; i < op->num_regions(); ++i) {
     auto& region = op->region(i);
     for (auto& block : region) {
       for (auto& op : block) {
-        AnalysisManagerHolder am(&op, last_am.GetPassInstrumentor());
-        if (!RunPipeline(*pm_, &op, am, opt_level, verify))
-          return SignalPassFailure();
+        nested_ops.push_back(&op);
       }
     }
   }
+
+  if (instrumentor) instrumentor->RunBeforeNestedPipelines(op);
+
+  bool parallel = CanRunInParallel(nested_ops);
+  bool success = parallel
+                     ? RunParallel(nested_ops, last_am, opt_level, verify)
+                     : RunSequential(nested_ops, last_am, opt_level, verify);
+  size_t num_threads = parallel ? pm_->num_threads() : 1;
+
+  if (instrumentor) instrumentor->RunAfterNestedPipelines(op, num_threads);
+
+  if (!success) return SignalPassFailure();
   return;
 }
 
+bool detail::PassAdaptor::RunSequential(const std::vector<Operation*>& ops,
+                                        AnalysisManager last_am,
+                                        uint8_t opt_level,
+                                        bool verify) {
+  for (auto* op : ops) {
+    AnalysisManagerHolder am(op, last_am.GetPassInstrumentor());
+    if (!RunPipeline(*pm_, op, am, opt_level, verify)) return false;
+  }
+  return true;
+}
+
+bool detail::PassAdaptor::CanRunInParallel(
+    const std::vector<Operation*>& ops) const {
+  if (pm_->num_threads() <= 1 || !pm_->CanCloneForThread()) return false;
+  size_t num_container_ops = 0;
+  for (auto* op : ops) {
+    if (op->num_regions() == 0) {
+      // Passes applied on a leaf op may touch the use-def chains shared with
+      // its siblings.
+      for (auto& pass : pm_->passes()) {
+        if (pass->CanApplyOn(op)) return false;
+      }
+      continue;
+    }
+    if (!IsIsolatedFromAbove(op)) return false;
+    ++num_container_ops;
+  }
+  return num_container_ops > 1;
+}
+
+bool detail::PassAdaptor::RunParallel(const std::vector<Operation*>& ops,
+                                      AnalysisManager last_am,
+                                      uint8_t opt_level,
+                                      bool verify) {
+  std::vector<Operation*> container_ops;
+  for (auto* op : ops) {
+    if (op->num_regions() > 0) {
+      container_ops.push_back(op);
+    } else {
+      // Leaf ops are not transformed by any pass, only run the pipeline for
+      // verification on the current thread.
+      AnalysisManagerHolder am(op, last_am.GetPassInstrumentor());
+      if (!RunPipeline(*pm_, op, am, opt_level, verify)) return false;
+    }
+  }
+
+  size_t num_workers = std::min(pm_->num_threads(), container_ops.size());
+  VLOG(4) << "Run pass pipeline on " << container_ops.size()
+          << " isolated ops with " << num_workers << " threads.";
+
+  std::atomic<size_t> next_op{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr exception = nullptr;
+  std::mutex exception_mutex;
+
+  auto Worker = [&](PassManager* pm) {
+    try {
+      for (size_t i = next_op.fetch_add(1);
+           i < container_ops.size() && !failed.load();
+           i = next_op.fetch_add(1)) {
+        AnalysisManagerHolder am(container_ops[i],
+                                 last_am.GetPassInstrumentor());
+        if (!RunPipeline(*pm, container_ops[i], am, opt_level, verify)) {
+          failed = true;
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(exception_mutex);
+      if (!exception) exception = std::current_exception();
+      failed = true;
+    }
+  };
+
+  std::vector<PassManager*> pms = pm_->ThreadPassManagers(num_workers);
+  auto* instrumentor = last_am.GetPassInstrumentor();
+  if (instrumentor) instrumentor->EnterParallelRun();
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < num_workers; ++i) {
+    workers.emplace_back(Worker, pms[i]);
+  }
+  Worker(pms[0]);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  if (instrumentor) instrumentor->ExitParallelRun();
+
+  if (exception) std::rethrow_exception(exception);
+  return !failed;
+}
+
 bool detail::PassAdaptor::RunPipeline(const PassManager& pm,
                                       Operation* op,
                                       AnalysisManager am,
@@ -203,6 +344,62 @@ bool PassManager::Run(Operation* op) {
   return detail::PassAdaptor::RunPipeline(*this, op, am, opt_level_, verify_);
 }
 
+bool PassManager::CanCloneForThread() {
+  if (!can_clone_for_thread_.has_value()) {
+    // The first copy is kept for the first worker thread.
+    auto pm = CloneForThread();
+    can_clone_for_thread_ = pm != nullptr;
+    if (pm) thread_pms_.push_back(std::move(pm));
+  }
+  return *can_clone_for_thread_;
+}
+
+std::vector<PassManager*> PassManager::ThreadPassManagers(size_t num) {
+  PADDLE_ENFORCE_EQ(
+      CanCloneForThread(),
+      true,
+      common::errors::PreconditionNotMet(
+          "The passes can not be cloned for the worker threads."));
+  while (thread_pms_.size() < num) {
+    thread_pms_.push_back(CloneForThread());
+  }
+  std::vector<PassManager*> pms;
+  for (size_t i = 0; i < num; ++i) {
+    pms.push_back(thread_pms_[i].get());
+  }
+  return pms;
+}
+
+std::unique_ptr<PassManager> PassManager::CloneForThread() const {
+  auto pm = std::make_unique<PassManager>(context_, opt_level_);
+  pm->verify_ = verify_;
+  pm->disable_log_ = disable_log_;
+  pm->value_replaced_hook_ = value_replaced_hook_;
+  for (auto& pass : passes()) {
+    // The passes writing the parameters are not run concurrently.
+    if (pass->Has(Pass::kParamScopeAttr)) return nullptr;
+    auto new_pass = pass->CloneForThread();
+    if (!new_pass) return nullptr;
+    // Share the attributes with the origin pass, the copy doesn't take
+    // ownership of them.
+    for (auto& attr : pass->attrs_) {
+      if (attr.first == Pass::kValueReplaceHookAttr) continue;
+      new_pass->attrs_[attr.first] = attr.second;
+    }
+    pm->AddPass(std::move(new_pass));
+  }
+  PADDLE_ENFORCE_EQ(
+      pm->Initialize(context_),
+      true,
+      common::errors::PreconditionNotMet(
+          "Failed to initialize the pass manager for a worker thread."));
+  return pm;
+}
+
+void PassManager::EnableMultiThreading(size_t num_threads) {
+  num_threads_ = std::max<size_t>(num_threads, 1);
+}
+
 bool PassManager::Initialize(IrContext* context) {
   for (auto& pass : passes()) {
     if (!pass->Initialize(context)) return false;
@@ -226,8 +423,16 @@ void PassManager::AddInstrumentation(std::unique_ptr<PassInstrumentation> pi) {
 //----------------------------------------------------------------------------------------------//
 namespace detail {
 struct PassInstrumentorImpl {
-  // TODO(wilber): Support multi-thread.
+  // Guards the instrumentations while the callbacks may be invoked from the
+  // worker threads of a parallel pipeline.
+  std::mutex mutex;
+  std::atomic<int> num_parallel_runs{0};
   std::vector<std::unique_ptr<PassInstrumentation>> instrumentations;
+
+  std::unique_lock<std::mutex> LockIfParallel() {
+    return num_parallel_runs.load() > 0 ? std::unique_lock<std::mutex>(mutex)
+                                        : std::unique_lock<std::mutex>();
+  }
 };
 }  // namespace detail
 
@@ -238,6 +443,7 @@ PassInstrumentor::~PassInstrumentor() = default;
 
 void PassInstrumentor::RunBeforePipeline(Operation* op) {
   if (op->num_regions() == 0) return;
+  auto guard = impl_->LockIfParallel();
   for (auto& instr : impl_->instrumentations) {
     instr->RunBeforePipeline(op);
   }
@@ -245,6 +451,7 @@ void PassInstrumentor::RunBeforePipeline(Operation* op) {
 
 void PassInstrumentor::RunAfterPipeline(Operation* op) {
   if (op->num_regions() == 0) return;
+  auto guard = impl_->LockIfParallel();
   for (auto it = impl_->instrumentations.rbegin();
        it != impl_->instrumentations.rend();
        ++it) {
@@ -254,6 +461,7 @@ void PassInstrumentor::RunAfterPipeline(Operation* op) {
 
 void PassInstrumentor::RunBeforePass(Pass* pass, Operation* op) {
   if (op->num_regions() == 0) return;
+  auto guard = impl_->LockIfParallel();
   for (auto& instr : impl_->instrumentations) {
     instr->RunBeforePass(pass, op);
   }
@@ -261,6 +469,7 @@ void PassInstrumentor::RunBeforePass(Pass* pass, Operation* op) {
 
 void PassInstrumentor::RunAfterPass(Pass* pass, Operation* op) {
   if (op->num_regions() == 0) return;
+  auto guard = impl_->LockIfParallel();
   for (auto it = impl_->instrumentations.rbegin();
        it != impl_->instrumentations.rend();
        ++it) {
@@ -268,10 +477,30 @@ void PassInstrumentor::RunAfterPass(Pass* pass, Operation* op) {
   }
 }
 
+void PassInstrumentor::RunBeforeNestedPipelines(Operation* op) {
+  if (op->num_regions() == 0) return;
+  auto guard = impl_->LockIfParallel();
+  for (auto& instr : impl_->instrumentations) {
+    instr->RunBeforeNestedPipelines(op);
+  }
+}
+
+void PassInstrumentor::RunAfterNestedPipelines(Operation* op,
+                                               size_t num_threads) {
+  if (op->num_regions() == 0) return;
+  auto guard = impl_->LockIfParallel();
+  for (auto it = impl_->instrumentations.rbegin();
+       it != impl_->instrumentations.rend();
+       ++it) {
+    (*it)->RunAfterNestedPipelines(op, num_threads);
+  }
+}
+
 void PassInstrumentor::RunBeforeAnalysis(const std::string& name,
                                          TypeId id,
                                          Operation* op) {
   if (op->num_regions() == 0) return;
+  auto guard = impl_->LockIfParallel();
   for (auto& instr : impl_->instrumentations) {
     instr->RunBeforeAnalysis(name, id, op);
   }
@@ -281,6 +510,7 @@ void PassInstrumentor::RunAfterAnalysis(const std::string& name,
                                         TypeId id,
                                         Operation* op) {
   if (op->num_regions() == 0) return;
+  auto guard = impl_->LockIfParallel();
   for (auto it = impl_->instrumentations.rbegin();
        it != impl_->instrumentations.rend();
        ++it) {
@@ -288,8 +518,13 @@ void PassInstrumentor::RunAfterAnalysis(const std::string& name,
   }
 }
 
+void PassInstrumentor::EnterParallelRun() { ++impl_->num_parallel_runs; }
+
+void PassInstrumentor::ExitParallelRun() { --impl_->num_parallel_runs; }
+
 void PassInstrumentor::AddInstrumentation(
     std::unique_ptr<PassInstrumentation> pi) {
+  std::lock_guard<std::mutex> guard(impl_->mutex);
   impl_->instrumentations.emplace_back(std::move(pi));
 }
 
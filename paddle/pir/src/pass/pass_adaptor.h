@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "paddle/pir/include/pass/pass.h"
 
 namespace pir {
@@ -34,6 +36,19 @@ class PassAdaptor final : public Pass {
  private:
   void RunImpl(Operation* op, uint8_t opt_level, bool verify);
 
+  bool RunSequential(const std::vector<Operation*>& ops,
+                     AnalysisManager last_am,
+                     uint8_t opt_level,
+                     bool verify);
+
+  // Returns true if the pipeline can be applied to ops concurrently.
+  bool CanRunInParallel(const std::vector<Operation*>& ops) const;
+
+  bool RunParallel(const std::vector<Operation*>& ops,
+                   AnalysisManager last_am,
+                   uint8_t opt_level,
+                   bool verify);
+
   static bool RunPass(Pass* pass,
                       Operation* op,
                       AnalysisManager am,
@@ -81,6 +81,19 @@ class PassTimer : public PassInstrumentation {
     pass_timers_[op][pass->name()].Stop();
   }
 
+  void RunBeforeNestedPipelines(Operation* op) override {
+    nested_timers_[op] = Timer();
+    nested_timers_[op].Start();
+  }
+
+  void RunAfterNestedPipelines(Operation* op, size_t num_threads) override {
+    nested_timers_[op].Stop();
+    if (num_threads <= 1) return;
+    std::ostringstream oss;
+    PrintNestedTime(op, num_threads, oss);
+    std::cout << oss.str() << std::endl;
+  }
+
  private:
   void PrintTime(Operation* op, std::ostream& os) {
     if (print_module_ && op->name() != "builtin.module") return;
@@ -113,11 +126,47 @@ class PassTimer : public PassInstrumentation {
     }
   }
 
+  // Compare the wall time of the nested pipelines run in parallel with the
+  // accumulated time that they would take sequentially.
+  void PrintNestedTime(Operation* op, size_t num_threads, std::ostream& os) {
+    if (print_module_ && op->name() != "builtin.module") return;
+
+    double accumulated_time = 0.0;
+    for (size_t i = 0; i < op->num_regions(); ++i) {
+      for (auto& block : op->region(i)) {
+        for (auto& nested_op : block) {
+          if (pipeline_timers_.count(&nested_op)) {
+            accumulated_time +=
+                pipeline_timers_[&nested_op].GetTimePerSecond();
+          }
+          if (nested_timers_.count(&nested_op)) {
+            accumulated_time += nested_timers_[&nested_op].GetTimePerSecond();
+          }
+        }
+      }
+    }
+    double wall_time = nested_timers_[op].GetTimePerSecond();
+
+    std::string header = "Parallel PassTiming on nested ops of " + op->name();
+    detail::PrintHeader(header, os);
+    os << "  Threads: " << num_threads << "\n";
+    os << "  Wall Time: " << std::fixed << std::setprecision(3) << wall_time
+       << " seconds\n";
+    os << "  Accumulated Pipeline Time: " << std::fixed << std::setprecision(3)
+       << accumulated_time << " seconds\n";
+    if (wall_time > 0) {
+      os << "  Speedup: " << std::fixed << std::setprecision(2)
+         << accumulated_time / wall_time << "x\n";
+    }
+  }
+
  private:
   bool print_module_;
 
   std::unordered_map<Operation*, Timer> pipeline_timers_;
 
+  std::unordered_map<Operation*, Timer> nested_timers_;
+
   std::unordered_map<Operation*,
                      std::unordered_map<std::string /*pass name*/, Timer>>
       pass_timers_;
@@ -214,3 +214,6 @@ atexit.register(core.pir.clear_cinn_compilation_cache)
 atexit.register(core.clear_device_manager)
 atexit.register(core.clear_kernel_factory)
 atexit.register(core.ProcessGroupIdMap.destroy)
+# Flush the final histograms of the sampling profiler before the static
+# objects it uses are destroyed.
+atexit.register(core.shutdown_op_sampling_profiler)
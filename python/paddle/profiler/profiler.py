@@ -73,6 +73,8 @@ class SummaryView(Enum):
     - **SummaryView.MemoryManipulationView** : The memory manipulation summary view.
 
     - **SummaryView.UDFView** : The user defined summary view.
+
+    - **SummaryView.HardwareCounterView** : The hardware counter summary view.
     """
 
     DeviceView = 0
@@ -84,6 +86,7 @@ class SummaryView(Enum):
     MemoryView = 6
     MemoryManipulationView = 7
     UDFView = 8
+    HardwareCounterView = 9
 
 
 class ProfilerState(Enum):
@@ -372,6 +375,8 @@ class Profiler:
         profile_memory (bool, optional): If it is True, collect tensor memory allocation and release information. Default: False.
         custom_device_types (list, optional): If targets contain profiler.ProfilerTarget.CUSTOM_DEVICE, custom_device_types select the custom device type for profiling. The default value represents all custom devices will be selected.
         with_flops (bool, optional): If it is True, the flops of the op will be calculated. Default: False.
+        with_hw_counters (bool, optional): If it is True, hardware performance counters (cycles, instructions, LLC misses and branch misses) of each op
+            on CPU are collected with perf_event_open. Only supported on Linux. Default: False.
 
     Examples:
         1. profiling range [2, 5).
@@ -498,6 +503,7 @@ class Profiler:
     record_shapes: bool
     profile_memory: bool
     with_flops: bool
+    with_hw_counters: bool
     emit_nvtx: bool
 
     def __init__(
@@ -514,6 +520,7 @@ class Profiler:
         emit_nvtx: bool = False,
         custom_device_types: list[str] = [],
         with_flops: bool = False,
+        with_hw_counters: bool = False,
     ) -> None:
         supported_targets = _get_supported_targets()
         if targets:
@@ -537,6 +544,8 @@ class Profiler:
             profileoption.trace_switch |= 1 << 3
             if not custom_device_types:
                 custom_device_types = paddle.device.get_all_custom_device_type()
+        if with_hw_counters:
+            profileoption.enable_hw_counters = True
         wrap_optimizers()
         self.profiler = _Profiler.create(profileoption, custom_device_types)
         if callable(scheduler):
@@ -575,6 +584,7 @@ class Profiler:
         self.record_shapes = record_shapes
         self.profile_memory = profile_memory
         self.with_flops = with_flops
+        self.with_hw_counters = with_hw_counters
         self.emit_nvtx = emit_nvtx
 
     def __enter__(self) -> Self:
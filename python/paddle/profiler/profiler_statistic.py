@@ -521,6 +521,11 @@ class EventSummary:
             self.min_general_gpu_time = float('inf')
             self.max_general_gpu_time = 0
             self._flops = 0
+            self.hw_counter_call = 0
+            self.cycles = 0
+            self.instructions = 0
+            self.llc_misses = 0
+            self.branch_misses = 0
 
         @property
         def flops(self):
@@ -565,6 +570,21 @@ class EventSummary:
         def add_flops(self, flops):
             self._flops += flops
 
+        def add_hw_counters(self, node):
+            if not getattr(node, 'has_hw_counters', False):
+                return
+            self.hw_counter_call += 1
+            self.cycles += node.cycles
+            self.instructions += node.instructions
+            self.llc_misses += node.llc_misses
+            self.branch_misses += node.branch_misses
+
+        @property
+        def ipc(self):
+            if self.cycles == 0:
+                return 0
+            return self.instructions / self.cycles
+
         def add_item(self, node):
             raise NotImplementedError
 
@@ -580,6 +600,7 @@ class EventSummary:
             self.add_gpu_time(node.gpu_time)
             self.add_general_gpu_time(node.general_gpu_time)
             self.add_flops(node.flops)
+            self.add_hw_counters(node)
             for child in node.children_node:
                 if child.type != TracerEventType.Operator:
                     if child.name not in self.operator_inners:
@@ -2011,4 +2032,75 @@ def _build_table(
                 append('')
                 append('')
 
+    if views is None or SummaryView.HardwareCounterView in views:
+        # ----- Print Hardware Counter Summary Report ----- #
+        hw_counter_items = [
+            item
+            for item in statistic_data.event_summary.items.values()
+            if item.hw_counter_call > 0
+        ]
+        if hw_counter_items:
+            hw_counter_items.sort(key=lambda x: x.cycles, reverse=True)
+            all_row_values = []
+            for item in hw_counter_items:
+                # misses per kilo instructions
+                kilo_instructions = max(item.instructions / 1000, 1)
+                all_row_values.append(
+                    [
+                        item.name,
+                        item.hw_counter_call,
+                        _format_large_number(item.cycles),
+                        _format_large_number(item.instructions),
+                        f'{item.ipc:.2f}',
+                        _format_large_number(item.llc_misses),
+                        f'{item.llc_misses / kilo_instructions:.2f}',
+                        _format_large_number(item.branch_misses),
+                        f'{item.branch_misses / kilo_instructions:.2f}',
+                    ]
+                )
+
+            # Calculate the column width
+            headers = [
+                'Name',
+                'Calls',
+                'Cycles',
+                'Instructions',
+                'IPC',
+                'LLC Misses',
+                'LLC MPKI',
+                'Branch Misses',
+                'Branch MPKI',
+            ]
+            row_format_list = [""]
+            header_sep_list = [""]
+            line_length_list = [-SPACING_SIZE]
+            name_column_width = 30
+            for row_values in all_row_values:
+                if len(row_values[0]) > name_column_width:
+                    name_column_width = len(row_values[0])
+            number_column_width = 13
+            add_column(name_column_width)
+            for _ in range(len(headers) - 1):
+                add_column(number_column_width)
+
+            row_format = row_format_list[0]
+            header_sep = header_sep_list[0]
+            line_length = line_length_list[0]
+
+            # construct table string
+            append(add_title(line_length, "Hardware Counter Summary"))
+            append(header_sep)
+            append(row_format.format(*headers))
+            append(header_sep)
+            for row_values in all_row_values:
+                append(row_format.format(*row_values))
+            append(header_sep)
+            append(
+                "Note:\nIPC: instructions per cycle, a low IPC together with a high LLC MPKI usually means the op is memory bound.\n"
+                "MPKI: misses per kilo instructions.\n"
+            )
+            append('-' * line_length)
+            append('')
+            append('')
+
     return ''.join(result)
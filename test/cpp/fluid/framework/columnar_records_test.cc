@@ -0,0 +1,293 @@
+//   Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/columnar_records.h"
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/archive.h"
+#include "test/cpp/phi/core/timer.h"
+
+namespace paddle {
+namespace framework {
+
+static std::vector<Record> RandomRecords(int num_records, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<Record> records(num_records);
+  for (auto& record : records) {
+    int num_uint64 = static_cast<int>(rng() % 120);
+    for (int i = 0; i < num_uint64; ++i) {
+      FeatureFeasign sign;
+      sign.uint64_feasign_ = rng();
+      record.uint64_feasigns_.emplace_back(sign, i % 40);
+    }
+    for (int i = 0; i < 3; ++i) {
+      FeatureFeasign sign;
+      sign.float_feasign_ = static_cast<float>(rng() % 1000) / 7.0f;
+      record.float_feasigns_.emplace_back(sign, 40 + i);
+    }
+    record.ins_id_ = "ins_" + std::to_string(rng() % 100000000);
+  }
+  return records;
+}
+
+static size_t PartOf(const Record& record, int num_parts) {
+  return std::hash<std::string>()(record.ins_id_) % num_parts;
+}
+
+static void ExpectSameRecord(const Record& a, const Record& b) {
+  ASSERT_EQ(a.ins_id_, b.ins_id_);
+  ASSERT_EQ(a.uint64_feasigns_.size(), b.uint64_feasigns_.size());
+  ASSERT_EQ(a.float_feasigns_.size(), b.float_feasigns_.size());
+  for (size_t i = 0; i < a.uint64_feasigns_.size(); ++i) {
+    ASSERT_EQ(a.uint64_feasigns_[i].sign().uint64_feasign_,
+              b.uint64_feasigns_[i].sign().uint64_feasign_);
+    ASSERT_EQ(a.uint64_feasigns_[i].slot(), b.uint64_feasigns_[i].slot());
+  }
+  for (size_t i = 0; i < a.float_feasigns_.size(); ++i) {
+    ASSERT_EQ(a.float_feasigns_[i].sign().float_feasign_,
+              b.float_feasigns_[i].sign().float_feasign_);
+    ASSERT_EQ(a.float_feasigns_[i].slot(), b.float_feasigns_[i].slot());
+  }
+}
+
+TEST(ColumnarRecords, pack_unpack) {
+  const int num_parts = 7;
+  auto records = RandomRecords(5000, 2025);
+  records[3].uint64_feasigns_.clear();
+  records[4].ins_id_.clear();
+  std::vector<std::string> batches;
+  PackColumnarRecords(
+      records,
+      num_parts,
+      [](const Record& record) { return PartOf(record, num_parts); },
+      &batches);
+  ASSERT_EQ(batches.size(), static_cast<size_t>(num_parts));
+
+  size_t total = 0;
+  for (int p = 0; p < num_parts; ++p) {
+    std::vector<Record> expected;
+    for (const auto& record : records) {
+      if (PartOf(record, num_parts) == static_cast<size_t>(p)) {
+        expected.push_back(record);
+      }
+    }
+    std::vector<Record> unpacked;
+    if (!batches[p].empty()) {
+      UnpackColumnarRecords(batches[p].data(), batches[p].size(), &unpacked);
+    }
+    ASSERT_EQ(unpacked.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      ExpectSameRecord(unpacked[i], expected[i]);
+    }
+    total += unpacked.size();
+  }
+  EXPECT_EQ(total, records.size());
+
+  // Every destination without records gets an empty batch.
+  PackColumnarRecords(
+      records, 3, [](const Record&) { return 1; }, &batches);
+  EXPECT_TRUE(batches[0].empty());
+  EXPECT_TRUE(batches[2].empty());
+
+  std::string truncated = batches[1].substr(0, batches[1].size() - 1);
+  std::vector<Record> unpacked;
+  EXPECT_ANY_THROW(
+      UnpackColumnarRecords(truncated.data(), truncated.size(), &unpacked));
+}
+
+// Writes a message prefixed with its length, an empty one ends the stream.
+static void WriteMessage(int fd, const std::string& msg) {
+  uint64_t length = msg.size();
+  std::string buffer(reinterpret_cast<const char*>(&length), sizeof(length));
+  buffer += msg;
+  size_t written = 0;
+  while (written < buffer.size()) {
+    ssize_t n = write(fd, buffer.data() + written, buffer.size() - written);
+    PADDLE_ENFORCE_GT(
+        n, 0, common::errors::Unavailable("Failed to write to the peer."));
+    written += n;
+  }
+}
+
+static bool ReadMessage(int fd, std::string* msg) {
+  uint64_t length = 0;
+  char* header = reinterpret_cast<char*>(&length);
+  size_t done = 0;
+  while (done < sizeof(length)) {
+    ssize_t n = read(fd, header + done, sizeof(length) - done);
+    PADDLE_ENFORCE_GT(
+        n, 0, common::errors::Unavailable("Failed to read from the peer."));
+    done += n;
+  }
+  msg->resize(length);
+  done = 0;
+  while (done < length) {
+    ssize_t n = read(fd, &(*msg)[done], length - done);
+    PADDLE_ENFORCE_GT(
+        n, 0, common::errors::Unavailable("Failed to read from the peer."));
+    done += n;
+  }
+  return length > 0;
+}
+
+// One trainer of the localhost shuffle: shuffles its num_records records to
+// all the trainers through sockets[trainer][peer], in batches of batch_size
+// records per trainer, and returns the records it received.
+static size_t ShuffleOverSockets(int trainer,
+                                 int num_trainers,
+                                 int num_records,
+                                 bool columnar,
+                                 int batch_size,
+                                 const std::vector<std::vector<int>>& sockets) {
+  auto records = RandomRecords(num_records, trainer);
+  auto part_of = [num_trainers](const Record& record) {
+    return PartOf(record, num_trainers);
+  };
+  std::vector<size_t> received(num_trainers, 0);
+  std::vector<std::thread> receivers;
+  for (int peer = 0; peer < num_trainers; ++peer) {
+    if (peer == trainer) {
+      continue;
+    }
+    receivers.emplace_back([&, peer]() {
+      std::string msg;
+      while (ReadMessage(sockets[trainer][peer], &msg)) {
+        std::vector<Record> data;
+        if (columnar) {
+          UnpackColumnarRecords(msg.data(), msg.size(), &data);
+        } else {
+          BinaryArchive ar;
+          ar.SetReadBuffer(&msg[0], msg.size(), nullptr);
+          while (ar.Cursor() < ar.Finish()) {
+            data.push_back(ar.Get<Record>());
+          }
+        }
+        received[peer] += data.size();
+      }
+    });
+  }
+
+  const size_t block = static_cast<size_t>(batch_size) * num_trainers;
+  for (size_t begin = 0; begin < records.size(); begin += block) {
+    std::vector<Record> data(
+        records.begin() + begin,
+        records.begin() + std::min(records.size(), begin + block));
+    std::vector<std::string> batches(num_trainers);
+    if (columnar) {
+      PackColumnarRecords(data, num_trainers, part_of, &batches);
+    } else {
+      std::vector<BinaryArchive> ars(num_trainers);
+      for (const auto& record : data) {
+        ars[part_of(record)] << record;
+      }
+      for (int p = 0; p < num_trainers; ++p) {
+        batches[p].assign(ars[p].Buffer(), ars[p].Length());
+      }
+    }
+    for (int p = 0; p < num_trainers; ++p) {
+      if (p == trainer) {
+        received[p] += std::count_if(
+            data.begin(), data.end(), [&](const Record& record) {
+              return part_of(record) == static_cast<size_t>(p);
+            });
+      } else if (!batches[p].empty()) {
+        WriteMessage(sockets[trainer][p], batches[p]);
+      }
+    }
+  }
+  for (int p = 0; p < num_trainers; ++p) {
+    if (p != trainer) {
+      WriteMessage(sockets[trainer][p], "");
+    }
+  }
+  for (auto& receiver : receivers) {
+    receiver.join();
+  }
+  size_t total = 0;
+  for (size_t n : received) {
+    total += n;
+  }
+  return total;
+}
+
+// Shuffles num_records records from each of 4 trainer processes over local
+// sockets, with BinaryArchives and with columnar batches.
+static void LocalhostShuffle(int num_records) {
+  const int num_trainers = 4;
+  for (bool columnar : {false, true}) {
+    // sockets[a][b] is the end trainer a uses to talk to trainer b.
+    std::vector<std::vector<int>> sockets(num_trainers,
+                                          std::vector<int>(num_trainers, -1));
+    for (int a = 0; a < num_trainers; ++a) {
+      for (int b = a + 1; b < num_trainers; ++b) {
+        int fds[2];
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        sockets[a][b] = fds[0];
+        sockets[b][a] = fds[1];
+      }
+    }
+    auto t0 = phi::tests::GetCurrentUS();
+    std::vector<pid_t> children;
+    for (int trainer = 0; trainer < num_trainers; ++trainer) {
+      pid_t pid = fork();
+      ASSERT_GE(pid, 0);
+      if (pid == 0) {
+        size_t received = ShuffleOverSockets(
+            trainer, num_trainers, num_records, columnar, 1024, sockets);
+        // Every trainer gets about a quarter of all the records.
+        const size_t expected = num_records;
+        _exit(received > expected * 3 / 4 && received < expected * 5 / 4 ? 0
+                                                                         : 1);
+      }
+      children.push_back(pid);
+    }
+    for (pid_t pid : children) {
+      int status = 0;
+      ASSERT_EQ(waitpid(pid, &status, 0), pid);
+      EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    auto t1 = phi::tests::GetCurrentUS();
+    for (auto& row : sockets) {
+      for (int fd : row) {
+        if (fd >= 0) {
+          close(fd);
+        }
+      }
+    }
+    VLOG(3) << "global shuffle of " << num_trainers << " trainers on localhost"
+            << (columnar ? " with columnar batches" : " with BinaryArchives")
+            << " takes " << t1 - t0 << " us.";
+  }
+}
+
+TEST(ColumnarRecords, localhost_shuffle) { LocalhostShuffle(2000); }
+
+// Times the shuffle on more records, run it with
+// --gtest_also_run_disabled_tests.
+TEST(ColumnarRecords, DISABLED_localhost_shuffle_benchmark) {
+  LocalhostShuffle(20000);
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -15,8 +15,14 @@
 #include <gtest/gtest.h>
 
 #include <fstream>
+#include <string>
+#include <vector>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/io/fs.h"
+#include "test/cpp/phi/core/timer.h"
+
+COMMON_DECLARE_bool(localfs_native_read);
 
 #if defined _WIN32 || defined __APPLE__
 #else
@@ -60,3 +66,94 @@ TEST(FS, mv) {
 
 #endif
 }
+
+#ifdef _LINUX
+static std::vector<std::string> ReadLines(const std::string& path,
+                                          const std::string& converter,
+                                          bool native_read) {
+  bool old = FLAGS_localfs_native_read;
+  FLAGS_localfs_native_read = native_read;
+  std::vector<std::string> lines;
+  {
+    int err_no = 0;
+    std::shared_ptr<FILE> fp =
+        paddle::framework::fs_open_read(path, &err_no, converter, true);
+    paddle::string::LineFileReader reader;
+    while (reader.getline(&*fp)) {
+      lines.emplace_back(reader.get());
+    }
+  }
+  FLAGS_localfs_native_read = old;
+  return lines;
+}
+
+static void WriteTestFiles(const std::string& prefix, int num_lines) {
+  std::ofstream out(prefix + ".txt");
+  for (int i = 0; i < num_lines; ++i) {
+    out << i << " " << i * 7919 % 1000003 << " slot_" << i % 13 << "\n";
+  }
+  out.close();
+  // Two gzip members, which zcat and the native reader read one after the
+  // other.
+  paddle::framework::shell_execute(paddle::string::format_string(
+      "head -n %d %s.txt | gzip -c > %s.gz && tail -n +%d %s.txt | gzip -c >> "
+      "%s.gz",
+      num_lines / 3,
+      prefix.c_str(),
+      prefix.c_str(),
+      num_lines / 3 + 1,
+      prefix.c_str(),
+      prefix.c_str()));
+}
+#endif
+
+TEST(FS, native_read) {
+#ifdef _LINUX
+  WriteTestFiles("native_read", 300000);
+  auto expected = ReadLines("native_read.txt", "cat", false);
+  ASSERT_EQ(expected.size(), 300000UL);
+  EXPECT_EQ(ReadLines("native_read.gz", "", false), expected);
+  EXPECT_EQ(ReadLines("native_read.txt", "", true), expected);
+  EXPECT_EQ(ReadLines("native_read.txt", " cat ", true), expected);
+  EXPECT_EQ(ReadLines("native_read.gz", "cat", true), expected);
+  // Other converters still run in a pipeline.
+  EXPECT_EQ(ReadLines("native_read.gz", "sed -n 1,10p", true).size(), 10UL);
+
+  // A file closed before its end stops the reader thread.
+  {
+    int err_no = 0;
+    auto fp = paddle::framework::fs_open_read("native_read.gz", &err_no, "");
+    paddle::string::LineFileReader reader;
+    ASSERT_TRUE(reader.getline(&*fp));
+    EXPECT_EQ(std::string(reader.get()), expected[0]);
+  }
+
+  bool old = FLAGS_localfs_native_read;
+  FLAGS_localfs_native_read = true;
+  EXPECT_ANY_THROW(paddle::framework::localfs_open_read("native_none.gz", ""));
+  FLAGS_localfs_native_read = old;
+  paddle::framework::localfs_remove("native_read.txt");
+  paddle::framework::localfs_remove("native_read.gz");
+#endif
+}
+
+// Times the native reader against the shell pipeline on larger files, run it
+// with --gtest_also_run_disabled_tests.
+TEST(FS, DISABLED_native_read_benchmark) {
+#ifdef _LINUX
+  WriteTestFiles("native_read_benchmark", 2000000);
+  for (const char* path :
+       {"native_read_benchmark.txt", "native_read_benchmark.gz"}) {
+    auto t0 = phi::tests::GetCurrentUS();
+    auto piped = ReadLines(path, "cat", false);
+    auto t1 = phi::tests::GetCurrentUS();
+    auto native = ReadLines(path, "cat", true);
+    auto t2 = phi::tests::GetCurrentUS();
+    EXPECT_EQ(piped, native);
+    VLOG(3) << "reading " << path << ": the shell pipeline takes " << t1 - t0
+            << " us, the native reader takes " << t2 - t1 << " us.";
+  }
+  paddle::framework::localfs_remove("native_read_benchmark.txt");
+  paddle::framework::localfs_remove("native_read_benchmark.gz");
+#endif
+}
@@ -14,6 +14,9 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/scope.h"
 
+#include <chrono>
+
+#include "glog/logging.h"
 #include "gtest/gtest.h"
 
 namespace paddle {
@@ -77,3 +80,89 @@ TEST(Scope, GetAllNames) {
 
   EXPECT_STREQ("a", str.c_str());
 }
+
+TEST(Scope, LocalVarIndex) {
+  Scope s;
+  s.ReserveVars(2);
+  Variable* a = s.Var("a");
+  Variable* b = s.Var("b");
+  Variable* c = s.Var("c");
+  int64_t a_index = s.LocalVarIndex("a");
+  int64_t c_index = s.LocalVarIndex("c");
+  EXPECT_EQ(-1, s.LocalVarIndex("d"));
+  EXPECT_EQ(a, s.LocalVar(a_index));
+  EXPECT_EQ(b, s.LocalVar(s.LocalVarIndex("b")));
+  EXPECT_EQ(c, s.LocalVar(c_index));
+
+  // The index of an erased or renamed variable is no longer valid, even if
+  // another variable reuses its slot.
+  s.EraseVars({"a"});
+  EXPECT_EQ(nullptr, s.FindVar("a"));
+  EXPECT_EQ(nullptr, s.LocalVar(a_index));
+  Variable* d = s.Var("d");
+  EXPECT_EQ(nullptr, s.LocalVar(a_index));
+  EXPECT_EQ(d, s.LocalVar(s.LocalVarIndex("d")));
+  s.Rename("c", "e");
+  EXPECT_EQ(nullptr, s.LocalVar(c_index));
+  EXPECT_EQ(c, s.LocalVar(s.LocalVarIndex("e")));
+  EXPECT_EQ(&s, s.FindScope(c));
+
+  s.EraseVarsExcept({b});
+  EXPECT_EQ(1UL, s.Size());
+  EXPECT_EQ(b, s.FindVar("b"));
+}
+
+TEST(Scope, ReserveVarsBenchmark) {
+  const int num_vars = 1000;
+  const int repeat = 100;
+  std::vector<std::string> names;
+  for (int i = 0; i < num_vars; ++i) {
+    names.push_back("local_scope_variable_" + std::to_string(i));
+  }
+  Scope s;
+  for (bool reserve : {false, true}) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; ++r) {
+      Scope& local_scope = s.NewScope();
+      if (reserve) {
+        local_scope.ReserveVars(num_vars);
+      }
+      for (auto& name : names) {
+        local_scope.Var(name);
+      }
+      s.DropKids();
+    }
+    std::chrono::duration<double, std::micro> us =
+        std::chrono::steady_clock::now() - start;
+    VLOG(3) << "Creating " << num_vars << " variables "
+            << (reserve ? "with" : "without") << " ReserveVars takes "
+            << us.count() / repeat << " us.";
+  }
+
+  std::vector<int64_t> indices;
+  for (auto& name : names) {
+    s.Var(name);
+    indices.push_back(s.LocalVarIndex(name));
+  }
+  size_t found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeat; ++r) {
+    for (auto& name : names) {
+      found += s.FindVar(name) != nullptr;
+    }
+  }
+  std::chrono::duration<double, std::micro> by_name =
+      std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeat; ++r) {
+    for (int64_t index : indices) {
+      found += s.LocalVar(index) != nullptr;
+    }
+  }
+  std::chrono::duration<double, std::micro> by_index =
+      std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(2UL * num_vars * repeat, found);
+  VLOG(3) << "Finding " << num_vars << " variables by name takes "
+          << by_name.count() / repeat << " us, by index takes "
+          << by_index.count() / repeat << " us.";
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/memory/memory.h"
+#include "paddle/phi/core/memory/memory_attribution.h"
+
+COMMON_DECLARE_bool(enable_memory_attribution);
+
+namespace paddle {
+namespace memory {
+
+TEST(memory_attribution_test, attribute_to_instruction) {
+  FLAGS_enable_memory_attribution = true;
+  MemoryAttribution::Instance().Reset();
+  phi::CPUPlace place;
+
+  AllocationPtr kept;
+  {
+    MemoryAttributionGuard guard("pd_op.big", 1, place);
+    kept = Alloc(place, 1 << 20);
+    // freed inside the op, never live at the peak
+    AllocationPtr temp = Alloc(place, 1 << 10);
+  }
+  {
+    MemoryAttributionGuard guard("pd_op.small", 2, place);
+    AllocationPtr temp = Alloc(place, 1 << 12);
+  }
+
+  auto stats = MemoryAttribution::Instance().GetPlaceStats();
+  ASSERT_EQ(stats.count(place), 1u);
+  const auto& stat = stats.at(place);
+  ASSERT_FALSE(stat.ops.empty());
+  // the peak is reached by pd_op.small while pd_op.big is still alive
+  EXPECT_EQ(stat.ops[0].name, "pd_op.big(1)");
+  EXPECT_EQ(stat.ops[0].alloc_count, 2);
+  EXPECT_GE(stat.ops[0].live_bytes_at_peak, 1 << 20);
+  EXPECT_GE(stat.ops[0].live_bytes, 1 << 20);
+  EXPECT_GE(stat.peak_bytes, (1 << 20) + (1 << 12));
+
+  std::string summary = MemoryAttribution::Instance().Summary();
+  EXPECT_NE(summary.find("pd_op.big(1)"), std::string::npos);
+  EXPECT_NE(summary.find("pd_op.small(2)"), std::string::npos);
+
+  std::string path = "memory_attribution_test.json";
+  MemoryAttribution::Instance().ExportChromeTrace(path);
+  std::ifstream ifs(path);
+  std::stringstream buffer;
+  buffer << ifs.rdbuf();
+  EXPECT_NE(buffer.str().find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(buffer.str().find("pd_op.small(2)"), std::string::npos);
+  std::remove(path.c_str());
+
+  kept.reset();
+  EXPECT_EQ(MemoryAttribution::Instance().GetPlaceStats().at(place).live_bytes,
+            0);
+  EXPECT_FALSE(MemoryAttribution::Instance().HasLiveBlocks());
+  FLAGS_enable_memory_attribution = false;
+}
+
+TEST(memory_attribution_test, free_after_disabled) {
+  FLAGS_enable_memory_attribution = true;
+  MemoryAttribution::Instance().Reset();
+  phi::CPUPlace place;
+
+  AllocationPtr kept;
+  {
+    MemoryAttributionGuard guard("pd_op.kept", 3, place);
+    kept = Alloc(place, 1 << 16);
+  }
+  EXPECT_TRUE(MemoryAttribution::Instance().HasLiveBlocks());
+
+  // The blocks allocated while enabled are still released from the tracker.
+  FLAGS_enable_memory_attribution = false;
+  kept.reset();
+  EXPECT_FALSE(MemoryAttribution::Instance().HasLiveBlocks());
+  EXPECT_EQ(MemoryAttribution::Instance().GetPlaceStats().at(place).live_bytes,
+            0);
+
+  // Nothing is tracked while disabled.
+  kept = Alloc(place, 1 << 16);
+  EXPECT_FALSE(MemoryAttribution::Instance().HasLiveBlocks());
+  kept.reset();
+}
+
+}  // namespace memory
+}  // namespace paddle
@@ -25,6 +25,7 @@
 #endif
 #include "paddle/fluid/platform/profiler/event_python.h"
 #include "paddle/fluid/platform/profiler/profiler.h"
+#include "paddle/phi/api/profiler/hardware_counters.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/platform/profiler.h"
 #include "paddle/phi/core/platform/profiler/event_tracing.h"
@@ -60,6 +61,55 @@ TEST(ProfilerTest, TestHostTracer) {
   EXPECT_EQ(host_events.count("TestTraceLevel_record2"), 0u);
 }
 
+TEST(ProfilerTest, TestHostTracerHardwareCounters) {
+  using paddle::platform::Profiler;
+  using paddle::platform::ProfilerOptions;
+  using phi::TracerEventType;
+  ProfilerOptions options;
+  options.trace_level = 2;
+  options.trace_switch = 1;
+  options.enable_hw_counters = true;
+  auto profiler = Profiler::Create(options);
+  EXPECT_TRUE(profiler);
+  paddle::platform::EnableHostEventRecorder();
+  profiler->Prepare();
+  profiler->Start();
+  bool supported = phi::HardwareCounterReader::IsEnabled();
+  {
+    phi::RecordEvent event("TestHardwareCounters_op",
+                           TracerEventType::Operator);
+    volatile double sum = 0;
+    for (int i = 0; i < 100000; ++i) {
+      sum = sum + i * 0.5;
+    }
+  }
+  {
+    phi::RecordEvent event("TestHardwareCounters_user",
+                           TracerEventType::UserDefined);
+  }
+  paddle::platform::DisableHostEventRecorder();
+  auto profiler_result = profiler->Stop();
+  EXPECT_FALSE(phi::HardwareCounterReader::IsEnabled());
+  auto nodetree = profiler_result->GetNodeTrees();
+  int num_checked = 0;
+  for (const auto& pair : nodetree->Traverse(true)) {
+    for (const auto evt : pair.second) {
+      if (evt->Name() == "TestHardwareCounters_op") {
+        EXPECT_EQ(evt->HasHardwareCounters(), supported);
+        if (supported) {
+          EXPECT_GT(evt->GetHardwareCounters().cycles, 0u);
+          EXPECT_GT(evt->GetHardwareCounters().instructions, 0u);
+        }
+        ++num_checked;
+      } else if (evt->Name() == "TestHardwareCounters_user") {
+        EXPECT_FALSE(evt->HasHardwareCounters());
+        ++num_checked;
+      }
+    }
+  }
+  EXPECT_EQ(num_checked, 2);
+}
+
 TEST(ProfilerTest, TestCudaTracer) {
   using paddle::platform::Profiler;
   using paddle::platform::ProfilerOptions;
@@ -16,11 +16,14 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <string>
 
+#include "paddle/phi/api/profiler/op_sampling_profiler.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/memory/memory_attribution.h"
 
 #include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 #include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
@@ -33,12 +36,19 @@
 
 #include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/common/macros.h"
 #include "paddle/pir/include/dialect/control_flow/ir/cf_dialect.h"
 #include "paddle/pir/include/dialect/control_flow/ir/cf_op.h"
 
 DECLARE_FILE_SYMBOLS(kernel_dialect);
 
+COMMON_DECLARE_bool(enable_pir_in_executor_trace_run);
+COMMON_DECLARE_int32(pir_interpreter_shape_plan_capacity);
+COMMON_DECLARE_int64(pir_interpreter_macro_instruction_max_numel);
+COMMON_DECLARE_bool(enable_memory_attribution);
+PHI_DECLARE_int32(op_sampling_profiler_interval);
+
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(full_int_array, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(uniform, CPU, ALL_LAYOUT);
@@ -385,5 +395,199 @@ TEST(StandaloneExecutor, while_op) {
   EXPECT_EQ(res0, true);
 }
 
+// A chain of adds on a fed [batch, 16] tensor, small enough for InferMeta to
+// be a visible part of a run. A batch > 0 gives the feed a static shape.
+std::unique_ptr<pir::Program> BuildAddChainProgram(int num_adds,
+                                                   int64_t batch = -1) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  pir::Type dense_tensor_dtype =
+      paddle::dialect::DenseTensorType::get(ctx,
+                                            pir::Float32Type::get(ctx),
+                                            phi::DDim{batch, 16},
+                                            phi::DataLayout::NCHW,
+                                            phi::LegacyLoD(),
+                                            0);
+  pir::AttributeMap attr_map;
+  attr_map.insert({"name", pir::StrAttribute::get(ctx, "x")});
+  attr_map.insert({"col", pir::Int32Attribute::get(ctx, 0)});
+  pir::Operation* feed_op = pir::Operation::Create(
+      {},
+      attr_map,
+      {dense_tensor_dtype},
+      ctx->GetRegisteredOpInfo(paddle::dialect::FeedOp::name()));
+  program.block()->push_back(feed_op);
+
+  pir::Value out = feed_op->result(0);
+  for (int i = 0; i < num_adds; ++i) {
+    out = builder.Build<paddle::dialect::AddOp>(out, feed_op->result(0))
+              .result(0);
+  }
+  builder.Build<pir::ShadowOutputOp>(out, "add_chain_out");
+  return paddle::dialect::PdOpLowerToKernelPass(&program);
+}
+
+phi::DenseTensor MakeFeedTensor(int64_t batch) {
+  phi::DenseTensor tensor;
+  tensor.Resize({batch, 16});
+  float* data = phi::DeviceContextPool::Instance()
+                    .Get(phi::CPUPlace())
+                    ->Alloc<float>(&tensor);
+  std::fill(data, data + tensor.numel(), 1.0f);
+  return tensor;
+}
+
+TEST(StandaloneExecutor, infer_meta_shape_plan) {
+  const int num_adds = 32;
+  auto kernel_program = BuildAddChainProgram(num_adds);
+  Scope scope;
+  PirInterpreter interpreter(
+      phi::CPUPlace(), {}, kernel_program->block(), &scope);
+  interpreter.SetSkipGcVars({"add_chain_out"});
+
+  auto run = [&](int64_t batch) {
+    interpreter.Run({"x"}, {MakeFeedTensor(batch)});
+    const Scope* inner_scope = interpreter.local_scope() == nullptr
+                                   ? &scope
+                                   : interpreter.local_scope();
+    const auto& out =
+        inner_scope->FindVar("add_chain_out")->Get<phi::DenseTensor>();
+    EXPECT_EQ(out.dims(), common::make_ddim({batch, 16}));
+    EXPECT_EQ(out.data<float>()[out.numel() - 1], num_adds + 1.0f);
+  };
+
+  for (int i = 0; i < 10; ++i) {
+    run(2);
+  }
+  auto stats = interpreter.GetShapePlanStats();
+  EXPECT_EQ(stats.plan_misses, 1);
+  EXPECT_EQ(stats.plan_hits, 9);
+  EXPECT_EQ(stats.infer_meta_misses, num_adds);
+  EXPECT_EQ(stats.infer_meta_hits, 9 * num_adds);
+
+  // A new batch size records a second plan, the first one is kept.
+  run(4);
+  run(2);
+  stats = interpreter.GetShapePlanStats();
+  EXPECT_EQ(stats.plan_misses, 2);
+  EXPECT_EQ(stats.plan_hits, 10);
+  EXPECT_EQ(stats.infer_meta_misses, 2 * num_adds);
+  EXPECT_EQ(stats.infer_meta_hits, 10 * num_adds);
+}
+
+TEST(StandaloneExecutor, infer_meta_shape_plan_benchmark) {
+  auto kernel_program = BuildAddChainProgram(64);
+  phi::DenseTensor x = MakeFeedTensor(1);
+  const int capacity = FLAGS_pir_interpreter_shape_plan_capacity;
+  for (int plan_capacity : {0, 4}) {
+    FLAGS_pir_interpreter_shape_plan_capacity = plan_capacity;
+    Scope scope;
+    PirInterpreter interpreter(
+        phi::CPUPlace(), {}, kernel_program->block(), &scope);
+    interpreter.SetSkipGcVars({"add_chain_out"});
+    interpreter.Run({"x"}, {x});
+
+    const int repeat = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i) {
+      interpreter.Run({"x"}, {x});
+    }
+    auto end = std::chrono::steady_clock::now();
+    auto stats = interpreter.GetShapePlanStats();
+    VLOG(3) << "64 adds with shape plan capacity " << plan_capacity
+            << " takes "
+            << std::chrono::duration<double, std::micro>(end - start).count() /
+                   repeat
+            << " us per run, infer meta hits " << stats.infer_meta_hits
+            << ", misses " << stats.infer_meta_misses << ".";
+    EXPECT_EQ(stats.infer_meta_hits, plan_capacity == 0 ? 0 : repeat * 64);
+  }
+  FLAGS_pir_interpreter_shape_plan_capacity = capacity;
+}
+
+// Returns the number of the occurrences of pattern in text.
+size_t CountOccurrences(const std::string& text, const std::string& pattern) {
+  size_t count = 0;
+  for (size_t pos = text.find(pattern); pos != std::string::npos;
+       pos = text.find(pattern, pos + pattern.size())) {
+    ++count;
+  }
+  return count;
+}
+
+// Returns the number of the sampled executions of op_name.
+uint64_t SampledCount(const std::string& op_name) {
+  std::string text = phi::OpSamplingProfiler::Instance().ExportText();
+  std::string key =
+      "paddle_op_latency_seconds_count{op=\"" + op_name + "\"} ";
+  size_t pos = text.find(key);
+  return pos == std::string::npos ? 0
+                                  : std::stoull(text.substr(pos + key.size()));
+}
+
+// The adds of a static [1, 16] tensor run as one macro instruction, which
+// only the trace run builds.
+TEST(StandaloneExecutor, macro_instruction) {
+  const int num_adds = 64;
+  auto kernel_program = BuildAddChainProgram(num_adds, 1);
+  phi::DenseTensor x = MakeFeedTensor(1);
+  const int64_t max_numel = FLAGS_pir_interpreter_macro_instruction_max_numel;
+  const bool trace_run = FLAGS_enable_pir_in_executor_trace_run;
+  FLAGS_enable_pir_in_executor_trace_run = true;
+  for (int64_t macro_max_numel : {0, 16}) {
+    FLAGS_pir_interpreter_macro_instruction_max_numel = macro_max_numel;
+    Scope scope;
+    PirInterpreter interpreter(
+        phi::CPUPlace(), {}, kernel_program->block(), &scope);
+    interpreter.SetSkipGcVars({"add_chain_out"});
+    auto run = [&] {
+      interpreter.Run({"x"}, {x});
+      const Scope* inner_scope = interpreter.local_scope() == nullptr
+                                     ? &scope
+                                     : interpreter.local_scope();
+      const auto& out =
+          inner_scope->FindVar("add_chain_out")->Get<phi::DenseTensor>();
+      EXPECT_EQ(out.dims(), common::make_ddim({1, 16}));
+      EXPECT_EQ(out.data<float>()[out.numel() - 1], num_adds + 1.0f);
+    };
+    run();
+    EXPECT_EQ(interpreter.NumMacroInstructions(),
+              macro_max_numel == 0 ? 0UL : 1UL);
+
+    // Every add of the macro instruction is still sampled and attributed.
+    FLAGS_op_sampling_profiler_interval = 1;
+    FLAGS_enable_memory_attribution = true;
+    paddle::memory::MemoryAttribution::Instance().Reset();
+    uint64_t num_sampled = SampledCount("pd_op.add");
+    run();
+    FLAGS_enable_memory_attribution = false;
+    FLAGS_op_sampling_profiler_interval = 0;
+    EXPECT_EQ(SampledCount("pd_op.add") - num_sampled,
+              static_cast<uint64_t>(num_adds));
+    EXPECT_EQ(CountOccurrences(paddle::memory::MemoryAttribution::Instance()
+                                   .ChromeTraceEvents(),
+                               "\"name\": \"pd_op.add("),
+              static_cast<size_t>(num_adds));
+
+    const int repeat = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i) {
+      run();
+    }
+    auto end = std::chrono::steady_clock::now();
+    VLOG(3) << num_adds << " adds of [1, 16] with macro instruction max numel "
+            << macro_max_numel << " takes "
+            << std::chrono::duration<double, std::micro>(end - start).count() /
+                   repeat / num_adds
+            << " us per op.";
+  }
+  FLAGS_pir_interpreter_macro_instruction_max_numel = max_numel;
+  FLAGS_enable_pir_in_executor_trace_run = trace_run;
+  phi::OpSamplingProfiler::Instance().Shutdown();
+}
+
 }  // namespace framework
 }  // namespace paddle
@@ -0,0 +1,161 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/api/profiler/op_sampling_profiler.h"
+#include "test/cpp/phi/core/timer.h"
+
+PHI_DECLARE_int32(op_sampling_profiler_interval);
+PHI_DECLARE_string(op_sampling_profiler_path);
+
+namespace phi {
+namespace tests {
+
+// A small piece of work, comparable to a cheap CPU kernel.
+float FakeOp(std::vector<float>* data) {
+  float sum = 0;
+  for (auto& v : *data) {
+    v = v * 0.5f + 1.0f;
+    sum += v;
+  }
+  return sum;
+}
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream fin(path);
+  std::stringstream content;
+  content << fin.rdbuf();
+  return content.str();
+}
+
+TEST(OpSamplingProfiler, export_histogram) {
+  FLAGS_op_sampling_profiler_path = "test_op_sampling_profiler.prom";
+  FLAGS_op_sampling_profiler_interval = 2;
+  const std::string op_name = "test_op_sampling.export";
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; ++t) {
+    threads.emplace_back([&op_name]() {
+      std::vector<float> data(256, 1.0f);
+      for (int i = 0; i < 100; ++i) {
+        OpSamplingGuard guard(op_name);
+        FakeOp(&data);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  FLAGS_op_sampling_profiler_interval = 0;
+
+  std::string text = OpSamplingProfiler::Instance().ExportText();
+  EXPECT_NE(text.find("# TYPE paddle_op_latency_seconds histogram"),
+            std::string::npos);
+  EXPECT_NE(text.find("paddle_op_latency_seconds_count{op=\"" + op_name +
+                      "\"} 100"),
+            std::string::npos);
+  EXPECT_NE(text.find("paddle_op_latency_seconds_bucket{op=\"" + op_name +
+                      "\",le=\"+Inf\"} 100"),
+            std::string::npos);
+
+  OpSamplingProfiler::Instance().Flush();
+  // The file is in the Prometheus text format, without the OpenMetrics EOF.
+  std::string flushed = ReadFile("test_op_sampling_profiler.prom");
+  EXPECT_NE(flushed.find("# TYPE paddle_op_latency_seconds histogram"),
+            std::string::npos);
+  EXPECT_EQ(flushed.find("# EOF"), std::string::npos);
+  OpSamplingProfiler::Instance().Shutdown();
+}
+
+TEST(OpSamplingProfiler, shutdown_flush) {
+  // The path is read when the profiler starts, later changes of the flag take
+  // effect at the next start.
+  const std::string path = "test_op_sampling_profiler.shutdown.prom";
+  const std::string other_path = "test_op_sampling_profiler.other.prom";
+  std::remove(path.c_str());
+  std::remove(other_path.c_str());
+  FLAGS_op_sampling_profiler_path = path;
+  FLAGS_op_sampling_profiler_interval = 1;
+  const std::string op_name = "test_op_sampling.shutdown";
+  // A new thread samples its first execution.
+  std::thread([&op_name]() {
+    std::vector<float> data(256, 1.0f);
+    OpSamplingGuard guard(op_name);
+    FakeOp(&data);
+  }).join();
+  FLAGS_op_sampling_profiler_interval = 0;
+  FLAGS_op_sampling_profiler_path = other_path;
+
+  OpSamplingProfiler::Instance().Shutdown();
+  EXPECT_NE(ReadFile(path).find("paddle_op_latency_seconds_count{op=\"" +
+                                op_name + "\"} 1"),
+            std::string::npos);
+  EXPECT_TRUE(ReadFile(other_path).empty());
+  FLAGS_op_sampling_profiler_path = "test_op_sampling_profiler.prom";
+}
+
+TEST(OpSamplingProfiler, overhead) {
+  const std::string op_name = "test_op_sampling.overhead";
+  std::vector<float> data(4096, 1.0f);
+  phi::tests::Timer timer;
+  float sink = 0;
+
+  // Returns the time in ns of one guard, or of one op if with_op.
+  auto Run = [&](size_t cycles, bool with_op) {
+    timer.tic();
+    for (size_t i = 0; i < cycles; ++i) {
+      OpSamplingGuard guard(op_name);
+      if (with_op) {
+        sink += FakeOp(&data);
+      }
+    }
+    return timer.toc() * 1e6 / cycles;
+  };
+
+  // The difference of two timings of the ops is lost in the noise of a busy
+  // machine, so the guards are timed alone and compared with the ops. Take
+  // the best of a few runs after a warm-up.
+  FLAGS_op_sampling_profiler_interval = 100;
+  Run(100000, false);
+  Run(100, true);
+  double guard_ns = 0, op_ns = 0;
+  for (int i = 0; i < 5; ++i) {
+    double t = Run(1000000, false);
+    guard_ns = i == 0 ? t : std::min(guard_ns, t);
+    t = Run(1000, true);
+    op_ns = i == 0 ? t : std::min(op_ns, t);
+  }
+  FLAGS_op_sampling_profiler_interval = 0;
+  OpSamplingProfiler::Instance().Shutdown();
+
+  VLOG(3) << "Sampling 1/100 takes " << guard_ns << "ns per execution of a "
+          << op_ns << "ns op, overhead: " << guard_ns / op_ns * 100
+          << "%, sink " << sink;
+  // A guard sampling one in 100 executions measured about 5ns against 3.4us
+  // for the op, an overhead of 0.15% in an optimized build.
+  EXPECT_LT(guard_ns, op_ns * 0.01);
+}
+
+}  // namespace tests
+}  // namespace phi
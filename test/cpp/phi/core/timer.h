@@ -19,6 +19,14 @@ limitations under the License. */
 namespace phi {
 namespace tests {
 
+// Returns the current time in microseconds, used to time the benchmarks in
+// the tests.
+inline double GetCurrentUS() {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
 class Timer {
  public:
   std::chrono::high_resolution_clock::time_point start;
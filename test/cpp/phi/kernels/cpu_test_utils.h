@@ -0,0 +1,98 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "test/cpp/phi/core/timer.h"
+
+namespace phi {
+namespace tests {
+
+// Helpers shared by the tests of the CPU kernels.
+
+inline const CPUContext& GetCPUContext() {
+  return *static_cast<const CPUContext*>(
+      DeviceContextPool::Instance().Get(CPUPlace()));
+}
+
+// Returns a float tensor of dims filled with uniform values in [low, high).
+inline DenseTensor RandomTensor(const DDim& dims,
+                                std::mt19937* rng,
+                                float low = -1.f,
+                                float high = 1.f) {
+  std::uniform_real_distribution<float> dist(low, high);
+  DenseTensor t;
+  t.Resize(dims);
+  float* data = GetCPUContext().Alloc<float>(&t);
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    data[i] = dist(*rng);
+  }
+  return t;
+}
+
+inline DenseTensor RandomTensor(const DDim& dims, unsigned int seed) {
+  std::mt19937 rng(seed);
+  return RandomTensor(dims, &rng);
+}
+
+// Expects |actual[i] - expected[i]| <= tolerance * (1 + |expected[i]|) for
+// the n values.
+template <typename T, typename U>
+void ExpectNear(const T* actual,
+                const U* expected,
+                size_t n,
+                double tolerance,
+                const std::string& what = "") {
+  for (size_t i = 0; i < n; ++i) {
+    double e = static_cast<double>(expected[i]);
+    ASSERT_NEAR(
+        static_cast<double>(actual[i]), e, tolerance * (1 + std::abs(e)))
+        << what << " at " << i;
+  }
+}
+
+template <typename T, typename U>
+void ExpectNear(const std::vector<T>& actual,
+                const std::vector<U>& expected,
+                double tolerance,
+                const std::string& what = "") {
+  ASSERT_EQ(actual.size(), expected.size()) << what;
+  ExpectNear(actual.data(), expected.data(), expected.size(), tolerance, what);
+}
+
+// Compares two float tensors.
+inline void ExpectNear(const DenseTensor& actual,
+                       const DenseTensor& expected,
+                       double tolerance,
+                       const std::string& what = "") {
+  ASSERT_EQ(actual.numel(), expected.numel()) << what;
+  ExpectNear(actual.data<float>(),
+             expected.data<float>(),
+             static_cast<size_t>(expected.numel()),
+             tolerance,
+             what);
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,229 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/funcs/broadcast_cpu_function.h"
+#include "paddle/phi/kernels/funcs/elementwise_utils.h"
+#include "test/cpp/phi/core/timer.h"
+
+namespace phi {
+namespace tests {
+
+constexpr int repeat = 20;
+
+struct MulAddFunctor {
+  float operator()(float a, float b) const { return a * 2.f + b; }
+};
+
+// d(out)/dx and d(out)/dy of MulAddFunctor
+struct MulAddDx {
+  float operator()(float x, float y, float out, float dout) const {
+    return 2.f * dout;
+  }
+};
+struct MulAddDy {
+  float operator()(float x, float y, float out, float dout) const {
+    return dout * (x - y) + out;
+  }
+};
+
+struct BroadcastCase {
+  std::vector<int> x_dims;
+  std::vector<int> y_dims;
+};
+
+std::vector<int> OutDims(const BroadcastCase& c) {
+  std::vector<int> out(c.x_dims.size());
+  for (size_t i = 0; i < out.size(); ++i) {
+    out[i] = std::max(c.x_dims[i], c.y_dims[i]);
+  }
+  return out;
+}
+
+int64_t Numel(const std::vector<int>& dims) {
+  int64_t numel = 1;
+  for (int d : dims) {
+    numel *= d;
+  }
+  return numel;
+}
+
+void RandomVec(std::vector<float>* vec) {
+  static unsigned int seed = 100;
+  std::mt19937 rng(seed++);
+  std::uniform_real_distribution<float> uniform_dist(-1.f, 1.f);
+  for (auto& v : *vec) {
+    v = uniform_dist(rng);
+  }
+}
+
+// The per-element implementation the broadcast functions replace.
+void RefForward(const BroadcastCase& c,
+                const std::vector<int>& out_dims,
+                const float* x,
+                const float* y,
+                float* out) {
+  int max_dim = static_cast<int>(out_dims.size());
+  std::vector<int> index(max_dim, 0);
+  for (int64_t i = 0; i < Numel(out_dims); ++i) {
+    int x_index =
+        funcs::GetElementwiseIndex(c.x_dims.data(), max_dim, index.data());
+    int y_index =
+        funcs::GetElementwiseIndex(c.y_dims.data(), max_dim, index.data());
+    out[i] = MulAddFunctor()(x[x_index], y[y_index]);
+    funcs::UpdateElementwiseIndexArray(out_dims.data(), max_dim, index.data());
+  }
+}
+
+void RefGrad(const BroadcastCase& c,
+             const std::vector<int>& out_dims,
+             const float* x,
+             const float* y,
+             const float* out,
+             const float* dout,
+             float* dx,
+             float* dy) {
+  int max_dim = static_cast<int>(out_dims.size());
+  std::fill(dx, dx + Numel(c.x_dims), 0.f);
+  std::fill(dy, dy + Numel(c.y_dims), 0.f);
+  std::vector<int> index(max_dim, 0);
+  for (int64_t i = 0; i < Numel(out_dims); ++i) {
+    int x_index =
+        funcs::GetElementwiseIndex(c.x_dims.data(), max_dim, index.data());
+    int y_index =
+        funcs::GetElementwiseIndex(c.y_dims.data(), max_dim, index.data());
+    dx[x_index] += MulAddDx()(x[x_index], y[y_index], out[i], dout[i]);
+    dy[y_index] += MulAddDy()(x[x_index], y[y_index], out[i], dout[i]);
+    funcs::UpdateElementwiseIndexArray(out_dims.data(), max_dim, index.data());
+  }
+}
+
+void TestAndBench(const BroadcastCase& c) {
+  std::vector<int> out_dims = OutDims(c);
+  int max_dim = static_cast<int>(out_dims.size());
+  std::vector<float> x(Numel(c.x_dims)), y(Numel(c.y_dims));
+  std::vector<float> out(Numel(out_dims)), out_ref(Numel(out_dims));
+  std::vector<float> dout(Numel(out_dims));
+  RandomVec(&x);
+  RandomVec(&y);
+  RandomVec(&dout);
+
+  funcs::CPUBroadcastLayout layout(
+      c.x_dims.data(), c.y_dims.data(), out_dims.data(), max_dim);
+
+  auto t0 = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    funcs::BroadcastBinaryCPU<float, float>(
+        layout, x.data(), y.data(), out.data(), MulAddFunctor());
+  }
+  auto t1 = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    RefForward(c, out_dims, x.data(), y.data(), out_ref.data());
+  }
+  auto t2 = GetCurrentUS();
+  for (size_t i = 0; i < out.size(); ++i) {
+    ASSERT_FLOAT_EQ(out[i], out_ref[i]);
+  }
+
+  std::vector<float> dx(x.size()), dy(y.size());
+  std::vector<float> dx_ref(x.size()), dy_ref(y.size());
+  auto t3 = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    funcs::BroadcastGradReduceCPU<float, float>(layout,
+                                                funcs::CPUBroadcastLayout::kX,
+                                                x.data(),
+                                                y.data(),
+                                                out.data(),
+                                                dout.data(),
+                                                dx.data(),
+                                                MulAddDx());
+    funcs::BroadcastGradReduceCPU<float, float>(layout,
+                                                funcs::CPUBroadcastLayout::kY,
+                                                x.data(),
+                                                y.data(),
+                                                out.data(),
+                                                dout.data(),
+                                                dy.data(),
+                                                MulAddDy());
+  }
+  auto t4 = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    RefGrad(c,
+            out_dims,
+            x.data(),
+            y.data(),
+            out_ref.data(),
+            dout.data(),
+            dx_ref.data(),
+            dy_ref.data());
+  }
+  auto t5 = GetCurrentUS();
+  // The reference sums in a different order.
+  for (size_t i = 0; i < dx.size(); ++i) {
+    ASSERT_NEAR(dx[i], dx_ref[i], 1e-3 * (1.f + std::abs(dx_ref[i])));
+  }
+  for (size_t i = 0; i < dy.size(); ++i) {
+    ASSERT_NEAR(dy[i], dy_ref[i], 1e-3 * (1.f + std::abs(dy_ref[i])));
+  }
+
+  VLOG(3) << "x " << common::make_ddim(c.x_dims) << ", y "
+          << common::make_ddim(c.y_dims) << ", merged rank " << layout.rank
+          << ": forward takes " << (t1 - t0) / repeat << " us, refer takes "
+          << (t2 - t1) / repeat << " us; grad takes " << (t4 - t3) / repeat
+          << " us, refer takes " << (t5 - t4) / repeat << " us.";
+}
+
+TEST(BroadcastCPU, shape_patterns) {
+  std::vector<BroadcastCase> cases = {
+      // bias of channel
+      {{8, 64, 28, 28}, {1, 64, 1, 1}},
+      // bias of the last dim
+      {{64, 128, 256}, {1, 1, 256}},
+      // outer product
+      {{1024, 1}, {1, 1024}},
+      // both inputs are broadcast
+      {{2, 3, 1, 5}, {2, 1, 4, 1}},
+      {{16, 1, 32, 64}, {16, 48, 1, 64}},
+      // broadcast along the middle dim
+      {{8, 64, 28, 28}, {8, 1, 28, 28}},
+      // broadcast of a scalar
+      {{256, 1024}, {1, 1}},
+      // broadcast along the innermost dim only
+      {{32, 4096, 1}, {32, 4096, 7}},
+      // tiny
+      {{3, 1}, {1, 2}},
+      {{1}, {5}},
+  };
+  for (const auto& c : cases) {
+    TestAndBench(c);
+  }
+}
+
+TEST(BroadcastCPU, empty) {
+  std::vector<int> x_dims = {1, 3}, y_dims = {0, 1}, out_dims = {0, 3};
+  funcs::CPUBroadcastLayout layout(
+      x_dims.data(), y_dims.data(), out_dims.data(), 2);
+  EXPECT_EQ(layout.numel, 0);
+  EXPECT_EQ(layout.OuterSize(), 0);
+  float x[3] = {1.f, 2.f, 3.f};
+  funcs::BroadcastBinaryCPU<float, float>(
+      layout, x, x, static_cast<float*>(nullptr), MulAddFunctor());
+}
+
+}  // namespace tests
+}  // namespace phi
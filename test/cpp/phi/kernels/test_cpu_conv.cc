@@ -0,0 +1,196 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/conv_kernel.h"
+#include "paddle/phi/kernels/funcs/conv_cpu_function.h"
+#include "test/cpp/phi/kernels/cpu_test_utils.h"
+
+namespace phi {
+namespace tests {
+
+// Sets FLAGS_cpu_conv2d_algo for the lifetime of the guard.
+class ConvAlgoGuard {
+ public:
+  explicit ConvAlgoGuard(const std::string& algo)
+      : old_(FLAGS_cpu_conv2d_algo) {
+    FLAGS_cpu_conv2d_algo = algo;
+  }
+  ~ConvAlgoGuard() { FLAGS_cpu_conv2d_algo = old_; }
+
+ private:
+  std::string old_;
+};
+
+struct ConvCase {
+  std::string name;
+  int64_t batch, channels, height, width, filters, kernel;
+  int stride, padding, groups, dilation;
+};
+
+std::vector<float> Conv(const ConvCase& c,
+                        const std::string& algo,
+                        bool channel_last = false,
+                        int repeat = 1,
+                        double* us = nullptr) {
+  ConvAlgoGuard guard(algo);
+  DDim in_dims = channel_last
+                     ? make_ddim({c.batch, c.height, c.width, c.channels})
+                     : make_ddim({c.batch, c.channels, c.height, c.width});
+  auto input = RandomTensor(in_dims, 1);
+  auto filter = RandomTensor(
+      {c.filters, c.channels / c.groups, c.kernel, c.kernel}, 2);
+  const int64_t extent = c.dilation * (c.kernel - 1) + 1;
+  const int64_t out_h = (c.height + 2 * c.padding - extent) / c.stride + 1;
+  const int64_t out_w = (c.width + 2 * c.padding - extent) / c.stride + 1;
+  DenseTensor out;
+  out.Resize(channel_last ? make_ddim({c.batch, out_h, out_w, c.filters})
+                          : make_ddim({c.batch, c.filters, out_h, out_w}));
+  auto t0 = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    ConvKernel<float, CPUContext>(GetCPUContext(),
+                                  input,
+                                  filter,
+                                  {c.stride, c.stride},
+                                  {c.padding, c.padding},
+                                  "EXPLICIT",
+                                  {c.dilation, c.dilation},
+                                  c.groups,
+                                  channel_last ? "NHWC" : "NCHW",
+                                  &out);
+  }
+  if (us != nullptr) {
+    *us = (GetCurrentUS() - t0) / repeat;
+  }
+  return std::vector<float>(out.data<float>(),
+                            out.data<float>() + out.numel());
+}
+
+TEST(CPUConv, algos_match_legacy) {
+  std::vector<ConvCase> cases = {
+      {"3x3", 2, 5, 11, 13, 7, 3, 1, 1, 1, 1},
+      {"3x3 stride 2", 2, 5, 11, 13, 7, 3, 2, 1, 1, 1},
+      {"3x3 no padding", 1, 3, 14, 15, 5, 3, 1, 0, 1, 1},
+      {"3x3 wide", 2, 40, 15, 17, 36, 3, 1, 1, 1, 1},
+      {"1x1", 1, 6, 9, 10, 4, 1, 1, 0, 1, 1},
+      {"1x1 stride 2", 1, 6, 9, 10, 4, 1, 2, 0, 1, 1},
+      {"5x5", 1, 3, 17, 19, 9, 5, 2, 2, 1, 1},
+      {"dilated", 1, 4, 10, 10, 6, 3, 1, 2, 1, 2},
+      {"grouped", 2, 8, 9, 9, 16, 3, 1, 1, 2, 1},
+      {"depthwise", 2, 8, 12, 12, 16, 3, 1, 1, 8, 1},
+      {"depthwise stride 2", 1, 4, 12, 12, 4, 3, 2, 1, 4, 1},
+  };
+  for (const auto& c : cases) {
+    auto expected = Conv(c, "legacy");
+    for (std::string algo : {"auto",
+                             "im2col",
+                             "direct",
+                             "depthwise",
+                             "winograd_f23",
+                             "winograd_f43"}) {
+      // Algorithms that do not support a conv fall back to auto.
+      ExpectNear(Conv(c, algo), expected, 1e-3, c.name + " with " + algo);
+    }
+    ExpectNear(Conv(c, "auto", true),
+               Conv(c, "legacy", true),
+               1e-3,
+               c.name + " in NHWC");
+  }
+}
+
+funcs::CPUConv2DShape Shape(
+    int64_t channels, int64_t size, int64_t kernel, int stride, int groups) {
+  return {1,
+          channels,
+          size,
+          size,
+          channels,
+          size / stride,
+          size / stride,
+          kernel,
+          kernel,
+          stride,
+          stride,
+          1,
+          1,
+          kernel / 2,
+          kernel / 2,
+          groups};
+}
+
+TEST(CPUConv, select_algo) {
+  ConvAlgoGuard guard("auto");
+  EXPECT_EQ(funcs::SelectCPUConvAlgo(Shape(64, 56, 3, 1, 1)),
+            funcs::CPUConvAlgo::kWinogradF43);
+  EXPECT_EQ(funcs::SelectCPUConvAlgo(Shape(256, 14, 3, 1, 1)),
+            funcs::CPUConvAlgo::kWinogradF23);
+  EXPECT_EQ(funcs::SelectCPUConvAlgo(Shape(512, 7, 3, 1, 1)),
+            funcs::CPUConvAlgo::kIm2ColGemm);
+  EXPECT_EQ(funcs::SelectCPUConvAlgo(Shape(64, 56, 3, 2, 64)),
+            funcs::CPUConvAlgo::kDepthwise);
+  EXPECT_EQ(funcs::SelectCPUConvAlgo(Shape(64, 56, 1, 1, 1)),
+            funcs::CPUConvAlgo::kIm2ColGemm);
+  FLAGS_cpu_conv2d_algo = "winograd_f23";
+  EXPECT_EQ(funcs::SelectCPUConvAlgo(Shape(512, 7, 3, 1, 1)),
+            funcs::CPUConvAlgo::kWinogradF23);
+  EXPECT_EQ(funcs::SelectCPUConvAlgo(Shape(64, 56, 1, 1, 1)),
+            funcs::CPUConvAlgo::kIm2ColGemm);
+}
+
+// Times every algorithm on the convs of resnet50 and mobilenet, run it with
+// --gtest_also_run_disabled_tests.
+TEST(CPUConv, DISABLED_resnet_mobilenet_benchmark) {
+  std::vector<ConvCase> cases = {
+      {"resnet50 conv1", 1, 3, 224, 224, 64, 7, 2, 3, 1, 1},
+      {"resnet50 3x3 56", 1, 64, 56, 56, 64, 3, 1, 1, 1, 1},
+      {"resnet50 3x3 28", 1, 128, 28, 28, 128, 3, 1, 1, 1, 1},
+      {"resnet50 3x3 14", 1, 256, 14, 14, 256, 3, 1, 1, 1, 1},
+      {"resnet50 3x3 7", 1, 512, 7, 7, 512, 3, 1, 1, 1, 1},
+      {"resnet50 1x1 56", 1, 64, 56, 56, 256, 1, 1, 0, 1, 1},
+      {"resnet50 3x3 56 batch 8", 8, 64, 56, 56, 64, 3, 1, 1, 1, 1},
+      {"mobilenet conv1", 1, 3, 224, 224, 32, 3, 2, 1, 1, 1},
+      {"mobilenet dw 112", 1, 32, 112, 112, 32, 3, 1, 1, 32, 1},
+      {"mobilenet dw 112 stride 2", 1, 64, 112, 112, 64, 3, 2, 1, 64, 1},
+      {"mobilenet dw 14", 1, 512, 14, 14, 512, 3, 1, 1, 512, 1},
+      {"mobilenet pw 112", 1, 32, 112, 112, 64, 1, 1, 0, 1, 1},
+  };
+  for (const auto& c : cases) {
+    auto expected = Conv(c, "legacy");
+    for (std::string algo : {"legacy",
+                             "auto",
+                             "im2col",
+                             "direct",
+                             "depthwise",
+                             "winograd_f23",
+                             "winograd_f43"}) {
+      double us = 0;
+      Conv(c, algo);
+      auto out = Conv(c, algo, false, 3, &us);
+      VLOG(3) << c.name << " with " << algo << " takes " << us << " us.";
+      // The deep reductions of these convs accumulate more rounding errors
+      // than the small cases of algos_match_legacy.
+      ExpectNear(out, expected, 1e-2, c.name + " with " + algo);
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,296 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/activation_kernel.h"
+#include "paddle/phi/kernels/elementwise_add_kernel.h"
+#include "paddle/phi/kernels/funcs/half_cpu_function.h"
+#include "paddle/phi/kernels/gelu_kernel.h"
+#include "paddle/phi/kernels/layer_norm_kernel.h"
+#include "paddle/phi/kernels/matmul_kernel.h"
+#include "test/cpp/phi/kernels/cpu_test_utils.h"
+
+namespace phi {
+namespace tests {
+
+using bf16 = phi::dtype::bfloat16;
+using fp16 = phi::dtype::float16;
+
+template <typename T>
+std::vector<T> RandomHalf(int64_t n, int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<T> data(n);
+  for (auto& x : data) {
+    x = funcs::FloatToHalf<T>(dist(rng));
+  }
+  return data;
+}
+
+// C = alpha * op(A) * op(B) + beta * C in double, for the values of the
+// half operands.
+template <typename T>
+std::vector<double> ReferenceGemm(bool trans_a,
+                                  bool trans_b,
+                                  int M,
+                                  int N,
+                                  int K,
+                                  float alpha,
+                                  const std::vector<T>& A,
+                                  int lda,
+                                  const std::vector<T>& B,
+                                  int ldb,
+                                  float beta,
+                                  const std::vector<T>& C,
+                                  int ldc) {
+  std::vector<double> out(M * N);
+  for (int m = 0; m < M; ++m) {
+    for (int n = 0; n < N; ++n) {
+      double sum = 0;
+      for (int k = 0; k < K; ++k) {
+        const T& a = trans_a ? A[k * lda + m] : A[m * lda + k];
+        const T& b = trans_b ? B[n * ldb + k] : B[k * ldb + n];
+        sum += static_cast<double>(funcs::HalfToFloat(a)) *
+               funcs::HalfToFloat(b);
+      }
+      out[m * N + n] = alpha * sum + beta * funcs::HalfToFloat(C[m * ldc + n]);
+    }
+  }
+  return out;
+}
+
+template <typename T, typename Gemm>
+void CheckGemm(const Gemm& gemm, const std::string& name) {
+  const int shapes[][3] = {{1, 1, 1},
+                           {3, 5, 7},
+                           {8, 32, 2},
+                           {9, 33, 3},
+                           {100, 70, 513},
+                           {97, 1030, 600},
+                           {1, 300, 257},
+                           {200, 1, 40}};
+  for (const auto& shape : shapes) {
+    const int M = shape[0], N = shape[1], K = shape[2];
+    for (bool trans_a : {false, true}) {
+      for (bool trans_b : {false, true}) {
+        const int lda = (trans_a ? M : K) + 3;
+        const int ldb = (trans_b ? K : N) + 1;
+        const int ldc = N + 2;
+        auto A = RandomHalf<T>((trans_a ? K : M) * lda, 1);
+        auto B = RandomHalf<T>((trans_b ? N : K) * ldb, 2);
+        auto C = RandomHalf<T>(M * ldc, 3);
+        auto expected = ReferenceGemm(
+            trans_a, trans_b, M, N, K, 0.5f, A, lda, B, ldb, 2.0f, C, ldc);
+        gemm(trans_a,
+             trans_b,
+             M,
+             N,
+             K,
+             0.5f,
+             A.data(),
+             lda,
+             B.data(),
+             ldb,
+             2.0f,
+             C.data(),
+             ldc);
+        for (int m = 0; m < M; ++m) {
+          for (int n = 0; n < N; ++n) {
+            double e = expected[m * N + n];
+            ASSERT_NEAR(funcs::HalfToFloat(C[m * ldc + n]),
+                        e,
+                        1e-2 * (1 + std::fabs(e)))
+                << name << " " << M << "x" << N << "x" << K << " trans_a "
+                << trans_a << " trans_b " << trans_b;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(CPUHalf, gemm) {
+  CheckGemm<bf16>(funcs::HalfGemm<bf16>, "bf16");
+  CheckGemm<bf16>(funcs::HalfGemmByFloat<bf16>, "bf16 by float");
+  CheckGemm<fp16>(funcs::HalfGemm<fp16>, "fp16");
+  bf16 a = funcs::FloatToHalf<bf16>(1.0f);
+  bf16 c;
+  if (funcs::Bf16GemmAVX512(
+          false, false, 1, 1, 1, 1.0f, &a, 1, &a, 1, 0.0f, &c, 1)) {
+    CheckGemm<bf16>(funcs::Bf16GemmAVX512, "bf16 avx512");
+  } else {
+    VLOG(3) << "The CPU does not support AVX512-BF16.";
+  }
+}
+
+template <typename T>
+DenseTensor ToTensor(const std::vector<float>& data, const DDim& dims) {
+  DenseTensor t;
+  t.Resize(dims);
+  T* ptr = GetCPUContext().Alloc<T>(&t);
+  for (size_t i = 0; i < data.size(); ++i) {
+    ptr[i] = static_cast<T>(data[i]);
+  }
+  return t;
+}
+
+template <typename T>
+std::vector<float> ToFloat(const DenseTensor& t) {
+  std::vector<float> data(t.numel());
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    data[i] = static_cast<float>(t.data<T>()[i]);
+  }
+  return data;
+}
+
+// Random floats that are exact in bfloat16, so the float kernels see the
+// same inputs as the half ones.
+std::vector<float> RandomInput(int64_t n, int seed) {
+  auto half = RandomHalf<bf16>(n, seed);
+  std::vector<float> data(n);
+  funcs::HalfToFloat(half.data(), n, data.data());
+  return data;
+}
+
+// Runs the kernel on float and on T tensors of the same values.
+template <typename T, typename Kernel>
+void CheckKernel(const std::vector<std::vector<float>>& inputs,
+                 const std::vector<DDim>& dims,
+                 const DDim& out_dims,
+                 const Kernel& kernel,
+                 const std::string& name) {
+  std::vector<DenseTensor> float_inputs, half_inputs;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    float_inputs.push_back(ToTensor<float>(inputs[i], dims[i]));
+    half_inputs.push_back(ToTensor<T>(inputs[i], dims[i]));
+  }
+  DenseTensor float_out, half_out;
+  float_out.Resize(out_dims);
+  half_out.Resize(out_dims);
+  kernel(float(), float_inputs, &float_out);
+  kernel(T(), half_inputs, &half_out);
+  const double tolerance = std::is_same<T, bf16>::value ? 2e-2 : 2e-3;
+  ExpectNear(ToFloat<T>(half_out), ToFloat<float>(float_out), tolerance, name);
+}
+
+template <typename T>
+void CheckKernels() {
+  const auto& ctx = GetCPUContext();
+  const int64_t M = 37, N = 70, K = 129;
+  auto a = RandomInput(M * K, 1);
+  auto b = RandomInput(K * N, 2);
+  auto c = RandomInput(M * N, 3);
+  auto d = RandomInput(M * N, 4);
+  auto e = RandomInput(4 * K * N, 5);
+  auto f = RandomInput(4 * K * M, 6);
+
+  CheckKernel<T>(
+      {a, b},
+      {{M, K}, {K, N}},
+      {M, N},
+      [&](auto t, const std::vector<DenseTensor>& in, DenseTensor* out) {
+        using U = decltype(t);
+        MatmulKernel<U, CPUContext>(ctx, in[0], in[1], false, false, out);
+      },
+      "matmul");
+  CheckKernel<T>(
+      {e, f},
+      {{4, K, N}, {4, K, M}},
+      {4, N, M},
+      [&](auto t, const std::vector<DenseTensor>& in, DenseTensor* out) {
+        using U = decltype(t);
+        MatmulKernel<U, CPUContext>(ctx, in[0], in[1], true, false, out);
+      },
+      "batched matmul");
+  CheckKernel<T>(
+      {c, d},
+      {{M, N}, {M, N}},
+      {M, N},
+      [&](auto t, const std::vector<DenseTensor>& in, DenseTensor* out) {
+        AddKernel<decltype(t), CPUContext>(ctx, in[0], in[1], out);
+      },
+      "add");
+  CheckKernel<T>(
+      {c},
+      {{M, N}},
+      {M, N},
+      [&](auto t, const std::vector<DenseTensor>& in, DenseTensor* out) {
+        SiluKernel<decltype(t), CPUContext>(ctx, in[0], out);
+      },
+      "silu");
+  CheckKernel<T>(
+      {c},
+      {{M, N}},
+      {M, N},
+      [&](auto t, const std::vector<DenseTensor>& in, DenseTensor* out) {
+        GeluKernel<decltype(t), CPUContext>(ctx, in[0], false, out);
+      },
+      "gelu");
+  CheckKernel<T>(
+      {c, std::vector<float>(d.begin(), d.begin() + N), b},
+      {{M, N}, {N}, {N}},
+      {M, N},
+      [&](auto t, const std::vector<DenseTensor>& in, DenseTensor* out) {
+        DenseTensor mean, var;
+        mean.Resize({M});
+        var.Resize({M});
+        LayerNormKernel<decltype(t), CPUContext>(
+            ctx, in[0], in[1], in[2], 1e-5f, 1, out, &mean, &var);
+      },
+      "layer_norm");
+}
+
+TEST(CPUHalf, kernels_match_float) {
+  CheckKernels<bf16>();
+  CheckKernels<fp16>();
+}
+
+// Times the half precision matmuls against the float one on square matrices,
+// run it with --gtest_also_run_disabled_tests.
+TEST(CPUHalf, DISABLED_matmul_benchmark) {
+  const auto& ctx = GetCPUContext();
+  for (int64_t n : {128, 512, 1024}) {
+    auto a = RandomInput(n * n, 1);
+    auto b = RandomInput(n * n, 2);
+    auto run = [&](auto t, const std::string& name) {
+      using U = decltype(t);
+      auto x = ToTensor<U>(a, {n, n});
+      auto y = ToTensor<U>(b, {n, n});
+      DenseTensor out;
+      out.Resize({n, n});
+      MatmulKernel<U, CPUContext>(ctx, x, y, false, false, &out);
+      auto t0 = GetCurrentUS();
+      const int repeat = 3;
+      for (int i = 0; i < repeat; ++i) {
+        MatmulKernel<U, CPUContext>(ctx, x, y, false, false, &out);
+      }
+      double us = (GetCurrentUS() - t0) / repeat;
+      VLOG(3) << name << " matmul " << n << "x" << n << " takes " << us
+              << " us, " << 2.0 * n * n * n / us / 1e3 << " GFLOPS.";
+      return ToFloat<U>(out);
+    };
+    auto expected = run(float(), "float");
+    ExpectNear(run(bf16(), "bfloat16"), expected, 2e-2, "bfloat16 matmul");
+    ExpectNear(run(fp16(), "float16"), expected, 2e-3, "float16 matmul");
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,521 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
+#include "paddle/phi/kernels/funcs/norm_cpu_function.h"
+#include "paddle/phi/kernels/layer_norm_grad_kernel.h"
+#include "paddle/phi/kernels/layer_norm_kernel.h"
+#include "paddle/phi/kernels/rms_norm_grad_kernel.h"
+#include "paddle/phi/kernels/rms_norm_kernel.h"
+#include "test/cpp/phi/kernels/cpu_test_utils.h"
+
+namespace phi {
+namespace tests {
+
+using bf16 = phi::dtype::bfloat16;
+
+// Uniform values in [offset - 1, offset + 1) that are exact in bfloat16.
+std::vector<double> RandomData(int64_t n, double offset, int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<double> data(n);
+  for (auto& x : data) {
+    x = static_cast<float>(bf16(static_cast<float>(offset) + dist(rng)));
+  }
+  return data;
+}
+
+template <typename T>
+DenseTensor ToTensor(const std::vector<double>& data, const DDim& dims) {
+  DenseTensor t;
+  t.Resize(dims);
+  T* ptr = GetCPUContext().Alloc<T>(&t);
+  for (size_t i = 0; i < data.size(); ++i) {
+    ptr[i] = static_cast<T>(data[i]);
+  }
+  return t;
+}
+
+template <typename T>
+std::vector<double> ToDouble(const DenseTensor& t) {
+  std::vector<double> data(t.numel());
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    data[i] = static_cast<double>(t.data<T>()[i]);
+  }
+  return data;
+}
+
+// The forward and backward of a row normalization in double: y, the mean
+// and the rstd of each row, dx, dscale and dbias. rms skips the mean.
+struct NormReference {
+  std::vector<double> y, mean, var, rstd, dx, dscale, dbias;
+
+  NormReference(bool rms,
+                int64_t rows,
+                int64_t cols,
+                const std::vector<double>& h,
+                const std::vector<double>& scale,
+                const std::vector<double>& bias,
+                const std::vector<double>& dy,
+                double epsilon)
+      : y(rows * cols),
+        mean(rows),
+        var(rows),
+        rstd(rows),
+        dx(rows * cols),
+        dscale(cols),
+        dbias(cols) {
+    for (int64_t r = 0; r < rows; ++r) {
+      const double* row = h.data() + r * cols;
+      double m = 0;
+      for (int64_t j = 0; !rms && j < cols; ++j) {
+        m += row[j] / cols;
+      }
+      double v = 0;
+      for (int64_t j = 0; j < cols; ++j) {
+        v += (row[j] - m) * (row[j] - m) / cols;
+      }
+      const double s = 1 / std::sqrt(v + epsilon);
+      double mean_g = 0, mean_g_xhat = 0;
+      for (int64_t j = 0; j < cols; ++j) {
+        const double xhat = (row[j] - m) * s;
+        const double g = dy[r * cols + j] * scale[j];
+        y[r * cols + j] = xhat * scale[j] + bias[j];
+        dscale[j] += dy[r * cols + j] * xhat;
+        dbias[j] += dy[r * cols + j];
+        mean_g += rms ? 0 : g / cols;
+        mean_g_xhat += g * xhat / cols;
+      }
+      for (int64_t j = 0; j < cols; ++j) {
+        const double xhat = (row[j] - m) * s;
+        const double g = dy[r * cols + j] * scale[j];
+        dx[r * cols + j] = s * (g - mean_g - xhat * mean_g_xhat);
+      }
+      mean[r] = m;
+      var[r] = v;
+      rstd[r] = s;
+    }
+  }
+};
+
+const int64_t kShapes[][2] = {{1, 1}, {7, 3}, {5, 33}, {16, 768}, {3, 1000}};
+
+template <typename T>
+void CheckLayerNorm(double tolerance) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  const auto& ctx = GetCPUContext();
+  for (const auto& shape : kShapes) {
+    const int64_t rows = shape[0], cols = shape[1];
+    // A large mean checks that the variance is not lost to cancellation.
+    auto x = RandomData(rows * cols, 100.0, 1);
+    auto scale = RandomData(cols, 0.0, 2);
+    auto bias = RandomData(cols, 0.0, 3);
+    auto dy = RandomData(rows * cols, 0.0, 4);
+    NormReference ref(false, rows, cols, x, scale, bias, dy, 1e-5);
+
+    auto x_t = ToTensor<T>(x, {rows, cols});
+    auto scale_t = ToTensor<T>(scale, {cols});
+    auto bias_t = ToTensor<T>(bias, {cols});
+    DenseTensor y, mean, var;
+    y.Resize({rows, cols});
+    mean.Resize({rows});
+    var.Resize({rows});
+    LayerNormKernel<T, CPUContext>(
+        ctx, x_t, scale_t, bias_t, 1e-5f, 1, &y, &mean, &var);
+    const std::string name = "layer_norm " + std::to_string(rows) + "x" +
+                             std::to_string(cols) + " ";
+    ExpectNear(ToDouble<T>(y), ref.y, tolerance, name + "y");
+    ExpectNear(ToDouble<MT>(mean), ref.mean, tolerance, name + "mean");
+    // The variance is relative to the scale of the data.
+    ExpectNear(ToDouble<MT>(var), ref.var, 1e-4, name + "var");
+
+    auto dy_t = ToTensor<T>(dy, {rows, cols});
+    DenseTensor dx, dscale, dbias;
+    dx.Resize({rows, cols});
+    dscale.Resize({cols});
+    dbias.Resize({cols});
+    dscale.set_meta(scale_t.meta());
+    dbias.set_meta(bias_t.meta());
+    LayerNormGradKernel<T, CPUContext>(ctx,
+                                       x_t,
+                                       scale_t,
+                                       bias_t,
+                                       mean,
+                                       var,
+                                       dy_t,
+                                       1e-5f,
+                                       1,
+                                       &dx,
+                                       &dscale,
+                                       &dbias);
+    ExpectNear(ToDouble<T>(dx), ref.dx, tolerance, name + "dx");
+    ExpectNear(
+        ToDouble<T>(dscale), ref.dscale, tolerance * rows, name + "dscale");
+    ExpectNear(
+        ToDouble<T>(dbias), ref.dbias, tolerance * rows, name + "dbias");
+  }
+}
+
+TEST(CPUNorm, layer_norm) {
+  CheckLayerNorm<float>(1e-4);
+  CheckLayerNorm<double>(1e-9);
+  CheckLayerNorm<bf16>(2e-2);
+}
+
+template <typename T>
+void CheckRmsNorm(double tolerance) {
+  const auto& ctx = GetCPUContext();
+  for (const auto& shape : kShapes) {
+    const int64_t rows = shape[0], cols = shape[1];
+    auto x = RandomData(rows * cols, 0.5, 1);
+    auto residual = RandomData(rows * cols, 0.0, 2);
+    auto bias = RandomData(cols, 0.0, 3);
+    auto scale = RandomData(cols, 0.0, 4);
+    auto norm_bias = RandomData(cols, 0.0, 5);
+    auto dy = RandomData(rows * cols, 0.0, 6);
+    std::vector<double> h(rows * cols);
+    for (int64_t i = 0; i < rows * cols; ++i) {
+      h[i] = x[i] + residual[i] + bias[i % cols];
+    }
+    NormReference ref(true, rows, cols, h, scale, norm_bias, dy, 1e-6);
+
+    auto x_t = ToTensor<T>(x, {rows, cols});
+    auto residual_t = ToTensor<T>(residual, {rows, cols});
+    auto bias_t = ToTensor<T>(bias, {cols});
+    auto scale_t = ToTensor<T>(scale, {cols});
+    auto norm_bias_t = ToTensor<T>(norm_bias, {cols});
+    DenseTensor out, residual_out, inv_var;
+    out.Resize({rows, cols});
+    residual_out.Resize({rows, cols});
+    inv_var.Resize({rows});
+    RmsNormKernel<T, CPUContext>(ctx,
+                                 x_t,
+                                 bias_t,
+                                 residual_t,
+                                 scale_t,
+                                 norm_bias_t,
+                                 1e-6f,
+                                 1,
+                                 0.0f,
+                                 0,
+                                 0.0f,
+                                 0.0f,
+                                 &out,
+                                 &residual_out,
+                                 &inv_var);
+    const std::string name =
+        "rms_norm " + std::to_string(rows) + "x" + std::to_string(cols) + " ";
+    ExpectNear(ToDouble<T>(out), ref.y, tolerance, name + "out");
+    ExpectNear(ToDouble<T>(residual_out), h, tolerance, name + "residual_out");
+    ExpectNear(ToDouble<float>(inv_var),
+               ref.rstd,
+               std::max(tolerance, 1e-6),
+               name + "inv_var");
+
+    auto dy_t = ToTensor<T>(dy, {rows, cols});
+    DenseTensor dx, dscale, dnorm_bias;
+    dx.Resize({rows, cols});
+    dscale.Resize({cols});
+    dnorm_bias.Resize({cols});
+    RmsNormGradKernel<T, CPUContext>(ctx,
+                                     x_t,
+                                     bias_t,
+                                     residual_t,
+                                     scale_t,
+                                     norm_bias_t,
+                                     inv_var,
+                                     dy_t,
+                                     1e-6f,
+                                     1,
+                                     0.0f,
+                                     &dx,
+                                     &dscale,
+                                     &dnorm_bias);
+    ExpectNear(ToDouble<T>(dx), ref.dx, tolerance, name + "dx");
+    ExpectNear(
+        ToDouble<T>(dscale), ref.dscale, tolerance * rows, name + "dscale");
+    ExpectNear(ToDouble<T>(dnorm_bias),
+               ref.dbias,
+               tolerance * rows,
+               name + "dnorm_bias");
+  }
+}
+
+TEST(CPUNorm, rms_norm) {
+  CheckRmsNorm<float>(1e-4);
+  CheckRmsNorm<double>(1e-9);
+  CheckRmsNorm<phi::dtype::float16>(5e-3);
+}
+
+// The column sums of the backward are added in a fixed order, so repeated
+// runs, also with other numbers of threads, give the same bits.
+TEST(CPUNorm, grad_deterministic) {
+  const auto& ctx = GetCPUContext();
+  const int64_t rows = 1000, cols = 257;
+  auto x_t = ToTensor<float>(RandomData(rows * cols, 3.0, 1), {rows, cols});
+  auto scale_t = ToTensor<float>(RandomData(cols, 0.0, 2), {cols});
+  auto bias_t = ToTensor<float>(RandomData(cols, 0.0, 3), {cols});
+  auto dy_t = ToTensor<float>(RandomData(rows * cols, 0.0, 4), {rows, cols});
+  DenseTensor y, mean, var;
+  y.Resize({rows, cols});
+  mean.Resize({rows});
+  var.Resize({rows});
+  LayerNormKernel<float, CPUContext>(
+      ctx, x_t, scale_t, bias_t, 1e-5f, 1, &y, &mean, &var);
+  DenseTensor inv_var;
+  inv_var.Resize({rows});
+  RmsNormKernel<float, CPUContext>(ctx,
+                                   x_t,
+                                   paddle::none,
+                                   paddle::none,
+                                   scale_t,
+                                   bias_t,
+                                   1e-6f,
+                                   1,
+                                   0.0f,
+                                   0,
+                                   0.0f,
+                                   0.0f,
+                                   &y,
+                                   nullptr,
+                                   &inv_var);
+
+  // dx, dscale and dbias of layer_norm, then of rms_norm.
+  auto run = [&] {
+    DenseTensor dx, dscale, dbias;
+    dx.Resize({rows, cols});
+    dscale.Resize({cols});
+    dbias.Resize({cols});
+    dscale.set_meta(scale_t.meta());
+    dbias.set_meta(bias_t.meta());
+    LayerNormGradKernel<float, CPUContext>(ctx,
+                                           x_t,
+                                           scale_t,
+                                           bias_t,
+                                           mean,
+                                           var,
+                                           dy_t,
+                                           1e-5f,
+                                           1,
+                                           &dx,
+                                           &dscale,
+                                           &dbias);
+    std::vector<DenseTensor> grads = {dx, dscale, dbias};
+    DenseTensor rms_dx, rms_dscale, rms_dbias;
+    rms_dx.Resize({rows, cols});
+    rms_dscale.Resize({cols});
+    rms_dbias.Resize({cols});
+    RmsNormGradKernel<float, CPUContext>(ctx,
+                                         x_t,
+                                         paddle::none,
+                                         paddle::none,
+                                         scale_t,
+                                         bias_t,
+                                         inv_var,
+                                         dy_t,
+                                         1e-6f,
+                                         1,
+                                         0.0f,
+                                         &rms_dx,
+                                         &rms_dscale,
+                                         &rms_dbias);
+    grads.insert(grads.end(), {rms_dx, rms_dscale, rms_dbias});
+    return grads;
+  };
+  auto expect_same_bits = [](const std::vector<DenseTensor>& a,
+                             const std::vector<DenseTensor>& b) {
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+      ASSERT_EQ(a[i].numel(), b[i].numel());
+      EXPECT_EQ(std::memcmp(a[i].data<float>(),
+                            b[i].data<float>(),
+                            a[i].numel() * sizeof(float)),
+                0)
+          << "grad " << i;
+    }
+  };
+
+  const auto expected = run();
+  expect_same_bits(expected, run());
+#ifdef PADDLE_WITH_MKLML
+  const int max_threads = omp_get_max_threads();
+  for (int threads : {1, 3, 8}) {
+    omp_set_num_threads(threads);
+    expect_same_bits(expected, run());
+  }
+  omp_set_num_threads(max_threads);
+#endif
+}
+
+// The fused residual add with residual_alpha and the int8 quantization of
+// the output, which round like the GPU kernels.
+TEST(CPUNorm, fused_residual_quant) {
+  const int64_t rows = 9, cols = 300;
+  auto x = RandomData(rows * cols, 0.0, 1);
+  auto residual = RandomData(rows * cols, 0.0, 2);
+  auto bias = RandomData(cols, 0.0, 3);
+  auto scale = RandomData(cols, 1.0, 4);
+  std::vector<double> zero(cols), h(rows * cols);
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    h[i] = x[i] + 0.5 * residual[i] + bias[i % cols];
+  }
+  NormReference ref(false, rows, cols, h, scale, zero, h, 1e-5);
+
+  auto to_float = [](const std::vector<double>& data) {
+    return std::vector<float>(data.begin(), data.end());
+  };
+  auto xf = to_float(x), rf = to_float(residual), bf = to_float(bias),
+       sf = to_float(scale);
+  funcs::CPUNormArgs<float> args;
+  args.rows = rows;
+  args.cols = cols;
+  args.epsilon = 1e-5f;
+  args.x = xf.data();
+  args.residual = rf.data();
+  args.bias = bf.data();
+  args.residual_alpha = 0.5f;
+  args.scale = sf.data();
+  std::vector<float> residual_out(rows * cols), rstd(rows);
+  std::vector<int8_t> out(rows * cols);
+  for (int round_type : {0, 1}) {
+    funcs::CPUNormQuant quant{0.05f, round_type, 127.0f, -127.0f};
+    funcs::CPUNormForward<false>(
+        args, out.data(), &quant, [&](int64_t r, float, float, float s) {
+          rstd[r] = s;
+        });
+    for (int64_t i = 0; i < rows * cols; ++i) {
+      double value = 127.0 * 0.05 * ref.y[i];
+      value = round_type == 0 ? std::nearbyint(value) : std::round(value);
+      value = std::min(std::max(value, -127.0), 127.0);
+      // The float and the double result may round to neighbours.
+      ASSERT_NEAR(out[i], value, 1.0) << "round_type " << round_type;
+    }
+    ExpectNear(rstd, ref.rstd, 1e-4, "rstd");
+  }
+  args.residual_out = residual_out.data();
+  funcs::CPUNormForward<false>(args,
+                               static_cast<float*>(nullptr),
+                               nullptr,
+                               [](int64_t, float, float, float) {});
+  ExpectNear(residual_out, h, 1e-6, "residual_out");
+}
+
+// Times the norm kernels and the jit layer_norm on model sized rows, run it
+// with --gtest_also_run_disabled_tests.
+TEST(CPUNorm, DISABLED_benchmark) {
+  const auto& ctx = GetCPUContext();
+  for (auto shape : {std::vector<int64_t>{4096, 768},
+                     std::vector<int64_t>{1024, 4096},
+                     std::vector<int64_t>{4096, 100}}) {
+    const int64_t rows = shape[0], cols = shape[1];
+    auto x_t = ToTensor<float>(RandomData(rows * cols, 5.0, 1), {rows, cols});
+    auto scale_t = ToTensor<float>(RandomData(cols, 0.0, 2), {cols});
+    auto bias_t = ToTensor<float>(RandomData(cols, 0.0, 3), {cols});
+    DenseTensor y, mean, var;
+    y.Resize({rows, cols});
+    mean.Resize({rows});
+    var.Resize({rows});
+    auto time = [](const auto& f) {
+      f();
+      auto t0 = GetCurrentUS();
+      const int repeat = 5;
+      for (int i = 0; i < repeat; ++i) {
+        f();
+      }
+      return (GetCurrentUS() - t0) / repeat;
+    };
+    const double layer_norm_us = time([&] {
+      LayerNormKernel<float, CPUContext>(
+          ctx, x_t, scale_t, bias_t, 1e-5f, 1, &y, &mean, &var);
+    });
+    auto layer_norm_y = ToDouble<float>(y);
+    // The jit kernel the float layer_norm used before.
+    auto jit_layer_norm =
+        jit::KernelFuncs<jit::LayerNormTuple<float>, CPUPlace>::Cache().At(
+            static_cast<int>(cols));
+    std::vector<float> x_copy(x_t.data<float>(),
+                              x_t.data<float>() + rows * cols);
+    const double jit_us = time([&] {
+      jit_layer_norm(x_copy.data(),
+                     y.data<float>(),
+                     mean.data<float>(),
+                     var.data<float>(),
+                     scale_t.data<float>(),
+                     bias_t.data<float>(),
+                     static_cast<int>(rows),
+                     1e-5f,
+                     static_cast<int>(cols));
+    });
+    ExpectNear(ToDouble<float>(y), layer_norm_y, 1e-4, "jit layer_norm");
+    DenseTensor dx, dscale, dbias;
+    dx.Resize({rows, cols});
+    dscale.Resize({cols});
+    dbias.Resize({cols});
+    dscale.set_meta(scale_t.meta());
+    dbias.set_meta(bias_t.meta());
+    const double grad_us = time([&] {
+      LayerNormGradKernel<float, CPUContext>(ctx,
+                                             x_t,
+                                             scale_t,
+                                             bias_t,
+                                             mean,
+                                             var,
+                                             x_t,
+                                             1e-5f,
+                                             1,
+                                             &dx,
+                                             &dscale,
+                                             &dbias);
+    });
+    DenseTensor out, inv_var;
+    out.Resize({rows, cols});
+    inv_var.Resize({rows});
+    const double rms_norm_us = time([&] {
+      RmsNormKernel<float, CPUContext>(ctx,
+                                       x_t,
+                                       paddle::none,
+                                       paddle::none,
+                                       scale_t,
+                                       paddle::none,
+                                       1e-6f,
+                                       1,
+                                       0.0f,
+                                       0,
+                                       0.0f,
+                                       0.0f,
+                                       &out,
+                                       nullptr,
+                                       &inv_var);
+    });
+    VLOG(3) << rows << "x" << cols << ": layer_norm takes " << layer_norm_us
+            << " us, the jit layer_norm " << jit_us
+            << " us, layer_norm_grad " << grad_us << " us, rms_norm "
+            << rms_norm_us << " us.";
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,192 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/dropout_kernel.h"
+#include "paddle/phi/kernels/funcs/random_cpu_function.h"
+#include "paddle/phi/kernels/gaussian_kernel.h"
+#include "paddle/phi/kernels/uniform_kernel.h"
+#include "test/cpp/phi/kernels/cpu_test_utils.h"
+
+namespace phi {
+namespace tests {
+
+// Sets FLAGS_cpu_random_use_philox for the lifetime of the guard.
+class PhiloxGuard {
+ public:
+  explicit PhiloxGuard(bool use_philox) : old_(FLAGS_cpu_random_use_philox) {
+    FLAGS_cpu_random_use_philox = use_philox;
+  }
+  ~PhiloxGuard() { FLAGS_cpu_random_use_philox = old_; }
+
+ private:
+  bool old_;
+};
+
+std::vector<float> Uniform(int64_t numel, int seed) {
+  DenseTensor out;
+  UniformKernel<float, CPUContext>(
+      GetCPUContext(), {numel}, DataType::FLOAT32, -1.0f, 1.0f, seed, &out);
+  return std::vector<float>(out.data<float>(), out.data<float>() + numel);
+}
+
+TEST(CPURandom, philox_known_answer) {
+  // Philox-4x32-10 of counter 0 and key 0, from the Random123 test vectors.
+  uint32_t words[4][funcs::kPhiloxBatch];
+  funcs::PhiloxBatch(0, 0, words);
+  EXPECT_EQ(words[0][0], 0x6627e8d5u);
+  EXPECT_EQ(words[1][0], 0xe169c58du);
+  EXPECT_EQ(words[2][0], 0xbc57ac4cu);
+  EXPECT_EQ(words[3][0], 0x9b00dbd8u);
+
+  // A stream started at an offset is the tail of the stream started at 0.
+  const int64_t n = 1000;
+  std::vector<float> head(n), tail(n - 40);
+  funcs::PhiloxUniformForEach<float>(
+      5, 0, n, [&](int64_t i, float u) { head[i] = u; });
+  funcs::PhiloxUniformForEach<float>(
+      5, 10, n - 40, [&](int64_t i, float u) { tail[i] = u; });
+  for (int64_t i = 0; i < n - 40; ++i) {
+    ASSERT_EQ(head[i + 40], tail[i]);
+  }
+}
+
+TEST(CPURandom, philox_generator_state) {
+  PhiloxGuard guard(true);
+  auto* generator = GetCPUContext().GetGenerator();
+  generator->SetCurrentSeed(2025);
+  auto first = Uniform(1 << 16, 0);
+  auto second = Uniform(1 << 16, 0);
+  EXPECT_NE(first, second);
+  // Reseeding resets the offset and replays the same numbers.
+  generator->SetCurrentSeed(2025);
+  EXPECT_EQ(Uniform(1 << 16, 0), first);
+  // A fixed seed does not depend on nor advance the generator.
+  auto offset = generator->GetCurrentOffset();
+  EXPECT_EQ(Uniform(1000, 7), Uniform(1000, 7));
+  EXPECT_EQ(generator->GetCurrentOffset(), offset);
+
+  double sum = 0;
+  for (float v : first) {
+    ASSERT_GE(v, -1.0f);
+    ASSERT_LT(v, 1.0f);
+    sum += v;
+  }
+  EXPECT_NEAR(sum / first.size(), 0.0, 0.02);
+}
+
+TEST(CPURandom, philox_distributions) {
+  PhiloxGuard guard(true);
+  const int64_t numel = 1 << 20;
+  DenseTensor normal;
+  GaussianKernel<double, CPUContext>(
+      GetCPUContext(), {numel}, 1.0f, 2.0f, 0, DataType::FLOAT64, &normal);
+  double sum = 0, square_sum = 0;
+  for (int64_t i = 0; i < numel; ++i) {
+    sum += normal.data<double>()[i];
+    square_sum += normal.data<double>()[i] * normal.data<double>()[i];
+  }
+  const double mean = sum / numel;
+  EXPECT_NEAR(mean, 1.0, 0.01);
+  EXPECT_NEAR(std::sqrt(square_sum / numel - mean * mean), 2.0, 0.01);
+
+  DenseTensor x, out, mask;
+  x.Resize({numel});
+  float* x_data = GetCPUContext().Alloc<float>(&x);
+  std::fill(x_data, x_data + numel, 1.0f);
+  out.Resize(x.dims());
+  mask.Resize(x.dims());
+  DropoutRawKernel<float, CPUContext>(GetCPUContext(),
+                                      x,
+                                      paddle::none,
+                                      0.3f,
+                                      false,
+                                      "upscale_in_train",
+                                      0,
+                                      false,
+                                      &out,
+                                      &mask);
+  int64_t kept = 0;
+  for (int64_t i = 0; i < numel; ++i) {
+    kept += mask.data<uint8_t>()[i];
+    ASSERT_FLOAT_EQ(out.data<float>()[i], mask.data<uint8_t>()[i] / 0.7f);
+  }
+  EXPECT_NEAR(static_cast<double>(kept) / numel, 0.7, 0.005);
+}
+
+// Runs dropout, uniform and gaussian on numel floats with either generator,
+// logs their times and checks the means of their outputs within tolerance.
+void RunRandomKernels(int64_t numel, bool use_philox, double tolerance) {
+  DenseTensor x, out, mask, uniform, normal;
+  x.Resize({numel});
+  float* x_data = GetCPUContext().Alloc<float>(&x);
+  std::fill(x_data, x_data + numel, 1.0f);
+  out.Resize(x.dims());
+  mask.Resize(x.dims());
+  auto Mean = [numel](const auto* data) {
+    double sum = 0;
+    for (int64_t i = 0; i < numel; ++i) {
+      sum += data[i];
+    }
+    return sum / numel;
+  };
+  PhiloxGuard guard(use_philox);
+  auto t0 = GetCurrentUS();
+  DropoutRawKernel<float, CPUContext>(GetCPUContext(),
+                                      x,
+                                      paddle::none,
+                                      0.5f,
+                                      false,
+                                      "upscale_in_train",
+                                      0,
+                                      false,
+                                      &out,
+                                      &mask);
+  auto t1 = GetCurrentUS();
+  UniformKernel<float, CPUContext>(
+      GetCPUContext(), {numel}, DataType::FLOAT32, 0.0f, 1.0f, 0, &uniform);
+  auto t2 = GetCurrentUS();
+  GaussianKernel<float, CPUContext>(
+      GetCPUContext(), {numel}, 0.0f, 1.0f, 0, DataType::FLOAT32, &normal);
+  auto t3 = GetCurrentUS();
+  VLOG(3) << (use_philox ? "philox" : "mt19937_64") << " on " << numel
+          << " floats: dropout takes " << t1 - t0 << " us, uniform takes "
+          << t2 - t1 << " us, gaussian takes " << t3 - t2 << " us.";
+  EXPECT_NEAR(Mean(mask.data<uint8_t>()), 0.5, tolerance);
+  EXPECT_NEAR(Mean(uniform.data<float>()), 0.5, tolerance);
+  EXPECT_NEAR(Mean(normal.data<float>()), 0.0, 2 * tolerance);
+}
+
+// Both generators give the requested distributions.
+TEST(CPURandom, both_generators) {
+  for (bool use_philox : {false, true}) {
+    RunRandomKernels(1 << 16, use_philox, 0.01);
+  }
+}
+
+// Times the generators on larger tensors, run it with
+// --gtest_also_run_disabled_tests.
+TEST(CPURandom, DISABLED_benchmark) {
+  for (bool use_philox : {false, true}) {
+    RunRandomKernels(1 << 22, use_philox, 0.005);
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,225 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/funcs/reduce_cpu_function.h"
+#include "paddle/phi/kernels/funcs/reduce_function.h"
+#include "paddle/phi/kernels/funcs/reduce_functor.h"
+#include "paddle/phi/kernels/logsumexp_kernel.h"
+#include "paddle/phi/kernels/reduce_max_kernel.h"
+#include "paddle/phi/kernels/reduce_sum_kernel.h"
+#include "test/cpp/phi/kernels/cpu_test_utils.h"
+
+namespace phi {
+namespace tests {
+
+struct ReduceCase {
+  std::vector<int64_t> dims;
+  std::vector<int64_t> axes;
+};
+
+std::vector<ReduceCase> ReduceCases() {
+  return {{{1 << 20}, {0}},
+          {{3, 300000}, {1}},
+          {{300000, 3}, {0}},
+          {{2048, 2048}, {0}},
+          {{2048, 2048}, {1}},
+          {{64, 128, 33}, {0, 2}},
+          {{8, 16, 32, 64}, {0, 2, 3}},
+          {{8, 16, 32, 64}, {-3, -1}},
+          {{2, 3, 1, 4, 5}, {2}},
+          {{4, 5, 6}, {0, 1, 2}}};
+}
+
+// Reduces x over axes in double with f, element by element.
+template <typename F>
+std::vector<double> ReferenceReduce(const std::vector<float>& x,
+                                    const ReduceCase& c,
+                                    double init,
+                                    const F& f) {
+  const int rank = static_cast<int>(c.dims.size());
+  std::vector<bool> reduced(rank, false);
+  for (int64_t axis : c.axes) {
+    reduced[axis < 0 ? axis + rank : axis] = true;
+  }
+  int64_t out_numel = 1;
+  for (int i = 0; i < rank; ++i) {
+    out_numel *= reduced[i] ? 1 : c.dims[i];
+  }
+  std::vector<double> out(out_numel, init);
+  std::vector<int64_t> index(rank, 0);
+  for (float v : x) {
+    int64_t o = 0;
+    for (int i = 0; i < rank; ++i) {
+      o = reduced[i] ? o : o * c.dims[i] + index[i];
+    }
+    out[o] = f(out[o], static_cast<double>(v));
+    for (int i = rank - 1; i >= 0 && ++index[i] == c.dims[i]; --i) {
+      index[i] = 0;
+    }
+  }
+  return out;
+}
+
+TEST(CPUReduce, sum_max_logsumexp) {
+  std::mt19937 rng(2025);
+  for (const auto& c : ReduceCases()) {
+    DenseTensor x = RandomTensor(make_ddim(c.dims), &rng);
+    std::vector<float> data(x.data<float>(), x.data<float>() + x.numel());
+    auto sum = ReferenceReduce(
+        data, c, 0.0, [](double a, double b) { return a + b; });
+    auto max = ReferenceReduce(data,
+                               c,
+                               -std::numeric_limits<double>::infinity(),
+                               [](double a, double b) {
+                                 return std::max(a, b);
+                               });
+    auto exp_sum = ReferenceReduce(
+        data, c, 0.0, [](double a, double b) { return a + std::exp(b); });
+
+    DenseTensor sum_out, max_out, lse_out;
+    for (auto* out : {&sum_out, &max_out, &lse_out}) {
+      out->Resize({static_cast<int64_t>(sum.size())});
+    }
+    SumKernel<float, CPUContext>(
+        GetCPUContext(), x, c.axes, DataType::FLOAT32, false, &sum_out);
+    MaxKernel<float, CPUContext>(GetCPUContext(), x, c.axes, false, &max_out);
+    std::vector<int> axes(c.axes.begin(), c.axes.end());
+    LogsumexpKernel<float, CPUContext>(
+        GetCPUContext(), x, axes, false, false, &lse_out);
+    for (size_t i = 0; i < sum.size(); ++i) {
+      ASSERT_NEAR(sum_out.data<float>()[i],
+                  sum[i],
+                  1e-4 * std::max(1.0, std::abs(sum[i])));
+      ASSERT_EQ(max_out.data<float>()[i], static_cast<float>(max[i]));
+      const double lse = std::log(exp_sum[i]);
+      ASSERT_NEAR(lse_out.data<float>()[i], lse, 1e-4 * std::max(1.0, lse));
+    }
+  }
+}
+
+TEST(CPUReduce, sum_mode) {
+  const int64_t n = 10000000;
+  std::vector<float> x(n, 0.1f);
+  float pairwise = 0.f, kahan = 0.f;
+  funcs::ReduceCPU(funcs::CPUSumOp<float>(),
+                   x.data(),
+                   1,
+                   n,
+                   1,
+                   &pairwise,
+                   funcs::CPUSumMode::kPairwise);
+  funcs::ReduceCPU(funcs::CPUSumOp<float>(),
+                   x.data(),
+                   1,
+                   n,
+                   1,
+                   &kahan,
+                   funcs::CPUSumMode::kKahan);
+  EXPECT_NEAR(pairwise, 1e6, 1.0);
+  EXPECT_NEAR(kahan, 1e6, 0.1);
+
+  std::vector<float> special = {1.f, std::nanf(""), 3.f};
+  float max = 0.f;
+  funcs::ReduceCPU(funcs::CPUMaxOp<float>(), special.data(), 1, 3, 1, &max);
+  EXPECT_TRUE(std::isnan(max));
+}
+
+// The chunks of a split reduced dim only depend on the shape, so sums with
+// other numbers of threads give the same bits.
+TEST(CPUReduce, thread_independent) {
+  std::mt19937 rng(2025);
+  const std::vector<ReduceCase> cases = {{{1 << 22}, {0}},
+                                         {{3, 1 << 20}, {1}},
+                                         {{1 << 20, 3}, {0}},
+                                         {{2048, 2048}, {0}},
+                                         {{64, 128, 33}, {0, 2}}};
+  for (const auto& c : cases) {
+    DenseTensor x = RandomTensor(make_ddim(c.dims), &rng);
+    int64_t out_numel = x.numel();
+    for (int64_t axis : c.axes) {
+      out_numel /= c.dims[axis < 0 ? axis + c.dims.size() : axis];
+    }
+    auto sum = [&] {
+      DenseTensor out;
+      out.Resize({out_numel});
+      SumKernel<float, CPUContext>(
+          GetCPUContext(), x, c.axes, DataType::FLOAT32, false, &out);
+      return std::vector<float>(out.data<float>(),
+                                out.data<float>() + out.numel());
+    };
+    const auto expected = sum();
+#ifdef PADDLE_WITH_MKLML
+    const int max_threads = omp_get_max_threads();
+    for (int threads : {1, 3, 8}) {
+      omp_set_num_threads(threads);
+      const auto actual = sum();
+      ASSERT_EQ(actual.size(), expected.size());
+      EXPECT_EQ(std::memcmp(actual.data(),
+                            expected.data(),
+                            expected.size() * sizeof(float)),
+                0)
+          << x.dims() << " with " << threads << " threads";
+    }
+    omp_set_num_threads(max_threads);
+#else
+    EXPECT_EQ(sum(), expected);
+#endif
+  }
+}
+
+// Times ReduceCPU against the Eigen reduction, run it with
+// --gtest_also_run_disabled_tests.
+TEST(CPUReduce, DISABLED_benchmark) {
+  std::mt19937 rng(2025);
+  for (const auto& c : ReduceCases()) {
+    DenseTensor x = RandomTensor(make_ddim(c.dims), &rng);
+    DenseTensor out, eigen_out;
+    int64_t out_numel = x.numel();
+    for (int64_t axis : c.axes) {
+      out_numel /= c.dims[axis < 0 ? axis + c.dims.size() : axis];
+    }
+    out.Resize({out_numel});
+    eigen_out.Resize({out_numel});
+
+    auto t0 = GetCurrentUS();
+    SumKernel<float, CPUContext>(
+        GetCPUContext(), x, c.axes, DataType::FLOAT32, false, &out);
+    auto t1 = GetCurrentUS();
+    const bool reduce_all = c.axes.size() == c.dims.size();
+    funcs::ReduceKernelImpl<CPUContext, float, float, funcs::SumFunctor>(
+        GetCPUContext(), x, &eigen_out, c.axes, false, reduce_all);
+    auto t2 = GetCurrentUS();
+    VLOG(3) << "sum of " << x.dims() << " over " << c.axes.size()
+            << " axes: ReduceCPU takes " << t1 - t0
+            << " us, the Eigen reduction takes " << t2 - t1 << " us.";
+    for (int64_t i = 0; i < out_numel; ++i) {
+      ASSERT_NEAR(out.data<float>()[i], eigen_out.data<float>()[i], 1e-2);
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
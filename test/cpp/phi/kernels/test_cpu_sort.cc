@@ -0,0 +1,283 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/argsort_kernel.h"
+#include "paddle/phi/kernels/funcs/cpu_sort.h"
+#include "paddle/phi/kernels/funcs/row_segments.h"
+#include "paddle/phi/kernels/unique_kernel.h"
+#include "test/cpp/phi/kernels/cpu_test_utils.h"
+
+namespace phi {
+namespace tests {
+
+// Random floats with many duplicates, signed zeros and NaNs.
+std::vector<float> RandomFloats(int64_t n, std::mt19937* rng) {
+  std::uniform_int_distribution<int> dist(-1000, 1000);
+  std::vector<float> data(n);
+  for (int64_t i = 0; i < n; ++i) {
+    int v = dist(*rng);
+    if (v == 1000) {
+      data[i] = std::numeric_limits<float>::quiet_NaN();
+    } else if (v == -1000) {
+      data[i] = -std::numeric_limits<float>::quiet_NaN();
+    } else if (v == 999) {
+      data[i] = -0.f;
+    } else {
+      data[i] = static_cast<float>(v) / 8;
+    }
+  }
+  return data;
+}
+
+TEST(CPUSort, sort_pairs_float) {
+  std::mt19937 rng(2025);
+  for (int64_t n : {0, 1, 100, 1000, 300000}) {
+    for (bool descending : {false, true}) {
+      std::vector<float> keys = RandomFloats(n, &rng);
+      std::vector<int64_t> values(n);
+      std::vector<std::pair<float, int64_t>> ref(n);
+      for (int64_t i = 0; i < n; ++i) {
+        values[i] = i;
+        ref[i] = std::make_pair(keys[i], i);
+      }
+      funcs::SortOrder<float> order(descending);
+      std::stable_sort(
+          ref.begin(), ref.end(), [&](const auto& a, const auto& b) {
+            return order(a.first, b.first);
+          });
+      funcs::SortPairs(keys.data(), values.data(), n, descending);
+      for (int64_t i = 0; i < n; ++i) {
+        ASSERT_EQ(values[i], ref[i].second);
+        ASSERT_TRUE(funcs::SameSortKey(keys[i], ref[i].first));
+      }
+    }
+  }
+}
+
+TEST(CPUSort, top_k) {
+  std::mt19937 rng(2025);
+  for (int64_t n : {1, 100, 5000, 300000}) {
+    for (int64_t k : {1, 10, 64}) {
+      if (k > n) {
+        continue;
+      }
+      for (bool largest : {false, true}) {
+        std::vector<float> data = RandomFloats(n, &rng);
+        std::vector<std::pair<float, int64_t>> ref(n);
+        for (int64_t i = 0; i < n; ++i) {
+          ref[i] = std::make_pair(data[i], i);
+        }
+        funcs::SortOrder<float> order(largest);
+        std::stable_sort(
+            ref.begin(), ref.end(), [&](const auto& a, const auto& b) {
+              return order(a.first, b.first);
+            });
+        std::vector<float> values(k);
+        std::vector<int64_t> indices(k);
+        funcs::TopK(
+            data.data(), n, k, largest, values.data(), indices.data());
+        for (int64_t i = 0; i < k; ++i) {
+          ASSERT_EQ(indices[i], ref[i].second)
+              << "n = " << n << ", k = " << k << ", i = " << i;
+        }
+      }
+    }
+  }
+
+  const int64_t vocab = 1 << 20, k = 8;
+  std::vector<float> logits(vocab);
+  std::uniform_real_distribution<float> uniform_dist(-1.f, 1.f);
+  for (auto& v : logits) {
+    v = uniform_dist(rng);
+  }
+  std::vector<float> values(k);
+  std::vector<int64_t> indices(k);
+  auto t0 = GetCurrentUS();
+  funcs::TopK(logits.data(), vocab, k, true, values.data(), indices.data());
+  auto t1 = GetCurrentUS();
+  std::vector<std::pair<float, int64_t>> pairs(vocab);
+  for (int64_t i = 0; i < vocab; ++i) {
+    pairs[i] = std::make_pair(logits[i], i);
+  }
+  std::partial_sort(pairs.begin(),
+                    pairs.begin() + k,
+                    pairs.end(),
+                    [](const auto& a, const auto& b) {
+                      return a.first > b.first;
+                    });
+  auto t2 = GetCurrentUS();
+  for (int64_t i = 0; i < k; ++i) {
+    ASSERT_EQ(indices[i], pairs[i].second);
+  }
+  VLOG(3) << "top " << k << " of " << vocab << ": TopK takes " << t1 - t0
+          << " us, partial_sort takes " << t2 - t1 << " us.";
+}
+
+TEST(CPUSort, segment_starts) {
+  std::vector<int> data = {1, 1, 2, 3, 3, 3, 1};
+  auto starts = funcs::SegmentStarts(static_cast<int64_t>(data.size()),
+                                     [&](int64_t i) {
+                                       return data[i] != data[i - 1];
+                                     });
+  EXPECT_EQ(starts, (std::vector<int64_t>{0, 2, 3, 6, 7}));
+  EXPECT_EQ(funcs::SegmentStarts(0, [](int64_t) { return true; }),
+            (std::vector<int64_t>{0}));
+}
+
+TEST(CPUSort, segmented_row_sum) {
+  const int64_t n = 200000, vocab = 1000, width = 4, padding_idx = 7;
+  std::mt19937 rng(2025);
+  std::uniform_int_distribution<int64_t> dist(0, vocab - 1);
+  std::vector<int64_t> ids(n);
+  std::vector<float> src(n * width);
+  std::map<int64_t, std::vector<float>> ref;
+  for (int64_t i = 0; i < n; ++i) {
+    ids[i] = dist(rng);
+    for (int64_t j = 0; j < width; ++j) {
+      src[i * width + j] = static_cast<float>((i + j) % 5);
+    }
+    if (ids[i] == padding_idx) {
+      continue;
+    }
+    auto& row = ref[ids[i]];
+    row.resize(width, 0.f);
+    for (int64_t j = 0; j < width; ++j) {
+      row[j] += src[i * width + j];
+    }
+  }
+
+  auto segments = funcs::GroupRows(ids.data(), n, padding_idx);
+  ASSERT_EQ(segments.size(), static_cast<int64_t>(ref.size()));
+  std::vector<float> dst(segments.size() * width);
+  funcs::SegmentedRowSum<float>(
+      segments,
+      width,
+      [&](int64_t p) { return src.data() + p * width; },
+      [&](int64_t g) { return dst.data() + g * width; });
+  int64_t g = 0;
+  for (const auto& item : ref) {
+    ASSERT_EQ(segments.rows[g], item.first);
+    for (int64_t j = 0; j < width; ++j) {
+      ASSERT_EQ(dst[g * width + j], item.second[j]);
+    }
+    ++g;
+  }
+}
+
+TEST(CPUSort, argsort_kernel) {
+  const int64_t rows = 4, cols = 3000;
+  std::mt19937 rng(2025);
+  std::vector<float> data = RandomFloats(rows * cols, &rng);
+  DenseTensor x;
+  x.Resize({rows, cols});
+  float* x_data = GetCPUContext().Alloc<float>(&x);
+  std::copy(data.begin(), data.end(), x_data);
+
+  for (bool descending : {false, true}) {
+    DenseTensor out, indices;
+    out.Resize({rows, cols});
+    indices.Resize({rows, cols});
+    ArgsortKernel<float, CPUContext>(
+        GetCPUContext(), x, -1, descending, true, &out, &indices);
+    funcs::SortOrder<float> order(descending);
+    for (int64_t r = 0; r < rows; ++r) {
+      std::vector<int64_t> ref(cols);
+      std::iota(ref.begin(), ref.end(), 0);
+      std::stable_sort(ref.begin(), ref.end(), [&](int64_t a, int64_t b) {
+        return order(data[r * cols + a], data[r * cols + b]);
+      });
+      for (int64_t c = 0; c < cols; ++c) {
+        ASSERT_EQ(indices.data<int64_t>()[r * cols + c], ref[c]);
+      }
+    }
+  }
+}
+
+TEST(CPUSort, unique_kernel) {
+  const int64_t n = 1000000;
+  std::mt19937 rng(2025);
+  std::uniform_int_distribution<int64_t> dist(0, 50000);
+  DenseTensor x;
+  x.Resize({n});
+  int64_t* x_data = GetCPUContext().Alloc<int64_t>(&x);
+  std::map<int64_t, std::pair<int64_t, int64_t>> ref;  // first, count
+  for (int64_t i = 0; i < n; ++i) {
+    x_data[i] = dist(rng) * 1000003;
+    auto it = ref.emplace(x_data[i], std::make_pair(i, 0)).first;
+    ++it->second.second;
+  }
+
+  DenseTensor out, indices, inverse, counts;
+  auto t0 = GetCurrentUS();
+  UniqueRawKernel<int64_t, CPUContext>(GetCPUContext(),
+                                       x,
+                                       true,
+                                       true,
+                                       true,
+                                       {},
+                                       DataType::INT64,
+                                       true,
+                                       &out,
+                                       &indices,
+                                       &inverse,
+                                       &counts);
+  auto t1 = GetCurrentUS();
+  VLOG(3) << "unique of " << n << " ids takes " << t1 - t0 << " us.";
+
+  ASSERT_EQ(out.numel(), static_cast<int64_t>(ref.size()));
+  int64_t g = 0;
+  for (const auto& item : ref) {
+    ASSERT_EQ(out.data<int64_t>()[g], item.first);
+    ASSERT_EQ(indices.data<int64_t>()[g], item.second.first);
+    ASSERT_EQ(counts.data<int64_t>()[g], item.second.second);
+    ++g;
+  }
+  for (int64_t i = 0; i < n; ++i) {
+    ASSERT_EQ(out.data<int64_t>()[inverse.data<int64_t>()[i]], x_data[i]);
+  }
+
+  // Without sorting the unique elements are in the order of their first
+  // occurrences.
+  DenseTensor unsorted_out, unsorted_inverse, unsorted_counts;
+  UniqueRawKernel<int64_t, CPUContext>(GetCPUContext(),
+                                       x,
+                                       false,
+                                       true,
+                                       true,
+                                       {},
+                                       DataType::INT64,
+                                       false,
+                                       &unsorted_out,
+                                       nullptr,
+                                       &unsorted_inverse,
+                                       &unsorted_counts);
+  ASSERT_EQ(unsorted_out.numel(), static_cast<int64_t>(ref.size()));
+  std::map<int64_t, int64_t> seen;
+  for (int64_t i = 0; i < n; ++i) {
+    auto it = seen.emplace(x_data[i], static_cast<int64_t>(seen.size())).first;
+    ASSERT_EQ(unsorted_inverse.data<int64_t>()[i], it->second);
+    ASSERT_EQ(unsorted_out.data<int64_t>()[it->second], x_data[i]);
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
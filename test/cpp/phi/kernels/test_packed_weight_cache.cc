@@ -0,0 +1,228 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/kernels/funcs/blas/packed_weight_cache.h"
+#include "paddle/phi/kernels/funcs/fc_functor.h"
+#include "test/cpp/phi/kernels/cpu_test_utils.h"
+
+COMMON_DECLARE_bool(use_packed_weight_cache);
+
+namespace phi {
+namespace tests {
+
+constexpr int repeat = 100;
+
+// out[M, N] = x[M, K] * w, where w is [K, N], or [N, K] if trans.
+void RefMatMul(const float* x,
+               const float* w,
+               bool trans,
+               int M,
+               int N,
+               int K,
+               std::vector<float>* out) {
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      double sum = 0;
+      for (int k = 0; k < K; ++k) {
+        sum += x[i * K + k] * (trans ? w[j * K + k] : w[k * N + j]);
+      }
+      (*out)[i * N + j] = static_cast<float>(sum);
+    }
+  }
+}
+
+TEST(PackedWeightCache, fc_small_batch) {
+  auto& cache = funcs::PackedWeightCache::Instance();
+  cache.Clear();
+  const int N = 1024, K = 1024;
+  DenseTensor w = RandomTensor({K, N}, 100);
+  cache.RegisterConstant(w);
+  EXPECT_EQ(cache.IsConstant(w.data()), funcs::PackedWeightCache::IsEnabled());
+
+  funcs::FCFunctor<CPUContext, float> fc;
+  for (int M : {1, 4, 16, 64}) {
+    DenseTensor x = RandomTensor({M, K}, M);
+    std::vector<float> out(M * N), ref(M * N);
+    RefMatMul(x.data<float>(), w.data<float>(), false, M, N, K, &ref);
+
+    FLAGS_use_packed_weight_cache = false;
+    auto t0 = GetCurrentUS();
+    for (int i = 0; i < repeat; ++i) {
+      fc(GetCPUContext(),
+         M,
+         N,
+         K,
+         x.data<float>(),
+         w.data<float>(),
+         out.data(),
+         nullptr);
+    }
+    auto t1 = GetCurrentUS();
+    ExpectNear(out, ref, 1e-4);
+
+    FLAGS_use_packed_weight_cache = true;
+    auto t2 = GetCurrentUS();
+    for (int i = 0; i < repeat; ++i) {
+      fc(GetCPUContext(),
+         M,
+         N,
+         K,
+         x.data<float>(),
+         w.data<float>(),
+         out.data(),
+         nullptr);
+    }
+    auto t3 = GetCurrentUS();
+    ExpectNear(out, ref, 1e-4);
+
+    VLOG(3) << "fc of [" << M << ", " << K << "] x [" << K << ", " << N
+            << "]: gemm takes " << (t1 - t0) / repeat
+            << " us, packed gemm takes " << (t3 - t2) / repeat << " us.";
+  }
+  EXPECT_EQ(cache.Size(), funcs::PackedWeightCache::IsEnabled() ? 1UL : 0UL);
+  cache.Clear();
+}
+
+TEST(PackedWeightCache, invalidation) {
+  auto& cache = funcs::PackedWeightCache::Instance();
+  cache.Clear();
+  const int M = 3, N = 17, K = 33;
+  DenseTensor x = RandomTensor({M, K}, 1);
+  DenseTensor w = RandomTensor({N, K}, 2);
+  std::vector<float> ref(M * N);
+  std::vector<float> out(M * N);
+  cache.RegisterConstant(w);
+  if (!funcs::PackedWeightCache::IsEnabled()) {
+    EXPECT_FALSE(funcs::PackedGEMM<float>(GetCPUContext(),
+                                          true,
+                                          M,
+                                          N,
+                                          K,
+                                          x.data<float>(),
+                                          w.data<float>(),
+                                          0.f,
+                                          out.data()));
+    return;
+  }
+
+  auto run = [&]() {
+    ASSERT_TRUE(funcs::PackedGEMM<float>(GetCPUContext(),
+                                         true,
+                                         M,
+                                         N,
+                                         K,
+                                         x.data<float>(),
+                                         w.data<float>(),
+                                         0.f,
+                                         out.data()));
+    RefMatMul(x.data<float>(), w.data<float>(), true, M, N, K, &ref);
+    ExpectNear(out, ref, 1e-4);
+  };
+  run();
+  EXPECT_EQ(cache.Size(), 1UL);
+
+  // An inplace write that bumps the version repacks the weight.
+  w.data<float>()[0] += 1.f;
+  w.InplaceVersionCounter().Bump();
+  run();
+
+  // An inplace write that does not bump the version needs Invalidate, which
+  // also unregisters the weight.
+  cache.Invalidate(w.data());
+  EXPECT_FALSE(cache.IsConstant(w.data()));
+  EXPECT_FALSE(funcs::PackedGEMM<float>(GetCPUContext(),
+                                        true,
+                                        M,
+                                        N,
+                                        K,
+                                        x.data<float>(),
+                                        w.data<float>(),
+                                        0.f,
+                                        out.data()));
+
+  // Freeing the weight releases the packed weight.
+  cache.RegisterConstant(w);
+  run();
+  const void* data = w.data();
+  w.clear();
+  EXPECT_FALSE(cache.IsConstant(data));
+  cache.ReleaseExpired();
+  EXPECT_EQ(cache.Size(), 0UL);
+}
+
+TEST(PackedWeightCache, concurrent_get) {
+  auto& cache = funcs::PackedWeightCache::Instance();
+  cache.Clear();
+  if (!funcs::PackedWeightCache::IsEnabled()) {
+    return;
+  }
+  const int M = 2, N = 64, K = 96;
+  const int num_threads = 8;
+  DenseTensor x = RandomTensor({M, K}, 1);
+  DenseTensor w0 = RandomTensor({K, N}, 2);
+  DenseTensor w1 = RandomTensor({K, N}, 3);
+  cache.RegisterConstant(w0);
+  cache.RegisterConstant(w1);
+  std::vector<float> ref0(M * N), ref1(M * N);
+  RefMatMul(x.data<float>(), w0.data<float>(), false, M, N, K, &ref0);
+  RefMatMul(x.data<float>(), w1.data<float>(), false, M, N, K, &ref1);
+
+  // The threads race to pack the weights on the first calls, and share the
+  // cached packed weights afterwards.
+  std::vector<std::vector<float>> outs(num_threads,
+                                       std::vector<float>(2 * M * N));
+  std::vector<int> num_packed(num_threads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < repeat; ++i) {
+        const DenseTensor& w = (i + t) % 2 ? w1 : w0;
+        num_packed[t] += funcs::PackedGEMM<float>(
+            GetCPUContext(),
+            false,
+            M,
+            N,
+            K,
+            x.data<float>(),
+            w.data<float>(),
+            0.f,
+            outs[t].data() + ((i + t) % 2) * M * N);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < num_threads; ++t) {
+    EXPECT_EQ(num_packed[t], repeat);
+    ExpectNear(outs[t].data(), ref0.data(), ref0.size(), 1e-4);
+    ExpectNear(outs[t].data() + M * N, ref1.data(), ref1.size(), 1e-4);
+  }
+  EXPECT_EQ(cache.Size(), 2UL);
+  auto packed =
+      cache.Get<float>(GetCPUContext(), w0.data<float>(), false, N, K);
+  EXPECT_EQ(packed,
+            cache.Get<float>(GetCPUContext(), w0.data<float>(), false, N, K));
+  cache.Clear();
+}
+
+}  // namespace tests
+}  // namespace phi
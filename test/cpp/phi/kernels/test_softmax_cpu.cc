@@ -0,0 +1,170 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/funcs/softmax.h"
+#include "test/cpp/phi/kernels/cpu_test_utils.h"
+
+namespace phi {
+namespace tests {
+
+constexpr int repeat = 10;
+
+template <typename T>
+void RandomVec(std::vector<T>* vec, T lower = -10, T upper = 10) {
+  static unsigned int seed = 100;
+  std::mt19937 rng(seed++);
+  std::uniform_real_distribution<double> uniform_dist(lower, upper);
+  for (auto& v : *vec) {
+    v = static_cast<T>(uniform_dist(rng));
+  }
+}
+
+// Softmax along axis_dim of x viewed as [n, axis_dim, remain], element by
+// element in double.
+template <typename T>
+void RefSoftmax(const std::vector<T>& x,
+                std::vector<T>* y,
+                int n,
+                int axis_dim,
+                int remain,
+                bool log_mode) {
+  for (int i = 0; i < n; ++i) {
+    for (int r = 0; r < remain; ++r) {
+      auto at = [&](int a) { return (i * axis_dim + a) * remain + r; };
+      double max_val = x[at(0)];
+      for (int a = 1; a < axis_dim; ++a) {
+        max_val = std::max<double>(max_val, x[at(a)]);
+      }
+      double sum = 0;
+      for (int a = 0; a < axis_dim; ++a) {
+        sum += std::exp(std::max(x[at(a)] - max_val, -64.));
+      }
+      for (int a = 0; a < axis_dim; ++a) {
+        double shifted = std::max(x[at(a)] - max_val, -64.);
+        (*y)[at(a)] = static_cast<T>(log_mode ? shifted - std::log(sum)
+                                              : std::exp(shifted) / sum);
+      }
+    }
+  }
+}
+
+template <typename T>
+void RefSoftmaxGrad(const std::vector<T>& y,
+                    const std::vector<T>& dy,
+                    std::vector<T>* dx,
+                    int n,
+                    int axis_dim,
+                    int remain,
+                    bool log_mode) {
+  for (int i = 0; i < n; ++i) {
+    for (int r = 0; r < remain; ++r) {
+      auto at = [&](int a) { return (i * axis_dim + a) * remain + r; };
+      double sum = 0;
+      for (int a = 0; a < axis_dim; ++a) {
+        sum += log_mode ? dy[at(a)] : dy[at(a)] * y[at(a)];
+      }
+      for (int a = 0; a < axis_dim; ++a) {
+        (*dx)[at(a)] =
+            static_cast<T>(log_mode ? dy[at(a)] - std::exp(y[at(a)]) * sum
+                                    : (dy[at(a)] - sum) * y[at(a)]);
+      }
+    }
+  }
+}
+
+template <typename T>
+void TestAndBench(int n, int axis_dim, int remain, bool log_mode) {
+  const int numel = n * axis_dim * remain;
+  std::vector<T> x(numel), dy(numel);
+  std::vector<T> y(numel), y_ref(numel), dx(numel), dx_ref(numel);
+  RandomVec<T>(&x);
+  RandomVec<T>(&dy, -1, 1);
+
+  auto t0 = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    funcs::SoftmaxCPU<T>(x.data(), y.data(), n, axis_dim, remain, log_mode);
+  }
+  auto t1 = GetCurrentUS();
+  RefSoftmax<T>(x, &y_ref, n, axis_dim, remain, log_mode);
+  ExpectNear(y, y_ref, 1e-4);
+
+  auto t2 = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    funcs::SoftmaxGradCPU<T>(
+        y.data(), dy.data(), dx.data(), n, axis_dim, remain, log_mode);
+  }
+  auto t3 = GetCurrentUS();
+  RefSoftmaxGrad<T>(y, dy, &dx_ref, n, axis_dim, remain, log_mode);
+  ExpectNear(dx, dx_ref, 1e-4);
+
+  VLOG(3) << (log_mode ? "log_softmax" : "softmax") << " of [" << n << ", "
+          << axis_dim << ", " << remain << "]: forward takes "
+          << (t1 - t0) / repeat << " us, backward takes " << (t3 - t2) / repeat
+          << " us.";
+}
+
+TEST(SoftmaxCPU, rows) {
+  for (bool log_mode : {false, true}) {
+    // attention scores of [batch * heads * seq_len, seq_len]
+    TestAndBench<float>(4 * 12 * 128, 128, 1, log_mode);
+    TestAndBench<float>(512, 1000, 1, log_mode);
+    TestAndBench<float>(3, 7, 1, log_mode);
+    TestAndBench<float>(1, 1, 1, log_mode);
+    TestAndBench<double>(64, 33, 1, log_mode);
+  }
+}
+
+TEST(SoftmaxCPU, strided) {
+  for (bool log_mode : {false, true}) {
+    // softmax along the channels of NCHW
+    TestAndBench<float>(16, 64, 28 * 28, log_mode);
+    TestAndBench<float>(2, 5, 3, log_mode);
+    TestAndBench<double>(8, 17, 9, log_mode);
+  }
+}
+
+TEST(SoftmaxCPU, masked) {
+  const int batch_size = 2, num_heads = 12, seq_len = 64, num_classes = 64;
+  const int numel = batch_size * num_heads * seq_len * num_classes;
+  std::vector<float> x(numel), mask(batch_size * seq_len * num_classes);
+  std::vector<float> y(numel), x_masked(numel), y_ref(numel);
+  RandomVec<float>(&x);
+  RandomVec<float>(&mask);
+  for (int i = 0; i < numel / num_classes; ++i) {
+    int b = i / (num_heads * seq_len), s = i % seq_len;
+    for (int c = 0; c < num_classes; ++c) {
+      x_masked[i * num_classes + c] =
+          x[i * num_classes + c] + mask[(b * seq_len + s) * num_classes + c];
+    }
+  }
+  funcs::MaskedSoftmaxCPU<float>(x.data(),
+                                 mask.data(),
+                                 y.data(),
+                                 batch_size,
+                                 num_heads,
+                                 seq_len,
+                                 num_classes);
+  RefSoftmax<float>(
+      x_masked, &y_ref, numel / num_classes, num_classes, 1, false);
+  ExpectNear(y, y_ref, 1e-4);
+}
+
+}  // namespace tests
+}  // namespace phi
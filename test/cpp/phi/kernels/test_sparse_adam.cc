@@ -0,0 +1,222 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/core/selected_rows.h"
+#include "paddle/phi/kernels/adam_kernel.h"
+#include "paddle/phi/kernels/adamw_kernel.h"
+#include "paddle/phi/kernels/selected_rows/adam_kernel.h"
+#include "paddle/phi/kernels/selected_rows/adamw_kernel.h"
+#include "test/cpp/phi/kernels/cpu_test_utils.h"
+
+namespace phi {
+namespace tests {
+
+DenseTensor MakeTensor(const DDim& dims, const std::vector<float>& data) {
+  DenseTensor t;
+  t.Resize(dims);
+  float* ptr = GetCPUContext().Alloc<float>(&t);
+  std::copy(data.begin(), data.end(), ptr);
+  return t;
+}
+
+// The inputs and outputs of an adam step on a [vocab, width] parameter.
+struct AdamState {
+  AdamState(int64_t vocab, int64_t width, std::mt19937* rng) {
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+    std::vector<float> values(vocab * width);
+    for (auto& v : values) {
+      v = dist(*rng);
+    }
+    param = MakeTensor({vocab, width}, values);
+    moment1 = MakeTensor({vocab, width}, values);
+    moment2 = MakeTensor({vocab, width}, values);
+    lr = MakeTensor({1}, {0.01f});
+    beta1_pow = MakeTensor({1}, {0.9f});
+    beta2_pow = MakeTensor({1}, {0.999f});
+    for (auto* out : {&param_out, &moment1_out, &moment2_out}) {
+      out->Resize({vocab, width});
+    }
+    for (auto* out : {&beta1_pow_out, &beta2_pow_out}) {
+      out->Resize({1});
+    }
+  }
+
+  DenseTensor param, moment1, moment2, lr, beta1_pow, beta2_pow;
+  DenseTensor param_out, moment1_out, moment2_out, moment2_max_out;
+  DenseTensor beta1_pow_out, beta2_pow_out, master_param_out;
+};
+
+TEST(SparseAdam, matches_dense) {
+  const int64_t vocab = 20000, width = 16, n = 50000;
+  std::mt19937 rng(2025);
+  std::uniform_int_distribution<int64_t> row_dist(0, vocab / 4);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  // Unsorted rows with duplicates, as the gradient of an embedding.
+  std::vector<int64_t> rows(n);
+  std::vector<float> grad_values(n * width);
+  std::vector<float> dense_grad(vocab * width, 0.f);
+  for (int64_t i = 0; i < n; ++i) {
+    rows[i] = row_dist(rng) * 3;
+    for (int64_t j = 0; j < width; ++j) {
+      grad_values[i * width + j] = dist(rng);
+      dense_grad[rows[i] * width + j] += grad_values[i * width + j];
+    }
+  }
+  SelectedRows grad(rows, vocab);
+  *grad.mutable_value() = MakeTensor({n, width}, grad_values);
+  DenseTensor grad_tensor = MakeTensor({vocab, width}, dense_grad);
+
+  for (bool with_decay : {false, true}) {
+    std::mt19937 state_rng(7);
+    AdamState sparse(vocab, width, &state_rng);
+    state_rng.seed(7);
+    AdamState dense(vocab, width, &state_rng);
+
+    auto t0 = GetCurrentUS();
+    sr::AdamwDenseParamSparseGradKernel<float, CPUContext>(
+        GetCPUContext(),
+        sparse.param,
+        grad,
+        sparse.lr,
+        sparse.moment1,
+        sparse.moment2,
+        paddle::none,
+        sparse.beta1_pow,
+        sparse.beta2_pow,
+        paddle::none,
+        paddle::none,
+        0.9f,
+        0.999f,
+        1e-8f,
+        1.0f,
+        0.01f,
+        with_decay,
+        false,
+        1000,
+        false,
+        false,
+        false,
+        &sparse.param_out,
+        &sparse.moment1_out,
+        &sparse.moment2_out,
+        &sparse.moment2_max_out,
+        &sparse.beta1_pow_out,
+        &sparse.beta2_pow_out,
+        &sparse.master_param_out);
+    auto t1 = GetCurrentUS();
+    VLOG(3) << "sparse adamw (with_decay = " << with_decay << ") of " << n
+            << " rows takes " << t1 - t0 << " us.";
+
+    AdamwDenseKernel<float, CPUContext>(GetCPUContext(),
+                                        dense.param,
+                                        grad_tensor,
+                                        dense.lr,
+                                        dense.moment1,
+                                        dense.moment2,
+                                        paddle::none,
+                                        dense.beta1_pow,
+                                        dense.beta2_pow,
+                                        paddle::none,
+                                        paddle::none,
+                                        0.9f,
+                                        0.999f,
+                                        1e-8f,
+                                        1.0f,
+                                        0.01f,
+                                        with_decay,
+                                        false,
+                                        1000,
+                                        false,
+                                        false,
+                                        false,
+                                        &dense.param_out,
+                                        &dense.moment1_out,
+                                        &dense.moment2_out,
+                                        &dense.moment2_max_out,
+                                        &dense.beta1_pow_out,
+                                        &dense.beta2_pow_out,
+                                        &dense.master_param_out);
+
+    ExpectNear(sparse.param_out, dense.param_out, 1e-5, "param_out");
+    ExpectNear(sparse.moment1_out, dense.moment1_out, 1e-5, "moment1_out");
+    ExpectNear(sparse.moment2_out, dense.moment2_out, 1e-5, "moment2_out");
+    ExpectNear(
+        sparse.beta1_pow_out, dense.beta1_pow_out, 1e-5, "beta1_pow_out");
+  }
+}
+
+TEST(SparseAdam, lazy_mode) {
+  const int64_t vocab = 1000, width = 8;
+  std::mt19937 rng(2025);
+  std::vector<int64_t> rows = {5, 3, 5, 999, 3, 5};
+  std::vector<float> grad_values(rows.size() * width, 0.5f);
+  SelectedRows grad(rows, vocab);
+  *grad.mutable_value() = MakeTensor(
+      {static_cast<int64_t>(rows.size()), width}, grad_values);
+
+  AdamState state(vocab, width, &rng);
+  // The rows without gradient are left as they are in place.
+  state.param_out = state.param;
+  state.moment1_out = state.moment1;
+  state.moment2_out = state.moment2;
+  std::vector<float> param(state.param.data<float>(),
+                           state.param.data<float>() + vocab * width);
+  sr::AdamDenseParamSparseGradKernel<float, CPUContext>(
+      GetCPUContext(),
+      state.param,
+      grad,
+      state.lr,
+      state.moment1,
+      state.moment2,
+      paddle::none,
+      state.beta1_pow,
+      state.beta2_pow,
+      paddle::none,
+      paddle::none,
+      0.9f,
+      0.999f,
+      1e-8f,
+      true,
+      1000,
+      false,
+      false,
+      false,
+      &state.param_out,
+      &state.moment1_out,
+      &state.moment2_out,
+      &state.moment2_max_out,
+      &state.beta1_pow_out,
+      &state.beta2_pow_out,
+      &state.master_param_out);
+  for (int64_t r = 0; r < vocab; ++r) {
+    const bool updated = r == 3 || r == 5 || r == 999;
+    for (int64_t j = 0; j < width; ++j) {
+      const float out = state.param_out.data<float>()[r * width + j];
+      if (updated) {
+        ASSERT_LT(out, param[r * width + j]);
+      } else {
+        ASSERT_EQ(out, param[r * width + j]);
+      }
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
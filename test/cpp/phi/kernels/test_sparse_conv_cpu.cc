@@ -0,0 +1,297 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <array>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/funcs/radix_sort.h"
+#include "paddle/phi/kernels/sparse/coalesce_kernel.h"
+#include "paddle/phi/kernels/sparse/conv_kernel.h"
+#include "paddle/phi/kernels/sparse/cpu/conv.h"
+#include "test/cpp/phi/kernels/cpu_test_utils.h"
+
+namespace phi {
+namespace tests {
+
+constexpr int repeat = 10;
+
+using Point = std::array<int, 4>;  // batch, z, y, x
+
+// A voxel grid of [batch, size, size, size] with about occupancy of the
+// voxels set, and values of [nnz, channels].
+SparseCooTensor RandomVoxelGrid(int batch,
+                                int size,
+                                double occupancy,
+                                int channels,
+                                std::vector<Point>* points) {
+  std::mt19937 rng(2025);
+  std::bernoulli_distribution occupied(occupancy);
+  std::uniform_real_distribution<float> uniform_dist(-1.f, 1.f);
+  points->clear();
+  for (int b = 0; b < batch; ++b) {
+    for (int z = 0; z < size; ++z) {
+      for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+          if (occupied(rng)) {
+            points->push_back({b, z, y, x});
+          }
+        }
+      }
+    }
+  }
+  // The conv kernels do not require sorted indices.
+  std::shuffle(points->begin(), points->end(), rng);
+
+  const int64_t nnz = static_cast<int64_t>(points->size());
+  DenseTensor indices, values;
+  indices.Resize({4, nnz});
+  values.Resize({nnz, channels});
+  int* indices_ptr = GetCPUContext().Alloc<int>(&indices);
+  float* values_ptr = GetCPUContext().Alloc<float>(&values);
+  for (int64_t i = 0; i < nnz; ++i) {
+    for (int d = 0; d < 4; ++d) {
+      indices_ptr[d * nnz + i] = (*points)[i][d];
+    }
+  }
+  for (int64_t i = 0; i < nnz * channels; ++i) {
+    values_ptr[i] = uniform_dist(rng);
+  }
+  return SparseCooTensor(
+      indices, values, common::make_ddim({batch, size, size, size, channels}));
+}
+
+// Computes a 3x3x3 conv with stride 1 and padding 1 point by point.
+std::map<Point, std::vector<float>> RefConv3d(const std::vector<Point>& points,
+                                              const float* values,
+                                              const float* kernel,
+                                              int size,
+                                              int in_channels,
+                                              int out_channels,
+                                              bool subm) {
+  std::set<Point> active(points.begin(), points.end());
+  std::map<Point, std::vector<float>> out;
+  for (size_t i = 0; i < points.size(); ++i) {
+    const Point& in = points[i];
+    for (int kz = 0; kz < 3; ++kz) {
+      for (int ky = 0; ky < 3; ++ky) {
+        for (int kx = 0; kx < 3; ++kx) {
+          Point o = {in[0], in[1] + 1 - kz, in[2] + 1 - ky, in[3] + 1 - kx};
+          if (o[1] < 0 || o[1] >= size || o[2] < 0 || o[2] >= size ||
+              o[3] < 0 || o[3] >= size) {
+            continue;
+          }
+          if (subm && active.count(o) == 0) {
+            continue;
+          }
+          auto& row = out[o];
+          row.resize(out_channels, 0.f);
+          const float* w =
+              kernel + ((kz * 3 + ky) * 3 + kx) * in_channels * out_channels;
+          for (int c = 0; c < in_channels; ++c) {
+            for (int oc = 0; oc < out_channels; ++oc) {
+              row[oc] += values[i * in_channels + c] * w[c * out_channels + oc];
+            }
+          }
+        }
+      }
+    }
+  }
+  return out;
+}
+
+void TestConv3d(bool subm) {
+  const int batch = 2, size = 40, in_channels = 16, out_channels = 32;
+  std::vector<Point> points;
+  SparseCooTensor x = RandomVoxelGrid(batch, size, 0.05, in_channels, &points);
+
+  std::mt19937 rng(100);
+  std::uniform_real_distribution<float> uniform_dist(-1.f, 1.f);
+  DenseTensor kernel;
+  kernel.Resize({3, 3, 3, in_channels, out_channels});
+  float* kernel_ptr = GetCPUContext().Alloc<float>(&kernel);
+  for (int64_t i = 0; i < kernel.numel(); ++i) {
+    kernel_ptr[i] = uniform_dist(rng);
+  }
+
+  const std::vector<int> paddings = {1, 1, 1}, dilations = {1, 1, 1},
+                         strides = {1, 1, 1};
+  SparseCooTensor out;
+  DenseTensor rulebook, counter;
+  auto run = [&]() {
+    sparse::Conv3dCooKernel<float, CPUContext>(GetCPUContext(),
+                                               x,
+                                               kernel,
+                                               paddings,
+                                               dilations,
+                                               strides,
+                                               1,
+                                               subm,
+                                               "",
+                                               &out,
+                                               &rulebook,
+                                               &counter);
+  };
+  run();
+
+  auto ref = RefConv3d(points,
+                       x.values().data<float>(),
+                       kernel_ptr,
+                       size,
+                       in_channels,
+                       out_channels,
+                       subm);
+  const int64_t out_nnz = out.nnz();
+  ASSERT_EQ(out_nnz, static_cast<int64_t>(ref.size()));
+  const int* out_indices = out.indices().data<int>();
+  const float* out_values = out.values().data<float>();
+  int64_t i = 0;
+  for (const auto& item : ref) {
+    for (int d = 0; d < 4; ++d) {
+      ASSERT_EQ(out_indices[d * out_nnz + i], item.first[d]);
+    }
+    for (int oc = 0; oc < out_channels; ++oc) {
+      ASSERT_NEAR(out_values[i * out_channels + oc], item.second[oc], 1e-3);
+    }
+    ++i;
+  }
+
+  auto t0 = GetCurrentUS();
+  for (int r = 0; r < repeat; ++r) {
+    DenseTensor tmp_rulebook;
+    SparseCooTensor tmp_out;
+    std::vector<int> counter_per_kernel(27);
+    sparse::ProductRuleBook<float, CPUContext, int>(GetCPUContext(),
+                                                    x,
+                                                    {3, 3, 3},
+                                                    paddings,
+                                                    dilations,
+                                                    strides,
+                                                    out.dims(),
+                                                    subm,
+                                                    &tmp_rulebook,
+                                                    counter_per_kernel.data());
+    sparse::UpdateRulebookAndOutIndex<float, CPUContext, int>(GetCPUContext(),
+                                                              x,
+                                                              27,
+                                                              out_channels,
+                                                              out.dims(),
+                                                              &tmp_rulebook,
+                                                              &tmp_out);
+  }
+  auto t1 = GetCurrentUS();
+  for (int r = 0; r < repeat; ++r) {
+    run();
+  }
+  auto t2 = GetCurrentUS();
+  VLOG(3) << (subm ? "subm " : "") << "conv3d of " << x.nnz()
+          << " voxels to " << out_nnz << " voxels with " << rulebook.dims()[1]
+          << " rules: rulebook takes " << (t1 - t0) / repeat
+          << " us, conv takes " << (t2 - t1) / repeat << " us.";
+}
+
+TEST(SparseConvCPU, subm_conv3d_voxel_grid) { TestConv3d(true); }
+
+TEST(SparseConvCPU, conv3d_voxel_grid) { TestConv3d(false); }
+
+TEST(SparseConvCPU, coalesce) {
+  const int64_t nnz = 200000, channels = 4;
+  const int size = 64;
+  std::mt19937 rng(2025);
+  std::uniform_int_distribution<int> coord_dist(0, size - 1);
+  std::uniform_real_distribution<float> uniform_dist(-1.f, 1.f);
+  DenseTensor indices, values;
+  indices.Resize({3, nnz});
+  values.Resize({nnz, channels});
+  int64_t* indices_ptr = GetCPUContext().Alloc<int64_t>(&indices);
+  float* values_ptr = GetCPUContext().Alloc<float>(&values);
+  // The duplicates are summed in their order in x.
+  std::map<std::array<int64_t, 3>, std::vector<float>> ref;
+  for (int64_t i = 0; i < nnz; ++i) {
+    std::array<int64_t, 3> point;
+    for (int d = 0; d < 3; ++d) {
+      point[d] = coord_dist(rng);
+      indices_ptr[d * nnz + i] = point[d];
+    }
+    auto it = ref.find(point);
+    for (int c = 0; c < channels; ++c) {
+      values_ptr[i * channels + c] = uniform_dist(rng);
+    }
+    if (it == ref.end()) {
+      ref.emplace(point,
+                  std::vector<float>(values_ptr + i * channels,
+                                     values_ptr + (i + 1) * channels));
+    } else {
+      for (int c = 0; c < channels; ++c) {
+        it->second[c] += values_ptr[i * channels + c];
+      }
+    }
+  }
+  SparseCooTensor x(
+      indices, values, common::make_ddim({size, size, size, channels}));
+
+  SparseCooTensor out;
+  auto t0 = GetCurrentUS();
+  for (int r = 0; r < repeat; ++r) {
+    sparse::CoalesceCooKernel<float, CPUContext>(GetCPUContext(), x, &out);
+  }
+  auto t1 = GetCurrentUS();
+  VLOG(3) << "coalesce of " << nnz << " points to " << out.nnz()
+          << " points takes " << (t1 - t0) / repeat << " us.";
+
+  const int64_t out_nnz = out.nnz();
+  ASSERT_EQ(out_nnz, static_cast<int64_t>(ref.size()));
+  const int64_t* out_indices = out.indices().data<int64_t>();
+  const float* out_values = out.values().data<float>();
+  int64_t i = 0;
+  for (const auto& item : ref) {
+    for (int d = 0; d < 3; ++d) {
+      ASSERT_EQ(out_indices[d * out_nnz + i], item.first[d]);
+    }
+    for (int c = 0; c < channels; ++c) {
+      ASSERT_EQ(out_values[i * channels + c], item.second[c]);
+    }
+    ++i;
+  }
+}
+
+TEST(SparseConvCPU, radix_sort_pairs) {
+  std::mt19937 rng(2025);
+  for (int64_t n : {0, 1, 100, 1000, 300000}) {
+    std::uniform_int_distribution<int> key_dist(-5000, 5000);
+    std::vector<int> keys(n);
+    std::vector<int64_t> values(n);
+    std::vector<std::pair<int, int64_t>> ref(n);
+    for (int64_t i = 0; i < n; ++i) {
+      keys[i] = key_dist(rng);
+      values[i] = i;
+      ref[i] = std::make_pair(keys[i], i);
+    }
+    std::stable_sort(ref.begin(), ref.end(), [](const auto& a, const auto& b) {
+      return a.first < b.first;
+    });
+    funcs::RadixSortPairs(keys.data(), values.data(), n);
+    for (int64_t i = 0; i < n; ++i) {
+      ASSERT_EQ(keys[i], ref[i].first);
+      ASSERT_EQ(values[i], ref[i].second);
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,212 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/funcs/wordpiece_trie.h"
+#include "test/cpp/phi/core/timer.h"
+
+namespace phi {
+namespace tests {
+
+// The greedy longest-match-first WordPiece which probes the vocab with every
+// candidate substring, as faster_tokenizer did before the trie.
+bool RefWordPiece(const Vocab& vocab,
+                  const std::wstring& text,
+                  std::vector<int64_t>* ids) {
+  auto it = vocab.find(text);
+  if (it != vocab.end()) {
+    ids->emplace_back(it->second);
+    return true;
+  }
+  size_t len = text.size();
+  size_t start = 0;
+  while (start < len) {
+    size_t end = len;
+    bool found = false;
+    while (start < end) {
+      std::wstring sub = text.substr(start, end - start);
+      if (start > 0) {
+        sub.insert(0, L"##");
+      }
+      auto it = vocab.find(sub);
+      if (it != vocab.end()) {
+        ids->emplace_back(it->second);
+        found = true;
+        break;
+      }
+      end -= 1;
+    }
+    if (!found) {
+      return false;
+    }
+    start = end;
+  }
+  return true;
+}
+
+std::wstring RandomWord(std::mt19937* rng,
+                        const std::wstring& alphabet,
+                        int max_len) {
+  std::uniform_int_distribution<int> len_dist(1, max_len);
+  std::uniform_int_distribution<size_t> ch_dist(0, alphabet.size() - 1);
+  std::wstring word;
+  for (int i = len_dist(*rng); i > 0; --i) {
+    word += alphabet[ch_dist(*rng)];
+  }
+  return word;
+}
+
+// A vocab of random pieces over a small alphabet with multi-byte characters.
+// The last character of the alphabet is not in any piece, so the words with
+// it are not covered.
+Vocab RandomVocab(std::mt19937* rng, const std::wstring& alphabet) {
+  const std::wstring known = alphabet.substr(0, alphabet.size() - 1);
+  Vocab vocab;
+  int32_t id = 0;
+  vocab.emplace(L"[UNK]", id++);
+  for (int i = 0; i < 3000; ++i) {
+    std::wstring piece = RandomWord(rng, known, 6);
+    vocab.emplace(piece, id++);
+    if (i % 3 != 0) {
+      vocab.emplace(L"##" + piece, id++);
+    }
+  }
+  for (wchar_t ch : known) {
+    vocab.emplace(std::wstring(1, ch), id++);
+    vocab.emplace(L"##" + std::wstring(1, ch), id++);
+  }
+  vocab.emplace(L"#", id++);
+  return vocab;
+}
+
+TEST(WordPieceTrie, same_as_greedy_longest_match) {
+  std::mt19937 rng(2025);
+  // Words never contain '#', which BasicTokenizer splits as punctuation.
+  const std::wstring alphabet = L"abcdefghé中z";
+  Vocab vocab = RandomVocab(&rng, alphabet);
+  funcs::WordPieceTrie trie(vocab);
+
+  const int num_words = 20000;
+  std::vector<std::wstring> words;
+  std::vector<std::string> utf8_words;
+  for (int i = 0; i < num_words; ++i) {
+    words.emplace_back(RandomWord(&rng, alphabet, 16));
+    utf8_words.emplace_back();
+    ConvertWstrToStr(words.back(), &utf8_words.back());
+  }
+
+  int64_t num_tokens = 0, num_covered = 0;
+  std::vector<int64_t> ids, ref_ids;
+  for (int i = 0; i < num_words; ++i) {
+    ids.assign(1, -2);
+    ref_ids.assign(1, -2);
+    bool covered =
+        trie.Tokenize(utf8_words[i].data(), utf8_words[i].size(), &ids);
+    bool ref_covered = RefWordPiece(vocab, words[i], &ref_ids);
+    ASSERT_EQ(covered, ref_covered) << utf8_words[i];
+    if (covered) {
+      ASSERT_EQ(ids, ref_ids) << utf8_words[i];
+      num_tokens += static_cast<int64_t>(ids.size()) - 1;
+      ++num_covered;
+    } else {
+      // nothing is appended for an uncovered word
+      ASSERT_EQ(ids.size(), 1UL);
+    }
+  }
+  EXPECT_GT(num_covered, 0);
+  EXPECT_LT(num_covered, num_words);
+
+  auto t0 = GetCurrentUS();
+  for (int i = 0; i < num_words; ++i) {
+    ids.clear();
+    trie.Tokenize(utf8_words[i].data(), utf8_words[i].size(), &ids);
+  }
+  auto t1 = GetCurrentUS();
+  for (int i = 0; i < num_words; ++i) {
+    ref_ids.clear();
+    RefWordPiece(vocab, words[i], &ref_ids);
+  }
+  auto t2 = GetCurrentUS();
+  VLOG(3) << num_tokens << " tokens of " << num_covered
+          << " words: trie takes " << num_tokens / (t1 - t0)
+          << " M tokens/s, refer takes " << num_tokens / (t2 - t1)
+          << " M tokens/s.";
+}
+
+TEST(WordPieceTrie, find) {
+  Vocab vocab;
+  vocab.emplace(L"[UNK]", 0);
+  vocab.emplace(L"中", 1);
+  vocab.emplace(L"中文", 2);
+  vocab.emplace(L"##文", 3);
+  funcs::WordPieceTrie trie(vocab);
+  std::string zh = "中", zh_wen = "中文", wen = "文";
+  EXPECT_EQ(trie.Find(zh.data(), zh.size()), 1);
+  EXPECT_EQ(trie.Find(zh_wen.data(), zh_wen.size()), 2);
+  EXPECT_EQ(trie.Find(wen.data(), wen.size()), -1);
+  EXPECT_EQ(trie.Find(zh_wen.data(), 1), -1);
+
+  std::vector<int64_t> ids;
+  std::string zh_wen_wen = "中文文";
+  EXPECT_TRUE(trie.Tokenize(zh_wen_wen.data(), zh_wen_wen.size(), &ids));
+  EXPECT_EQ(ids, (std::vector<int64_t>{2, 3}));
+  EXPECT_FALSE(trie.Tokenize(wen.data(), wen.size(), &ids));
+  EXPECT_EQ(ids.size(), 2UL);
+
+  auto shared_trie = funcs::WordPieceTrie::Get(&vocab);
+  EXPECT_EQ(funcs::WordPieceTrie::Get(&vocab), shared_trie);
+}
+
+// The trie kept in a vocab is dropped with it, so another vocab of the same
+// size built at the same address gets its own trie.
+TEST(WordPieceTrie, lives_with_vocab) {
+  alignas(Vocab) unsigned char storage[sizeof(Vocab)];
+  auto* vocab = new (storage) Vocab();
+  vocab->emplace(L"a", 0);
+  vocab->emplace(L"b", 1);
+  std::weak_ptr<const funcs::WordPieceTrie> first_trie =
+      funcs::WordPieceTrie::Get(vocab);
+  EXPECT_EQ(funcs::WordPieceTrie::Get(vocab)->Find("a", 1), 0);
+  vocab->~Vocab();
+  EXPECT_TRUE(first_trie.expired());
+
+  auto* other = new (storage) Vocab();
+  ASSERT_EQ(static_cast<void*>(other), static_cast<void*>(vocab));
+  other->emplace(L"a", 1);
+  other->emplace(L"c", 0);
+  auto trie = funcs::WordPieceTrie::Get(other);
+  EXPECT_EQ(trie->Find("a", 1), 1);
+  EXPECT_EQ(trie->Find("b", 1), -1);
+  EXPECT_EQ(trie->Find("c", 1), 0);
+
+  // Reading the vocab keeps its trie.
+  EXPECT_NE(other->find(L"a"), other->end());
+  EXPECT_NE(other->begin(), other->end());
+  EXPECT_EQ(other->wordpiece_trie(), trie);
+
+  // Changing the vocab drops its trie.
+  other->emplace(L"b", 2);
+  EXPECT_EQ(funcs::WordPieceTrie::Get(other)->Find("b", 1), 2);
+  other->~Vocab();
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <thread>
 #include <unordered_map>
 
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
@@ -399,3 +400,33 @@ TEST(type_test, get_type_name) {
   auto name = pir::get_type_name<TestNamespace::TestClass>();
   EXPECT_EQ(name, "TestNamespace::TestClass");
 }
+
+TEST(type_test, concurrent_parametric_storage) {
+  // Parametric types created concurrently from several threads must still be
+  // uniqued to a single storage.
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  pir::Type fp32 = pir::Float32Type::get(ctx);
+  pir::Type int32 = pir::Int32Type::get(ctx);
+
+  constexpr int kNumThreads = 4;
+  constexpr int kNumTypes = 64;
+  std::vector<std::vector<pir::Type>> results(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kNumTypes; ++i) {
+        std::vector<pir::Type> elements(i % 8 + 1, i % 2 ? fp32 : int32);
+        results[t].push_back(pir::VectorType::get(ctx, elements));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (int t = 1; t < kNumThreads; ++t) {
+    for (int i = 0; i < kNumTypes; ++i) {
+      EXPECT_EQ(results[0][i], results[t][i]);
+    }
+  }
+}
@@ -0,0 +1,201 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/program.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_instrumentation.h"
+#include "paddle/pir/include/pass/pass_manager.h"
+
+#include "test/cpp/pir/tools/test_dialect.h"
+#include "test/cpp/pir/tools/test_op.h"
+
+namespace {
+
+constexpr size_t kNumRegionOps = 8;
+
+// Records the threads and the tags of the passes run on the region ops.
+struct RunRecord {
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::set<std::string> tags;
+  size_t num_runs = 0;
+
+  void Add(const std::string& tag) {
+    std::lock_guard<std::mutex> guard(mutex);
+    threads.insert(std::this_thread::get_id());
+    tags.insert(tag);
+    ++num_runs;
+  }
+};
+
+// A pass configured by its constructor, which is not registered.
+class RecordPass : public pir::Pass {
+ public:
+  RecordPass(const std::string& tag, RunRecord* record)
+      : pir::Pass("record_pass", 0), tag_(tag), record_(record) {}
+
+  void Run(pir::Operation* op) override {
+    // Give the other workers a chance to pick up the remaining ops.
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    record_->Add(tag_);
+  }
+
+  bool CanApplyOn(pir::Operation* op) const override {
+    return op->isa<test::RegionOp>();
+  }
+
+ protected:
+  std::string tag_;
+  RunRecord* record_;
+};
+
+class ClonableRecordPass : public RecordPass {
+ public:
+  using RecordPass::RecordPass;
+
+  std::unique_ptr<pir::Pass> CloneForThread() const override {
+    ++num_clones;
+    return std::make_unique<ClonableRecordPass>(tag_, record_);
+  }
+
+  static std::atomic<size_t> num_clones;
+};
+
+std::atomic<size_t> ClonableRecordPass::num_clones{0};
+
+// Captures the number of threads used for the ops nested in the module.
+class ThreadsInstrumentation : public pir::PassInstrumentation {
+ public:
+  explicit ThreadsInstrumentation(size_t* num_threads)
+      : num_threads_(num_threads) {}
+
+  void RunAfterNestedPipelines(pir::Operation* op,
+                               size_t num_threads) override {
+    if (op->isa<pir::ModuleOp>()) *num_threads_ = num_threads;
+  }
+
+ private:
+  size_t* num_threads_;
+};
+
+void BuildProgram(pir::IrContext* ctx, pir::Program* program) {
+  pir::Builder builder(ctx, program->block());
+  for (size_t i = 0; i < kNumRegionOps; ++i) {
+    builder.SetInsertionPointToBlockEnd(program->block());
+    test::RegionOp region_op = builder.Build<test::RegionOp>();
+    pir::Block& block = region_op->region(0).emplace_back();
+    builder.SetInsertionPointToBlockEnd(&block);
+    builder.Build<test::Operation2>();
+    builder.Build<test::Operation2>();
+  }
+}
+
+}  // namespace
+
+TEST(pass_multi_threading, run_parallel) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+  pir::Program program(ctx);
+  BuildProgram(ctx, &program);
+
+  RunRecord record;
+  size_t num_threads = 0;
+  pir::PassManager pm(ctx);
+  pm.AddPass(std::make_unique<ClonableRecordPass>("configured", &record));
+  pm.AddInstrumentation(
+      std::make_unique<ThreadsInstrumentation>(&num_threads));
+  EXPECT_EQ(pm.num_threads(), 1u);
+  pm.EnableMultiThreading(4);
+  EXPECT_EQ(pm.num_threads(), 4u);
+  ClonableRecordPass::num_clones = 0;
+  EXPECT_TRUE(pm.CanCloneForThread());
+
+  EXPECT_TRUE(pm.Run(&program));
+  EXPECT_EQ(num_threads, 4u);
+  EXPECT_EQ(record.num_runs, kNumRegionOps);
+  EXPECT_GT(record.threads.size(), 1u);
+  // The copies keep the configuration of the origin pass.
+  EXPECT_EQ(record.tags, std::set<std::string>{"configured"});
+  size_t num_clones = ClonableRecordPass::num_clones;
+  EXPECT_EQ(num_clones, 4u);
+
+  // The copies are made once and reused by the later runs.
+  EXPECT_TRUE(pm.Run(&program));
+  EXPECT_EQ(record.num_runs, 2 * kNumRegionOps);
+  EXPECT_EQ(ClonableRecordPass::num_clones, num_clones);
+}
+
+TEST(pass_multi_threading, run_sequential) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+  pir::Program program(ctx);
+  BuildProgram(ctx, &program);
+
+  // A pass that does not opt in runs sequentially.
+  {
+    RunRecord record;
+    size_t num_threads = 0;
+    pir::PassManager pm(ctx);
+    pm.AddPass(std::make_unique<RecordPass>("not_clonable", &record));
+    pm.AddInstrumentation(
+        std::make_unique<ThreadsInstrumentation>(&num_threads));
+    pm.EnableMultiThreading(4);
+    EXPECT_FALSE(pm.CanCloneForThread());
+    EXPECT_TRUE(pm.Run(&program));
+    EXPECT_EQ(num_threads, 1u);
+    EXPECT_EQ(record.num_runs, kNumRegionOps);
+    EXPECT_EQ(record.threads.size(), 1u);
+  }
+
+  // A pass writing the parameters runs sequentially.
+  {
+    RunRecord record;
+    size_t num_threads = 0;
+    int scope = 0;
+    pir::PassManager pm(ctx);
+    auto pass = std::make_unique<ClonableRecordPass>("scope", &record);
+    pass->SetNotOwned(pir::Pass::kParamScopeAttr, &scope);
+    pm.AddPass(std::move(pass));
+    pm.AddInstrumentation(
+        std::make_unique<ThreadsInstrumentation>(&num_threads));
+    pm.EnableMultiThreading(4);
+    EXPECT_FALSE(pm.CanCloneForThread());
+    EXPECT_TRUE(pm.Run(&program));
+    EXPECT_EQ(num_threads, 1u);
+    EXPECT_EQ(record.num_runs, kNumRegionOps);
+  }
+
+  // Adding a pass drops the copies made for the former pipeline.
+  {
+    RunRecord record;
+    pir::PassManager pm(ctx);
+    pm.AddPass(std::make_unique<ClonableRecordPass>("first", &record));
+    pm.EnableMultiThreading(4);
+    EXPECT_TRUE(pm.CanCloneForThread());
+    pm.AddPass(std::make_unique<RecordPass>("second", &record));
+    EXPECT_FALSE(pm.CanCloneForThread());
+  }
+}
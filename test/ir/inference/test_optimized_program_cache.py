@@ -0,0 +1,155 @@
+# Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import tempfile
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.inference import Config, create_predictor
+from paddle.jit import to_static
+from paddle.static import InputSpec
+
+CACHE_PREFIX = '_optimized_program_cache_'
+
+
+class SimpleNet(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+        self.fc1 = paddle.nn.Linear(16, 32)
+        self.fc2 = paddle.nn.Linear(32, 8)
+
+    def forward(self, x):
+        return self.fc2(paddle.nn.functional.relu(self.fc1(x)))
+
+
+class TestOptimizedProgramCache(unittest.TestCase):
+    def setUp(self):
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.model_prefix = os.path.join(self.temp_dir.name, 'net/inference')
+        self.cache_dir = os.path.join(self.temp_dir.name, 'cache')
+        self.save_model(seed=1)
+        self.x = np.random.random([4, 16]).astype(np.float32)
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def save_model(self, seed):
+        paddle.seed(seed)
+        with paddle.pir_utils.DygraphPirGuard():
+            model = to_static(
+                SimpleNet(),
+                input_spec=[InputSpec(shape=[None, 16], name='x')],
+                full_graph=True,
+            )
+            paddle.jit.save(model, self.model_prefix)
+
+    def create_config(self, use_cache=True):
+        config = Config(
+            self.model_prefix + '.json', self.model_prefix + '.pdiparams'
+        )
+        config.disable_gpu()
+        config.switch_ir_optim(True)
+        config.enable_new_executor()
+        config.enable_new_ir()
+        config.set_optim_cache_dir(self.cache_dir)
+        config.enable_optimized_program_cache(use_cache)
+        return config
+
+    def run_predictor(self, config):
+        predictor = create_predictor(config)
+        input_tensor = predictor.get_input_handle(
+            predictor.get_input_names()[0]
+        )
+        input_tensor.copy_from_cpu(self.x)
+        predictor.run()
+        output_tensor = predictor.get_output_handle(
+            predictor.get_output_names()[0]
+        )
+        return output_tensor.copy_to_cpu()
+
+    def cache_entries(self):
+        if not os.path.exists(self.cache_dir):
+            return []
+        return sorted(
+            name
+            for name in os.listdir(self.cache_dir)
+            if name.startswith(CACHE_PREFIX)
+        )
+
+    def cached_program_mtime(self, entry):
+        return os.stat(
+            os.path.join(self.cache_dir, entry, '_optimized.json')
+        ).st_mtime_ns
+
+    def test_miss_then_hit(self):
+        baseline = self.run_predictor(self.create_config(use_cache=False))
+        self.assertEqual(self.cache_entries(), [])
+
+        # The first start misses and saves the optimized program.
+        out = self.run_predictor(self.create_config())
+        entries = self.cache_entries()
+        self.assertEqual(len(entries), 1)
+        cache_path = os.path.join(self.cache_dir, entries[0])
+        for name in [
+            '_optimized.json',
+            '_optimized.pdiparams',
+            '_optimized_program_cache_info',
+        ]:
+            self.assertTrue(os.path.exists(os.path.join(cache_path, name)))
+        mtime = self.cached_program_mtime(entries[0])
+        np.testing.assert_allclose(out, baseline, rtol=1e-5, atol=1e-6)
+
+        # The second start loads the cached program without saving it again.
+        out = self.run_predictor(self.create_config())
+        self.assertEqual(self.cache_entries(), entries)
+        self.assertEqual(self.cached_program_mtime(entries[0]), mtime)
+        np.testing.assert_allclose(out, baseline, rtol=1e-5, atol=1e-6)
+
+    def test_invalidate_on_config_change(self):
+        self.run_predictor(self.create_config())
+        entries = self.cache_entries()
+        self.assertEqual(len(entries), 1)
+
+        config = self.create_config()
+        config.delete_pass('matmul_add_act_fuse_pass')
+        self.run_predictor(config)
+        new_entries = self.cache_entries()
+        self.assertEqual(len(new_entries), 2)
+        self.assertTrue(set(entries).issubset(new_entries))
+
+    def test_invalidate_on_model_change(self):
+        self.run_predictor(self.create_config())
+        entries = self.cache_entries()
+        self.assertEqual(len(entries), 1)
+
+        # Same program with other weights, so the params file differs.
+        self.save_model(seed=2)
+        baseline = self.run_predictor(self.create_config(use_cache=False))
+        out = self.run_predictor(self.create_config())
+        new_entries = self.cache_entries()
+        self.assertEqual(len(new_entries), 2)
+        self.assertTrue(set(entries).issubset(new_entries))
+        np.testing.assert_allclose(out, baseline, rtol=1e-5, atol=1e-6)
+
+    def test_no_save_no_dir(self):
+        # Looking up the optimized model path does not create directories.
+        self.run_predictor(self.create_config(use_cache=False))
+        self.assertFalse(os.path.exists(self.cache_dir))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -74,6 +74,7 @@ class TestFused3EmbeddingEltwiseLayernormPattern(PassTest):
                 yield [main_prog, start_prog], False
 
     def setUp(self):
+        self.places.append(paddle.CPUPlace())
         if core.is_compiled_with_cuda():
             self.places.append(paddle.CUDAPlace(0))
 
@@ -127,6 +128,67 @@ class TestFused2EmbeddingEltwiseLayernormPattern(PassTest):
                 yield [main_prog, start_prog], False
 
     def setUp(self):
+        self.places.append(paddle.CPUPlace())
+        if core.is_compiled_with_cuda():
+            self.places.append(paddle.CUDAPlace(0))
+
+    def test_check_output(self):
+        self.check_pass_correct(atol=1e-3, rtol=1e-3)
+
+
+class TestEmbeddingEltwiseLayernormNotFused(PassTest):
+    r'''
+    The fused kernels only take int64 ids, no padding_idx and a layer_norm
+    over the last dim, other programs are kept as they are.
+    '''
+
+    def is_program_valid(self, program):
+        return True
+
+    def sample_program(self):
+        for ids_dtype, padding_idx, begin_norm_axis in [
+            ('int32', None, 2),
+            ('int64', 0, 2),
+            ('int64', None, 1),
+        ]:
+            with paddle.pir_utils.IrGuard():
+                main_prog = paddle.static.Program()
+                start_prog = paddle.static.Program()
+                with paddle.pir.core.program_guard(main_prog, start_prog):
+                    x1 = paddle.static.data(
+                        name='x1', shape=[1, 30], dtype=ids_dtype
+                    )
+
+                    embedding1 = paddle.nn.Embedding(
+                        512, 768, padding_idx=padding_idx
+                    )
+                    embedding2 = paddle.nn.Embedding(30522, 768)
+
+                    add_out1 = paddle.add(embedding1(x1), embedding2(x1))
+                    layer_norm = paddle.nn.LayerNorm(
+                        add_out1.shape[begin_norm_axis:]
+                    )
+                    out = layer_norm(add_out1)
+                    out = paddle.assign(out)
+                    self.pass_attr_list = [
+                        {'embedding_eltwise_layernorm_fuse_pass': {}}
+                    ]
+                    self.feeds = {
+                        "x1": np.random.randint(0, 512, (1, 30)).astype(
+                            ids_dtype
+                        ),
+                    }
+                    self.fetch_list = [out]
+                    self.valid_op_map = {
+                        "pd_op.add": 1,
+                        "pd_op.layer_norm": 1,
+                        "pd_op.embedding": 2,
+                        "pd_op.fused_embedding_eltwise_layernorm": 0,
+                    }
+                    yield [main_prog, start_prog], False
+
+    def setUp(self):
+        self.places.append(paddle.CPUPlace())
         if core.is_compiled_with_cuda():
             self.places.append(paddle.CUDAPlace(0))
 
@@ -0,0 +1,113 @@
+# Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from pass_test import PassTest
+
+import paddle
+from paddle.base import core
+
+paddle.enable_static()
+
+
+class TestRemoveRedundantReshapePattern(PassTest):
+    r'''
+          x
+          |
+       squeeze
+          |
+      unsqueeze        ->        x
+          |                      |
+       reshape                reshape
+          |                      |
+       reshape                  relu
+          |
+         relu
+    '''
+
+    def is_program_valid(self, program):
+        return True
+
+    def sample_program(self):
+        with paddle.pir_utils.IrGuard():
+            main_prog = paddle.static.Program()
+            start_prog = paddle.static.Program()
+            with paddle.pir.core.program_guard(main_prog, start_prog):
+                x = paddle.static.data(
+                    name='x', shape=[4, 1, 16], dtype='float32'
+                )
+                out = paddle.unsqueeze(paddle.squeeze(x, axis=1), axis=1)
+                out = paddle.reshape(out, [4, 4, 4])
+                out = paddle.reshape(out, [-1, 8])
+                out = paddle.nn.functional.relu(out)
+                out = paddle.assign(out)
+                self.pass_attr_list = [{'remove_redundant_reshape_pass': {}}]
+                self.feeds = {
+                    "x": np.random.random((4, 1, 16)).astype("float32"),
+                }
+                self.fetch_list = [out]
+                self.valid_op_map = {
+                    "pd_op.squeeze": 0,
+                    "pd_op.unsqueeze": 0,
+                    "pd_op.reshape": 1,
+                    "pd_op.relu": 1,
+                }
+                yield [main_prog, start_prog], False
+
+    def setUp(self):
+        self.places.append(paddle.CPUPlace())
+        if core.is_compiled_with_cuda():
+            self.places.append(paddle.CUDAPlace(0))
+
+    def test_check_output(self):
+        self.check_pass_correct()
+
+
+class TestRemoveInvalidReshapePattern(PassTest):
+    def is_program_valid(self, program):
+        return True
+
+    def sample_program(self):
+        with paddle.pir_utils.IrGuard():
+            main_prog = paddle.static.Program()
+            start_prog = paddle.static.Program()
+            with paddle.pir.core.program_guard(main_prog, start_prog):
+                x = paddle.static.data(name='x', shape=[4, 16], dtype='float32')
+                out = paddle.reshape(x, [4, 16])
+                out = paddle.nn.functional.relu(out)
+                out = paddle.assign(out)
+                self.pass_attr_list = [{'remove_redundant_reshape_pass': {}}]
+                self.feeds = {
+                    "x": np.random.random((4, 16)).astype("float32"),
+                }
+                self.fetch_list = [out]
+                self.valid_op_map = {
+                    "pd_op.reshape": 0,
+                    "pd_op.relu": 1,
+                }
+                yield [main_prog, start_prog], False
+
+    def setUp(self):
+        self.places.append(paddle.CPUPlace())
+        if core.is_compiled_with_cuda():
+            self.places.append(paddle.CUDAPlace(0))
+
+    def test_check_output(self):
+        self.check_pass_correct()
+
+
+if __name__ == "__main__":
+    unittest.main()